@@ -26,6 +26,7 @@
 #include "StringPredicates.h"
 #include "log.h"
 #include "crc.h"
+#include "cache.h"
 
 #ifdef HAVE_PWD_H
 # include <pwd.h>
@@ -66,6 +67,7 @@ CRcInitFile::CRcInitFile()
       _fdthread(100),
       _netdebug(false),
       _admin(false),
+      _cachesize(gnash::CACHE_DEFAULT_SIZE),
       _certfile("server.pem"),
       _certdir("/etc/pki/tls")
 {
@@ -238,6 +240,8 @@ CRcInitFile::parseFile(const std::string& filespec)
 		setFDThread(num);
             else if (extractNumber(num, "portOffset", variable, value) )
 		setPortOffset(num);
+	    else if (extractNumber(num, "cacheSize", variable, value) )
+		setCacheSize(static_cast<size_t>(num) * 1024 * 1024);
 
         } while (!in.eof());
 
@@ -273,6 +277,7 @@ CRcInitFile::dump(std::ostream& os) const
          << ((_threading)?"enabled":"disabled") << endl;
     os << "\tSpecial Testing output for Gnash: "
          << ((_testing)?"enabled":"disabled") << endl;
+    os << "\tFile cache size: " << _cachesize << " bytes" << endl;
 
 //    RcInitFile::dump();
 }
@@ -98,6 +98,11 @@ public:
     
     void setCgiRoot(const std::string &x) { _cgiroot = x; }
     std::string getCgiRoot() { return _cgiroot; }
+
+    /// \brief Get the memory budget in bytes for the file cache.
+    size_t getCacheSize() const { return _cachesize; }
+    /// \brief Set the memory budget in bytes for the file cache.
+    void setCacheSize(size_t x) { _cachesize = x; }
     
     /// \brief Get the Root SSL certificate
     const std::string& getRootCert() const {
@@ -177,6 +182,11 @@ public:
     ///		not, also to reduce complecity when debugging.
     bool _admin;
 
+    /// \var _cachesize
+    ///		The maximum amount of memory in bytes used by files
+    ///		held in the cache, set in megabytes in the config file.
+    size_t _cachesize;
+
     /// \var _certfile
     ///		This is the name of the server certificate file
     std::string _certfile;
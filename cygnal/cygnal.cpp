@@ -81,6 +81,8 @@ extern "C"{
 
 #include "handler.h"
 #include "cache.h"
+#include "idlewheel.h"
+#include "metrics.h"
 #include "cygnal.h"
 
 #ifdef ENABLE_NLS
@@ -509,6 +511,9 @@ main(int argc, char *argv[])
     
     log_network(_("Document Root for media files is: %s"), docroot);
     crcfile.setDocumentRoot(docroot);
+
+    // Limit how much memory the files kept in the cache can use.
+    cache.setMaxSize(crcfile.getCacheSize());
     
     // load the file of peers. A peer is another instance of Cygnal we
     // can use for distributed processing.
@@ -674,11 +679,13 @@ admin_handler(Network::thread_params_t *args)
 		    cmd = Handler::STATUS;
 		} else if (strncmp(ptr, "HELP", 2) == 0) {
 		    cmd = Handler::HELP;
-		    net.writeNet("commands: help, status, poll, interval, statistics, quit.\n");
+		    net.writeNet("commands: help, status, poll, interval, statistics, metrics, quit.\n");
 		} else if (strncmp(ptr, "POLL", 2) == 0) {
 		    cmd = Handler::POLL;
 		} else if (strncmp(ptr, "INTERVAL", 2) == 0) {
 		    cmd = Handler::INTERVAL;
+		} else if (strncmp(ptr, "METRICS", 2) == 0) {
+		    cmd = Handler::METRICS;
 		}
 	    }
 	    switch (cmd) {
@@ -741,6 +748,11 @@ admin_handler(Network::thread_params_t *args)
 	      case Handler::INTERVAL:
 		  net.writeNet("set interval\n");
 		  break;
+	      case Handler::METRICS:
+		  net.writeNet(Metrics::getDefaultInstance().dump());
+		  // only send them once for each request
+		  cmd = Handler::UNKNOWN;
+		  break;
 	      default:
 		  break;
 	    };
@@ -909,8 +921,12 @@ connection_handler(Network::thread_params_t *args)
 	    rargs->protocol = args->protocol;
 	    rargs->netfd = args->netfd;
 	    RTMPServer *rtmp = new RTMPServer;
+	    Metrics &metrics = Metrics::getDefaultInstance();
+	    std::uint64_t start = Metrics::now();
 	    std::shared_ptr<cygnal::Element> tcurl =
 		rtmp->processClientHandShake(args->netfd);
+	    metrics.record(Metrics::RTMP_HANDSHAKE, Metrics::now() - start);
+	    metrics.increment(Metrics::RTMP_HANDSHAKES);
 	    if (!tcurl) {
 // 		    log_error("Couldn't read the tcUrl variable!");
 		rtmp->closeNet(args->netfd);
@@ -1013,6 +1029,9 @@ event_handler(Network::thread_params_t *args)
     FD_ZERO(&hits);
     FD_SET(args->netfd, &hits);
 
+    // Persistent HTTP connections are closed after sitting idle.
+    IdleWheel idle(HTTP_KEEPALIVE_TIMEOUT);
+
     tids.increment();
     
     // We need to calculate the highest numbered file descriptor
@@ -1059,9 +1078,33 @@ event_handler(Network::thread_params_t *args)
 //log_network("Sending following chunk of %s", ds->getFilespec());
 		if (ds->play(i, false)) {
 		    if (ds->getState() == DiskStream::CLOSED) {
-			net.closeNet(args->netfd);
-			hand->removeClient(args->netfd);
-			done = true;
+			// A persistent connection stays open for the
+			// next request once the file has been sent.
+			std::shared_ptr<HTTPServer> &http = hand->getHTTPHandler(i);
+			if (http && http->keepAlive()) {
+			    hand->setDiskStream(i, std::shared_ptr<DiskStream>());
+			    idle.touch(i, time(0));
+			    // Now answer the requests pipelined behind
+			    // the file, which may start sending another.
+			    if (http->pendingRequestData()) {
+				http->processPendingRequests(hand, i);
+			    }
+			    ds = hand->getDiskStream(i);
+			    if (!http->keepAlive()
+				&& !(ds && (ds->getState() == DiskStream::PLAY))) {
+				idle.remove(args->netfd);
+				net.closeNet(args->netfd);
+				hand->removeClient(args->netfd);
+				done = true;
+			    }
+			} else {
+			    idle.remove(args->netfd);
+			    net.closeNet(args->netfd);
+			    hand->removeClient(args->netfd);
+			    done = true;
+			}
+		    } else {
+			idle.touch(i, time(0));
 		    }
 		} else {
 		    // something went wrong, the stream failed
@@ -1088,14 +1131,20 @@ event_handler(Network::thread_params_t *args)
 		      largs.netfd = i;
 		      // largs.filespec = fullpath;
 		      std::shared_ptr<HTTPServer> &http = hand->getHTTPHandler(i);
-		      if (!http->http_handler(hand, args->netfd, args->buffer)) {
+		      bool alive = http->http_handler(hand, args->netfd, args->buffer);
+		      // The first request is only handled once, after
+		      // that requests are read from the network.
+		      delete args->buffer;
+		      args->buffer = 0;
+		      if (!alive) {
 			  log_network(_("Done with HTTP connection for fd #%d, CGI %s"), i, args->filespec);
+			  idle.remove(i);
 			  net.closeNet(args->netfd);
 			  hand->removeClient(args->netfd);
 			  done = true;
 		      } else {
 			  log_network(_("Not Done with HTTP connection for fd #%d, it's a persistent connection."), i);
-			  
+			  idle.touch(i, time(0));
 		      }
 		      continue;
 		  }
@@ -1162,6 +1211,27 @@ event_handler(Network::thread_params_t *args)
 	    // hand->removeClient(args->netfd);
 	    // done = true;
 	}
+
+	// Send the SharedObject changes made since the last time
+	// through the loop.
+	hand->sync();
+
+	// Close the persistent connections that have been idle too long,
+	// unless data just arrived for them.
+	std::vector<int> expired = idle.expire(time(0));
+	for (size_t i = 0; i < expired.size(); i++) {
+	    if (FD_ISSET(expired[i], &hits)) {
+		idle.touch(expired[i], time(0));
+		continue;
+	    }
+	    log_network(_("Closing idle HTTP connection on fd #%d"),
+			expired[i]);
+	    net.closeNet(expired[i]);
+	    hand->removeClient(expired[i]);
+	    if (expired[i] == args->netfd) {
+		done = true;
+	    }
+	}
 	retries++;
 #if 0
 	if (retries >= 10) {
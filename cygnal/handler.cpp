@@ -87,8 +87,87 @@ bool
 Handler::sync(int /* in_fd */)
 {
 //    GNASH_REPORT_FUNCTION;
+    bool sent = false;
+
+    // Copy the SharedObjects and their connections, so the network
+    // writes don't happen while holding the lock.
+    std::vector<std::shared_ptr<ServerSO> > objs;
+    std::map<int, std::shared_ptr<RTMPServer> > rtmp;
+    {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_sharedobjs.empty()) {
+	    return false;
+	}
+	std::map<std::string, std::shared_ptr<ServerSO> >::iterator it;
+	for (it = _sharedobjs.begin(); it != _sharedobjs.end(); ++it) {
+	    objs.push_back(it->second);
+	}
+	rtmp = _rtmp;
+    }
 
-    return false;
+    for (size_t i = 0; i < objs.size(); i++) {
+	ServerSO::updates_t updates = objs[i]->flush();
+	ServerSO::updates_t::iterator uit;
+	for (uit = updates.begin(); uit != updates.end(); ++uit) {
+	    int fd = uit->first;
+	    cygnal::Buffer &buf = *uit->second;
+	    std::map<int, std::shared_ptr<RTMPServer> >::iterator rit
+		= rtmp.find(fd);
+	    if ((rit == rtmp.end()) || !rit->second) {
+		objs[i]->removeSubscriber(fd);
+		continue;
+	    }
+	    if (rit->second->sendMsg(fd, 3, RTMP::HEADER_12, buf.allocated(),
+				     RTMP::SHARED_OBJ, RTMPMsg::FROM_SERVER,
+				     buf)) {
+		sent = true;
+	    } else {
+		log_error(_("Couldn't send SharedObject \"%s\" to fd #%d"),
+			  objs[i]->getObjectName(), fd);
+	    }
+	}
+    }
+
+    return sent;
+}
+
+std::shared_ptr<ServerSO>
+Handler::getSharedObject(const std::string &name, bool create)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::map<std::string, std::shared_ptr<ServerSO> >::iterator it
+	= _sharedobjs.find(name);
+    if (it != _sharedobjs.end()) {
+	return it->second;
+    }
+    if (!create) {
+	return std::shared_ptr<ServerSO>();
+    }
+
+    std::shared_ptr<ServerSO> so(new ServerSO(name));
+    // Persistent SharedObjects are stored in the same place as the
+    // client side ones.
+    std::string filename = name;
+    std::replace(filename.begin(), filename.end(), '/', '_');
+    so->setFilespec(crcfile.getSOLSafeDir() + "/" + filename + ".sol");
+    _sharedobjs[name] = so;
+
+    return so;
+}
+
+bool
+Handler::processSharedObject(int fd, std::uint8_t *data, size_t size)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::string name = ServerSO::decodeName(data, size);
+    if (name.empty()) {
+	log_error(_("SharedObject message has no name!"));
+	return false;
+    }
+
+    return getSharedObject(name, true)->processMessage(fd, data, size);
 }
 
 size_t
@@ -259,6 +338,11 @@ Handler::removeClient(int x)
 	    _clients.erase(it);
 	}
     }
+
+    std::map<std::string, std::shared_ptr<ServerSO> >::iterator sit;
+    for (sit = _sharedobjs.begin(); sit != _sharedobjs.end(); ++sit) {
+	sit->second->removeSubscriber(x);
+    }
 }
 
 void 
@@ -500,13 +584,32 @@ Handler::seekStream()
     return -1;
 }
 
+std::shared_ptr<gnash::DiskStream>
+Handler::getCurrentDiskStream()
+{
+    // Don't use operator[], which would add an empty stream.
+    std::map<int, std::shared_ptr<gnash::DiskStream> >::iterator it
+	= _diskstreams.find(_streams);
+    if (it == _diskstreams.end()) {
+	return std::shared_ptr<gnash::DiskStream>();
+    }
+    return it->second;
+}
+
+// Seek to a time in milliseconds within the stream being played. The
+// keyframe index makes this a binary search instead of a scan of the
+// whole file.
 int
-Handler::seekStream(int /* offset */)
+Handler::seekStream(int offset)
 {
     GNASH_REPORT_FUNCTION;
-    // _diskstreams[int(streamid)]->setState(DiskStream::SEEK);
 
-    return -1;
+    std::shared_ptr<gnash::DiskStream> ds = getCurrentDiskStream();
+    if (!ds || (offset < 0)) {
+	return -1;
+    }
+
+    return ds->seekTime(offset);
 }
 
 // Pause the RTMP stream
@@ -53,6 +53,7 @@
 #include "rtmp_msg.h"
 #include "http.h"
 #include "network.h"
+#include "serverSO.h"
 
 // _definst_ is the default instance name
 namespace cygnal
@@ -76,6 +77,7 @@ public:
 	POLL,
 	HELP,
 	INTERVAL,
+	METRICS,
 	QUIT
     } admin_cmd_e;
     /// This enum contains the possible values for streaming video
@@ -107,7 +109,9 @@ public:
     ~Handler();
 
     /// \var sync
-    ///     Send the onSync message to all connected clients
+    ///     Send the onSync message to all connected clients, with
+    ///     the SharedObject properties that changed since the last
+    ///     sync. This is called once each time through the event loop.
     bool sync() { return sync(_in_fd); };
     bool sync(int in_fd);
 
@@ -123,12 +127,38 @@ public:
     // Operate on a disk streaming inprogress
     std::shared_ptr<gnash::DiskStream> getDiskStream(int x) { return _diskstreams[x]; }
     void setDiskStream(int x, std::shared_ptr<gnash::DiskStream> y) { _diskstreams[x] = y; }
+    /// \brief Get the stream being played, which is the one seekStream()
+    ///		seeks in.
+    ///
+    /// @return The stream, or a null pointer if there isn't one.
+    std::shared_ptr<gnash::DiskStream> getCurrentDiskStream();
 
     /// Add a SharedObject
     void addSOL(std::shared_ptr<cygnal::Element> x) {
 	_sol.push_back(x);
     };
 
+    /// \brief Get a remote SharedObject.
+    ///
+    /// @param name The name of the SharedObject.
+    ///
+    /// @param create Create the SharedObject if it doesn't exist.
+    ///
+    /// @return The SharedObject, or an empty pointer.
+    std::shared_ptr<ServerSO> getSharedObject(const std::string &name,
+					       bool create);
+
+    /// \brief Process a SharedObject message from a client.
+    ///
+    /// @param fd The file descriptor the message came from.
+    ///
+    /// @param data A pointer to the body of the RTMP message.
+    ///
+    /// @param size The size of the body of the RTMP message.
+    ///
+    /// @return true if the message could be parsed, false if not.
+    bool processSharedObject(int fd, std::uint8_t *data, size_t size);
+
     /// \method addClient
     ///     Add a client to the list for output messages for a
     ///     resource. This also specifies the protocol handler
@@ -199,6 +229,11 @@ public:
 
     // Seek within the RTMP stream
     int seekStream();
+    /// \overload int seekStream(int offset)
+    /// @param offset The time in milliseconds to seek to.
+    ///
+    /// @return The time of the keyframe playback resumes at, or -1
+    ///		if the stream can't seek.
     int seekStream(int offset);
 
     // Pause the RTMP stream
@@ -292,6 +327,10 @@ protected:
     /// \var _sol
     ///	    is for remote SharedObjects
     std::vector<std::shared_ptr<cygnal::Element> > _sol;
+    /// \var _sharedobjs
+    ///	    is the remote SharedObjects clients are connected to,
+    ///     indexed by name.
+    std::map<std::string, std::shared_ptr<ServerSO> > _sharedobjs;
     ///var _bodysize;
     ///     is to store the body size of the previous packet for this
     ///     channel. 4 and 1 byte heades don't use the length field,
@@ -54,6 +54,7 @@
 #include "http_server.h"
 #include "proc.h"
 #include "cache.h"
+#include "metrics.h"
 
 // Not POSIX, so best not rely on it if possible.
 #ifndef PATH_MAX
@@ -95,38 +96,37 @@ HTTPServer::processClientRequest(int /* fd */)
 }
 
 HTTP::http_method_e
-HTTPServer::processClientRequest(Handler *hand, int fd, cygnal::Buffer *buf)
+HTTPServer::processClientRequest(Handler * /* hand */, int fd, cygnal::Buffer *buf)
 {
     GNASH_REPORT_FUNCTION;
     
-    cygnal::Buffer result;
-
     if (buf) {
+	// Each handler sends its own reply to the client.
 	_cmd = extractCommand(buf->reference());
 	switch (_cmd) {
 	  case HTTP::HTTP_GET:
-	      result = processGetRequest(hand, fd, buf);
+	      processGetRequest(fd, buf);
 	      break;
 	  case HTTP::HTTP_POST:
-	      result = processPostRequest(fd, buf);
+	      processPostRequest(fd, buf);
 	      break;
 	  case HTTP::HTTP_HEAD:
-	      result = processHeadRequest(fd, buf);
+	      processHeadRequest(fd, buf);
 	      break;
 	  case HTTP::HTTP_CONNECT:
-	      result = processConnectRequest(fd, buf);
+	      processConnectRequest(fd, buf);
 	      break;
 	  case HTTP::HTTP_TRACE:
-	      result = processTraceRequest(fd, buf);
+	      processTraceRequest(fd, buf);
 	      break;
 	  case HTTP::HTTP_OPTIONS:
-	      result = processOptionsRequest(fd, buf);
+	      processOptionsRequest(fd, buf);
 	      break;
 	  case HTTP::HTTP_PUT:
-	      result = processPutRequest(fd, buf);
+	      processPutRequest(fd, buf);
 	      break;
 	  case HTTP::HTTP_DELETE:
-	      result = processDeleteRequest(fd, buf);
+	      processDeleteRequest(fd, buf);
 	      break;
 	  default:
 	      break;
@@ -176,7 +176,7 @@ HTTPServer::processClientRequest(Handler *hand, int fd, cygnal::Buffer *buf)
 
 // A GET request asks the server to send a file to the client
 cygnal::Buffer &
-HTTPServer::processGetRequest(Handler *hand, int fd, cygnal::Buffer *buf)
+HTTPServer::processGetRequest(int fd, cygnal::Buffer *buf)
 {
     GNASH_REPORT_FUNCTION;
 
@@ -199,29 +199,37 @@ HTTPServer::processGetRequest(Handler *hand, int fd, cygnal::Buffer *buf)
     
     string url = _docroot + _filespec;
 
-    std::shared_ptr<DiskStream> ds = hand->getDiskStream(fd);
-    if (ds) {
-	_diskstream = ds;
-    }
-    if (!_diskstream) {
-	_diskstream.reset(new DiskStream);
-	log_network(_("New filestream %s"), _filespec);
-    } else {
-	log_network(_("Reusing filestream %s"), _filespec);
-    }
+    // Every request on a persistent connection may be for a different
+    // file, so never reuse the stream left over from the last one.
+    _diskstream.reset(new DiskStream);
+    log_network(_("New filestream %s"), _filespec);
     
     // Oopen the file and read the first chunk into memory
-    if (_diskstream->open(url)) {
-	formatErrorResponse(HTTPServer::NOT_FOUND);
-    } else {
-	// Get the file size for the HTTPServer header
-	if (_diskstream->getFileType() == DiskStream::FILETYPE_NONE) {
-	    formatErrorResponse(HTTPServer::NOT_FOUND);
-	} else {
-	    // cache.addPath(_filespec, filestream->getFilespec());
-	    // cache.addFile(_filespec, filestream);
+    if (!_diskstream->open(url)
+	|| (_diskstream->getFileType() == DiskStream::FILETYPE_NONE)) {
+	cygnal::Buffer &reply = formatErrorResponse(HTTPServer::NOT_FOUND);
+	writeNet(fd, reply);
+	_diskstream.reset();
+	return reply;
+    }
+
+    // A conditional GET only wants the file if it changed since the
+    // client cached it.
+    struct stat st;
+    if (stat(url.c_str(), &st) == 0) {
+	setLastModified(st.st_mtime);
+	time_t since = parseDate(getField("if-modified-since"));
+	if (since && (st.st_mtime <= since)) {
+	    log_network(_("%s not modified since %s"), _filespec,
+			getField("if-modified-since"));
+	    cygnal::Buffer &reply = formatHeader(_diskstream->getFileType(),
+						 0, HTTPServer::NOT_MODIFIED);
+	    writeNet(fd, reply);
+	    _diskstream.reset();
+	    return reply;
 	}
     }
+
     // Closing the file closes the disk file, but leaves data resident
     // in memory for future access to this file. If we've been opened,
     // the next operation is to start writing the file next time
@@ -233,7 +241,6 @@ HTTPServer::processGetRequest(Handler *hand, int fd, cygnal::Buffer *buf)
 // 	cache.addFile(_filespec, _diskstream);
 
     // Create the reply message
-//     _close = true; Force sending the close connection in the header
     cygnal::Buffer &reply = formatHeader(_diskstream->getFileType(),
 				      _diskstream->getFileSize(),
 				      HTTPServer::OK);
@@ -269,32 +276,36 @@ HTTPServer::processGetRequest(Handler *hand, int fd, cygnal::Buffer *buf)
 // the header like we normally do, we then read the amount of bytes specified by
 // the "content-length" field, and then write that data to disk, or decode the amf.
 std::shared_ptr<cygnal::Buffer>
-HTTPServer::processPostRequest(int fd, cygnal::Buffer * /* bufFIXME */)
+HTTPServer::processPostRequest(int fd, cygnal::Buffer *request)
 {
     GNASH_REPORT_FUNCTION;
 
 //    cerr << "QUE1 = " << _que.size() << endl;
 
     std::shared_ptr<cygnal::Buffer> buf;
+
+    // Without a request, use the next message read from the network.
+    if (request == nullptr) {
+	if (_que.size() == 0) {
+	    return buf;
+	}
     
-    if (_que.size() == 0) {
-	return buf;
-    }
-    
-    buf = _que.pop();
-    if (buf == nullptr) {
-	log_debug("Queue empty, net connection dropped for fd #%d",
-		  getFileFd());
-	return buf;
+	buf = _que.pop();
+	if (buf == nullptr) {
+	    log_debug("Queue empty, net connection dropped for fd #%d",
+		      getFileFd());
+	    return buf;
+	}
+	request = buf.get();
     }
-//    cerr << __FUNCTION__ << buf->allocated() << " : " << hexify(buf->reference(), buf->allocated(), true) << endl;
+//    cerr << __FUNCTION__ << request->allocated() << " : " << hexify(request->reference(), request->allocated(), true) << endl;
     
     clearHeader();
-    std::uint8_t *data = processHeaderFields(buf.get());
+    std::uint8_t *data = processHeaderFields(request);
     size_t length = strtol(getField("content-length").c_str(), nullptr, 0);
     std::shared_ptr<cygnal::Buffer> content(new cygnal::Buffer(length));
     int ret = 0;
-    if (buf->allocated() - (data - buf->reference()) ) {
+    if (request->allocated() - (data - request->reference()) ) {
 //	cerr << "Don't need to read more data: have " << buf->allocated() << " bytes" << endl;
 	content->copy(data, length);
 	ret = length;
@@ -404,12 +415,39 @@ HTTPServer::processOptionsRequest(int /* fd */, cygnal::Buffer */* buf */)
     return buf;
 }
 
+// A HEAD request is a GET request without the file, so the client
+// can check the size and date of a file without downloading it.
 std::shared_ptr<cygnal::Buffer>
-HTTPServer::processHeadRequest(int /* fd */, cygnal::Buffer */* buf */)
+HTTPServer::processHeadRequest(int fd, cygnal::Buffer *request)
 {
 //    GNASH_REPORT_FUNCTION;
     std::shared_ptr<cygnal::Buffer> buf;
-    log_unimpl(_("HEAD request"));
+
+    if (request == nullptr) {
+	return buf;
+    }
+
+    clearHeader();
+    processHeaderFields(request);
+
+    _docroot = crcfile.getDocumentRoot();
+    string url = _docroot + _filespec;
+
+    DiskStream ds;
+    if (!ds.open(url) || (ds.getFileType() == DiskStream::FILETYPE_NONE)) {
+	cygnal::Buffer &reply = formatErrorResponse(HTTPServer::NOT_FOUND);
+	writeNet(fd, reply);
+	return buf;
+    }
+
+    struct stat st;
+    if (stat(url.c_str(), &st) == 0) {
+	setLastModified(st.st_mtime);
+    }
+    cygnal::Buffer &reply = formatHeader(ds.getFileType(), ds.getFileSize(),
+					 HTTPServer::OK);
+    writeNet(fd, reply);
+    ds.close();
     
     return buf;
 }
@@ -431,32 +469,28 @@ HTTPServer::formatErrorResponse(http_status_e code)
 
     char num[12];
     // First build the message body, so we know how to set Content-Length
-    _buffer += "<!DOCTYPE HTML PUBLIC \"-//IETF//DTD HTML 2.0//EN\">\r\n";
-    _buffer += "<html><head>\r\n";
-    _buffer += "<title>";
+    string body;
+    body += "<!DOCTYPE HTML PUBLIC \"-//IETF//DTD HTML 2.0//EN\">\r\n";
+    body += "<html><head>\r\n";
+    body += "<title>";
     sprintf(num, "%d", code);
-    _buffer += num;
-    _buffer += " Not Found</title>\r\n";
-    _buffer += "</head><body>\r\n";
-    _buffer += "<h1>Not Found</h1>\r\n";
-    _buffer += "<p>The requested URL ";
-    _buffer += _filespec;
-    _buffer += " was not found on this server.</p>\r\n";
-    _buffer += "<hr>\r\n";
-    _buffer += "<address>Cygnal (GNU/Linux) Server at ";
-    _buffer += getField("host");
-    _buffer += " </address>\r\n";
-    _buffer += "</body></html>\r\n";
-
-    // First build the header
-    formatDate();
-    formatServer();
-    formatContentLength(_filesize);
-    formatConnection("close");
-    formatContentType(_filetype);
-
-    // All HTTPServer messages are followed by a blank line.
-    terminateHeader();
+    body += num;
+    body += " Not Found</title>\r\n";
+    body += "</head><body>\r\n";
+    body += "<h1>Not Found</h1>\r\n";
+    body += "<p>The requested URL ";
+    body += _filespec;
+    body += " was not found on this server.</p>\r\n";
+    body += "<hr>\r\n";
+    body += "<address>Cygnal (GNU/Linux) Server at ";
+    body += getField("host");
+    body += " </address>\r\n";
+    body += "</body></html>\r\n";
+
+    // Then the header, which is followed by the body. The connection
+    // stays open, as the client knows where this response ends.
+    formatHeader(DiskStream::FILETYPE_HTML, body.size(), code);
+    _buffer += body;
 
     return _buffer;
 }
@@ -996,6 +1030,46 @@ HTTPServer::dump()
     }
 }
     
+// Handle the complete requests received so far, in order. This stops
+// after a GET that leaves a file to be sent, as the next reply can't
+// go out until the event loop has sent all of it.
+bool
+HTTPServer::processPendingRequests(Handler *hand, int netfd)
+{
+//    GNASH_REPORT_FUNCTION;
+
+    bool handled = false;
+    std::shared_ptr<cygnal::Buffer> request;
+    while ((request = nextRequest())) {
+	handled = true;
+	Metrics::getDefaultInstance().increment(Metrics::HTTP_REQUESTS);
+	HTTP::http_method_e cmd = processClientRequest(hand, netfd,
+						       request.get());
+	if ((cmd == HTTP::HTTP_GET) && _diskstream) {
+	    log_debug("Found active DiskStream! for fd #%d: %s", netfd,
+		      _filespec);
+	    hand->setDiskStream(netfd, _diskstream);
+	    // The stream isn't added to the cache: it is played, and so
+	    // changed, by this connection, while streams in the cache are
+	    // read by other threads at the same time.
+	    // Send the first chunk of the file to the client, and the
+	    // event loop sends the rest.
+	    _diskstream->play(netfd, false);
+	    if (_diskstream->getState() == DiskStream::PLAY) {
+		break;
+	    }
+	} else {
+	    log_debug("No active DiskStreams for fd #%d: %s...", netfd,
+		      _filespec);
+	}
+	if (!keepAlive()) {
+	    break;
+	}
+    }
+
+    return handled;
+}
+
 bool
 HTTPServer::http_handler(Handler *hand, int netfd, cygnal::Buffer *buf)
 {
@@ -1017,33 +1091,42 @@ HTTPServer::http_handler(Handler *hand, int netfd, cygnal::Buffer *buf)
     clock_gettime (CLOCK_REALTIME, &start);
 #endif
 
+    // Requests may arrive split across packets, or several pipelined
+    // requests may arrive in one packet, so everything read is added to
+    // the pending data, and complete requests are split off from that.
     if (buf) {
-	log_network(_("FIXME: Existing data in packet!"));
+	addRequestData(buf->reference(), buf->allocated());
     } else {
-	log_network(_("FIXME: No existing data in packet!"));
 	// See if we have any messages waiting
 	if (recvMsg(netfd) == 0) {
 	    log_debug("Net HTTP server failed to read from fd #%d...", netfd);
 	    return false;
 	}
     }
-    
-    // Process incoming messages
-    HTTP::http_method_e cmd = processClientRequest(hand, netfd, buf);    
-    if (cmd != HTTP::HTTP_GET) {
-	log_debug("No active DiskStreams for fd #%d: %s...", netfd,
-		  _filespec);
-    } else {
-	if (_diskstream) {
-	    log_debug("Found active DiskStream! for fd #%d: %s", netfd,
-		      _filespec);
-	    hand->setDiskStream(netfd, _diskstream);
- 	    cache.addFile(_filespec, _diskstream);
-// Send the first chunk of the file to the client.
-	    // log_network("Sending first chunk of %s", _filespec);
-	    _diskstream->play(netfd, false);
+    while (_que.size()) {
+	std::shared_ptr<cygnal::Buffer> chunk = _que.pop();
+	if (chunk) {
+	    addRequestData(chunk->reference(), chunk->allocated());
 	}
     }
+
+    // Responses go out in the same order as the requests, so while a
+    // file is still being sent the requests stay queued, and the event
+    // loop handles them once it has sent the rest of the file.
+    std::shared_ptr<DiskStream> active = hand->getDiskStream(netfd);
+    if (active && (active->getState() == DiskStream::PLAY)) {
+	log_network(_("Queueing requests on fd #%d behind %s"), netfd,
+		    active->getFilespec());
+	return true;
+    }
+
+    bool handled = processPendingRequests(hand, netfd);
+
+    // Only part of a request has arrived, so wait for the rest of it.
+    if (!handled) {
+	log_network(_("Waiting for the rest of the request on fd #%d"), netfd);
+	return true;
+    }
     
 //	www->dump();
     if ((getField("content-type") == "application/x-amf")
@@ -45,7 +45,7 @@ public:
     // These are for the protocol itself
     http_method_e processClientRequest(int fd);
     http_method_e processClientRequest(Handler *hand, int fd, cygnal::Buffer *buf);
-    cygnal::Buffer &processGetRequest(Handler *hand, int fd, cygnal::Buffer *buf);
+    cygnal::Buffer &processGetRequest(int fd, cygnal::Buffer *buf);
     std::shared_ptr<cygnal::Buffer> processPostRequest(int fd, cygnal::Buffer *buf);
     std::shared_ptr<cygnal::Buffer> processPutRequest(int fd, cygnal::Buffer *buf);
     std::shared_ptr<cygnal::Buffer> processDeleteRequest(int fd, cygnal::Buffer *buf);
@@ -94,6 +94,12 @@ public:
 #endif
 
     bool http_handler(Handler *hand, int netfd, cygnal::Buffer *buf);
+
+    /// \brief Handle the requests queued behind a file being sent.
+    ///
+    /// @return True if a complete request was handled.
+    bool processPendingRequests(Handler *hand, int netfd);
+
     std::shared_ptr<gnash::DiskStream> getDiskStream() { return _diskstream; };
 
     void dump();    
@@ -19,6 +19,7 @@
 //
 
 #include "GnashSystemNetHeaders.h"
+#include "GnashSystemIOHeaders.h"
 #include "buffer.h"
 #include "log.h"
 #include "amf.h"
@@ -32,6 +33,10 @@
 #include <cmath>
 #include <climits>
 #include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <algorithm>
 
 using gnash::log_debug;
 using gnash::log_error;
@@ -39,6 +44,53 @@ using gnash::log_error;
 namespace cygnal
 {
 
+namespace {
+
+/// The keyframe index file starts with this, followed by a version number.
+const char INDEX_MAGIC[] = "FLVX";
+const std::uint32_t INDEX_VERSION = 1;
+
+// The index file is always big endian, like the FLV file itself.
+void
+writeBig(std::ostream &out, std::uint64_t value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--) {
+	out.put(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+}
+
+std::uint64_t
+readBig(std::istream &in, int bytes)
+{
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+	value = (value << 8) | static_cast<std::uint8_t>(in.get());
+    }
+    return value;
+}
+
+// Read a 24 bit big endian integer, which is used for most of the
+// fields in a tag header.
+std::uint32_t
+read24(const std::uint8_t *data)
+{
+    return (data[0] << 16) | (data[1] << 8) | data[2];
+}
+
+bool
+compareKeyframe(std::uint32_t timestamp, const Flv::flv_keyframe_t &key)
+{
+    return timestamp < key.timestamp;
+}
+
+bool
+sortKeyframe(const Flv::flv_keyframe_t &a, const Flv::flv_keyframe_t &b)
+{
+    return a.timestamp < b.timestamp;
+}
+
+} // anonymous namespace
+
 Flv::Flv() 
 {
 //    GNASH_REPORT_FUNCTION;
@@ -305,6 +357,164 @@ Flv::decodeTagHeader(std::uint8_t *buf)
     return tag;
 }
 
+size_t
+Flv::buildIndex(const std::uint8_t *data, size_t size)
+{
+//    GNASH_REPORT_FUNCTION;
+    _keyframes.clear();
+
+    if ((data == nullptr) || (size < FLV_HEADER_SIZE)
+	|| (memcmp(data, "FLV", 3) != 0)) {
+	log_error(_("Can't index, not an FLV file"));
+	return 0;
+    }
+
+    // Files with no video can seek to any audio tag, so index those
+    // instead, but not so many that the index gets large.
+    std::vector<flv_keyframe_t> audio;
+    bool video = false;
+
+    // The header size is a 32 bit field, and is followed by the size
+    // of the previous tag, which is always zero for the first tag.
+    std::uint64_t offset = (read24(data + 5) << 8) | data[8];
+    offset += sizeof(previous_size_t);
+    while ((offset + sizeof(flv_tag_t)) <= size) {
+	const std::uint8_t *tag = data + offset;
+	std::uint32_t bodysize = read24(tag + 1);
+	// The extended byte is the upper 8 bits of the timestamp.
+	std::uint32_t timestamp = read24(tag + 4)
+	    | (static_cast<std::uint32_t>(tag[7]) << 24);
+	if ((offset + sizeof(flv_tag_t) + bodysize) > size) {
+	    log_debug(_("FLV file is truncated at offset %d"), offset);
+	    break;
+	}
+	if (((tag[0] & 0x1f) == TAG_VIDEO) && bodysize) {
+	    video = true;
+	    if ((tag[sizeof(flv_tag_t)] >> 4) == KEYFRAME) {
+		flv_keyframe_t key = { timestamp, offset };
+		_keyframes.push_back(key);
+	    }
+	} else if (((tag[0] & 0x1f) == TAG_AUDIO) && !video) {
+	    if (audio.empty() || (timestamp >= (audio.back().timestamp
+					       + FLV_INDEX_AUDIO_INTERVAL))) {
+		flv_keyframe_t key = { timestamp, offset };
+		audio.push_back(key);
+	    }
+	}
+	offset += sizeof(flv_tag_t) + bodysize + sizeof(previous_size_t);
+    }
+
+    if (!video) {
+	_keyframes.swap(audio);
+    }
+
+    // Timestamps should only go up, but don't trust the file.
+    std::stable_sort(_keyframes.begin(), _keyframes.end(), sortKeyframe);
+
+    log_debug(_("Indexed %d keyframes in FLV file of %d bytes"),
+	      _keyframes.size(), size);
+
+    return _keyframes.size();
+}
+
+bool
+Flv::readIndex(const std::string &filespec, std::uint64_t size,
+	       std::int64_t mtime)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::ifstream in(filespec.c_str(), std::ios::in | std::ios::binary);
+    if (!in) {
+	return false;
+    }
+
+    char magic[sizeof(INDEX_MAGIC) - 1];
+    in.read(magic, sizeof(magic));
+    if (!in || (memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0)
+	|| (readBig(in, 4) != INDEX_VERSION)) {
+	log_error(_("%s isn't an FLV keyframe index"), filespec);
+	return false;
+    }
+
+    // The index is stale if the FLV file changed after it was written.
+    if ((readBig(in, 8) != size)
+	|| (static_cast<std::int64_t>(readBig(in, 8)) != mtime)) {
+	log_debug(_("FLV keyframe index %s is stale"), filespec);
+	return false;
+    }
+
+    std::uint32_t count = readBig(in, 4);
+    std::vector<flv_keyframe_t> keyframes;
+    keyframes.reserve(std::min<std::uint64_t>(count, size / sizeof(flv_tag_t)));
+    for (std::uint32_t i = 0; i < count; i++) {
+	flv_keyframe_t key;
+	key.timestamp = readBig(in, 4);
+	key.offset = readBig(in, 8);
+	if (!in || (key.offset >= size)) {
+	    log_error(_("FLV keyframe index %s is corrupted"), filespec);
+	    return false;
+	}
+	keyframes.push_back(key);
+    }
+    _keyframes.swap(keyframes);
+
+    return true;
+}
+
+bool
+Flv::writeIndex(const std::string &filespec, std::uint64_t size,
+		std::int64_t mtime)
+{
+//    GNASH_REPORT_FUNCTION;
+    // Write to a temporary file renamed into place, so that another
+    // process never reads a partly written index.
+    std::ostringstream tmp;
+    tmp << filespec << ".tmp-" << getpid();
+    const std::string tmpspec = tmp.str();
+
+    std::ofstream out(tmpspec.c_str(),
+		      std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+	return false;
+    }
+
+    out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC) - 1);
+    writeBig(out, INDEX_VERSION, 4);
+    writeBig(out, size, 8);
+    writeBig(out, mtime, 8);
+    writeBig(out, _keyframes.size(), 4);
+    std::vector<flv_keyframe_t>::const_iterator it;
+    for (it = _keyframes.begin(); it != _keyframes.end(); ++it) {
+	writeBig(out, it->timestamp, 4);
+	writeBig(out, it->offset, 8);
+    }
+
+    out.close();
+    if (!out || std::rename(tmpspec.c_str(), filespec.c_str()) != 0) {
+	std::remove(tmpspec.c_str());
+	return false;
+    }
+
+    return true;
+}
+
+const Flv::flv_keyframe_t *
+Flv::findKeyframe(std::uint32_t timestamp) const
+{
+//    GNASH_REPORT_FUNCTION;
+    if (_keyframes.empty()) {
+	return nullptr;
+    }
+
+    std::vector<flv_keyframe_t>::const_iterator it =
+	std::upper_bound(_keyframes.begin(), _keyframes.end(), timestamp,
+			 compareKeyframe);
+    if (it != _keyframes.begin()) {
+	--it;
+    }
+
+    return &(*it);
+}
+
 std::shared_ptr<cygnal::Element>
 Flv::findProperty(const std::string &name)
 {
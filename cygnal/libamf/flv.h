@@ -41,6 +41,14 @@ const size_t FLV_HEADER_SIZE = 0x9;
 /// \brief The maximum value that can be held in a 32 bit word.
 const std::uint32_t FLV_MAX_LENGTH = 0xffffff;
 
+/// \brief The suffix added to the name of an FLV file for the name of
+///	it's keyframe index, which is stored next to it.
+const char FLV_INDEX_SUFFIX[] = ".idx";
+
+/// \brief The minimum time in milliseconds between index entries for
+///	files with no video, where every audio tag is a seek point.
+const std::uint32_t FLV_INDEX_AUDIO_INTERVAL = 1000;
+
 /// \class Flv
 ///	This class abstracts an FLV file into something usable by Gnash.
 class DSOEXPORT Flv {
@@ -158,6 +166,14 @@ class DSOEXPORT Flv {
         std::uint8_t  streamid[3];  // always 0
     } flv_tag_t;
     
+    /// \struct Flv::flv_keyframe_t.
+    ///		An entry in the keyframe index, which is where in
+    ///		the file playback can start for a given time.
+    typedef struct {
+        std::uint32_t timestamp;   // timestamp in milliseconds
+        std::uint64_t offset;      // offset of the tag in the file
+    } flv_keyframe_t;
+
     Flv();
     ~Flv();
 
@@ -232,6 +248,58 @@ class DSOEXPORT Flv {
     void setProperties(std::vector<std::shared_ptr<cygnal::Element> > array)
 			{ _properties = array; };
 
+    /// \brief Build the keyframe index by scanning all the tags.
+    ///		Only the tag headers are read, so this is fast even
+    ///		for large files.
+    ///
+    /// @param data A real pointer to the contents of the FLV file.
+    ///
+    /// @param size The size of the FLV file in bytes.
+    ///
+    /// @return The number of entries in the index.
+    size_t buildIndex(const std::uint8_t *data, size_t size);
+
+    /// \brief Read a keyframe index written by writeIndex().
+    ///		The index is only used if it was built from the
+    ///		same version of the FLV file.
+    ///
+    /// @param filespec The name of the index file.
+    ///
+    /// @param size The size of the FLV file in bytes.
+    ///
+    /// @param mtime The modification time of the FLV file.
+    ///
+    /// @return True if the index was read, false if it's missing or stale.
+    bool readIndex(const std::string &filespec, std::uint64_t size,
+		   std::int64_t mtime);
+
+    /// \brief Write the keyframe index to disk, so it doesn't have
+    ///		to be built again.
+    ///
+    /// @param filespec The name of the index file.
+    ///
+    /// @param size The size of the FLV file in bytes.
+    ///
+    /// @param mtime The modification time of the FLV file.
+    ///
+    /// @return True if the index was written, false if it couldn't be.
+    bool writeIndex(const std::string &filespec, std::uint64_t size,
+		    std::int64_t mtime);
+
+    /// \brief Find the keyframe to start playback from for a time.
+    ///
+    /// @param timestamp The time in milliseconds to seek to.
+    ///
+    /// @return A real pointer to the last keyframe at or before the
+    ///		time, or the first keyframe if the time is before all of
+    ///		them. NULL if the index is empty.
+    const flv_keyframe_t *findKeyframe(std::uint32_t timestamp) const;
+
+    /// \brief Get the keyframe index.
+    ///
+    /// @return The keyframes, sorted by timestamp.
+    const std::vector<flv_keyframe_t> &getIndex() const { return _keyframes; };
+
     /// \brief Convert a 24 bit integer to a 32 bit one so we can use it.
     ///
     /// @return An unsigned 32 bit integer
@@ -263,7 +331,11 @@ class DSOEXPORT Flv {
     ///         The data contained in the first onMetaData tag from
     ///         the FLV file.
     std::shared_ptr<cygnal::Element> _metadata;
-    
+
+    /// \var Flv::_keyframes
+    ///		The keyframe index, sorted by timestamp, which is
+    ///		used to find where to start playback when seeking.
+    std::vector<flv_keyframe_t> _keyframes;
 }; // end of class definition
 
 
@@ -183,12 +183,12 @@ SOL::formatHeader(const std::string &name, int filesize)
     // we just built it the same way it always is.
     // first is the TCSO, we have no idea what this stands for.
     const char magic[] = "TCSO";
-    _header.insert(_header.end(), boost::begin(magic), boost::end(magic));
+    _header.insert(_header.end(), magic, magic + 4);
 
     // then the 0x0004 bytes, also a mystery
     appendSwapped(_header, SOL_BLOCK_MARK);
     // finally a bunch of zeros to pad things for this field
-    _header.insert(_header.end(), '\0', sizeof(std::uint32_t));
+    _header.insert(_header.end(), sizeof(std::uint32_t), '\0');
 
     // Encode the name. This is not a string object, which has a type field
     // one byte field precedding the length as a file type of AMF::STRING.
@@ -200,7 +200,7 @@ SOL::formatHeader(const std::string &name, int filesize)
     _header.insert(_header.end(), name.begin(), name.end());
     
     // finally a bunch of zeros to pad things at the end of the header
-    _header.insert(_header.end(), '\0', sizeof(std::uint32_t));
+    _header.insert(_header.end(), sizeof(std::uint32_t), '\0');
 
 #if 0
     unsigned char *hexint;
@@ -265,6 +265,7 @@ SOL::writeFile(const std::string &filespec, const std::string &name)
 	      outsize = el->getNameSize() + 4;
 	      memcpy(ptr, var->reference(), outsize); 
 	      ptr += outsize;
+	      *ptr++ = 0;	// every property is terminated
 	      break;
 	  case Element::OBJECT_AMF0:
 	      outsize = el->getNameSize() + 5;
@@ -280,8 +281,7 @@ SOL::writeFile(const std::string &filespec, const std::string &name)
               assert(ptr+outsize < endPtr);
 	      memcpy(ptr, var->reference(), outsize);
 	      ptr += outsize;
-// 	      *ptr++ = 0;	// doubles are terminated too!
-// 	      *ptr++ = 0;	// doubles are terminated too!
+	      *ptr++ = 0;	// doubles are terminated too!
 	      break;
 	  case Element::STRING_AMF0:
 	      if (el->getDataSize() == 0) {
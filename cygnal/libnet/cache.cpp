@@ -27,6 +27,7 @@
 #include <sys/stat.h>
 #include <string>
 #include <map>
+#include <sstream>
 #include <iostream>
 #include <unistd.h>
 
@@ -38,25 +39,24 @@ using std::string;
 using std::map;
 using std::endl;
 
-static std::mutex cache_mutex;
-
 namespace gnash
 {
 
+/// \var CACHE_MAX_REFERENCE
+///	How many sweeps of the clock hand a file that keeps being hit
+///	survives. This keeps the mappings of hot files pinned in memory.
+const int CACHE_MAX_REFERENCE = 3;
+
 Cache::Cache() 
-#ifdef USE_STATS_CACHE
-    : _pathname_lookups(0),
-      _pathname_hits(0),
-      _response_lookups(0),
-      _response_hits(0),
-      _file_lookups(0),
-      _file_hits(0)
-#endif
+    : _maxsize(CACHE_DEFAULT_SIZE),
+      _used(0)
 {
 //    GNASH_REPORT_FUNCTION;
     log_error(_("using this constructor is only allowed for testing purposes."));
 #ifdef USE_STATS_CACHE
-    clock_gettime (CLOCK_REALTIME, &_last_access);
+    for (size_t i = 0; i < CACHE_SHARDS; i++) {
+        clock_gettime (CLOCK_REALTIME, &_shards[i].last_access);
+    }
 #endif
 }
 
@@ -74,21 +74,37 @@ Cache::getDefaultInstance()
     return c;
 }
 
+Cache::shard_t &
+Cache::getShard(const std::string &name)
+{
+    return _shards[std::hash<std::string>()(name) % CACHE_SHARDS];
+}
+
+void
+Cache::setMaxSize(size_t size)
+{
+//    GNASH_REPORT_FUNCTION;
+    _maxsize = size;
+    reclaim(0);
+}
+
 void
 Cache::addPath(const std::string &name, const std::string &fullpath)
 {
 //    GNASH_REPORT_FUNCTION;
-    std::lock_guard<std::mutex> lock(cache_mutex);
-    _pathnames[name] = fullpath;
+    shard_t &shard = getShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.pathnames[name] = fullpath;
 }
 
 void
 Cache::addResponse(const std::string &name, const std::string &response)
 {
 //    GNASH_REPORT_FUNCTION;
-    std::lock_guard<std::mutex> lock(cache_mutex);
+    shard_t &shard = getShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 
-    _responses[name] = response;
+    shard.responses[name] = response;
 }
 
 void
@@ -96,86 +112,237 @@ Cache::addFile(const std::string &name, std::shared_ptr<DiskStream> &file)
 {
     // GNASH_REPORT_FUNCTION;
 
-    std::lock_guard<std::mutex> lock(cache_mutex);
-    log_network(_("Adding file %s to cache."), name);
-    _files[name] = file;
+    if (!file) {
+        return;
+    }
+
+    size_t size = file->getFileSize();
+    if (size > _maxsize) {
+        log_network(_("Not caching %s, %d bytes is over the %d byte limit."),
+                    name, size, _maxsize.load());
+        return;
+    }
+
+    file_t entry;
+    entry.file = file;
+    entry.size = size;
+    entry.stamped = false;
+    entry.mtime = 0;
+    entry.filesize = 0;
+    entry.checked = time(nullptr);
+    entry.referenced = 1;
+
+    // Remember what the file looked like on disk, so we can tell
+    // when it changes. Streams that only live in memory have
+    // nothing to compare against.
+    struct stat st;
+    if (!file->getFilespec().empty()
+        && (stat(file->getFilespec().c_str(), &st) == 0)) {
+        entry.stamped = true;
+        entry.mtime = st.st_mtime;
+        entry.filesize = st.st_size;
+    }
+
+    shard_t &shard = getShard(name);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        log_network(_("Adding file %s to cache."), name);
+        map<string, file_t>::iterator it = shard.files.find(name);
+        if (it != shard.files.end()) {
+            dropFile(shard, it);
+        }
+        // New files go just behind the clock hand, so they get a
+        // full sweep before they are considered for eviction.
+        entry.ring = shard.ring.insert(shard.hand, name);
+        shard.files[name] = entry;
+        _used += size;
+    }
+
+    if (_used > _maxsize) {
+        reclaim(&shard - _shards);
+    }
 }
 
-string &
+string
 Cache::findPath(const std::string &name)
 {
 //    GNASH_REPORT_FUNCTION;
-    std::lock_guard<std::mutex> lock(cache_mutex);
+    shard_t &shard = getShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    map<string, string>::const_iterator it = shard.pathnames.find(name);
 #ifdef USE_STATS_CACHE
-    clock_gettime (CLOCK_REALTIME, &_last_access);
-    _pathname_lookups++;
-    map<string, string>::iterator it;
-    it = _pathnames.find(name);
-    if (it != _pathnames.end()) {
-        _pathname_hits++;
+    clock_gettime (CLOCK_REALTIME, &shard.last_access);
+    shard.pathname_lookups++;
+    if (it != shard.pathnames.end()) {
+        shard.pathname_hits++;
     }
 #endif
-    return _pathnames[name];
+    if (it == shard.pathnames.end()) {
+        return string();
+    }
+    return it->second;
 }
 
-string &
+string
 Cache::findResponse(const std::string &name)
 {
 //    GNASH_REPORT_FUNCTION;
-    std::lock_guard<std::mutex> lock(cache_mutex);
+    shard_t &shard = getShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    map<string, string>::const_iterator it = shard.responses.find(name);
 #ifdef USE_STATS_CACHE
-    clock_gettime (CLOCK_REALTIME, &_last_access);
-    _response_lookups++;
-    map<string, string>::const_iterator it;
-    it = _responses.find(name);
-    if (it != _responses.end()) {
-        _response_hits++;
+    clock_gettime (CLOCK_REALTIME, &shard.last_access);
+    shard.response_lookups++;
+    if (it != shard.responses.end()) {
+        shard.response_hits++;
     }
 #endif
-    return _responses[name];
+    if (it == shard.responses.end()) {
+        return string();
+    }
+    return it->second;
 }
 
-std::shared_ptr<DiskStream> &
+std::shared_ptr<DiskStream>
 Cache::findFile(const std::string &name)
 {
 //    GNASH_REPORT_FUNCTION;
 
     log_network(_("Trying to find %s in the cache."), name);
-    std::lock_guard<std::mutex> lock(cache_mutex);
+    shard_t &shard = getShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
 #ifdef USE_STATS_CACHE
-    clock_gettime (CLOCK_REALTIME, &_last_access);
-    _file_lookups++;
-    map<string, std::shared_ptr<DiskStream> >::const_iterator it;
-    it = _files.find(name);
-    if (it != _files.end()) {
-        _file_hits++;
+    clock_gettime (CLOCK_REALTIME, &shard.last_access);
+    shard.file_lookups++;
+#endif
+    map<string, file_t>::iterator it = shard.files.find(name);
+    if (it == shard.files.end()) {
+        return std::shared_ptr<DiskStream>();
     }
+
+    file_t &entry = it->second;
+
+    // Don't stat the file on every hit, once a second is plenty to
+    // notice files being replaced on disk.
+    time_t now = time(nullptr);
+    if (entry.stamped && (now - entry.checked >= CACHE_VALIDATE_INTERVAL)) {
+        struct stat st;
+        if ((stat(entry.file->getFilespec().c_str(), &st) != 0)
+            || (st.st_mtime != entry.mtime)
+            || (st.st_size != entry.filesize)) {
+            log_network(_("File %s changed on disk, dropping it from the cache."),
+                        name);
+            dropFile(shard, it);
+            return std::shared_ptr<DiskStream>();
+        }
+        entry.checked = now;
+    }
+
+    if (entry.referenced < CACHE_MAX_REFERENCE) {
+        entry.referenced++;
+    }
+#ifdef USE_STATS_CACHE
+    shard.file_hits++;
 #endif
-    return _files[name];
+    return entry.file;
 }
 
 void
 Cache::removePath(const std::string &name)
 {
 //    GNASH_REPORT_FUNCTION;
-    std::lock_guard<std::mutex> lock(cache_mutex);
-    _pathnames.erase(name);
+    shard_t &shard = getShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.pathnames.erase(name);
 }
 
 void
 Cache::removeResponse(const std::string &name)
 {
 //    GNASH_REPORT_FUNCTION;
-    std::lock_guard<std::mutex> lock(cache_mutex);
-    _responses.erase(name);
+    shard_t &shard = getShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.responses.erase(name);
 }
 
 void
 Cache::removeFile(const std::string &name)
 {
 //    GNASH_REPORT_FUNCTION;
-    std::lock_guard<std::mutex> lock(cache_mutex);
-    _files.erase(name);
+    shard_t &shard = getShard(name);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    map<string, file_t>::iterator it = shard.files.find(name);
+    if (it != shard.files.end()) {
+        dropFile(shard, it);
+    }
+}
+
+void
+Cache::dropFile(shard_t &shard, map<string, file_t>::iterator it)
+{
+//    GNASH_REPORT_FUNCTION;
+    if (shard.hand == it->second.ring) {
+        ++shard.hand;
+    }
+    shard.ring.erase(it->second.ring);
+    _used -= it->second.size;
+    shard.files.erase(it);
+}
+
+bool
+Cache::evictOne(shard_t &shard)
+{
+//    GNASH_REPORT_FUNCTION;
+
+    // Each file is passed over at most CACHE_MAX_REFERENCE + 1
+    // times before it's evicted, so this many steps is enough to
+    // either find a victim or know there isn't one.
+    size_t steps = shard.ring.size() * (CACHE_MAX_REFERENCE + 1);
+    for (size_t i = 0; i < steps; i++) {
+        if (shard.hand == shard.ring.end()) {
+            shard.hand = shard.ring.begin();
+        }
+        map<string, file_t>::iterator it = shard.files.find(*shard.hand);
+        file_t &entry = it->second;
+        // A stream still in use by another thread keeps it's memory
+        // mapped no matter what we do, so it stays pinned.
+        if (entry.file.use_count() > 1) {
+            ++shard.hand;
+            continue;
+        }
+        if (entry.referenced > 0) {
+            entry.referenced--;
+            ++shard.hand;
+            continue;
+        }
+        log_network(_("Evicting %s from the cache."), it->first);
+#ifdef USE_STATS_CACHE
+        shard.file_evictions++;
+#endif
+        dropFile(shard, it);
+        return true;
+    }
+
+    return false;
+}
+
+void
+Cache::reclaim(size_t start)
+{
+//    GNASH_REPORT_FUNCTION;
+
+    // Only one shard is ever locked at a time, so threads adding
+    // files to different shards can both reclaim without deadlock.
+    size_t idle = 0;
+    for (size_t i = start; (_used > _maxsize) && (idle < CACHE_SHARDS); i++) {
+        shard_t &shard = _shards[i % CACHE_SHARDS];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (evictOne(shard)) {
+            idle = 0;
+        } else {
+            idle++;
+        }
+    }
 }
 
 #ifdef USE_STATS_CACHE
@@ -185,58 +352,93 @@ Cache::stats(bool xml) const
 //    GNASH_REPORT_FUNCTION;
     // dump timing related data
     struct timespec now;
+    struct timespec last = { 0, 0 };
     std::stringstream text;
+    size_t pathnames = 0, responses = 0, files = 0;
+    long pathname_lookups = 0, pathname_hits = 0;
+    long response_lookups = 0, response_hits = 0;
+    long file_lookups = 0, file_hits = 0, file_evictions = 0;
+
+    for (size_t i = 0; i < CACHE_SHARDS; i++) {
+        const shard_t &shard = _shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if ((shard.last_access.tv_sec > last.tv_sec)
+            || ((shard.last_access.tv_sec == last.tv_sec)
+                && (shard.last_access.tv_nsec > last.tv_nsec))) {
+            last = shard.last_access;
+        }
+        pathnames += shard.pathnames.size();
+        responses += shard.responses.size();
+        files += shard.files.size();
+        pathname_lookups += shard.pathname_lookups;
+        pathname_hits += shard.pathname_hits;
+        response_lookups += shard.response_lookups;
+        response_hits += shard.response_hits;
+        file_lookups += shard.file_lookups;
+        file_hits += shard.file_hits;
+        file_evictions += shard.file_evictions;
+    }
     
     clock_gettime (CLOCK_REALTIME, &now);    
-    double time = ((now.tv_sec - _last_access.tv_sec) + ((now.tv_nsec - _last_access.tv_nsec)/1e9));
+    double time = ((now.tv_sec - last.tv_sec) + ((now.tv_nsec - last.tv_nsec)/1e9));
 
     if (xml) {
 	text << "<cache>" << endl;
 	text << "	<LastAccess>"       << time              << " </LastAccess>" << endl;
 	text << "	<PathNames>" << endl
-	     << "		<Total>" << _pathnames.size() << "</Total>" << endl
-	     << "		<Hits>"     << _pathname_hits    << "</Hits>" << endl
+	     << "		<Total>" << pathnames << "</Total>" << endl
+	     << "		<Hits>"     << pathname_hits    << "</Hits>" << endl
 	     << "	</PathNames>" << endl;
 	text << "	<Responses>" << endl;
-	text << "		<Total>" << _responses.size() << "</Total>" << endl
-	     << "		<Hits>"     << _response_hits   << "</Hits>" << endl
+	text << "		<Total>" << responses << "</Total>" << endl
+	     << "		<Hits>"     << response_hits   << "</Hits>" << endl
 	     << "       </Responses>" << endl;
 	text << "	<Files>" << endl
-	     << "		<Total>"     << _files.size()     << "</Total>" << endl
-	     << "		<Hits>"     << _file_hits        << "</Hits>" << endl
+	     << "		<Total>"     << files     << "</Total>" << endl
+	     << "		<Hits>"     << file_hits        << "</Hits>" << endl
+	     << "		<Evictions>" << file_evictions  << "</Evictions>" << endl
+	     << "		<Bytes>"     << _used           << "</Bytes>" << endl
+	     << "		<MaxBytes>"  << _maxsize        << "</MaxBytes>" << endl
 	     << "       </Files>" << endl;
     } else {
 	text << "Time since last access:  " << std::fixed << time << " seconds ago." << endl;
 	
-	text << "Pathnames in cache: " << _pathnames.size() << ", accessed "
-	     << _pathname_lookups << " times" << endl;
-	text << "	Pathname hits from cache: " << _pathname_hits << endl;
+	text << "Pathnames in cache: " << pathnames << ", accessed "
+	     << pathname_lookups << " times" << endl;
+	text << "	Pathname hits from cache: " << pathname_hits << endl;
 	
-	text << "Responses in cache: " << _responses.size() << ", accessed "
-	     << _response_lookups << " times" << endl;
-	text << "	Response hits from cache: " << _response_hits << endl;
+	text << "Responses in cache: " << responses << ", accessed "
+	     << response_lookups << " times" << endl;
+	text << "	Response hits from cache: " << response_hits << endl;
 	
-	text << "Files in cache: " << _files.size() << ", accessed "
-	     << _file_lookups << " times" << endl;
-	text << "	File hits from cache: " << _file_hits << endl;
+	text << "Files in cache: " << files << ", accessed "
+	     << file_lookups << " times" << endl;
+	text << "	File hits from cache: " << file_hits << endl;
+	text << "	Files evicted from cache: " << file_evictions << endl;
+	text << "	Memory used by files: " << _used << " of "
+	     << _maxsize << " bytes" << endl;
     }
     
-    map<std::string, std::shared_ptr<DiskStream> >::const_iterator data;
-    for (data = _files.begin(); data != _files.end(); ++data) {
-	const struct timespec *last = data->second->getLastAccessTime();
-	time = ((now.tv_sec - last->tv_sec) + ((now.tv_nsec - last->tv_nsec)/1e9));
-	if (xml) {
-	    text << "	<DiskStreams>" << endl
-		 << "		<Name>\"" << data->first << "\"</Name>" << endl
-		 << "		<Hits>" << data->second->getAccessCount() << "</Hits>" << endl
-		 << "		<LastAccess>" << time << "</LastAccess>" << endl
-		 << "	</DiskStreams>" << endl;
-	} else {
-	    text << "Disktream: " << data->first
-		 << ", accessed: " << data->second->getAccessCount()
-		 << " times." << endl;
-	    text << "	Time since last file access:  " << std::fixed << time << " seconds ago." << endl;
-	}
+    for (size_t i = 0; i < CACHE_SHARDS; i++) {
+        const shard_t &shard = _shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        map<std::string, file_t>::const_iterator data;
+        for (data = shard.files.begin(); data != shard.files.end(); ++data) {
+            const struct timespec *last = data->second.file->getLastAccessTime();
+            time = ((now.tv_sec - last->tv_sec) + ((now.tv_nsec - last->tv_nsec)/1e9));
+            if (xml) {
+                text << "	<DiskStreams>" << endl
+                     << "		<Name>\"" << data->first << "\"</Name>" << endl
+                     << "		<Hits>" << data->second.file->getAccessCount() << "</Hits>" << endl
+                     << "		<LastAccess>" << time << "</LastAccess>" << endl
+                     << "	</DiskStreams>" << endl;
+            } else {
+                text << "Disktream: " << data->first
+                     << ", accessed: " << data->second.file->getAccessCount()
+                     << " times." << endl;
+                text << "	Time since last file access:  " << std::fixed << time << " seconds ago." << endl;
+            }
+        }
     }
 
     if (xml) {
@@ -251,30 +453,41 @@ void
 Cache::dump(std::ostream& os) const
 {    
     GNASH_REPORT_FUNCTION;    
-    std::lock_guard<std::mutex> lock(cache_mutex);
 
-    // Dump all the pathnames
-    os << "Pathname cache has " << _pathnames.size() << " files." << endl;
-    map<string, string>::const_iterator name;
-    for (name = _pathnames.begin(); name != _pathnames.end(); ++name) {
-        os << "Full path for \"" << name->first << "\" is: " << name->second << endl;
-    }
+    for (size_t i = 0; i < CACHE_SHARDS; i++) {
+        const shard_t &shard = _shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
 
-    // Dump the responses
-    os << "Responses cache has " << _responses.size() << " files." << endl;
-    for (name = _responses.begin(); name != _responses.end(); ++name) {
-        os << "Response for \"" << name->first << "\" is: " << name->second << endl;
-    }
+        if (shard.pathnames.empty() && shard.responses.empty()
+            && shard.files.empty()) {
+            continue;
+        }
+        os << "Cache shard #" << i << ":" << endl;
+
+        // Dump all the pathnames
+        os << "Pathname cache has " << shard.pathnames.size() << " files." << endl;
+        map<string, string>::const_iterator name;
+        for (name = shard.pathnames.begin(); name != shard.pathnames.end(); ++name) {
+            os << "Full path for \"" << name->first << "\" is: " << name->second << endl;
+        }
+
+        // Dump the responses
+        os << "Responses cache has " << shard.responses.size() << " files." << endl;
+        for (name = shard.responses.begin(); name != shard.responses.end(); ++name) {
+            os << "Response for \"" << name->first << "\" is: " << name->second << endl;
+        }
     
-    os << "DiskStream cache has " << _files.size() << " files." << endl;
+        os << "DiskStream cache has " << shard.files.size() << " files." << endl;
     
-    map<std::string, std::shared_ptr<DiskStream> >::const_iterator data;
-    for (data = _files.begin(); data != _files.end(); ++data) {
-        std::shared_ptr<DiskStream> filedata = data->second;
-        os << "file info for \"" << data->first << "\" is: " << endl;
-        filedata->dump();
-        os << "-----------------------------" << endl;
+        map<std::string, file_t>::const_iterator data;
+        for (data = shard.files.begin(); data != shard.files.end(); ++data) {
+            std::shared_ptr<DiskStream> filedata = data->second.file;
+            os << "file info for \"" << data->first << "\" is: " << endl;
+            filedata->dump();
+            os << "-----------------------------" << endl;
+        }
     }
+    os << "Files use " << _used << " of " << _maxsize << " bytes." << endl;
 
 #ifdef USE_STATS_CACHE
     this->stats(false);
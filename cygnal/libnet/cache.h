@@ -25,7 +25,12 @@
 
 #include <string>
 #include <map> 
+#include <list>
+#include <mutex>
+#include <atomic>
 #include <iostream>
+#include <ctime>
+#include <sys/types.h>
 
 #include "statistics.h"
 #include "diskstream.h"
@@ -39,11 +44,26 @@ namespace gnash {
 // max size of files to map enirely into the cache
 static const size_t CACHE_LIMIT = 102400000;
 
+// default memory budget for the files held in the cache
+static const size_t CACHE_DEFAULT_SIZE = 64 * 1024 * 1024;
+
+// number of independently locked partitions of the cache
+static const size_t CACHE_SHARDS = 16;
+
+// seconds between checks of a cached file against the disk
+static const time_t CACHE_VALIDATE_INTERVAL = 1;
+
 // forward instatiate
 //class DiskStream;
 
 /// \class Cache
-//
+///	The cache of path names, HTTP responses and memory mapped
+///	files shared by all the server threads. The tables are split
+///	into shards by the hash of the name, each with it's own lock,
+///	so threads looking up different files don't contend. Files
+///	are charged against a memory budget, and when that is exceeded
+///	the least recently used ones are dropped using the CLOCK
+///	algorithm.
 class DSOEXPORT Cache {
 public:
     Cache();
@@ -51,16 +71,32 @@ public:
     DSOEXPORT static Cache& getDefaultInstance();
     
     void DSOEXPORT addPath(const std::string &name, const std::string &fullpath);
-    std::string &findPath(const std::string &name);
+    std::string findPath(const std::string &name);
     void removePath(const std::string &name);
     
     void addResponse(const std::string &name, const std::string &response);
-    std::string &findResponse(const std::string &name);
+    std::string findResponse(const std::string &name);
     void removeResponse(const std::string &name);
     
+    /// \brief Add a file to the cache.
+    ///		Files too big to ever fit in the memory budget are
+    ///		not cached. Adding a file may evict others.
     void addFile(const std::string &name, std::shared_ptr<DiskStream > &file);
-    std::shared_ptr<DiskStream> & findFile(const std::string &name);
+
+    /// \brief Find a file in the cache.
+    ///		Files that have changed on disk since they were
+    ///		cached are dropped, and reported as not found.
+    ///
+    /// @return The cached DiskStream, or an empty pointer.
+    std::shared_ptr<DiskStream> findFile(const std::string &name);
     void removeFile(const std::string &name);
+
+    /// \brief Set the memory budget in bytes for cached files.
+    void setMaxSize(size_t size);
+    /// \brief Get the memory budget in bytes for cached files.
+    size_t getMaxSize() const { return _maxsize; }
+    /// \brief Get the number of bytes held by cached files.
+    size_t getMemoryUsed() const { return _used; }
     
     ///  \brief Dump the internal data of this class in a human readable form.
     /// @remarks This should only be used for debugging purposes.
@@ -72,26 +108,81 @@ public:
     std::string DSOEXPORT stats(bool xml) const;
 #endif
 private:
-    /// \var Cache::_pathnames
-    ///		The cache of file names converted to absolute path names.
-    std::map<std::string, std::string> _pathnames;
-    /// \var Cache::
-    ///		The cache of HTTP responses.
-    std::map<std::string, std::string> _responses;
-    /// \var Cache::_responses
-    ///		The cache of Distream handles to often played files.
-    std::map<std::string, std::shared_ptr<DiskStream> > _files;
-
-    /// \brief Cache file statistics variables are defined here.
+    /// \struct Cache::file_t
+    ///		A cached file, and what we knew about it on disk when
+    ///		it was added.
+    typedef struct {
+        std::shared_ptr<DiskStream> file;
+        size_t	size;
+        bool	stamped;
+        time_t	mtime;
+        off_t	filesize;
+        time_t	checked;
+        int	referenced;
+        std::list<std::string>::iterator ring;
+    } file_t;
+
+    /// \struct Cache::shard_t
+    ///		One partition of the cache, with it's own lock.
+    typedef struct shard {
+        shard() : hand(ring.end())
+#ifdef USE_STATS_CACHE
+                , pathname_lookups(0), pathname_hits(0),
+                  response_lookups(0), response_hits(0),
+                  file_lookups(0), file_hits(0), file_evictions(0)
+#endif
+            { }
+        mutable std::mutex mutex;
+        /// The cache of file names converted to absolute path names.
+        std::map<std::string, std::string> pathnames;
+        /// The cache of HTTP responses.
+        std::map<std::string, std::string> responses;
+        /// The cache of Distream handles to often played files.
+        std::map<std::string, file_t> files;
+        /// The names of the files in the order the clock hand
+        /// sweeps them.
+        std::list<std::string> ring;
+        std::list<std::string>::iterator hand;
 #ifdef USE_STATS_CACHE
-    struct timespec _last_access;
-    long	_pathname_lookups;
-    long	_pathname_hits;
-    long	_response_lookups;
-    long	_response_hits;
-    long	_file_lookups;
-    long	_file_hits;
+        struct timespec last_access;
+        long	pathname_lookups;
+        long	pathname_hits;
+        long	response_lookups;
+        long	response_hits;
+        long	file_lookups;
+        long	file_hits;
+        long	file_evictions;
 #endif
+    } shard_t;
+
+    /// \brief Get the shard a name is stored in.
+    shard_t &getShard(const std::string &name);
+
+    /// \brief Drop a file, the shard must already be locked.
+    void dropFile(shard_t &shard, std::map<std::string, file_t>::iterator it);
+
+    /// \brief Advance the clock hand of a locked shard.
+    ///
+    /// @return True if a file was evicted, false if the shard has
+    ///		nothing left that can be evicted.
+    bool evictOne(shard_t &shard);
+
+    /// \brief Evict files until the memory budget is met.
+    ///
+    /// @param start The index of the shard to start evicting from.
+    void reclaim(size_t start);
+
+    /// \var Cache::_shards
+    ///		The partitions of the cache.
+    shard_t	_shards[CACHE_SHARDS];
+
+    /// \var Cache::_maxsize
+    ///		The memory budget in bytes for cached files.
+    std::atomic<size_t> _maxsize;
+
+    /// \var Cache::_used
+    ///		The bytes currently charged against the budget.
+    std::atomic<size_t> _used;
 };
 
 /// \brief Dump to the specified output stream.
@@ -28,6 +28,7 @@
 #include "log.h"
 #include "gmemory.h"
 #include "buffer.h"
+#include "metrics.h"
 
 using std::deque;
 
@@ -99,6 +100,7 @@ CQue::push(std::shared_ptr<cygnal::Buffer> data)
 //     GNASH_REPORT_FUNCTION;
     std::lock_guard<std::mutex> lock(_mutex);
     _que.push_back(data);
+    Metrics::getDefaultInstance().record(Metrics::QUEUE_DEPTH, _que.size());
 #ifdef USE_STATS_QUEUE
     _stats.totalbytes += data->size();
     _stats.totalin++;
@@ -90,7 +90,9 @@ DiskStream::DiskStream()
       _max_memload(0),
       _filesize(0),
       _pagesize(0),
-      _offset(0)
+      _offset(0),
+      _mapstart(0),
+      _mapsize(0)
 {
 //    GNASH_REPORT_FUNCTION;
     /// \brief get the pagesize and cache the value
@@ -130,7 +132,9 @@ DiskStream::DiskStream(const string &str)
       _max_memload(0),
       _filesize(0),
       _pagesize(0),
-      _offset(0)
+      _offset(0),
+      _mapstart(0),
+      _mapsize(0)
 {
 //    GNASH_REPORT_FUNCTION;
     /// \brief get the pagesize and cache the value
@@ -170,7 +174,9 @@ DiskStream::DiskStream(const string &str, std::uint8_t *data, size_t size)
       _dataptr(nullptr),
       _max_memload(0),
       _pagesize(0),
-      _offset(0)
+      _offset(0),
+      _mapstart(0),
+      _mapsize(0)
 {
 //    GNASH_REPORT_FUNCTION;
     
@@ -204,6 +210,7 @@ DiskStream::DiskStream(const string &str, std::uint8_t *data, size_t size)
     std::copy(data, data + size, _dataptr);
     _filespec = str;
     _filesize = size;
+    _mapsize = size;
     
 #ifdef USE_STATS_CACHE
     clock_gettime (CLOCK_REALTIME, &_last_access);
@@ -218,7 +225,9 @@ DiskStream::DiskStream(const string &str, cygnal::Buffer &buf)
       _dataptr(nullptr),
       _max_memload(0),
       _pagesize(0),
-      _offset(0)
+      _offset(0),
+      _mapstart(0),
+      _mapsize(0)
 {
 //    GNASH_REPORT_FUNCTION;
     
@@ -252,6 +261,7 @@ DiskStream::DiskStream(const string &str, cygnal::Buffer &buf)
     std::copy(buf.begin(), buf.end(), _dataptr);
     _filespec = str;
     _filesize = buf.size();
+    _mapsize = buf.size();
     
 #ifdef USE_STATS_CACHE
     clock_gettime (CLOCK_REALTIME, &_last_access);
@@ -267,7 +277,9 @@ DiskStream::DiskStream(const string &str, int netfd)
       _max_memload(0),
       _filesize(0),
       _pagesize(0),
-      _offset(0)
+      _offset(0),
+      _mapstart(0),
+      _mapsize(0)
 {
 //    GNASH_REPORT_FUNCTION;
     /// \brief get the pagesize and cache the value
@@ -502,6 +514,8 @@ DiskStream::loadToMem(size_t filesize, off_t offset)
 	log_debug(_("File %s a offset %d mapped to: %p"), _filespec, offset, (void *)dataptr);
 	clock_gettime (CLOCK_REALTIME, &_last_access);
 	_dataptr = dataptr;
+	_mapstart = page;
+	_mapsize = loadsize;
 	// map the seekptr to the end of data
 	_seekptr = _dataptr + _pagesize;
 	_state = OPEN;
@@ -511,7 +525,9 @@ DiskStream::loadToMem(size_t filesize, off_t offset)
     std::uint8_t *ptr = dataptr;
     if (_filetype == FILETYPE_FLV) {
 	// FIXME: for now, assume all media files are in FLV format
-	_flv.reset(new cygnal::Flv);
+	if (!_flv) {
+	    _flv.reset(new cygnal::Flv);
+	}
 	std::shared_ptr<cygnal::Flv::flv_header_t> head = _flv->decodeHeader(ptr);
 	ptr += sizeof(cygnal::Flv::flv_header_t);
 	ptr += sizeof(cygnal::Flv::previous_size_t);
@@ -670,6 +686,9 @@ DiskStream::open(const string &filespec, int netfd, Statistics &statistics)
 	_state = OPEN;
 	_filetype = determineFileType(filespec);
 	loadToMem(0); // load the first page into memory
+	if (_filetype == FILETYPE_FLV) {
+	    loadIndex();
+	}
     } else {
 	log_error (_("File %s doesn't exist"), _filespec);
 	_state = DONE;
@@ -750,7 +769,11 @@ DiskStream::play(int netfd, bool flag)
 #ifdef HAVE_SENDFILE_XX
 		  ret = sendfile(netfd, _filefd, &_offset, _filesize - _offset);
 #else
-		  ret = net.writeNet(netfd, (_dataptr + _offset), (_filesize - _offset));
+		  if (!mapWindow(_offset, _filesize - _offset)) {
+		      return false;
+		  }
+		  ret = net.writeNet(netfd, (_dataptr + (_offset - _mapstart)),
+				     (_filesize - _offset));
 		  if (ret != (_filesize - _offset)) {
 		      log_error(_("In %s(%d): couldn't write %d bytes to net fd #%d! %s"),
 				__FUNCTION__, __LINE__, (_filesize - _offset),
@@ -768,7 +791,11 @@ DiskStream::play(int netfd, bool flag)
 #ifdef HAVE_SENDFILE_XX
 		  ret = sendfile(netfd, _filefd, &_offset, _pagesize);
 #else
-		  ret = net.writeNet(netfd, (_dataptr + _offset), _pagesize);
+		  if (!mapWindow(_offset, _pagesize)) {
+		      return false;
+		  }
+		  ret = net.writeNet(netfd, (_dataptr + (_offset - _mapstart)),
+				     _pagesize);
 		  if (ret != _pagesize) {
 		      log_error(_("In %s(%d): couldn't write %d of bytes of data to net fd #%d! Got %d, %s"),
 				__FUNCTION__, __LINE__, _pagesize, netfd,
@@ -900,6 +927,153 @@ DiskStream::seek(off_t offset)
     return loadToMem(offset);    
 }
 
+/// \brief Seek to a time within an FLV stream.
+///
+/// @param timestamp The time in milliseconds to seek to.
+///
+/// @return The time of the keyframe playback starts at, or -1
+///		if the stream can't seek.
+int
+DiskStream::seekTime(std::uint32_t timestamp)
+{
+//    GNASH_REPORT_FUNCTION;
+
+    if (!_flv || (_dataptr == nullptr)) {
+	log_error(_("Can't seek in %s, it isn't an open FLV file"), _filespec);
+	return -1;
+    }
+
+    const cygnal::Flv::flv_keyframe_t *key = _flv->findKeyframe(timestamp);
+    if ((key == nullptr) || (key->offset >= _filesize)) {
+	log_error(_("No keyframe to seek to in %s"), _filespec);
+	return -1;
+    }
+
+    log_network(_("Seeking to %d milliseconds in %s, keyframe at %d is at offset %d"),
+		timestamp, _filespec, key->timestamp, key->offset);
+
+    // Only the first part of a big file is mapped when it's opened,
+    // so map the part holding the keyframe.
+    if (!mapWindow(key->offset,
+		   std::min(_pagesize, static_cast<size_t>(_filesize - key->offset)))) {
+	return -1;
+    }
+
+    // ::play() starts sending from the offset.
+    _offset = key->offset;
+    _state = PLAY;
+
+    return key->timestamp;
+}
+
+bool
+DiskStream::mapWindow(off_t offset, size_t size)
+{
+//    GNASH_REPORT_FUNCTION;
+
+    if (_dataptr && (offset >= _mapstart)
+	&& ((offset - _mapstart) + size <= _mapsize)) {
+	return true;
+    }
+
+#if !defined(_WIN32) && !defined(__amigaos4__)
+    if (_filefd <= 0) {
+	log_error(_("Can't map offset %d of %s, the file isn't open"),
+		  offset, _filespec);
+	return false;
+    }
+
+    // Mappings have to start on a page boundary.
+    off_t start = offset - (offset % _pagesize);
+    size_t loadsize = std::min(_max_memload,
+			       static_cast<size_t>(_filesize - start));
+    if ((offset - start) + size > loadsize) {
+	log_error(_("Can't map %d bytes at offset %d of %s"), size, offset,
+		  _filespec);
+	return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mem_mutex);
+    void *data = mmap(nullptr, loadsize, PROT_READ, MAP_SHARED, _filefd,
+		      start);
+    if (data == MAP_FAILED) {
+	log_error(_("Couldn't map file %s into memory: %s"), _filespec,
+		  strerror(errno));
+	return false;
+    }
+    if (_dataptr) {
+	munmap(_dataptr, _mapsize);
+    }
+    log_debug(_("Moved the mapping of %s to offset %d"), _filespec, start);
+    _dataptr = static_cast<std::uint8_t *>(data);
+    _seekptr = _dataptr + _pagesize;
+    _mapstart = start;
+    _mapsize = loadsize;
+
+    return true;
+#else
+    log_unimpl(_("Mapping files too big to load into memory"));
+    return false;
+#endif
+}
+
+/// \brief Load the keyframe index of an FLV file.
+///
+/// @return True if there is an index, false if not.
+bool
+DiskStream::loadIndex()
+{
+//    GNASH_REPORT_FUNCTION;
+
+    struct stat st;
+    if (stat(_filespec.c_str(), &st) != 0) {
+	return false;
+    }
+    if (!_flv) {
+	_flv.reset(new cygnal::Flv);
+    }
+
+    string index = _filespec + cygnal::FLV_INDEX_SUFFIX;
+    if (_flv->readIndex(index, st.st_size, st.st_mtime)) {
+	log_debug(_("Loaded %d keyframes from %s"), _flv->getIndex().size(),
+		  index);
+	return true;
+    }
+
+    // Scan the whole file. If only part of it is in memory, map all of
+    // it just long enough to read the tag headers.
+    size_t count = 0;
+    if (fullyPopulated()) {
+	count = _flv->buildIndex(_dataptr, st.st_size);
+    } else {
+#if !defined(_WIN32) && !defined(__amigaos4__)
+	int fd = ::open(_filespec.c_str(), O_RDONLY);
+	if (fd < 0) {
+	    return false;
+	}
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED) {
+	    log_error(_("Couldn't map %s to index it: %s"), _filespec,
+		      strerror(errno));
+	    return false;
+	}
+	count = _flv->buildIndex(static_cast<std::uint8_t *>(data), st.st_size);
+	munmap(data, st.st_size);
+#else
+	log_unimpl(_("Indexing FLV files too big to load into memory"));
+#endif
+    }
+
+    // The index still works if it can't be saved, it just has to be
+    // built again next time.
+    if (count && !_flv->writeIndex(index, st.st_size, st.st_mtime)) {
+	log_network(_("Couldn't write keyframe index %s"), index);
+    }
+
+    return (count > 0);
+}
+
 /// \brief Upload a file into a sandbox.
 ///	The sandbox is an area where uploaded files can get
 ///	written to safely. For SWF content, the file name also
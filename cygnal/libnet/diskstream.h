@@ -161,6 +161,24 @@ public:
     ///
     /// @return A real pointer to the location of the data seeked to.
     std::uint8_t * seek(off_t offset);
+
+    /// \brief Seek to a time within an FLV stream.
+    ///		Playback starts at the keyframe at or before the
+    ///		time, which is found with the keyframe index.
+    ///
+    /// @param timestamp The time in milliseconds to seek to.
+    ///
+    /// @return The time of the keyframe playback starts at, or -1
+    ///		if the stream can't seek.
+    DSOEXPORT int seekTime(std::uint32_t timestamp);
+
+    /// \brief Load the keyframe index of an FLV file.
+    ///		The index is read from the file next to the FLV file
+    ///		if it's current, otherwise it's built by scanning the
+    ///		FLV file and then written there for next time.
+    ///
+    /// @return True if there is an index, false if not.
+    DSOEXPORT bool loadIndex();
     
     /// \brief Upload a file into a sandbox.
     ///		The sandbox is an area where uploaded files can get
@@ -328,6 +346,27 @@ private:
     ///		page.
     off_t	_offset;
 
+    /// \var DiskStream::_mapstart
+    ///		The offset within the file of the start of the memory
+    ///		currently mapped.
+    off_t	_mapstart;
+
+    /// \var DiskStream::_mapsize
+    ///		The size in bytes of the memory currently mapped.
+    size_t	_mapsize;
+
+    /// \brief Map the part of the file holding a range of bytes.
+    ///		Files too big to load into memory are mapped up to
+    ///		_max_memload bytes at a time, so the mapping has to move
+    ///		when playing or seeking past the end of it.
+    ///
+    /// @param offset The location in bytes in the file of the data.
+    ///
+    /// @param size The amount of bytes that have to be mapped.
+    ///
+    /// @return True if the data is in memory, false if not.
+    bool mapWindow(off_t offset, size_t size);
+
     /// \brief An internal routine used to extract the type of file.
     ///
     /// @param filespec An optional filename to extract the type from.
@@ -84,7 +84,9 @@ HTTP::HTTP()
       _clientid(0),
       _index(0),
       _max_requests(0),
-      _close(false)
+      _close(false),
+      _requests(0),
+      _last_modified(0)
 {
 //    GNASH_REPORT_FUNCTION;
 //    struct status_codes *status = new struct status_codes;
@@ -102,7 +104,9 @@ HTTP::HTTP(Handler *hand)
       _clientid(0),
       _index(0),
       _max_requests(0),
-      _close(false)
+      _close(false),
+      _requests(0),
+      _last_modified(0)
 
 {
 //    GNASH_REPORT_FUNCTION;
@@ -147,6 +151,15 @@ HTTP::processHeaderFields(cygnal::Buffer *buf)
     // The end of the header block is always followed by a blank line
     string::size_type end = head.find("\r\n\r\n", 0);
 //    head.erase(end, buf.size()-end);
+
+    // A persistent connection handles many requests, so nothing
+    // from the last one may leak into this one.
+    _fields.clear();
+    _keepalive = false;
+    _close = false;
+    _last_modified = 0;
+    _requests++;
+
     Tok t(head, Sep("\r\n"));
     for (Tok::iterator i = t.begin(); i != t.end(); ++i) {
 	string::size_type pos = i->find(":", 0);
@@ -169,6 +182,10 @@ HTTP::processHeaderFields(cygnal::Buffer *buf)
 		if (value.find("keep-alive", 0) != string::npos) {
 		    _keepalive = true;
 		}
+		if (value.find("close", 0) != string::npos) {
+		    _keepalive = false;
+		    _close = true;
+		}
 	    }
 	    if (name == "content-length") {
 		_filesize = strtol(value.c_str(), nullptr, 0);
@@ -229,10 +246,59 @@ HTTP::processHeaderFields(cygnal::Buffer *buf)
 #endif
 	}
     }
+
+    // Don't let one client hold a connection open forever.
+    if (_keepalive && (_requests >= HTTP_KEEPALIVE_MAX)) {
+	log_network(_("Closing persistent connection after %d requests"),
+		    _requests);
+	_close = true;
+    }
     
     return buf->reference() + end + 4;
 }
 
+void
+HTTP::addRequestData(const std::uint8_t *data, size_t size)
+{
+//    GNASH_REPORT_FUNCTION;
+    if (data && size) {
+	_pending.append(reinterpret_cast<const char *>(data), size);
+    }
+}
+
+std::shared_ptr<cygnal::Buffer>
+HTTP::nextRequest()
+{
+//    GNASH_REPORT_FUNCTION;
+    std::shared_ptr<cygnal::Buffer> buf;
+
+    string::size_type end = _pending.find("\r\n\r\n", 0);
+    if (end == string::npos) {
+	return buf;
+    }
+    end += 4;
+
+    // Only a request with a body has a Content-Length field, and
+    // the whole body has to arrive before the request can be handled.
+    size_t length = 0;
+    string head = _pending.substr(0, end);
+    std::transform(head.begin(), head.end(), head.begin(),
+		   (int(*)(int)) tolower);
+    string::size_type pos = head.find("\r\ncontent-length:", 0);
+    if (pos != string::npos) {
+	length = strtoul(head.c_str() + pos + 17, nullptr, 0);
+    }
+    if (_pending.size() < end + length) {
+	return buf;
+    }
+
+    buf.reset(new cygnal::Buffer(end + length));
+    buf->copy(reinterpret_cast<std::uint8_t *>(&_pending[0]), end + length);
+    _pending.erase(0, end + length);
+
+    return buf;
+}
+
 // // Parse an Echo Request message coming from the Red5 echo_test. This
 // // method should only be used for testing purposes.
 // vector<std::shared_ptr<cygnal::Element > >
@@ -937,16 +1003,28 @@ HTTP::formatHeader(DiskStream::filetype_e type, size_t size, http_status_e code)
 
     formatDate();
     formatServer();
-    formatLastModified();
+    if (_last_modified) {
+	formatLastModified(_last_modified);
+    } else {
+	formatLastModified();
+    }
     formatAcceptRanges("bytes");
     formatContentLength(size);
 
-    // Apache closes the connection on GET requests, so we do the same.
-    // This is a bit silly, because if we close after every GET request,
-    // we're not really handling the persistance of HTTP 1.1 at all.
+    // Tell the client whether the connection stays open after this
+    // response, and for how long.
     if (_close) {
 	formatConnection("close");
 	_keepalive = false;
+    } else if (_keepalive) {
+	formatConnection("Keep-Alive");
+	sprintf(num, "%d", HTTP_KEEPALIVE_TIMEOUT);
+	std::string alive = "timeout=";
+	alive += num;
+	sprintf(num, "%d", static_cast<int>(HTTP_KEEPALIVE_MAX - _requests));
+	alive += ", max=";
+	alive += num;
+	formatKeepAlive(alive);
     }
     formatContentType(type);
 
@@ -1131,6 +1209,40 @@ HTTP::formatLastModified()
     return formatLastModified(date.str());
 }
 
+cygnal::Buffer &
+HTTP::formatLastModified(time_t mtime)
+{
+//    GNASH_REPORT_FUNCTION;
+    return formatLastModified(httpDate(mtime));
+}
+
+std::string
+HTTP::httpDate(time_t date)
+{
+//    GNASH_REPORT_FUNCTION;
+    struct tm tm;
+    char str[64];
+
+    gmtime_r(&date, &tm);
+    strftime(str, sizeof(str), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+
+    return str;
+}
+
+time_t
+HTTP::parseDate(const std::string &date)
+{
+//    GNASH_REPORT_FUNCTION;
+    struct tm tm;
+
+    memset(&tm, 0, sizeof(struct tm));
+    if (strptime(date.c_str(), "%a, %d %b %Y %H:%M:%S", &tm) == nullptr) {
+	return 0;
+    }
+
+    return timegm(&tm);
+}
+
 cygnal::Buffer &
 HTTP::formatEchoResponse(const std::string &num, cygnal::Buffer &data)
 {
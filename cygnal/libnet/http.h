@@ -24,6 +24,7 @@
 #include <map>
 #include <vector>
 #include <sstream>
+#include <ctime>
 
 #ifdef HAVE_CONFIG_H
 #include "gnashconfig.h"
@@ -39,6 +40,16 @@
 
 namespace gnash
 {
+
+/// \var HTTP_KEEPALIVE_TIMEOUT
+///	The number of seconds a persistent connection may sit idle
+///	before the server closes it.
+const int HTTP_KEEPALIVE_TIMEOUT = 15;
+
+/// \var HTTP_KEEPALIVE_MAX
+///	The number of requests served over one persistent connection
+///	before the server closes it.
+const size_t HTTP_KEEPALIVE_MAX = 100;
     
 class DSOEXPORT HTTP : public gnash::Network
 {
@@ -145,6 +156,25 @@ public:
     // starts, and is "Content-Length" bytes long, of "Content-Type" data.
     std::uint8_t *processHeaderFields(cygnal::Buffer *buf);
     
+    /// \brief Add data read from the network to the pending requests.
+    ///
+    /// @param data A real pointer to the data.
+    ///
+    /// @param size The number of bytes of data.
+    void addRequestData(const std::uint8_t *data, size_t size);
+
+    /// \brief Split the next complete request off the pending data.
+    ///		Clients pipelining requests may send several of them
+    ///		in one packet, so they are split off and handled one
+    ///		at a time in the order they arrived.
+    ///
+    /// @return The request, header and content, or an empty pointer
+    ///		if all of the next request hasn't arrived yet.
+    std::shared_ptr<cygnal::Buffer> nextRequest();
+
+    /// \brief Get the number of bytes of request data not yet handled.
+    size_t pendingRequestData() const { return _pending.size(); }
+
     // Get the field for header 'name' that was stored by processHeaderFields()
     std::string &getField(const std::string &name) { return _fields[name]; };
     size_t NumOfFields() { return _fields.size(); };
@@ -217,6 +247,7 @@ public:
     cygnal::Buffer &formatAcceptRanges(const std::string &data)
  	{return formatCommon("Accept-Ranges: " + data); };
     cygnal::Buffer &formatLastModified();
+    cygnal::Buffer &formatLastModified(time_t mtime);
     cygnal::Buffer &formatLastModified(const std::string &data)
  	{return formatCommon("Last-Modified: " + data); }
     cygnal::Buffer &formatEtag(const std::string &data)
@@ -231,6 +262,21 @@ public:
  	{return formatCommon("TE: " + data); };
     // All HTTP messages are terminated with a blank line
     void terminateHeader() { _buffer += "\r\n"; };    
+
+    /// \brief Format a time as an HTTP date.
+    ///
+    /// @param date The time in seconds since the epoch.
+    ///
+    /// @return The date in RFC 1123 format, always in GMT.
+    static std::string httpDate(time_t date);
+
+    /// \brief Parse an HTTP date, like in an If-Modified-Since field.
+    ///
+    /// @param date The date in RFC 1123 format.
+    ///
+    /// @return The time in seconds since the epoch, or 0 if the
+    ///		date couldn't be parsed.
+    static time_t parseDate(const std::string &date);
     
 //     cygnal::Buffer &formatErrorResponse(http_status_e err);
     
@@ -282,6 +328,9 @@ public:
     void keepAlive(bool x) { _keepalive = x; };
     
     int getMaxRequests() { return _max_requests; }
+    size_t getRequests() { return _requests; }
+    void setLastModified(time_t x) { _last_modified = x; }
+    bool isClosing() { return _close; }
     int getFileSize() { return _filesize; }
     std::string &getFilespec() { return _filespec; }
     std::string &getParams() { return _params; }
@@ -338,6 +387,19 @@ protected:
     std::string		_docroot;
 
     bool		_close;
+
+    /// \var HTTP::_requests
+    ///		The number of requests handled on this connection.
+    size_t		_requests;
+
+    /// \var HTTP::_last_modified
+    ///		The modification time of the file being sent, if known.
+    time_t		_last_modified;
+
+    /// \var HTTP::_pending
+    ///		Data read from the network that hasn't been handled
+    ///		yet, which may hold several pipelined requests.
+    std::string		_pending;
 };  
 
 // This is the thread for all incoming HTTP connections for the server
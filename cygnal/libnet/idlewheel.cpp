@@ -0,0 +1,113 @@
+// idlewheel.cpp:  Timeouts for idle network connections, for Cygnal.
+// 
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include <vector>
+
+#include "idlewheel.h"
+#include "log.h"
+
+namespace gnash {
+
+IdleWheel::IdleWheel(int timeout)
+    : _timeout(timeout),
+      _slots(timeout + 1),
+      _last(0)
+{
+//    GNASH_REPORT_FUNCTION;
+}
+
+IdleWheel::~IdleWheel()
+{
+//    GNASH_REPORT_FUNCTION;
+}
+
+void
+IdleWheel::touch(int fd, time_t now)
+{
+//    GNASH_REPORT_FUNCTION;
+    remove(fd);
+
+    time_t deadline = now + _timeout;
+    _deadlines[fd] = deadline;
+    _slots[deadline % _slots.size()].insert(fd);
+
+    if (_last == 0) {
+	_last = now;
+    }
+}
+
+void
+IdleWheel::remove(int fd)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::map<int, time_t>::iterator it = _deadlines.find(fd);
+    if (it != _deadlines.end()) {
+	_slots[it->second % _slots.size()].erase(fd);
+	_deadlines.erase(it);
+    }
+}
+
+std::vector<int>
+IdleWheel::expire(time_t now)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::vector<int> idle;
+
+    if (_deadlines.empty()) {
+	_last = now;
+	return idle;
+    }
+
+    // Only the slots for the seconds since the last check can hold
+    // expired connections, but never go around the wheel more than once.
+    time_t first = _last + 1;
+    if ((now - _last) >= static_cast<time_t>(_slots.size())) {
+	first = now - _slots.size() + 1;
+    }
+
+    for (time_t t = first; t <= now; t++) {
+	std::set<int> &slot = _slots[t % _slots.size()];
+	std::set<int>::iterator it = slot.begin();
+	while (it != slot.end()) {
+	    if (_deadlines[*it] <= now) {
+		log_network(_("Connection on fd #%d has been idle for %d seconds"),
+			    *it, _timeout);
+		idle.push_back(*it);
+		_deadlines.erase(*it);
+		slot.erase(it++);
+	    } else {
+		++it;
+	    }
+	}
+    }
+    _last = now;
+
+    return idle;
+}
+
+} // end of gnash namespace
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: t
+// End:
@@ -0,0 +1,101 @@
+// idlewheel.h:  Timeouts for idle network connections, for Cygnal.
+// 
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#ifndef __IDLEWHEEL_H__
+#define __IDLEWHEEL_H__
+
+#include <ctime>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "dsodefs.h" //For DSOEXPORT.
+
+/// \namespace gnash
+///	This is the main namespace for Gnash and it's libraries.
+namespace gnash {
+
+/// \class IdleWheel
+///	This tracks when each persistent network connection was last
+///	used, so the ones that sit idle too long can be closed. The
+///	connections are hashed into one second slots by when they
+///	expire, so checking for idle connections only looks at the
+///	slots that expired since the last check, instead of at every
+///	open connection.
+class DSOEXPORT IdleWheel {
+public:
+    /// \brief Create a new wheel.
+    ///
+    /// @param timeout The number of seconds a connection may sit idle.
+    IdleWheel(int timeout);
+    ~IdleWheel();
+
+    /// \brief Note that a connection was just used.
+    ///
+    /// @param fd The file descriptor of the connection.
+    ///
+    /// @param now The current time.
+    void touch(int fd, time_t now);
+
+    /// \brief Stop tracking a connection, usually because it closed.
+    ///
+    /// @param fd The file descriptor of the connection.
+    void remove(int fd);
+
+    /// \brief Remove and return all the connections that have been
+    ///		idle too long.
+    ///
+    /// @param now The current time.
+    ///
+    /// @return The file descriptors of the idle connections.
+    std::vector<int> expire(time_t now);
+
+    /// \brief Get the number of connections being tracked.
+    size_t size() const { return _deadlines.size(); }
+
+    /// \brief Get the number of seconds a connection may sit idle.
+    int getTimeout() const { return _timeout; }
+
+private:
+    /// \var IdleWheel::_timeout
+    ///		The number of seconds a connection may sit idle.
+    int				_timeout;
+
+    /// \var IdleWheel::_slots
+    ///		The connections, hashed by the second they expire.
+    std::vector<std::set<int> >	_slots;
+
+    /// \var IdleWheel::_deadlines
+    ///		When each connection expires, so a late check never
+    ///		expires a connection early.
+    std::map<int, time_t>	_deadlines;
+
+    /// \var IdleWheel::_last
+    ///		The time of the last check for idle connections.
+    time_t			_last;
+};
+
+} // end of gnash namespace
+
+#endif // __IDLEWHEEL_H__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: t
+// End:
@@ -0,0 +1,312 @@
+// metrics.cpp:  Counters and latency histograms for Cygnal.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <cstdint>
+
+#include "metrics.h"
+#include "getclocktime.hpp"
+#include "log.h"
+
+namespace gnash {
+
+// The names used when the metrics are dumped. If you add another
+// enum to counter_e or histogram_e, you have to add the name here.
+static const char *counter_names[] = {
+    "cygnal_connections_total",
+    "cygnal_bytes_sent_total",
+    "cygnal_messages_sent_total",
+    "cygnal_http_requests_total",
+    "cygnal_rtmp_handshakes_total"
+};
+
+static const char *histogram_names[] = {
+    "cygnal_first_byte_microseconds",
+    "cygnal_rtmp_handshake_microseconds",
+    "cygnal_send_latency_microseconds",
+    "cygnal_queue_depth"
+};
+
+// The percentiles that are dumped for each histogram.
+static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+Histogram::Histogram()
+{
+//    GNASH_REPORT_FUNCTION;
+    clear();
+}
+
+void
+Histogram::clear()
+{
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+	_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+int
+Histogram::bucket(std::uint64_t value)
+{
+    // Small values each get their own bucket.
+    if (value < static_cast<std::uint64_t>(METRICS_SUB_COUNT)) {
+	return value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    if (msb > METRICS_MAX_BITS) {
+	return METRICS_BUCKETS - 1;
+    }
+    // Larger values share a bucket with others that have the same
+    // top METRICS_SUB_BITS+1 bits.
+    int shift = msb - METRICS_SUB_BITS;
+    return ((shift + 1) * METRICS_SUB_COUNT)
+	+ static_cast<int>((value >> shift) - METRICS_SUB_COUNT);
+}
+
+std::uint64_t
+Histogram::highest(int bucket)
+{
+    if (bucket < (2 * METRICS_SUB_COUNT)) {
+	return bucket;
+    }
+    int shift = (bucket / METRICS_SUB_COUNT) - 1;
+    std::uint64_t base = METRICS_SUB_COUNT + (bucket % METRICS_SUB_COUNT);
+    return ((base + 1) << shift) - 1;
+}
+
+void
+Histogram::record(std::uint64_t value)
+{
+    _buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    std::uint64_t max = _max.load(std::memory_order_relaxed);
+    while ((value > max)
+	   && !_max.compare_exchange_weak(max, value,
+					  std::memory_order_relaxed)) {
+    }
+}
+
+void
+Histogram::merge(const Histogram &hist)
+{
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+	std::uint64_t count = hist._buckets[i].load(std::memory_order_relaxed);
+	if (count) {
+	    _buckets[i].fetch_add(count, std::memory_order_relaxed);
+	}
+    }
+    _count.fetch_add(hist.count(), std::memory_order_relaxed);
+    _sum.fetch_add(hist.sum(), std::memory_order_relaxed);
+    if (hist.max() > max()) {
+	_max.store(hist.max(), std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t
+Histogram::percentile(double percent) const
+{
+    std::uint64_t total = count();
+    if (total == 0) {
+	return 0;
+    }
+
+    // The rank of the value we want, counting from one.
+    std::uint64_t rank = static_cast<std::uint64_t>((percent / 100.0) * total + 0.5);
+    if (rank < 1) {
+	rank = 1;
+    }
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < METRICS_BUCKETS; i++) {
+	seen += _buckets[i].load(std::memory_order_relaxed);
+	if (seen >= rank) {
+	    // Never report more than the largest value recorded.
+	    std::uint64_t value = highest(i);
+	    return (value < max()) ? value : max();
+	}
+    }
+
+    return max();
+}
+
+Metrics::Metrics()
+{
+//    GNASH_REPORT_FUNCTION;
+    clear();
+    for (int i = 0; i < FD_SETSIZE; i++) {
+	_accepted[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+Metrics::~Metrics()
+{
+//    GNASH_REPORT_FUNCTION;
+}
+
+Metrics&
+Metrics::getDefaultInstance()
+{
+//    GNASH_REPORT_FUNCTION;
+    static Metrics m;
+    return m;
+}
+
+std::uint64_t
+Metrics::now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (static_cast<std::uint64_t>(now.tv_sec) * 1000000) + (now.tv_nsec / 1000);
+}
+
+Metrics::shard_t &
+Metrics::getShard()
+{
+    // Each thread gets the next shard the first time it records
+    // anything, which spreads the threads evenly across them.
+    static std::atomic<unsigned int> next(0);
+    static thread_local unsigned int shard =
+	next.fetch_add(1, std::memory_order_relaxed) % METRICS_SHARDS;
+
+    return _shards[shard];
+}
+
+void
+Metrics::increment(counter_e counter, std::uint64_t value)
+{
+    getShard().counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+void
+Metrics::record(histogram_e hist, std::uint64_t value)
+{
+    getShard().histograms[hist].record(value);
+}
+
+void
+Metrics::accepted(int fd)
+{
+    increment(CONNECTIONS);
+    if ((fd >= 0) && (fd < FD_SETSIZE)) {
+	_accepted[fd].store(now(), std::memory_order_relaxed);
+    }
+}
+
+void
+Metrics::sent(int fd, std::uint64_t when)
+{
+    increment(MESSAGES_SENT);
+    if ((fd < 0) || (fd >= FD_SETSIZE)) {
+	return;
+    }
+    // Only the first send after the accept gets the start time.
+    std::uint64_t start = _accepted[fd].load(std::memory_order_relaxed);
+    if (start && _accepted[fd].compare_exchange_strong(start, 0,
+						   std::memory_order_relaxed)) {
+	record(FIRST_BYTE, (when > start) ? (when - start) : 0);
+    }
+}
+
+void
+Metrics::closed(int fd)
+{
+    if ((fd >= 0) && (fd < FD_SETSIZE)) {
+	_accepted[fd].store(0, std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t
+Metrics::getCounter(counter_e counter) const
+{
+    std::uint64_t total = 0;
+    for (int i = 0; i < METRICS_SHARDS; i++) {
+	total += _shards[i].counters[counter].load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+void
+Metrics::getHistogram(histogram_e hist, Histogram &result) const
+{
+    for (int i = 0; i < METRICS_SHARDS; i++) {
+	result.merge(_shards[i].histograms[hist]);
+    }
+}
+
+std::string
+Metrics::dump() const
+{
+//    GNASH_REPORT_FUNCTION;
+    std::stringstream text;
+
+    for (int i = 0; i < COUNTER_MAX; i++) {
+	text << "# TYPE " << counter_names[i] << " counter" << std::endl;
+	text << counter_names[i] << " "
+	     << getCounter(static_cast<counter_e>(i)) << std::endl;
+    }
+
+    for (int i = 0; i < HISTOGRAM_MAX; i++) {
+	Histogram hist;
+	getHistogram(static_cast<histogram_e>(i), hist);
+	const char *name = histogram_names[i];
+	text << "# TYPE " << name << " summary" << std::endl;
+	for (size_t j = 0; j < sizeof(percentiles)/sizeof(double); j++) {
+	    text << name << "{quantile=\"" << (percentiles[j] / 100.0)
+		 << "\"} " << hist.percentile(percentiles[j]) << std::endl;
+	}
+	text << name << "{quantile=\"1\"} " << hist.max() << std::endl;
+	text << name << "_sum " << hist.sum() << std::endl;
+	text << name << "_count " << hist.count() << std::endl;
+    }
+
+    return text.str();
+}
+
+void
+Metrics::clear()
+{
+//    GNASH_REPORT_FUNCTION;
+    for (int i = 0; i < METRICS_SHARDS; i++) {
+	for (int j = 0; j < COUNTER_MAX; j++) {
+	    _shards[i].counters[j].store(0, std::memory_order_relaxed);
+	}
+	for (int j = 0; j < HISTOGRAM_MAX; j++) {
+	    _shards[i].histograms[j].clear();
+	}
+    }
+}
+
+} // end of gnash namespace
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: t
+// End:
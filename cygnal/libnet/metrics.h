@@ -0,0 +1,219 @@
+// metrics.h:  Counters and latency histograms for Cygnal.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <sys/select.h>
+
+#include "dsodefs.h"
+
+/// \namespace gnash
+///	This is the main namespace for Gnash and it's libraries.
+namespace gnash {
+
+// number of sub buckets for each power of two in a histogram, which
+// keeps the error of a recorded value under 1/32nd, about 3%
+static const int METRICS_SUB_BITS = 5;
+static const int METRICS_SUB_COUNT = 1 << METRICS_SUB_BITS;
+
+// largest power of two a histogram can hold. In microseconds this
+// is about 19 hours, larger values are counted as the largest.
+static const int METRICS_MAX_BITS = 36;
+
+// number of buckets in a histogram
+static const int METRICS_BUCKETS = (METRICS_MAX_BITS - METRICS_SUB_BITS + 2)
+                                   * METRICS_SUB_COUNT;
+
+// number of sets of counters, which threads are spread across
+static const int METRICS_SHARDS = 8;
+
+/// \class Histogram
+///	An HDR style histogram, where buckets get wider as the values
+///	get larger, so the relative error stays the same from
+///	microseconds to hours. Recording a value is a couple of atomic
+///	adds, so it's cheap enough to leave on in production.
+class DSOEXPORT Histogram {
+public:
+    Histogram();
+
+    /// \brief Record a value.
+    ///
+    /// @param value The value, usually a time in microseconds.
+    void record(std::uint64_t value);
+
+    /// \brief Reset all the counts to zero.
+    void clear();
+
+    /// \brief Add the values of another histogram to this one.
+    ///
+    /// @param hist The histogram to add.
+    void merge(const Histogram &hist);
+
+    /// \brief Get the value a percentage of the values are at or below.
+    ///
+    /// @param percent The percentage, from 0 to 100.
+    ///
+    /// @return The largest value that could be in the bucket the
+    ///		percentile falls in.
+    std::uint64_t percentile(double percent) const;
+
+    std::uint64_t count() const { return _count.load(std::memory_order_relaxed); };
+    std::uint64_t sum() const { return _sum.load(std::memory_order_relaxed); };
+    std::uint64_t max() const { return _max.load(std::memory_order_relaxed); };
+
+    /// \brief Get the bucket a value is counted in.
+    static int bucket(std::uint64_t value);
+
+    /// \brief Get the largest value counted in a bucket.
+    static std::uint64_t highest(int bucket);
+
+private:
+    std::atomic<std::uint64_t> _buckets[METRICS_BUCKETS];
+    std::atomic<std::uint64_t> _count;
+    std::atomic<std::uint64_t> _sum;
+    std::atomic<std::uint64_t> _max;
+};
+
+/// \class Metrics
+///	The counters and latency histograms for the whole server.
+///	Each thread records into one of several shards, so threads
+///	don't fight over the same cache lines, and the shards are
+///	only added together when the metrics are read.
+class DSOEXPORT Metrics {
+public:
+    /// \enum Metrics::counter_e
+    ///		The events that are counted.
+    typedef enum {
+        CONNECTIONS,
+        BYTES_SENT,
+        MESSAGES_SENT,
+        HTTP_REQUESTS,
+        RTMP_HANDSHAKES,
+        COUNTER_MAX
+    } counter_e;
+
+    /// \enum Metrics::histogram_e
+    ///		The values that are recorded in histograms.
+    typedef enum {
+        FIRST_BYTE,             // accept to the first byte sent
+        RTMP_HANDSHAKE,         // time to do the RTMP handshake
+        SEND_LATENCY,           // time to send a message
+        QUEUE_DEPTH,            // messages waiting in a queue
+        HISTOGRAM_MAX
+    } histogram_e;
+
+    Metrics();
+    ~Metrics();
+    DSOEXPORT static Metrics& getDefaultInstance();
+
+    /// \brief Get the time to measure latency with.
+    ///
+    /// @return A monotonic time in microseconds.
+    static std::uint64_t now();
+
+    /// \brief Count an event.
+    ///
+    /// @param counter The event to count.
+    ///
+    /// @param value The number to add.
+    void increment(counter_e counter, std::uint64_t value);
+    void increment(counter_e counter) { increment(counter, 1); };
+
+    /// \brief Record a value in a histogram.
+    ///
+    /// @param hist The histogram to record the value in.
+    ///
+    /// @param value The value.
+    void record(histogram_e hist, std::uint64_t value);
+
+    /// \brief Note when a connection was accepted, so the time to
+    ///		the first byte sent on it can be recorded.
+    ///
+    /// @param fd The file descriptor of the new connection.
+    void accepted(int fd);
+
+    /// \brief Note that data was sent on a connection. Only the first
+    ///		time after the connection was accepted is recorded.
+    ///
+    /// @param fd The file descriptor of the connection.
+    ///
+    /// @param when The time the data was sent, from now().
+    void sent(int fd, std::uint64_t when);
+
+    /// \brief Forget about a connection that was closed.
+    ///
+    /// @param fd The file descriptor of the connection.
+    void closed(int fd);
+
+    /// \brief Get the total of a counter across all threads.
+    std::uint64_t getCounter(counter_e counter) const;
+
+    /// \brief Get a histogram with the values from all threads.
+    ///
+    /// @param hist The histogram to get.
+    ///
+    /// @param result The histogram to add the values to.
+    void getHistogram(histogram_e hist, Histogram &result) const;
+
+    /// \brief Format all the metrics as text, one value per line in
+    ///		the format used by Prometheus, so it's easy to parse.
+    ///
+    /// @return The metrics.
+    std::string dump() const;
+
+    /// \brief Reset all the metrics to zero.
+    void clear();
+
+private:
+    /// \struct Metrics::shard_t
+    ///		The metrics recorded by some of the threads.
+    struct shard_t {
+        std::atomic<std::uint64_t> counters[COUNTER_MAX];
+        Histogram histograms[HISTOGRAM_MAX];
+    };
+
+    /// \brief Get the shard for the calling thread.
+    shard_t &getShard();
+
+    /// \var Metrics::_shards
+    ///		The metrics, split up by thread.
+    shard_t _shards[METRICS_SHARDS];
+
+    /// \var Metrics::_accepted
+    ///		When each connection was accepted, or zero once the
+    ///		first byte was sent.
+    std::atomic<std::uint64_t> _accepted[FD_SETSIZE];
+};
+
+} // end of gnash namespace
+
+#endif // __METRICS_H__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: t
+// End:
@@ -66,6 +66,7 @@
 #endif
 
 #include "buffer.h"
+#include "metrics.h"
 #include "GnashException.h"
 
 #ifndef MAXHOSTNAMELEN
@@ -93,6 +94,8 @@ static void cntrlc_handler(int sig);
 // this is set when we get a signal during a pselect() or ppoll()
 static int  sig_number = 0;
 
+static Metrics& metrics = Metrics::getDefaultInstance();
+
 Network::Network()
 	:
 	_ipaddr(INADDR_ANY),
@@ -406,6 +409,7 @@ Network::newConnection(bool block, int fd)
     if (_debug) {
 	log_debug(_("Accepting TCP/IP connection on fd #%d for port %d"), _sockfd, _port);
     }
+    metrics.accepted(_sockfd);
 
     return _sockfd;
 }
@@ -755,6 +759,7 @@ Network::closeNet(int sockfd)
     if (sockfd <= 0) {
         return true;
     }
+    metrics.closed(sockfd);
 
     while (retries < 3) {
         if (sockfd) {
@@ -1113,6 +1118,7 @@ Network::writeNet(int fd, const byte_t *buffer, int nbytes, int timeout)
 
     fd_set              fdset;
     int                 ret = -1;
+    std::uint64_t       start = Metrics::now();
 
     std::lock_guard<std::mutex> lock(_net_mutex);
     
@@ -1195,6 +1201,10 @@ Network::writeNet(int fd, const byte_t *buffer, int nbytes, int timeout)
             return ret;
         }
         if (ret > 0) {
+            std::uint64_t end = Metrics::now();
+            metrics.record(Metrics::SEND_LATENCY, end - start);
+            metrics.increment(Metrics::BYTES_SENT, ret);
+            metrics.sent(fd, end);
             bufptr += ret;
             if (ret != nbytes) {
 		if (_debug) {
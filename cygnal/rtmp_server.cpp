@@ -1242,13 +1242,11 @@ RTMPServer::sendFile(int fd, const std::string &filespec)
     // See if the file is in the cache and already opened.
     std::shared_ptr<DiskStream> filestream(cache.findFile(filespec));
     if (filestream) {
-	cerr << "FIXME: found file in cache!" << endl;
+	log_network(_("Found %s in the cache"), filespec);
     } else {
 	filestream.reset(new DiskStream);
 //	    cerr << "New Filestream at 0x" << hex << filestream.get() << endl;
 	
-//	    cache.addFile(url, filestream);	FIXME: always reload from disk for now.
-	
 	// Open the file and read the first chunk into memory
 	if (!filestream->open(filespec)) {
 	    return false;
@@ -1258,9 +1256,21 @@ RTMPServer::sendFile(int fd, const std::string &filespec)
 		return false;
 	    } else {
 		cache.addPath(filespec, filestream->getFilespec());
+		// Only files mapped entirely into memory can be shared
+		// between threads, larger ones get paged in per stream.
+		// Close the file before publishing it, as from then on
+		// other threads may read the stream at the same time.
+		if (filestream->fullyPopulated()) {
+		    filestream->close();
+		    cache.addFile(filespec, filestream);
+		}
 	    }
 	}
     }
+
+    // A shared stream is never modified, only read from its mapping,
+    // so the paging and closing below is done for our own streams only.
+    const bool shared = filestream->fullyPopulated();
     
     size_t filesize = filestream->getFileSize();
     size_t bytes_read = 0;
@@ -1296,15 +1306,20 @@ RTMPServer::sendFile(int fd, const std::string &filespec)
 		page += filestream->getPagesize();
 	    } while (bytes_read <= filesize);
 	} else {
-	    filestream->loadToMem(filesize, 0);
-//	    ret = writeNet(fd, filestream->get(), filesize);
-	    if (sendMsg(fd, getChannel(), RTMP::HEADER_12, filesize,
-			RTMP::NOTIFY, RTMPMsg::FROM_SERVER, filestream->get()+24,
+	    std::uint8_t *data = filestream->get();
+	    if (!shared) {
+		data = filestream->loadToMem(filesize, 0);
+	    }
+//	    ret = writeNet(fd, data, filesize);
+	    if (data && sendMsg(fd, getChannel(), RTMP::HEADER_12, filesize,
+			RTMP::NOTIFY, RTMPMsg::FROM_SERVER, data+24,
 			filesize-24)) {
 	    }
 					
 	}
-	filestream->close();
+	if (!shared) {
+	    filestream->close();
+	}
 #ifdef USE_STATS_CACHE
 	struct timespec end;
 	clock_gettime (CLOCK_REALTIME, &end);
@@ -1501,11 +1516,16 @@ rtmp_handler(Network::thread_params_t *args)
 		      case RTMP::ROUTE:
 		      case RTMP::AUDIO_DATA:
 		      case RTMP::VIDEO_DATA:
-		      case RTMP::SHARED_OBJ:
 			  body = rtmp->decodeMsgBody(tmpptr, qhead->bodysize);
 			  log_network("SharedObject name is \"%s\"",
 				      body->getMethodName());
 			  break;
+		      case RTMP::SHARED_OBJ:
+			  // The changes get sent to the clients the
+			  // next time the handler syncs.
+			  hand->processSharedObject(args->netfd, tmpptr,
+						    qhead->bodysize);
+			  break;
 		      case RTMP::AMF3_NOTIFY:
 			  log_unimpl(_("RTMP type %d"), qhead->type);
 			  break;
@@ -1629,7 +1649,22 @@ rtmp_handler(Network::thread_params_t *args)
 				  }
 			      }  
 			  } else if (body->getMethodName() == "seek") {
-			      hand->seekStream();
+			      // NetStream.seek() sends the time in milliseconds
+			      int ret = -1;
+			      if ((body->size() > 1) && body->at(1)) {
+				  ret = hand->seekStream(static_cast<int>(body->at(1)->to_number()));
+			      }
+			      std::shared_ptr<DiskStream> ds = hand->getCurrentDiskStream();
+			      if ((ret >= 0) && ds) {
+				  response = rtmp->encodeResult(RTMPMsg::NS_SEEK_NOTIFY, ds->getFilespec(), transid);
+			      } else {
+				  response = rtmp->encodeResult(RTMPMsg::NS_SEEK_FAILED, transid);
+			      }
+			      if (rtmp->sendMsg(args->netfd, qhead->channel,
+					RTMP::HEADER_8, response->allocated(),
+					RTMP::INVOKE, RTMPMsg::FROM_SERVER,
+					*response)) {
+			      }
 			  } else if (body->getMethodName() == "pause") {
 			      hand->pauseStream(transid);
 			  } else if (body->getMethodName() == "close") {
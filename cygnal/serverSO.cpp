@@ -25,6 +25,8 @@
 
 #include "StringPredicates.h"
 #include "log.h"
+#include "amf.h"
+#include "rtmp.h"
 #include "serverSO.h"
 
 #ifdef HAVE_PWD_H
@@ -32,13 +34,16 @@
 #endif
 
 #include <sys/types.h>
+#include <arpa/inet.h>
 #include <cstdint>
+#include <ctime>
 
 #include <cctype>  // for toupper
 #include <string>
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <thread>
 
 using namespace std;
 using namespace gnash;
@@ -48,24 +53,441 @@ using namespace gnash;
 namespace cygnal {
 
 
+// Only one SharedObject is written to disk at a time, so the
+// background threads don't all fight over the disk.
+static std::mutex save_mutex;
+
+// The size of the header of a SharedObject message, not counting
+// the name, which is the version, the flags, and 4 unused bytes.
+static const size_t SO_HEADER_SIZE = sizeof(std::uint16_t) + (3 * sizeof(std::uint32_t));
+
+// The size of the header of each event in a SharedObject message.
+static const size_t SO_EVENT_SIZE = sizeof(std::uint8_t) + sizeof(std::uint32_t);
+
+// The flags field is 2 for a persistent SharedObject.
+static const std::uint32_t SO_PERSISTENT = 2;
+
 ServerSO::ServerSO()
+    : _version(1),
+      _saved(1),
+      _savetime(0),
+      _persistent(false),
+      _saving(new std::atomic<bool>(false))
 {
 //    GNASH_REPORT_FUNCTION;
 }
 
+ServerSO::ServerSO(const std::string &name)
+    : _version(1),
+      _saved(1),
+      _savetime(0),
+      _persistent(false),
+      _saving(new std::atomic<bool>(false))
+{
+//    GNASH_REPORT_FUNCTION;
+    setObjectName(name);
+}
+
 //Never destroy (TODO: add a destroyDefaultInstance)
 ServerSO::~ServerSO()
 {
 //    GNASH_REPORT_FUNCTION;    
 }
 
+bool
+ServerSO::setProperty(std::shared_ptr<cygnal::Element> el)
+{
+//    GNASH_REPORT_FUNCTION;
+    if (!el || (el->getNameSize() == 0)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    slot_t &slot = _slots[el->getName()];
+    slot.value = el;
+    slot.version = ++_version;
+
+    return true;
+}
+
+std::shared_ptr<cygnal::Element>
+ServerSO::getProperty(const std::string &name)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<std::string, slot_t>::iterator it = _slots.find(name);
+    if (it == _slots.end()) {
+        return std::shared_ptr<cygnal::Element>();
+    }
+
+    return it->second.value;
+}
+
+bool
+ServerSO::deleteProperty(const std::string &name)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<std::string, slot_t>::iterator it = _slots.find(name);
+    if ((it == _slots.end()) || !it->second.value) {
+        return false;
+    }
+
+    // Keep the slot until all the clients have been told it's gone.
+    it->second.value.reset();
+    it->second.version = ++_version;
+
+    return true;
+}
+
+size_t
+ServerSO::propertySize()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = 0;
+    std::map<std::string, slot_t>::iterator it;
+    for (it = _slots.begin(); it != _slots.end(); ++it) {
+        if (it->second.value) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void
+ServerSO::addSubscriber(int fd)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::lock_guard<std::mutex> lock(_mutex);
+    // A version of zero means the client has nothing yet, which is
+    // why the first version of the SharedObject is one.
+    _subscribers[fd] = 0;
+}
+
+void
+ServerSO::removeSubscriber(int fd)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _subscribers.erase(fd);
+}
+
+size_t
+ServerSO::subscriberSize()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _subscribers.size();
+}
+
+std::string
+ServerSO::decodeName(std::uint8_t *data, size_t size)
+{
+    if ((data == nullptr) || (size < sizeof(std::uint16_t))) {
+        return std::string();
+    }
+    std::uint16_t length = ntohs(*reinterpret_cast<std::uint16_t *>(data));
+    if (length + sizeof(std::uint16_t) > size) {
+        return std::string();
+    }
+
+    return std::string(reinterpret_cast<const char *>(data + sizeof(std::uint16_t)),
+                       length);
+}
+
+bool
+ServerSO::processMessage(int fd, std::uint8_t *data, size_t size)
+{
+//    GNASH_REPORT_FUNCTION;
+    std::uint8_t *ptr = data;
+    std::uint8_t *tooFar = data + size;
+
+    if ((data == nullptr) || (size < SO_HEADER_SIZE)) {
+        log_error(_("SharedObject message is too short!"));
+        return false;
+    }
+
+    // The header has the name, the version the client has, the
+    // flags, and 4 bytes nobody seems to know what they're for.
+    std::string name = decodeName(data, size);
+    ptr += sizeof(std::uint16_t) + name.size();
+    if (ptr + (3 * sizeof(std::uint32_t)) > tooFar) {
+        log_error(_("SharedObject name is too long!"));
+        return false;
+    }
+    ptr += sizeof(std::uint32_t);           // the client's version
+    std::uint32_t flags = ntohl(*reinterpret_cast<std::uint32_t *>(ptr));
+    ptr += sizeof(std::uint32_t);
+    ptr += sizeof(std::uint32_t);           // unused
+
+    while (ptr + SO_EVENT_SIZE <= tooFar) {
+        std::uint8_t type = *ptr++;
+        std::uint32_t evsize = ntohl(*reinterpret_cast<std::uint32_t *>(ptr));
+        ptr += sizeof(std::uint32_t);
+        if (ptr + evsize > tooFar) {
+            log_error(_("SharedObject event is bigger than the message!"));
+            return false;
+        }
+        std::uint8_t *evend = ptr + evsize;
+        switch (type) {
+          case RTMP::CREATE_OBJ:
+              log_network(_("Client on fd #%d connected to SharedObject \"%s\""),
+                          fd, name);
+              if (flags & SO_PERSISTENT) {
+                  setPersistent(true);
+              }
+              addSubscriber(fd);
+              break;
+          case RTMP::DELETE_OBJ:
+              log_network(_("Client on fd #%d disconnected from SharedObject \"%s\""),
+                          fd, name);
+              removeSubscriber(fd);
+              break;
+          case RTMP::REQUEST_CHANGE:
+          {
+              // There may be more than one property in the event.
+              AMF amf;
+              while (ptr < evend) {
+                  std::shared_ptr<cygnal::Element> el
+                      = amf.extractProperty(ptr, evend);
+                  if (!el || (amf.totalsize() == 0)) {
+                      break;
+                  }
+                  setProperty(el);
+                  ptr += amf.totalsize();
+              }
+              break;
+          }
+          case RTMP::REQUEST_DELETE_SLOT:
+              if (evsize >= sizeof(std::uint16_t)) {
+                  std::uint16_t len = ntohs(*reinterpret_cast<std::uint16_t *>(ptr));
+                  if (ptr + sizeof(std::uint16_t) + len <= evend) {
+                      deleteProperty(std::string(reinterpret_cast<const char *>
+                                          (ptr + sizeof(std::uint16_t)), len));
+                  }
+              }
+              break;
+          case RTMP::SEND_MESSAGE:
+              log_unimpl(_("SharedObject send message"));
+              break;
+          default:
+              log_error(_("Unknown SharedObject event type %d"), type);
+              break;
+        }
+        ptr = evend;
+    }
+
+    return true;
+}
+
+std::shared_ptr<cygnal::Buffer>
+ServerSO::encodeChanges(std::uint32_t since)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return encodeChangesLocked(since);
+}
+
+std::shared_ptr<cygnal::Buffer>
+ServerSO::encodeChangesLocked(std::uint32_t since)
+{
+//    GNASH_REPORT_FUNCTION;
+    // Encode the events first, as the Buffer has to be big enough
+    // for all of them.
+    vector<std::pair<std::uint8_t, std::shared_ptr<cygnal::Buffer> > > events;
+    size_t total = 0;
+
+    // A client that has nothing yet gets a clear first, then every
+    // property.
+    if (since == 0) {
+        events.push_back(std::make_pair(static_cast<std::uint8_t>(RTMP::CLEAR),
+                                        std::shared_ptr<cygnal::Buffer>()));
+    }
+
+    std::map<std::string, slot_t>::iterator it;
+    for (it = _slots.begin(); it != _slots.end(); ++it) {
+        slot_t &slot = it->second;
+        if (slot.version <= since) {
+            continue;
+        }
+        std::shared_ptr<cygnal::Buffer> buf;
+        if (slot.value) {
+            // A named Element is encoded as a property, which is
+            // just what a change event holds.
+            buf = AMF::encodeElement(*slot.value);
+            if (!buf) {
+                continue;
+            }
+            events.push_back(std::make_pair(static_cast<std::uint8_t>(RTMP::CHANGE), buf));
+        } else if (since) {
+            buf.reset(new cygnal::Buffer(it->first.size() + sizeof(std::uint16_t)));
+            *buf = static_cast<std::uint16_t>(htons(it->first.size()));
+            *buf += it->first;
+            events.push_back(std::make_pair(static_cast<std::uint8_t>(RTMP::DELETE_SLOT), buf));
+        } else {
+            continue;
+        }
+        total += buf->allocated();
+    }
+
+    if (since && events.empty()) {
+        return std::shared_ptr<cygnal::Buffer>();
+    }
+
+    const std::string &name = getObjectName();
+    total += SO_HEADER_SIZE + name.size() + (events.size() * SO_EVENT_SIZE);
+    std::shared_ptr<cygnal::Buffer> msg(new cygnal::Buffer(total));
+
+    *msg = static_cast<std::uint16_t>(htons(name.size()));
+    *msg += name;
+    *msg += static_cast<std::uint32_t>(htonl(_version));
+    *msg += static_cast<std::uint32_t>(htonl(_persistent ? SO_PERSISTENT : 0));
+    *msg += static_cast<std::uint32_t>(0);
+
+    for (size_t i = 0; i < events.size(); i++) {
+        *msg += events[i].first;
+        std::shared_ptr<cygnal::Buffer> buf = events[i].second;
+        if (buf) {
+            *msg += static_cast<std::uint32_t>(htonl(buf->allocated()));
+            *msg += buf;
+        } else {
+            *msg += static_cast<std::uint32_t>(0);
+        }
+    }
+
+    return msg;
+}
+
+ServerSO::updates_t
+ServerSO::flush()
+{
+//    GNASH_REPORT_FUNCTION;
+    updates_t updates;
+    bool save_now = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Most clients are at the same version, so the message for
+        // each version is only encoded once and then shared.
+        std::map<std::uint32_t, std::shared_ptr<cygnal::Buffer> > encoded;
+        std::map<int, std::uint32_t>::iterator it;
+        for (it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+            if (it->second == _version) {
+                continue;
+            }
+            std::map<std::uint32_t, std::shared_ptr<cygnal::Buffer> >::iterator eit
+                = encoded.find(it->second);
+            if (eit == encoded.end()) {
+                eit = encoded.insert(std::make_pair(it->second,
+                                     encodeChangesLocked(it->second))).first;
+            }
+            if (eit->second) {
+                updates[it->first] = eit->second;
+            }
+            it->second = _version;
+        }
+
+        // Now every client is up to date, so nobody needs to be told
+        // about the deleted properties anymore.
+        std::map<std::string, slot_t>::iterator sit = _slots.begin();
+        while (sit != _slots.end()) {
+            if (!sit->second.value) {
+                _slots.erase(sit++);
+            } else {
+                ++sit;
+            }
+        }
+
+        if (_persistent && (_saved != _version)
+            && ((time(0) - _savetime) >= SO_SAVE_INTERVAL)) {
+            save_now = true;
+        }
+    }
+
+    if (save_now) {
+        save(true);
+    }
+
+    return updates;
+}
+
+bool
+ServerSO::save(bool background)
+{
+//    GNASH_REPORT_FUNCTION;
+    if (getFilespec().empty()) {
+        return false;
+    }
+
+    // Don't start another write while the last one is still going,
+    // the next flush will pick up the changes.
+    bool expected = false;
+    if (!_saving->compare_exchange_strong(expected, true)) {
+        return false;
+    }
+
+    // Write a copy, so properties can keep changing while the file
+    // is written. SOL::writeFile() byte swaps numbers in place, so
+    // the copy can't share the Elements with the clients either.
+    std::shared_ptr<SOL> copy(new SOL);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        AMF amf;
+        std::map<std::string, slot_t>::iterator it;
+        for (it = _slots.begin(); it != _slots.end(); ++it) {
+            if (!it->second.value) {
+                continue;
+            }
+            std::shared_ptr<cygnal::Buffer> buf = AMF::encodeElement(*it->second.value);
+            if (!buf) {
+                continue;
+            }
+            std::shared_ptr<cygnal::Element> el
+                = amf.extractProperty(buf->reference(), buf->reference() + buf->allocated());
+            if (el) {
+                copy->addObj(el);
+            }
+        }
+        copy->setFilespec(getFilespec());
+        copy->setObjectName(getObjectName());
+        _saved = _version;
+        _savetime = time(0);
+    }
+
+    std::shared_ptr<std::atomic<bool> > saving = _saving;
+    auto write = [copy, saving]() {
+        std::lock_guard<std::mutex> lock(save_mutex);
+        if (!copy->writeFile(copy->getFilespec(), copy->getObjectName())) {
+            log_error(_("Couldn't write SharedObject to %s"), copy->getFilespec());
+        }
+        saving->store(false);
+    };
+
+    if (background) {
+        std::thread writer(write);
+        writer.detach();
+    } else {
+        write();
+    }
+
+    return true;
+}
+
 /// \brief Dump the internal data of this class in a human readable form.
 /// @remarks This should only be used for debugging purposes.
 void
 ServerSO::dump(std::ostream& os) const
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     os << endl << "Dump ServerSO:" << endl;
-
+    os << "\tName: " << getObjectName() << ", version " << _version
+       << (_persistent ? ", persistent" : "") << endl;
+    os << "\t" << _subscribers.size() << " subscribers, "
+       << _slots.size() << " slots" << endl;
+    std::map<std::string, slot_t>::const_iterator it;
+    for (it = _slots.begin(); it != _slots.end(); ++it) {
+        os << "\t" << it->first << " @" << it->second.version
+           << (it->second.value ? "" : " (deleted)") << endl;
+    }
 }
 
 } // end of namespace cygnal
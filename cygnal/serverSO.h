@@ -19,33 +19,193 @@
 #define __SERVERSO_H__
 
 #include <iostream>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
 
 #include "sol.h"
 #include "element.h"
+#include "buffer.h"
 
 /// \namespace cygnal
 ///
 /// This namespace is for all the Cygnal specific classes not used by
 /// anything else in Gnash.
 namespace cygnal {
+
+// The minimum number of seconds between writes of a persistent
+// SharedObject to disk, so busy objects aren't written every tick.
+const int SO_SAVE_INTERVAL = 5;
     
 /// \class cygnal::ServerSO
 ///	This class handles storing SharedObject on the server side.
 ///     The SOL class is used to optionally read and write a disk 
 ///     file similar to the client side.
+///
+///	Every slot remembers the version of the object it was last
+///	changed in, and every subscriber remembers the last version it
+///	was sent, so flush() only has to send each subscriber the slots
+///	that changed since then. All the changes made between two calls
+///	to flush() go out in a single message, and subscribers at the
+///	same version share the same message.
 class DSOEXPORT ServerSO : public cygnal::SOL
 {
 public:
+    /// \struct ServerSO::slot_t
+    ///		A property of the SharedObject.
+    typedef struct {
+	/// The value of the property, which is empty once the
+	/// property has been deleted.
+	std::shared_ptr<cygnal::Element> value;
+	/// The version of the SharedObject this was last changed in.
+	std::uint32_t version;
+    } slot_t;
+
+    /// The messages to send, indexed by file descriptor.
+    typedef std::map<int, std::shared_ptr<cygnal::Buffer> > updates_t;
+
     ServerSO();
+    ServerSO(const std::string &name);
     ~ServerSO();
 
+    /// \brief Get the current version of this SharedObject, which
+    ///		goes up by one every time a property is changed.
+    std::uint32_t getVersion() const { return _version; };
+
+    /// \brief Set if this SharedObject is written to disk.
+    void setPersistent(bool flag) { _persistent = flag; };
+    bool isPersistent() const { return _persistent; };
+
+    /// \brief Change the value of a property.
+    ///
+    /// @param el The new value. The name of the Element is the name
+    ///		of the property.
+    ///
+    /// @return true if the property was changed, false if the Element
+    ///		doesn't have a name.
+    bool setProperty(std::shared_ptr<cygnal::Element> el);
+
+    /// \brief Get the value of a property.
+    ///
+    /// @param name The name of the property.
+    ///
+    /// @return The value, or an empty pointer if there is no property
+    ///		with that name.
+    std::shared_ptr<cygnal::Element> getProperty(const std::string &name);
+
+    /// \brief Delete a property.
+    ///
+    /// @param name The name of the property.
+    ///
+    /// @return true if the property was deleted, false if there was
+    ///		no property with that name.
+    bool deleteProperty(const std::string &name);
+
+    /// \brief Get the number of properties.
+    size_t propertySize();
+
+    /// \brief Add a client, which is sent all of the properties
+    ///		the next time this SharedObject is flushed.
+    ///
+    /// @param fd The file descriptor of the client.
+    void addSubscriber(int fd);
+
+    /// \brief Stop sending changes to a client.
+    ///
+    /// @param fd The file descriptor of the client.
+    void removeSubscriber(int fd);
+
+    /// \brief Get the number of clients.
+    size_t subscriberSize();
+
+    /// \brief Process a SharedObject message from a client.
+    ///
+    /// @param fd The file descriptor the message came from.
+    ///
+    /// @param data A pointer to the body of the RTMP message.
+    ///
+    /// @param size The size of the body of the RTMP message.
+    ///
+    /// @return true if the message could be parsed, false if not.
+    bool processMessage(int fd, std::uint8_t *data, size_t size);
+
+    /// \brief Get the name of the SharedObject a message is for.
+    ///
+    /// @param data A pointer to the body of the RTMP message.
+    ///
+    /// @param size The size of the body of the RTMP message.
+    ///
+    /// @return The name, which is empty if the message is too short.
+    static std::string decodeName(std::uint8_t *data, size_t size);
+
+    /// \brief Encode the changes made after a version.
+    ///
+    /// @param since The version the client already has, or zero if
+    ///		it has nothing yet.
+    ///
+    /// @return The body of a SharedObject message, or an empty
+    ///		pointer if nothing changed.
+    std::shared_ptr<cygnal::Buffer> encodeChanges(std::uint32_t since);
+
+    /// \brief Get the messages that bring all the clients up to date.
+    ///		This also writes the SharedObject to disk in the
+    ///		background if it's persistent and has changed.
+    ///
+    /// @return The body of the message for each client that needs one.
+    updates_t flush();
+
+    /// \brief Write the SharedObject to disk.
+    ///
+    /// @param background Write it in another thread, so the caller
+    ///		doesn't have to wait for the disk.
+    ///
+    /// @return true if the file was written, or the thread was
+    ///		started, false if not.
+    bool save(bool background);
+
     /// \brief Dump the internal data of this class in a human readable form.
     /// @remarks This should only be used for debugging purposes.
     void dump() const { dump(std::cerr); }
     
     /// \overload dump(std::ostream& os) const
     void dump(std::ostream& os) const;
-    
+
+private:
+    std::shared_ptr<cygnal::Buffer> encodeChangesLocked(std::uint32_t since);
+
+    /// \var ServerSO::_slots
+    ///		The properties, including the ones that were deleted
+    ///		but not sent to all the clients yet.
+    std::map<std::string, slot_t> _slots;
+
+    /// \var ServerSO::_subscribers
+    ///		The last version sent to each client.
+    std::map<int, std::uint32_t> _subscribers;
+
+    /// \var ServerSO::_version
+    ///		The current version of this SharedObject.
+    std::uint32_t _version;
+
+    /// \var ServerSO::_saved
+    ///		The version that was last written to disk.
+    std::uint32_t _saved;
+
+    /// \var ServerSO::_savetime
+    ///		When this SharedObject was last written to disk.
+    time_t _savetime;
+
+    bool _persistent;
+
+    /// \var ServerSO::_saving
+    ///		Set while a thread is writing this SharedObject to
+    ///		disk. It's shared with the thread, as this object may
+    ///		be gone before the thread is done.
+    std::shared_ptr<std::atomic<bool> > _saving;
+
+    mutable std::mutex _mutex;
 };
 
 /// \brief Dump to the specified output stream.
@@ -121,6 +121,12 @@ main (int /*argc*/, char** /*argv*/) {
         runtest.fail ("getFDThread");
     }
 
+    if (crc.getCacheSize() == 32 * 1024 * 1024) {
+        runtest.pass ("getCacheSize");
+    } else {
+        runtest.fail ("getCacheSize");
+    }
+
     crc.dump();
 }
 
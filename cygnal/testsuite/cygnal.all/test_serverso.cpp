@@ -0,0 +1,214 @@
+// 
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "log.h"
+#include "amf.h"
+#include "element.h"
+#include "buffer.h"
+#include "rtmp.h"
+#include "sol.h"
+#include "serverSO.h"
+
+#ifdef HAVE_DEJAGNU_H
+#include "dejagnu.h"
+#else
+#include "check.h"
+#endif
+
+using namespace std;
+using namespace gnash;
+using namespace cygnal;
+
+TestState runtest;
+
+// The type of each event in a SharedObject message.
+static vector<int>
+events(std::shared_ptr<Buffer> msg)
+{
+    vector<int> types;
+    if (!msg) {
+        return types;
+    }
+    std::uint8_t *ptr = msg->reference();
+    std::uint8_t *end = ptr + msg->allocated();
+    std::uint16_t length = ntohs(*reinterpret_cast<std::uint16_t *>(ptr));
+    ptr += sizeof(std::uint16_t) + length + (3 * sizeof(std::uint32_t));
+    while (ptr < end) {
+        types.push_back(*ptr++);
+        std::uint32_t size = ntohl(*reinterpret_cast<std::uint32_t *>(ptr));
+        ptr += sizeof(std::uint32_t) + size;
+    }
+    return types;
+}
+
+static std::shared_ptr<Element>
+number(const string &name, double value)
+{
+    std::shared_ptr<Element> el(new Element);
+    el->makeNumber(name, value);
+    return el;
+}
+
+// Build a message like the ones a client sends.
+static std::shared_ptr<Buffer>
+request(const string &name, std::uint8_t type, std::shared_ptr<Buffer> data)
+{
+    size_t size = data ? data->allocated() : 0;
+    std::shared_ptr<Buffer> msg(new Buffer(name.size() + 19 + size));
+    *msg = static_cast<std::uint16_t>(htons(name.size()));
+    *msg += name;
+    *msg += static_cast<std::uint32_t>(0);
+    *msg += static_cast<std::uint32_t>(htonl(2));
+    *msg += static_cast<std::uint32_t>(0);
+    *msg += type;
+    *msg += static_cast<std::uint32_t>(htonl(size));
+    if (data) {
+        *msg += data;
+    }
+    return msg;
+}
+
+int
+main (int /*argc*/, char** /*argv*/) {
+    gnash::LogFile& dbglogfile = gnash::LogFile::getDefaultInstance();
+    dbglogfile.setVerbosity();
+
+    ServerSO so("lobby");
+    so.setProperty(number("players", 3));
+    so.setProperty(number("games", 1));
+    so.addSubscriber(5);
+    so.addSubscriber(6);
+
+    // New clients get everything, and share one message.
+    ServerSO::updates_t updates = so.flush();
+    vector<int> types = events(updates[5]);
+    if ((updates.size() == 2) && (updates[5] == updates[6])
+        && (types.size() == 3) && (types[0] == RTMP::CLEAR)
+        && (types[1] == RTMP::CHANGE) && (types[2] == RTMP::CHANGE)) {
+        runtest.pass("ServerSO::flush(new subscribers)");
+    } else {
+        runtest.fail("ServerSO::flush(new subscribers)");
+    }
+
+    if (so.flush().empty()) {
+        runtest.pass("ServerSO::flush(no changes)");
+    } else {
+        runtest.fail("ServerSO::flush(no changes)");
+    }
+
+    // Lots of changes to one slot in a tick are one change event.
+    for (int i = 0; i < 100; i++) {
+        so.setProperty(number("players", i));
+    }
+    updates = so.flush();
+    types = events(updates[6]);
+    if ((updates.size() == 2) && (types.size() == 1)
+        && (types[0] == RTMP::CHANGE)
+        && (so.getProperty("players")->to_number() == 99)) {
+        runtest.pass("ServerSO::flush(coalesced)");
+    } else {
+        runtest.fail("ServerSO::flush(coalesced)");
+    }
+
+    // A client that joins later gets the whole object, while the
+    // others only get what changed.
+    so.addSubscriber(7);
+    so.deleteProperty("games");
+    updates = so.flush();
+    vector<int> late = events(updates[7]);
+    types = events(updates[5]);
+    if ((types.size() == 1) && (types[0] == RTMP::DELETE_SLOT)
+        && (late.size() == 2) && (late[0] == RTMP::CLEAR)
+        && (late[1] == RTMP::CHANGE) && (so.propertySize() == 1)
+        && !so.getProperty("games")) {
+        runtest.pass("ServerSO::deleteProperty()");
+    } else {
+        runtest.fail("ServerSO::deleteProperty()");
+    }
+
+    so.removeSubscriber(7);
+    so.setProperty(number("games", 2));
+    updates = so.flush();
+    if ((updates.size() == 2) && (updates.find(7) == updates.end())) {
+        runtest.pass("ServerSO::removeSubscriber()");
+    } else {
+        runtest.fail("ServerSO::removeSubscriber()");
+    }
+
+    // Messages from a client
+    ServerSO remote;
+    std::shared_ptr<Buffer> msg = request("room", RTMP::CREATE_OBJ,
+                                          std::shared_ptr<Buffer>());
+    if ((ServerSO::decodeName(msg->reference(), msg->allocated()) == "room")
+        && remote.processMessage(9, msg->reference(), msg->allocated())
+        && (remote.subscriberSize() == 1) && remote.isPersistent()) {
+        runtest.pass("ServerSO::processMessage(connect)");
+    } else {
+        runtest.fail("ServerSO::processMessage(connect)");
+    }
+
+    std::shared_ptr<Element> el = number("score", 42);
+    msg = request("room", RTMP::REQUEST_CHANGE, AMF::encodeElement(*el));
+    if (remote.processMessage(9, msg->reference(), msg->allocated())
+        && remote.getProperty("score")
+        && (remote.getProperty("score")->to_number() == 42)) {
+        runtest.pass("ServerSO::processMessage(change)");
+    } else {
+        runtest.fail("ServerSO::processMessage(change)");
+    }
+
+    std::shared_ptr<Buffer> slot(new Buffer(7));
+    *slot = static_cast<std::uint16_t>(htons(5));
+    *slot += "score";
+    msg = request("room", RTMP::REQUEST_DELETE_SLOT, slot);
+    if (remote.processMessage(9, msg->reference(), msg->allocated())
+        && !remote.getProperty("score")) {
+        runtest.pass("ServerSO::processMessage(delete slot)");
+    } else {
+        runtest.fail("ServerSO::processMessage(delete slot)");
+    }
+
+    // Write it to disk, and make sure the values don't change.
+    string filespec = "serverso.sol";
+    so.setFilespec(filespec);
+    SOL sol;
+    if (so.save(false) && sol.readFile(filespec) && (sol.size() == 2)
+        && (so.getProperty("players")->to_number() == 99)) {
+        runtest.pass("ServerSO::save()");
+    } else {
+        runtest.fail("ServerSO::save()");
+    }
+    unlink(filespec.c_str());
+}
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: t
+// End:
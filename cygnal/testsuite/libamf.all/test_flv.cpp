@@ -30,6 +30,9 @@
 #include <fcntl.h>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <sstream>
+#include <unistd.h>
 
 #include "log.h"
 #include "dejagnu.h"
@@ -51,6 +54,7 @@ static void usage (void);
 // Prototypes for test cases
 static void test_headers();
 static void test_tags();
+static void test_index();
 
 // We use the Memory profiling class to check the malloc buffers
 // in the kernel to make sure the allocations and frees happen
@@ -108,6 +112,7 @@ main(int argc, char *argv[])
     // run the tests
     test_headers();
     test_tags();
+    test_index();
 }
 
 void
@@ -273,6 +278,93 @@ test_tags()
 #endif
 }
 
+// Add a tag with a one byte body to an FLV file in memory.
+static void
+add_tag(std::vector<std::uint8_t> &data, std::uint8_t type,
+        std::uint32_t timestamp, std::uint8_t flags)
+{
+    std::uint8_t tag[] = { type, 0, 0, 1,
+                           static_cast<std::uint8_t>((timestamp >> 16) & 0xff),
+                           static_cast<std::uint8_t>((timestamp >> 8) & 0xff),
+                           static_cast<std::uint8_t>(timestamp & 0xff),
+                           static_cast<std::uint8_t>((timestamp >> 24) & 0xff),
+                           0, 0, 0, flags, 0, 0, 0, 12 };
+    data.insert(data.end(), tag, tag + sizeof(tag));
+}
+
+void
+test_index()
+{
+    Flv flv;
+
+    std::vector<std::uint8_t> data;
+    std::uint8_t head[] = { 'F', 'L', 'V', 1, 5, 0, 0, 0, 9, 0, 0, 0, 0 };
+    data.insert(data.end(), head, head + sizeof(head));
+    add_tag(data, Flv::TAG_VIDEO, 0, 0x12);       // keyframe
+    add_tag(data, Flv::TAG_AUDIO, 20, 0x2f);
+    add_tag(data, Flv::TAG_VIDEO, 40, 0x22);      // interframe
+    add_tag(data, Flv::TAG_VIDEO, 2000, 0x12);    // keyframe
+    add_tag(data, Flv::TAG_VIDEO, 0x1000000, 0x12); // extended timestamp
+
+    if (flv.buildIndex(&data[0], data.size()) == 3) {
+        runtest.pass("Flv::buildIndex()");
+    } else {
+        runtest.fail("Flv::buildIndex()");
+    }
+
+    const Flv::flv_keyframe_t *key1 = flv.findKeyframe(1999);
+    const Flv::flv_keyframe_t *key2 = flv.findKeyframe(3000);
+    const Flv::flv_keyframe_t *key3 = flv.findKeyframe(0x2000000);
+    if (key1 && key2 && key3
+        && (key1->timestamp == 0) && (key1->offset == 13)
+        && (key2->timestamp == 2000) && (key2->offset == 13 + (16 * 3))
+        && (key3->timestamp == 0x1000000)) {
+        runtest.pass("Flv::findKeyframe()");
+    } else {
+        runtest.fail("Flv::findKeyframe()");
+    }
+
+    // The index is only used for the same version of the FLV file.
+    Flv flv2;
+    Flv flv3;
+    flv.writeIndex("test_flv.idx", data.size(), 1234);
+    if (flv2.readIndex("test_flv.idx", data.size(), 1234)
+        && (flv2.getIndex().size() == 3)
+        && (flv2.getIndex()[1].offset == key2->offset)
+        && !flv3.readIndex("test_flv.idx", data.size(), 5678)) {
+        runtest.pass("Flv::readIndex()");
+    } else {
+        runtest.fail("Flv::readIndex()");
+    }
+
+    // A new index replaces the old one, without leaving its temporary
+    // file behind.
+    std::ostringstream tmp;
+    tmp << "test_flv.idx.tmp-" << getpid();
+    struct stat st;
+    Flv flv4;
+    if (flv.writeIndex("test_flv.idx", data.size(), 5678)
+        && flv4.readIndex("test_flv.idx", data.size(), 5678)
+        && (stat(tmp.str().c_str(), &st) != 0)) {
+        runtest.pass("Flv::writeIndex()");
+    } else {
+        runtest.fail("Flv::writeIndex()");
+    }
+    unlink("test_flv.idx");
+
+    // Files without video use audio tags, one a second at most.
+    std::vector<std::uint8_t> audio(head, head + sizeof(head));
+    add_tag(audio, Flv::TAG_AUDIO, 0, 0x2f);
+    add_tag(audio, Flv::TAG_AUDIO, 500, 0x2f);
+    add_tag(audio, Flv::TAG_AUDIO, 1000, 0x2f);
+    add_tag(audio, Flv::TAG_AUDIO, 1500, 0x2f);
+    if (flv3.buildIndex(&audio[0], audio.size()) == 2) {
+        runtest.pass("Flv::buildIndex(audio)");
+    } else {
+        runtest.fail("Flv::buildIndex(audio)");
+    }
+}
+
 static void
 usage (void)
 {
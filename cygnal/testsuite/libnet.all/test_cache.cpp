@@ -58,6 +58,8 @@ static void usage (void);
 static void test (void);
 static void test_errors (void);
 static void test_remove (void);
+static void test_evict (void);
+static void test_stale (void);
 static void create_file(const std::string &, size_t);
 
 static bool dump = false;
@@ -108,6 +110,8 @@ main(int argc, char *argv[])
     test();
     test_errors();
     test_remove();
+    test_evict();
+    test_stale();
 
     unlink("outbuf1.raw");
     unlink("outbuf2.raw");
@@ -280,6 +284,102 @@ test_remove(void)
      }
 }
 
+static void
+test_evict(void)
+{
+    Cache cache;
+
+    // Room for three of the four files
+    cache.setMaxSize(1000);
+
+    std::shared_ptr<DiskStream> file1(new DiskStream);
+    create_file("outbuf1.raw", 300);
+    file1->open("outbuf1.raw");
+
+    std::shared_ptr<DiskStream> file2(new DiskStream);
+    create_file("outbuf2.raw", 300);
+    file2->open("outbuf2.raw");
+
+    std::shared_ptr<DiskStream> file3(new DiskStream);
+    create_file("outbuf3.raw", 300);
+    file3->open("outbuf3.raw");
+
+    std::shared_ptr<DiskStream> file4(new DiskStream);
+    create_file("outbuf4.raw", 300);
+    file4->open("outbuf4.raw");
+
+    cache.addFile("foo", file1);
+    cache.addFile("bar", file2);
+    cache.addFile("barfoo", file3);
+    if (cache.getMemoryUsed() == 900) {
+        runtest.pass("Cache::getMemoryUsed()");
+    } else {
+        runtest.fail("Cache::getMemoryUsed()");
+    }
+
+    // Drop our references, so the cache is the only owner
+    file1.reset();
+    file2.reset();
+    file3.reset();
+
+    cache.addFile("foobar", file4);
+    file4.reset();
+    if (cache.getMemoryUsed() <= cache.getMaxSize()) {
+        runtest.pass("Cache::addFile() evicts over budget");
+    } else {
+        runtest.fail("Cache::addFile() evicts over budget");
+    }
+
+    // Shrinking the budget evicts right away
+    cache.setMaxSize(300);
+    if (cache.getMemoryUsed() <= 300) {
+        runtest.pass("Cache::setMaxSize()");
+    } else {
+        runtest.fail("Cache::setMaxSize()");
+    }
+
+    // Files bigger than the whole budget are never cached
+    std::shared_ptr<DiskStream> file5(new DiskStream);
+    create_file("outbuf5.raw", 400);
+    file5->open("outbuf5.raw");
+    cache.addFile("big", file5);
+    if (cache.findFile("big") == 0) {
+        runtest.pass("Cache::addFile(too big)");
+    } else {
+        runtest.fail("Cache::addFile(too big)");
+    }
+    file5->close();
+    unlink("outbuf5.raw");
+}
+
+static void
+test_stale(void)
+{
+    Cache cache;
+
+    std::shared_ptr<DiskStream> file1(new DiskStream);
+    create_file("outbuf1.raw", 100);
+    file1->open("outbuf1.raw");
+    cache.addFile("foo", file1);
+
+    if (cache.findFile("foo")) {
+        runtest.pass("Cache::findFile(unchanged)");
+    } else {
+        runtest.fail("Cache::findFile(unchanged)");
+    }
+
+    // Changing the file on disk invalidates the cached copy once
+    // it's checked again.
+    create_file("outbuf1.raw", 200);
+    sleep(CACHE_VALIDATE_INTERVAL + 1);
+    if (cache.findFile("foo") == 0) {
+        runtest.pass("Cache::findFile(changed)");
+    } else {
+        runtest.fail("Cache::findFile(changed)");
+    }
+    file1->close();
+}
+
 static void
 test_errors (void)
 {
@@ -34,6 +34,8 @@
 #include <log.h>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <cstring>
 #include "as_value.h"
 #include "as_object.h"
 
@@ -52,6 +54,7 @@ static void usage (void);
 // Prototypes for test cases
 static void test();
 static void test_mem();
+static void test_seek();
 static void create_file(const std::string &, size_t);
 
 // Enable the display of memory allocation and timing data
@@ -105,6 +108,7 @@ main(int argc, char *argv[])
     // run the tests
     test();
     test_mem();
+    test_seek();
 }
 
 void
@@ -223,6 +227,87 @@ test_mem()
     }
 }
 
+static void
+add_tag(std::vector<std::uint8_t> &data, std::uint8_t type,
+        std::uint32_t timestamp, std::uint8_t flags, size_t bodysize)
+{
+    std::uint8_t tag[] = { type,
+                           static_cast<std::uint8_t>((bodysize >> 16) & 0xff),
+                           static_cast<std::uint8_t>((bodysize >> 8) & 0xff),
+                           static_cast<std::uint8_t>(bodysize & 0xff),
+                           static_cast<std::uint8_t>((timestamp >> 16) & 0xff),
+                           static_cast<std::uint8_t>((timestamp >> 8) & 0xff),
+                           static_cast<std::uint8_t>(timestamp & 0xff),
+                           static_cast<std::uint8_t>((timestamp >> 24) & 0xff),
+                           0, 0, 0 };
+    data.insert(data.end(), tag, tag + sizeof(tag));
+    data.push_back(flags);
+    for (size_t i = 1; i < bodysize; i++) {
+        data.push_back(static_cast<std::uint8_t>(i + timestamp));
+    }
+    std::uint32_t prev = sizeof(tag) + bodysize;
+    std::uint8_t size[] = { static_cast<std::uint8_t>((prev >> 24) & 0xff),
+                            static_cast<std::uint8_t>((prev >> 16) & 0xff),
+                            static_cast<std::uint8_t>((prev >> 8) & 0xff),
+                            static_cast<std::uint8_t>(prev & 0xff) };
+    data.insert(data.end(), size, size + sizeof(size));
+}
+
+// Seeking to a keyframe past the part of a big FLV file that's mapped
+// when it's opened has to map the part with the keyframe.
+void
+test_seek()
+{
+    DiskStream ds;
+
+    // DiskStream maps at most 2560 pages of a file at a time.
+    size_t window = ds.getPagesize() * 2560;
+
+    std::vector<std::uint8_t> data;
+    std::uint8_t head[] = { 'F', 'L', 'V', 1, 5, 0, 0, 0, 9, 0, 0, 0, 0 };
+    data.insert(data.end(), head, head + sizeof(head));
+    add_tag(data, 9, 0, 0x12, 100);             // keyframe
+    while (data.size() <= window) {
+        add_tag(data, 9, 40, 0x22, 0x100000);   // interframes
+    }
+    size_t offset = data.size();
+    add_tag(data, 9, 5000, 0x12, 100);          // keyframe
+
+    int fd = open("seek.flv", O_WRONLY|O_CREAT|O_TRUNC, S_IRWXU|S_IRGRP|S_IROTH);
+    if ((fd < 0) || (write(fd, &data[0], data.size())
+                     != static_cast<ssize_t>(data.size()))) {
+        runtest.unresolved("DiskStream::seekTime()");
+        return;
+    }
+    close(fd);
+
+    if (!ds.open("seek.flv") || ds.fullyPopulated()) {
+        runtest.unresolved("DiskStream::seekTime()");
+    } else if (ds.seekTime(6000) != 5000) {
+        runtest.fail("DiskStream::seekTime()");
+    } else {
+        runtest.pass("DiskStream::seekTime()");
+
+        // Playing sends the file from the keyframe to the end.
+        int out = open("seek.out", O_RDWR|O_CREAT|O_TRUNC, S_IRWXU|S_IRGRP|S_IROTH);
+        ds.play(out, true);
+        std::vector<std::uint8_t> sent(data.size() - offset + 1);
+        lseek(out, 0, SEEK_SET);
+        ssize_t ret = read(out, &sent[0], sent.size());
+        close(out);
+        if ((ret == static_cast<ssize_t>(data.size() - offset))
+            && (memcmp(&sent[0], &data[offset], ret) == 0)) {
+            runtest.pass("DiskStream::play() after seekTime()");
+        } else {
+            runtest.fail("DiskStream::play() after seekTime()");
+        }
+        unlink("seek.out");
+    }
+
+    unlink("seek.flv");
+    unlink("seek.flv.idx");
+}
+
 /// \brief create a test file to read in later. This lets us create
 /// files of arbitrary sizes.
 void
@@ -49,6 +49,7 @@ extern int optind, getopt(int, char *const *, const char *);
 #include "network.h"
 #include "amf.h"
 #include "buffer.h"
+#include "idlewheel.h"
 #include "GnashNumeric.h"
 
 using namespace gnash;
@@ -58,6 +59,7 @@ using namespace std;
 static void usage (void);
 static void tests (void);
 static void test_post (void);
+static void test_keepalive (void);
 // static void test_rtmpt (void);
 
 static TestState runtest;
@@ -95,6 +97,7 @@ main(int argc, char *argv[])
 
     tests();
     test_post();
+    test_keepalive();
 //    test_rtmpt();
 }
 
@@ -1970,6 +1973,105 @@ test_rtmpt (void)
 }
 #endif
 
+void
+test_keepalive()
+{
+    HTTP http;
+
+    // Two pipelined requests, and the start of a third, all in one packet.
+    string pipe = "GET /index.html HTTP/1.1\r\nHost: localhost:4080\r\n\r\n";
+    pipe += "POST /echo/gateway HTTP/1.1\r\nHost: localhost:4080\r\n";
+    pipe += "Content-Length: 5\r\n\r\nHello";
+    pipe += "GET /flvplayer.swf HTTP/1.1\r\nHost: local";
+    http.addRequestData(reinterpret_cast<const std::uint8_t *>(pipe.c_str()),
+                        pipe.size());
+
+    std::shared_ptr<cygnal::Buffer> req1 = http.nextRequest();
+    std::shared_ptr<cygnal::Buffer> req2 = http.nextRequest();
+    std::shared_ptr<cygnal::Buffer> req3 = http.nextRequest();
+    if (req1 && req2 && !req3
+        && (req1->allocated() == 50)
+        && (memcmp(req2->reference() + req2->allocated() - 5, "Hello", 5) == 0)) {
+        runtest.pass("HTTP::nextRequest(pipelined)");
+    } else {
+        runtest.fail("HTTP::nextRequest(pipelined)");
+    }
+
+    // The rest of the third request arrives in a later packet.
+    string rest = "host:4080\r\n\r\n";
+    http.addRequestData(reinterpret_cast<const std::uint8_t *>(rest.c_str()),
+                        rest.size());
+    req3 = http.nextRequest();
+    if (req3 && (http.pendingRequestData() == 0)) {
+        http.processHeaderFields(req3.get());
+        if (http.getFilespec() == "/flvplayer.swf") {
+            runtest.pass("HTTP::nextRequest(split)");
+        } else {
+            runtest.fail("HTTP::nextRequest(split)");
+        }
+    } else {
+        runtest.fail("HTTP::nextRequest(split)");
+    }
+
+    // HTTP 1.1 is persistent by default, so the reply says how long
+    // the connection stays open.
+    if (http.keepAlive() && !http.isClosing()) {
+        runtest.pass("HTTP::keepAlive(HTTP/1.1)");
+    } else {
+        runtest.fail("HTTP::keepAlive(HTTP/1.1)");
+    }
+    http.formatHeader(HTTP::OK);
+    string head(reinterpret_cast<const char *>(http.getHeader()));
+    if ((head.find("Connection: Keep-Alive\r\n") != string::npos)
+        && (head.find("Keep-Alive: timeout=15, max=") != string::npos)) {
+        runtest.pass("HTTP::formatHeader(Keep-Alive)");
+    } else {
+        runtest.fail("HTTP::formatHeader(Keep-Alive)");
+    }
+
+    cygnal::Buffer close;
+    close = "GET /index.html HTTP/1.1\r\nConnection: close\r\n\r\n";
+    http.processHeaderFields(&close);
+    http.formatHeader(HTTP::OK);
+    head = reinterpret_cast<const char *>(http.getHeader());
+    if (!http.keepAlive() && (head.find("Connection: close") != string::npos)) {
+        runtest.pass("HTTP::formatHeader(Connection: close)");
+    } else {
+        runtest.fail("HTTP::formatHeader(Connection: close)");
+    }
+
+    // Dates are sent as RFC 1123, and have to survive being lower cased
+    // by processHeaderFields().
+    string date = HTTP::httpDate(784111777);
+    if ((date == "Sun, 06 Nov 1994 08:49:37 GMT")
+        && (HTTP::parseDate("sun, 06 nov 1994 08:49:37 gmt") == 784111777)
+        && (HTTP::parseDate("yesterday") == 0)) {
+        runtest.pass("HTTP::parseDate()");
+    } else {
+        runtest.fail("HTTP::parseDate()");
+    }
+
+    IdleWheel idle(15);
+    idle.touch(5, 1000);
+    idle.touch(6, 1000);
+    idle.touch(7, 1005);
+    idle.touch(5, 1010);
+    std::vector<int> expired = idle.expire(1015);
+    if ((expired.size() == 1) && (expired[0] == 6) && (idle.size() == 2)) {
+        runtest.pass("IdleWheel::expire()");
+    } else {
+        runtest.fail("IdleWheel::expire()");
+    }
+
+    // A late check still only expires what is due.
+    expired = idle.expire(1100);
+    if ((expired.size() == 2) && (idle.size() == 0)) {
+        runtest.pass("IdleWheel::expire(late)");
+    } else {
+        runtest.fail("IdleWheel::expire(late)");
+    }
+}
+
 static void
 usage (void)
 {
@@ -0,0 +1,203 @@
+// 
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+#ifdef HAVE_DEJAGNU_H
+#include "dejagnu.h"
+#else
+#include "check.h"
+#endif
+
+#include "log.h"
+#include "metrics.h"
+
+using namespace std;
+using namespace gnash;
+
+static void test_histogram();
+static void test_metrics();
+
+TestState runtest;
+
+int
+main (int /*argc*/, char** /*argv*/) {
+    gnash::LogFile& dbglogfile = gnash::LogFile::getDefaultInstance();
+    dbglogfile.setVerbosity();
+
+    test_histogram();
+    test_metrics();
+}
+
+static void
+test_histogram()
+{
+    // Small values get a bucket each, larger ones share
+    if ((Histogram::bucket(0) == 0) && (Histogram::bucket(31) == 31)
+        && (Histogram::highest(Histogram::bucket(31)) == 31)) {
+        runtest.pass("Histogram::bucket(small)");
+    } else {
+        runtest.fail("Histogram::bucket(small)");
+    }
+
+    // Every value must land in a bucket that covers it, and the
+    // bucket can't be more than about 3% too wide.
+    bool ok = true;
+    std::uint64_t value = 1;
+    while (value < (static_cast<std::uint64_t>(1) << METRICS_MAX_BITS)) {
+        int b = Histogram::bucket(value);
+        std::uint64_t high = Histogram::highest(b);
+        if ((b >= METRICS_BUCKETS) || (high < value)
+            || ((high - value) > (value / METRICS_SUB_COUNT))
+            || ((b > 0) && (Histogram::highest(b - 1) >= value))) {
+            ok = false;
+            break;
+        }
+        value = value + (value / 7) + 1;
+    }
+    if (ok) {
+        runtest.pass("Histogram::bucket(range)");
+    } else {
+        runtest.fail("Histogram::bucket(range)");
+    }
+
+    if (Histogram::bucket(~static_cast<std::uint64_t>(0)) == (METRICS_BUCKETS - 1)) {
+        runtest.pass("Histogram::bucket(huge)");
+    } else {
+        runtest.fail("Histogram::bucket(huge)");
+    }
+
+    Histogram hist;
+    if ((hist.count() == 0) && (hist.percentile(50) == 0)) {
+        runtest.pass("Histogram::percentile(empty)");
+    } else {
+        runtest.fail("Histogram::percentile(empty)");
+    }
+
+    for (int i = 1; i <= 1000; i++) {
+        hist.record(i * 10);
+    }
+    std::uint64_t p50 = hist.percentile(50);
+    std::uint64_t p99 = hist.percentile(99);
+    if ((hist.count() == 1000) && (hist.max() == 10000)
+        && (hist.sum() == 5005000)) {
+        runtest.pass("Histogram::record()");
+    } else {
+        runtest.fail("Histogram::record()");
+    }
+    if ((p50 >= 5000) && (p50 <= 5000 + 5000/METRICS_SUB_COUNT)
+        && (p99 >= 9900) && (p99 <= 9900 + 9900/METRICS_SUB_COUNT)
+        && (hist.percentile(100) == 10000)) {
+        runtest.pass("Histogram::percentile()");
+    } else {
+        runtest.fail("Histogram::percentile()");
+    }
+
+    Histogram total;
+    total.merge(hist);
+    total.merge(hist);
+    if ((total.count() == 2000) && (total.max() == 10000)
+        && (total.percentile(50) == p50)) {
+        runtest.pass("Histogram::merge()");
+    } else {
+        runtest.fail("Histogram::merge()");
+    }
+
+    hist.clear();
+    if ((hist.count() == 0) && (hist.max() == 0) && (hist.percentile(99) == 0)) {
+        runtest.pass("Histogram::clear()");
+    } else {
+        runtest.fail("Histogram::clear()");
+    }
+}
+
+static void
+test_metrics()
+{
+    Metrics &metrics = Metrics::getDefaultInstance();
+    metrics.clear();
+
+    // Several threads counting at once must not lose any
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.push_back(std::thread([&metrics]() {
+            for (int j = 0; j < 10000; j++) {
+                metrics.increment(Metrics::BYTES_SENT, 2);
+                metrics.record(Metrics::SEND_LATENCY, j);
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    Histogram latency;
+    metrics.getHistogram(Metrics::SEND_LATENCY, latency);
+    if ((metrics.getCounter(Metrics::BYTES_SENT) == 80000)
+        && (latency.count() == 40000) && (latency.max() == 9999)) {
+        runtest.pass("Metrics::increment(threads)");
+    } else {
+        runtest.fail("Metrics::increment(threads)");
+    }
+
+    // Only the first send after an accept is the time to first byte
+    metrics.accepted(7);
+    std::uint64_t now = Metrics::now();
+    metrics.sent(7, now + 100);
+    metrics.sent(7, now + 5000);
+    metrics.accepted(8);
+    metrics.closed(8);
+    metrics.sent(8, now + 5000);
+    Histogram first;
+    metrics.getHistogram(Metrics::FIRST_BYTE, first);
+    if ((first.count() == 1) && (first.max() < 5000)
+        && (metrics.getCounter(Metrics::CONNECTIONS) == 2)
+        && (metrics.getCounter(Metrics::MESSAGES_SENT) == 3)) {
+        runtest.pass("Metrics::sent()");
+    } else {
+        runtest.fail("Metrics::sent()");
+    }
+
+    string text = metrics.dump();
+    if ((text.find("cygnal_bytes_sent_total 80000\n") != string::npos)
+        && (text.find("cygnal_send_latency_microseconds_count 40000\n") != string::npos)
+        && (text.find("cygnal_send_latency_microseconds{quantile=\"0.99\"}") != string::npos)) {
+        runtest.pass("Metrics::dump()");
+    } else {
+        runtest.fail("Metrics::dump()");
+    }
+
+    metrics.clear();
+    if (metrics.getCounter(Metrics::BYTES_SENT) == 0) {
+        runtest.pass("Metrics::clear()");
+    } else {
+        runtest.fail("Metrics::clear()");
+    }
+}
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: t
+// End:
@@ -312,6 +312,7 @@ Player::init_gui()
 
     _gui->setAudioDump(_audioDump);
     _gui->setMaxAdvances(_maxAdvances);
+    _gui->setMaxFrameSkip(RcInitFile::getDefaultInstance().getMaxFrameSkip());
 
 #ifdef GNASH_FPS_DEBUG
     if (_fpsDebugTime) {
@@ -36,6 +36,7 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <algorithm>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/lexical_cast.hpp>
@@ -92,6 +93,8 @@ DumpGui::DumpGui(unsigned long xid, float scale, bool loop, RunResources& r)
     _fileOutputFPS(0), // dump at every heart-beat by default
     _fileOutputAdvance(0),
     _lastVideoFrameDump(0), // this will be computed
+    _output(nullptr),
+    _y4m(false),
     _sleepUS(0),
     _started(false),
     _startTime(0)
@@ -106,7 +109,7 @@ DumpGui::DumpGui(unsigned long xid, float scale, bool loop, RunResources& r)
 
 DumpGui::~DumpGui()
 {
-    std::cout << "FRAMECOUNT=" << _framecount << "" << std::endl;
+    info() << "FRAMECOUNT=" << _framecount << "" << std::endl;
 }
 
 bool
@@ -203,7 +206,10 @@ DumpGui::run()
     //
     unsigned int clockAdvance = _interval;
 
-    const bool doDisplay = _fileStream.is_open();
+    const bool doDisplay = _output;
+
+    // Every frame is dumped, however long it takes to render.
+    setMaxFrameSkip(0);
 
     terminate_request = false;
 
@@ -220,11 +226,15 @@ DumpGui::run()
 
             writeSamples();
 
-            // Dump a video frame if it's time for it or no frame
-            // was dumped yet
-            size_t elapsed = _clock.elapsed();
-            if (!_framecount || 
-                    (elapsed - _lastVideoFrameDump) >= _fileOutputAdvance) {
+            // Dump the first video frame now, and then one for every
+            // _fileOutputAdvance milliseconds of movie time. Heart-beats
+            // don't come at that rate, so the current frame is written
+            // again when several are due, and none is written when
+            // none is due.
+            const unsigned long elapsed = _clock.elapsed();
+            if (!_framecount) writeFrame();
+            while (!terminate_request &&
+                    elapsed - _lastVideoFrameDump >= _fileOutputAdvance) {
                 writeFrame();
             }
 
@@ -261,8 +271,8 @@ DumpGui::run()
 
     const std::uint32_t total_time = _clock.elapsed() - _startTime;
 
-    std::cout << "TIME=" << total_time << std::endl;
-    std::cout << "FPS_ACTUAL=" << _fileOutputFPS << std::endl;
+    info() << "TIME=" << total_time << std::endl;
+    info() << "FPS_ACTUAL=" << _fileOutputFPS << std::endl;
     
     // In this Gui, quit() does not exit, but it is necessary to catch the
     // last frame for screenshots.
@@ -279,7 +289,7 @@ DumpGui::setTimeout(unsigned int timeout)
 void
 DumpGui::setInterval(unsigned int interval)
 {
-    std::cout << "INTERVAL=" << interval << std::endl;
+    info() << "INTERVAL=" << interval << std::endl;
     _interval = interval;
 }
 
@@ -293,18 +303,113 @@ DumpGui::createWindow(int width, int height)
     return true;
 }
 
+void
+DumpGui::setInvalidatedRegions(const InvalidatedRanges& ranges)
+{
+    _agg_renderer->set_invalidated_regions(ranges);
+
+    if (!_y4m) return;
+
+    for (size_t rno = 0; rno < ranges.size(); ++rno) {
+        // twips changed to pixels here
+        const geometry::Range2d<int> bounds = Intersection(
+                _agg_renderer->world_to_pixel(ranges.getRange(rno)),
+                _validbounds);
+        if (bounds.isNull()) continue;
+        _drawbounds.push_back(bounds);
+    }
+
+    // Many small regions are no cheaper to convert than the whole frame.
+    if (_drawbounds.size() > 32) {
+        _drawbounds.assign(1, _validbounds);
+    }
+}
+
 void
 DumpGui::writeFrame()
 {
-    if (!_fileStream.is_open()) return;
+    if (!_output) return;
+
+    if (_y4m) {
+        if (!_framecount) {
+            // The frame rate is given exactly, as frames are dumped every
+            // _fileOutputAdvance milliseconds of movie time (see run()).
+            *_output << "YUV4MPEG2 W" << _width << " H" << _height <<
+                " F1000:" << _fileOutputAdvance << " Ip A1:1 C420jpeg\n";
+        }
+
+        for (const geometry::Range2d<int>& bounds : _drawbounds) {
+            convertToYUV(bounds);
+        }
+        _drawbounds.clear();
 
-    _fileStream.write(reinterpret_cast<char*>(_offscreenbuf.get()),
-            _offscreenbuf_size);
+        *_output << "FRAME\n";
+        _output->write(reinterpret_cast<char*>(_yuvbuf.data()),
+                _yuvbuf.size());
+    }
+    else {
+        _output->write(reinterpret_cast<char*>(_offscreenbuf.get()),
+                _offscreenbuf_size);
+    }
+
+    if (!*_output) {
+        log_error(_("Unable to write video frame, stopping the dump"));
+        terminate_request = true;
+    }
 
-    _lastVideoFrameDump = _clock.elapsed();
+    // The time the frame was due at, not the time it was written at,
+    // so that frames don't drift from the movie time.
+    if (_framecount) _lastVideoFrameDump += _fileOutputAdvance;
+    else _lastVideoFrameDump = _clock.elapsed();
     ++_framecount;
 }
 
+void
+DumpGui::convertToYUV(const geometry::Range2d<int>& bounds)
+{
+    const int chromaWidth = (_width + 1) / 2;
+    const int chromaHeight = (_height + 1) / 2;
+
+    unsigned char* const ys = _yuvbuf.data();
+    unsigned char* const us = ys + _width * _height;
+    unsigned char* const vs = us + chromaWidth * chromaHeight;
+
+    const unsigned char* const buf = _offscreenbuf.get();
+    const int rowSize = _width * ((_bpp + 7) / 8);
+
+    // Whole 2x2 blocks are converted, so that their chroma includes
+    // all of their pixels. The pixels are BGRA, and the conversion uses
+    // the integer BT.601 coefficients.
+    const int maxX = bounds.getMaxX();
+    const int maxY = bounds.getMaxY();
+
+    for (int y = bounds.getMinY() & ~1; y <= maxY; y += 2) {
+        for (int x = bounds.getMinX() & ~1; x <= maxX; x += 2) {
+
+            int u = 0;
+            int v = 0;
+            int n = 0;
+
+            for (int py = y; py < std::min(y + 2, _height); ++py) {
+                for (int px = x; px < std::min(x + 2, _width); ++px) {
+                    const unsigned char* p = buf + py * rowSize + px * 4;
+                    const int b = p[0];
+                    const int g = p[1];
+                    const int r = p[2];
+                    ys[py * _width + px] =
+                        ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+                    u += -38 * r - 74 * g + 112 * b;
+                    v += 112 * r - 94 * g - 18 * b;
+                    ++n;
+                }
+            }
+
+            us[y / 2 * chromaWidth + x / 2] = ((u / n + 128) >> 8) + 128;
+            vs[y / 2 * chromaWidth + x / 2] = ((v / n + 128) >> 8) + 128;
+        }
+    }
+}
+
 void
 DumpGui::writeSamples()
 {
@@ -351,24 +456,44 @@ DumpGui::init_dumpfile()
         return;
     }
 
-    _fileStream.open(_fileOutput.c_str());
+    // A stream on standard output or a FIFO is always YUV4MPEG2, which
+    // needs no seeking and carries its own dimensions and frame rate.
+    const std::string::size_type len = _fileOutput.size();
+    _y4m = _fileOutput == "-" ||
+        (len > 4 && _fileOutput.compare(len - 4, 4, ".y4m") == 0);
+
+    if (_fileOutput == "-") {
+        _output = &std::cout;
+    }
+    else {
+        _fileStream.open(_fileOutput.c_str(),
+                std::ios::out | std::ios::binary | std::ios::trunc);
     
-    if (!_fileStream) {
-        log_error(_("Unable to write file '%s'."), _fileOutput);
-        std::cerr << "# FATAL:  Unable to write file '" << _fileOutput
-            << "'" << std::endl;
-        std::exit(EXIT_FAILURE);
+        if (!_fileStream) {
+            log_error(_("Unable to write file '%s'."), _fileOutput);
+            std::cerr << "# FATAL:  Unable to write file '" << _fileOutput
+                << "'" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        _output = &_fileStream;
     }
 
     // Yes, this should go to cout.  The user needs to know this
     // information in order to process the file.  Print out in a
     // format that is easy to source into shell.
-    std::cout << 
-        "# Gnash created a raw dump file with the following properties:\n" <<
-        "COLORSPACE=" << _pixelformat << "\n" <<
+    info() << 
+        "# Gnash created a " << (_y4m ? "YUV4MPEG2" : "raw") <<
+        " dump file with the following properties:\n" <<
+        "COLORSPACE=" << (_y4m ? "I420" : _pixelformat) << "\n" <<
         "NAME=" << _fileOutput << "\n";
 }
 
+std::ostream&
+DumpGui::info()
+{
+    return _output == &std::cout ? std::cerr : std::cout;
+}
+
 void
 DumpGui::setRenderHandlerSize(int width, int height)
 {
@@ -383,7 +508,7 @@ DumpGui::setRenderHandlerSize(int width, int height)
     _width = width;
     _height = height;
 
-    std::cout << "WIDTH=" << _width  << "\n" <<
+    info() << "WIDTH=" << _width  << "\n" <<
         "HEIGHT=" << _height  << std::endl;
 
     const int row_size = width * ((_bpp+7)/8);
@@ -411,6 +536,12 @@ DumpGui::setRenderHandlerSize(int width, int height)
 
     _agg_renderer->init_buffer(_offscreenbuf.get(), _offscreenbuf_size, _width,
          _height, row_size);
+
+    if (_y4m) {
+        const size_t chroma = ((_width + 1) / 2) * ((_height + 1) / 2);
+        _yuvbuf.resize(_width * _height + 2 * chroma);
+        _drawbounds.assign(1, _validbounds);
+    }
 }
 
 void 
@@ -29,6 +29,8 @@
 
 #include <string>
 #include <fstream>
+#include <ostream>
+#include <vector>
 
 namespace gnash {
     namespace sound {
@@ -64,7 +66,7 @@ class DSOEXPORT DumpGui : public Gui
     bool setupEvents() { return true; }
     void setFullscreen() { return; }
     void setInvalidatedRegion(const SWFRect& /*bounds*/) { return; }
-    void setInvalidatedRegions(const InvalidatedRanges& /*ranges*/) { return; }
+    void setInvalidatedRegions(const InvalidatedRanges& ranges);
     void setCursor(gnash_cursor_type /*newcursor*/) { return; }
     void setRenderHandlerSize(int width, int height);
     void unsetFullscreen() { return; }
@@ -99,8 +101,29 @@ private:
     unsigned int _fileOutputAdvance;   /* ms of time between video dump frms */
     unsigned long _lastVideoFrameDump; /* time of last video frame dump */
     std::ofstream _fileStream;         /* stream for output file */
+    std::ostream* _output;             /* _fileStream, or std::cout for "-" */
     void init_dumpfile();               /* convenience method to create dump file */
 
+    /// Where to print information about the dump.
+    //
+    /// This is std::cout, unless the video goes there.
+    std::ostream& info();
+
+    /// Whether video is written as a YUV4MPEG2 stream, for "-" and .y4m
+    /// files, rather than as raw frames.
+    bool _y4m;
+
+    /// Convert the pixels in bounds from the offscreen buffer to _yuvbuf.
+    void convertToYUV(const geometry::Range2d<int>& bounds);
+
+    /// The last YUV 4:2:0 frame, in planar order.
+    std::vector<unsigned char> _yuvbuf;
+
+    /// The pixels rendered again since the last frame was written.
+    //
+    /// Only these are converted to YUV before the next frame.
+    std::vector<geometry::Range2d<int> > _drawbounds;
+
     std::shared_ptr<sound::sound_handler> _soundHandler;
 
     ManualClock _clock;
@@ -0,0 +1,71 @@
+#!/bin/sh
+#
+#   Copyright (C) 2012 Free Software Foundation, Inc.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+# Checks that the YUV4MPEG2 stream written by dump-gnash has as many
+# frames as the rate in its header gives for the time dumped, when the
+# requested rate is not the rate of the movie.
+
+testsuite=${srcdir:-.}/../testsuite
+out=dump_rate_test.y4m
+status=0
+
+# Dump a movie for 2 seconds at the given rate.
+check_rate()
+{
+    movie=$1
+    fps=$2
+
+    rm -f $out
+    info=`./dump-gnash -D $out@$fps -t 2 $movie 2>/dev/null`
+    if test ! -s $out; then
+        echo "FAILED: no stream dumped from $movie at $fps fps"
+        status=1
+        return
+    fi
+
+    header=`head -n 1 $out`
+    width=`echo "$header" | sed -n 's/.* W\([0-9]*\) .*/\1/p'`
+    height=`echo "$header" | sed -n 's/.* H\([0-9]*\) .*/\1/p'`
+    advance=`echo "$header" | sed -n 's/.* F1000:\([0-9]*\) .*/\1/p'`
+    time=`echo "$info" | sed -n 's/^TIME=//p'`
+    interval=`echo "$info" | sed -n 's/^INTERVAL=//p' | tail -n 1`
+
+    # Each frame is a FRAME line and a 4:2:0 picture.
+    size=`wc -c < $out`
+    framesize=`expr 6 + $width \* $height + 2 \* \( \( $width + 1 \) / 2 \) \* \( \( $height + 1 \) / 2 \)`
+    frames=`expr \( $size - ${#header} - 1 \) / $framesize`
+
+    # The first frame is written at the first heart-beat, and then one
+    # every $advance milliseconds.
+    expected=`expr \( $time - $interval \) / $advance + 1`
+    if test $frames -lt `expr $expected - 1` -o \
+            $frames -gt `expr $expected + 1`; then
+        echo "FAILED: $movie at $fps fps: $frames frames in $time ms," \
+             "expected $expected at F1000:$advance"
+        status=1
+    else
+        echo "PASSED: $movie at $fps fps: $frames frames in $time ms"
+    fi
+}
+
+# Faster and slower than the movie.
+check_rate $testsuite/media/red.swf 30
+check_rate $testsuite/samples/car_smash.swf 25
+
+rm -f $out
+exit $status
@@ -308,7 +308,7 @@ getDebuggingOptions(gnash::Player& p)
 #ifdef GNASH_FPS_DEBUG
     ("debug-fps,f", po::value<float>()
         ->notifier(std::bind(&Player::setFpsPrintTime, &p, std::placeholders::_1)),
-        _("Print FPS every num seconds"))
+        _("Print FPS, heart-beat jitter and render time every num seconds"))
 #endif 
 
     ;
@@ -41,6 +41,7 @@
 
 #ifdef GNASH_FPS_DEBUG
 #include "ClockTime.h"
+#include <iostream>
 #include <boost/format.hpp>
 #endif
 
@@ -99,6 +100,7 @@ Gui::Gui(RunResources& r) :
     _mouseShown(true),
     _maxAdvances(0),
     _advances(0),
+    _maxFrameSkip(0),
     _xscale(1.0f),
     _yscale(1.0f),
     _xoffset(0),
@@ -109,6 +111,13 @@ Gui::Gui(RunResources& r) :
     ,fps_timer(0)
     ,fps_timer_interval(0.0)
     ,frames_dropped(0)
+    ,fps_last_beat(0)
+    ,fps_beats(0)
+    ,fps_jitter_total(0)
+    ,fps_jitter_max(0)
+    ,fps_renders(0)
+    ,fps_render_total(0)
+    ,fps_render_max(0)
 #endif
     ,_movieDef(nullptr)
     ,_stage(nullptr)
@@ -143,6 +152,7 @@ Gui::Gui(unsigned long xid, float scale, bool loop, RunResources& r)
     _mouseShown(true),
     _maxAdvances(0),
     _advances(0),
+    _maxFrameSkip(0),
     _xscale(scale),
     _yscale(scale),
     _xoffset(0), // TODO: x and y offset will need update !
@@ -153,6 +163,13 @@ Gui::Gui(unsigned long xid, float scale, bool loop, RunResources& r)
     ,fps_timer(0)
     ,fps_timer_interval(0.0)
     ,frames_dropped(0)
+    ,fps_last_beat(0)
+    ,fps_beats(0)
+    ,fps_jitter_total(0)
+    ,fps_jitter_max(0)
+    ,fps_renders(0)
+    ,fps_render_total(0)
+    ,fps_render_max(0)
 #endif        
     ,_movieDef(nullptr)
     ,_stage(nullptr)
@@ -761,6 +778,10 @@ Gui::display(movie_root* m)
         // less verbose, and often necessary: see the exact coordinates of the
         // invalidated bounds (mainly to see if it's NULL or something else).	
         std::cout << "Calculated changed ranges: " << changed_ranges << "\n";
+
+        // how many characters were looked at to find them.
+        std::cout << "Characters visited: " << m->invalidatedBoundsVisited()
+                  << ", skipped: " << m->invalidatedBoundsSkipped() << "\n";
     }
 #endif
     
@@ -964,14 +985,62 @@ Gui::advanceMovie(bool doDisplay)
 #endif
     
 #ifdef GNASH_FPS_DEBUG
+    if (fps_timer_interval) {
+        const std::uint64_t now = clocktime::getTicks();
+        if (fps_last_beat) {
+            const std::uint64_t beat = now - fps_last_beat;
+            const std::uint64_t jitter =
+                beat > _interval ? beat - _interval : _interval - beat;
+            ++fps_beats;
+            fps_jitter_total += jitter;
+            fps_jitter_max = std::max(fps_jitter_max, jitter);
+        }
+        fps_last_beat = now;
+    }
+
     // will be a no-op if fps_timer_interval is zero
     if (advanced) {
         fpsCounterTick();
     }
 #endif
+
+    // When heart-beats are late, as when rendering takes longer than the
+    // frame rate allows, the next frame may be due already. It is then
+    // advanced without rendering this one, so that the movie keeps to
+    // its frame rate. Screenshots are of given frames, so none is skipped
+    // for them, and skipped frames count towards the advance limit.
+    size_t skipped = 0;
+    while (advanced && skipped < _maxFrameSkip && !_screenShotter.get() &&
+            (!_maxAdvances || _advances + skipped < _maxAdvances) &&
+            m->timeToNextFrame() <= 0) {
+
+        // Don't skip past the end of a movie that doesn't loop.
+        const MovieClip& root = m->getRootMovie();
+        if (!loops() &&
+                root.get_current_frame() + 1 >= root.get_frame_count()) {
+            break;
+        }
+
+        if (!m->advance()) break;
+        ++skipped;
+
+#ifdef GNASH_FPS_DEBUG
+        ++frames_dropped;
+        fpsCounterTick();
+#endif
+    }
     
     if (doDisplay && visible()) {
+#ifdef GNASH_FPS_DEBUG
+        const std::uint64_t start = clocktime::getTicks();
         display(m);
+        const std::uint64_t spent = clocktime::getTicks() - start;
+        ++fps_renders;
+        fps_render_total += spent;
+        fps_render_max = std::max(fps_render_max, spent);
+#else
+        display(m);
+#endif
     }
     
     if (!loops()) {
@@ -994,7 +1063,7 @@ Gui::advanceMovie(bool doDisplay)
         if (_maxAdvances && (_advances > _maxAdvances)) {
             quit();
         }
-        ++_advances;
+        _advances += 1 + skipped;
     }
 
 	return advanced;
@@ -1228,9 +1297,22 @@ Gui::fpsCounterTick()
                                fps_rate_min % avg % fps_rate_max %
                                fps_counter_total % secs_total %
                                frames_dropped << std::endl;
+
+    std::cerr << boost::format("Heart-beat jitter: avg %0.1f ms, max %u ms; "
+                               "render time: avg %0.1f ms, max %u ms") %
+        (fps_beats ? float(fps_jitter_total) / fps_beats : 0.0f) %
+        fps_jitter_max %
+        (fps_renders ? float(fps_render_total) / fps_renders : 0.0f) %
+        fps_render_max << std::endl;
       
     fps_counter = 0;
     fps_timer = current_timer;
+    fps_beats = 0;
+    fps_jitter_total = 0;
+    fps_jitter_max = 0;
+    fps_renders = 0;
+    fps_render_total = 0;
+    fps_render_max = 0;
     
   }
    
@@ -350,6 +350,12 @@ public:
 
     /// Set the maximum number of frame advances before Gnash exits.
     void setMaxAdvances(unsigned long ul) { if (ul) _maxAdvances = ul; }
+
+    /// Set the most frames in a row not rendered to keep to the frame rate.
+    //
+    /// 0 renders every frame, and the movie slows down when rendering
+    /// takes longer than the frame rate allows.
+    void setMaxFrameSkip(unsigned int n) { _maxFrameSkip = n; }
     
     void showUpdatedRegions(bool x) { _showUpdatedRegions = x; }
     bool showUpdatedRegions() const { return _showUpdatedRegions; }
@@ -521,6 +527,9 @@ protected:
     /// Counter to keep track of frame advances
     unsigned long _advances;
 
+    /// Most frames in a row advanced without rendering when late.
+    unsigned int _maxFrameSkip;
+
     /// Name of a file to dump audio to
     std::string _audioDump;
 
@@ -573,6 +582,19 @@ private:
     /// Number of frames rendering of which was dropped
     unsigned int frames_dropped;
 
+    /// Time of the last heart-beat, or 0 before the first one.
+    std::uint64_t fps_last_beat;
+
+    /// Heart-beats since the last print, and the total and largest
+    /// difference, in milliseconds, between their interval and _interval.
+    unsigned int fps_beats;
+    std::uint64_t fps_jitter_total, fps_jitter_max;
+
+    /// Frames rendered since the last print, and the total and largest
+    /// time, in milliseconds, spent rendering them.
+    unsigned int fps_renders;
+    std::uint64_t fps_render_total, fps_render_max;
+
     /// \brief
     /// Should be called on every frame advance (including inter-frames caused
     /// by mouse events).
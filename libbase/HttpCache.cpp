@@ -0,0 +1,380 @@
+// HttpCache.cpp:  Persistent cache of HTTP responses, for Gnash.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include "HttpCache.h"
+
+#include <memory>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <fcntl.h>
+#include <utime.h>
+
+#include "GnashFileUtilities.h"
+#include "StringPredicates.h"
+#include "rc.h"
+#include "log.h"
+
+namespace gnash {
+
+namespace {
+
+/// The first line of every cache file, to change when the format does.
+const char* const magic = "GnashHttpCache 1";
+
+/// The suffix of cache files.
+const char* const suffix = ".cache";
+
+/// The prefix of files being written.
+const char* const tmpPrefix = ".tmp-";
+
+/// Files being written for longer than this, in seconds, were left by
+/// processes that died and are removed.
+const std::time_t tmpTimeout = 3600;
+
+/// Expiry heuristics don't make responses fresh for longer than this.
+const std::time_t maxHeuristicLifetime = 24 * 3600;
+
+/// Read a line without its newline. False at end of file.
+bool
+readLine(FILE* f, std::string& line)
+{
+    line.clear();
+    int c;
+    while ((c = std::getc(f)) != EOF && c != '\n') {
+        // Nothing valid is this long.
+        if (line.size() > 65536) return false;
+        line += static_cast<char>(c);
+    }
+    return c == '\n';
+}
+
+/// 64-bit FNV-1a hash.
+std::uint64_t
+hash(const std::string& s)
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool
+endsWith(const std::string& s, const std::string& end)
+{
+    return s.size() >= end.size() &&
+        s.compare(s.size() - end.size(), end.size(), end) == 0;
+}
+
+/// Parse the header of a cache file, leaving it at the start of the body.
+bool
+readEntry(FILE* f, HttpCache::Entry& entry)
+{
+    std::string line;
+    if (!readLine(f, line) || line != magic) return false;
+
+    while (readLine(f, line)) {
+        if (line.empty()) return true;
+
+        const std::string::size_type space = line.find(' ');
+        const std::string key = line.substr(0, space);
+        const std::string value = space == std::string::npos ?
+            std::string() : line.substr(space + 1);
+
+        if (key == "url") entry.url = value;
+        else if (key == "etag") entry.etag = value;
+        else if (key == "lastModified") entry.lastModified = value;
+        else if (key == "expires") {
+            entry.expires = std::strtoll(value.c_str(), nullptr, 10);
+        }
+        else if (key == "size") {
+            entry.size = std::strtoull(value.c_str(), nullptr, 10);
+        }
+    }
+    return false;
+}
+
+/// A cache file found when evicting.
+struct CacheFile
+{
+    std::string path;
+    std::uint64_t size;
+    std::time_t used;
+};
+
+}
+
+HttpCache::HttpCache(const std::string& dir, std::uint64_t maxSize)
+    :
+    _dir(dir),
+    _maxSize(maxSize)
+{
+}
+
+HttpCache*
+HttpCache::getDefaultInstance()
+{
+    static std::unique_ptr<HttpCache> cache;
+    static bool initialized = false;
+
+    // Only the first call creates the cache, but it may be made by
+    // several loading threads at once.
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (initialized) return cache.get();
+    initialized = true;
+
+    const RcInitFile& rcfile = RcInitFile::getDefaultInstance();
+    const std::string& dir = rcfile.getHttpCacheDir();
+    if (dir.empty()) return nullptr;
+
+    if (!mkdirRecursive(dir + "/")) {
+        log_error(_("Could not create HTTP cache directory %s: %s"),
+                dir, std::strerror(errno));
+        return nullptr;
+    }
+
+    cache.reset(new HttpCache(dir,
+                std::uint64_t(rcfile.getHttpCacheSize()) * 1024 * 1024));
+    return cache.get();
+}
+
+std::string
+HttpCache::path(const std::string& url) const
+{
+    char name[17];
+    std::snprintf(name, sizeof name, "%016llx",
+            static_cast<unsigned long long>(hash(url)));
+    return _dir + "/" + name + suffix;
+}
+
+FILE*
+HttpCache::open(const std::string& url, Entry& entry) const
+{
+    const std::string file = path(url);
+
+    FILE* f = std::fopen(file.c_str(), "rb");
+    if (!f) return nullptr;
+
+    entry = Entry();
+
+    // A different URL with the same hash, or a file that is truncated
+    // or corrupted, is a miss. It will be replaced when stored.
+    struct stat st;
+    if (!readEntry(f, entry) || entry.url != url ||
+            fstat(fileno(f), &st) != 0 ||
+            std::uint64_t(st.st_size - std::ftell(f)) != entry.size) {
+        std::fclose(f);
+        return nullptr;
+    }
+
+    // Mark as recently used for eviction.
+    utime(file.c_str(), nullptr);
+
+    return f;
+}
+
+bool
+HttpCache::store(Entry entry, FILE* body)
+{
+    const long pos = std::ftell(body);
+    if (std::fseek(body, 0, SEEK_END) != 0) return false;
+    entry.size = std::ftell(body);
+
+    // Don't throw away the whole cache for one response.
+    if (entry.size > _maxSize / 2) {
+        std::fseek(body, pos, SEEK_SET);
+        remove(entry.url);
+        return false;
+    }
+
+    static std::atomic<unsigned int> counter(0);
+    std::ostringstream tmp;
+    tmp << _dir << "/" << tmpPrefix << getpid() << "-" << counter++;
+    const std::string tmpPath = tmp.str();
+
+    FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) {
+        std::fseek(body, pos, SEEK_SET);
+        log_error(_("Could not write to HTTP cache %s: %s"), _dir,
+                std::strerror(errno));
+        return false;
+    }
+
+    std::fprintf(f, "%s\nurl %s\netag %s\nlastModified %s\n"
+            "expires %lld\nsize %llu\n\n", magic, entry.url.c_str(),
+            entry.etag.c_str(), entry.lastModified.c_str(),
+            static_cast<long long>(entry.expires),
+            static_cast<unsigned long long>(entry.size));
+
+    std::fseek(body, 0, SEEK_SET);
+    std::vector<char> buf(64 * 1024);
+    std::uint64_t copied = 0;
+    size_t got;
+    while ((got = std::fread(&buf[0], 1, buf.size(), body)) > 0) {
+        if (std::fwrite(&buf[0], 1, got, f) != got) break;
+        copied += got;
+    }
+    std::fseek(body, pos, SEEK_SET);
+
+    const bool ok = copied == entry.size && !std::ferror(f);
+    if (std::fclose(f) != 0 || !ok ||
+            std::rename(tmpPath.c_str(), path(entry.url).c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    evict();
+    return true;
+}
+
+void
+HttpCache::remove(const std::string& url)
+{
+    std::remove(path(url).c_str());
+}
+
+void
+HttpCache::evict()
+{
+    // Processes evicting at once would each remove files to make room,
+    // removing more than needed.
+    const std::string lockPath = _dir + "/.lock";
+    const int lockfd = ::open(lockPath.c_str(), O_RDWR | O_CREAT, 0600);
+    if (lockfd < 0) return;
+
+    struct flock fl;
+    std::memset(&fl, 0, sizeof fl);
+    fl.l_type = F_WRLCK;
+    fl.l_whence = SEEK_SET;
+    if (fcntl(lockfd, F_SETLKW, &fl) != 0) {
+        ::close(lockfd);
+        return;
+    }
+
+    DIR* dir = opendir(_dir.c_str());
+    if (!dir) {
+        ::close(lockfd);
+        return;
+    }
+
+    const std::time_t now = std::time(nullptr);
+    std::vector<CacheFile> files;
+    std::uint64_t total = 0;
+
+    while (struct dirent* ent = readdir(dir)) {
+        const std::string name = ent->d_name;
+        const std::string file = _dir + "/" + name;
+
+        struct stat st;
+        if (stat(file.c_str(), &st) != 0) continue;
+
+        if (name.compare(0, std::strlen(tmpPrefix), tmpPrefix) == 0) {
+            if (now - st.st_mtime > tmpTimeout) std::remove(file.c_str());
+            continue;
+        }
+        if (!endsWith(name, suffix)) continue;
+
+        const CacheFile f = { file, std::uint64_t(st.st_size), st.st_mtime };
+        files.push_back(f);
+        total += f.size;
+    }
+    closedir(dir);
+
+    if (total > _maxSize) {
+        std::sort(files.begin(), files.end(),
+                [](const CacheFile& a, const CacheFile& b) {
+                    return a.used < b.used;
+                });
+        for (const CacheFile& f : files) {
+            if (total <= _maxSize) break;
+            if (std::remove(f.path.c_str()) == 0) total -= f.size;
+        }
+    }
+
+    // Closing releases the lock.
+    ::close(lockfd);
+}
+
+bool
+HttpCache::cacheable(const Headers& headers, std::time_t now, Entry& entry)
+{
+    // The request headers a response varies on aren't known here.
+    if (headers.vary) return false;
+
+    StringNoCaseEqual noCaseCompare;
+    bool noCache = false;
+    long maxAge = -1;
+
+    std::istringstream directives(headers.cacheControl);
+    std::string directive;
+    while (std::getline(directives, directive, ',')) {
+        directive.erase(std::remove_if(directive.begin(), directive.end(),
+                    [](char c) { return std::isspace(c); }), directive.end());
+
+        if (noCaseCompare(directive, "no-store")) return false;
+        if (noCaseCompare(directive, "no-cache")) noCache = true;
+        else if (noCaseCompare(directive.substr(0, 8), "max-age=")) {
+            maxAge = std::strtol(directive.c_str() + 8, nullptr, 10);
+        }
+    }
+
+    const std::time_t date = headers.date == -1 ? now : headers.date;
+
+    std::time_t lifetime = 0;
+    if (noCache) lifetime = 0;
+    else if (maxAge >= 0) lifetime = maxAge;
+    else if (headers.expires != -1) lifetime = headers.expires - date;
+    else if (headers.lastModified != -1) {
+        // Files that haven't changed for a long time are unlikely
+        // to change soon.
+        lifetime = std::min((date - headers.lastModified) / 10,
+                maxHeuristicLifetime);
+    }
+
+    lifetime -= headers.age;
+    if (lifetime < 0) lifetime = 0;
+
+    if (!headers.etag.empty()) entry.etag = headers.etag;
+    if (!headers.lastModifiedText.empty()) {
+        entry.lastModified = headers.lastModifiedText;
+    }
+    entry.expires = now + lifetime;
+
+    return lifetime > 0 || entry.revalidatable();
+}
+
+} // namespace gnash
+
+// Local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -0,0 +1,169 @@
+// HttpCache.h:  Persistent cache of HTTP responses, for Gnash.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#ifndef GNASH_HTTPCACHE_H
+#define GNASH_HTTPCACHE_H
+
+#include "dsodefs.h" // for DSOEXPORT
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <ctime>
+
+namespace gnash {
+
+/// A directory of HTTP responses kept across runs.
+//
+/// Each response is kept in one file, named after a hash of its URL,
+/// holding the validators and expiry time of the response followed
+/// by its body. Files are written under a temporary name and renamed,
+/// so several processes can share the directory: readers always see
+/// a complete response, and an open response stays readable when it
+/// is replaced or removed.
+///
+/// The least recently used responses are removed when the directory
+/// grows over its maximum size. Using a response updates the time of
+/// its file, so that this is shared by all processes too.
+///
+class DSOEXPORT HttpCache
+{
+public:
+
+    /// The information kept with a response body.
+    struct Entry
+    {
+        Entry() : expires(0), size(0) {}
+
+        std::string url;
+
+        /// The ETag header, empty if there was none.
+        std::string etag;
+
+        /// The Last-Modified header, empty if there was none.
+        std::string lastModified;
+
+        /// The time after which the response is stale.
+        std::time_t expires;
+
+        /// The size of the body.
+        std::uint64_t size;
+
+        /// Whether the response can be used without asking the server.
+        bool fresh(std::time_t now) const {
+            return now < expires;
+        }
+
+        /// Whether a stale response can be validated by the server.
+        bool revalidatable() const {
+            return !etag.empty() || !lastModified.empty();
+        }
+    };
+
+    /// The response headers deciding whether and how long to cache.
+    struct Headers
+    {
+        Headers() : date(-1), expires(-1), lastModified(-1), age(0),
+                    vary(false) {}
+
+        std::string cacheControl;
+
+        std::string etag;
+
+        /// The Last-Modified header as sent.
+        std::string lastModifiedText;
+
+        /// The Date, Expires and Last-Modified times, -1 if absent
+        /// or invalid.
+        std::time_t date;
+        std::time_t expires;
+        std::time_t lastModified;
+
+        /// The Age header, in seconds.
+        long age;
+
+        /// Whether there was a Vary header.
+        bool vary;
+    };
+
+    /// Use a cache directory.
+    //
+    /// @param dir      The directory to keep responses in, which must
+    ///                 exist.
+    /// @param maxSize  The size in bytes over which responses are removed.
+    HttpCache(const std::string& dir, std::uint64_t maxSize);
+
+    /// The cache configured in gnashrc, or 0 if there is none.
+    static HttpCache* getDefaultInstance();
+
+    /// Open the cached body of a URL.
+    //
+    /// @param url      The URL of the response.
+    /// @param entry    Set to the information about the response.
+    /// @return         The body, to be closed by the caller, positioned
+    ///                 at its start. 0 if the URL isn't cached.
+    FILE* open(const std::string& url, Entry& entry) const;
+
+    /// Cache a response, replacing any previous one for its URL.
+    //
+    /// Responses are removed if the cache is now too large.
+    //
+    /// @param entry    The information about the response. Its size is
+    ///                 set from the body.
+    /// @param body     The body to copy from its start. Its position is
+    ///                 kept.
+    /// @return         Whether the response was cached.
+    bool store(Entry entry, FILE* body);
+
+    /// Remove the cached response for a URL, if any.
+    void remove(const std::string& url);
+
+    /// Remove the least recently used responses until the cache isn't
+    /// larger than its maximum size.
+    void evict();
+
+    /// Decide whether to cache a response, and until when.
+    //
+    /// @param headers  The headers of the response.
+    /// @param now      The time the response was received.
+    /// @param entry    The entry to update. Validators are only changed
+    ///                 when the headers have them, so that the entry of
+    ///                 a validated response can be updated.
+    /// @return         False if the response must not be cached.
+    static bool cacheable(const Headers& headers, std::time_t now,
+            Entry& entry);
+
+private:
+
+    /// The path of the file for a URL.
+    std::string path(const std::string& url) const;
+
+    const std::string _dir;
+
+    const std::uint64_t _maxSize;
+};
+
+} // namespace gnash
+
+#endif
+
+// Local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
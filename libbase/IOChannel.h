@@ -89,6 +89,31 @@ public:
         return read(dst, num);
     }
 
+    /// Get the given number of bytes without copying them
+    //
+    /// Channels keeping their whole input in memory return the bytes
+    /// at the current position and advance past them, as read() would.
+    /// The bytes stay valid as long as the channel.
+    ///
+    /// @param num  The number of bytes wanted. On return, the number
+    ///             of bytes available, which is less at EOF.
+    ///
+    /// @return The bytes, or 0 if the channel can't give them in place,
+    ///         in which case nothing is read.
+    ///
+    /// Default implementation returns 0.
+    ///
+    virtual const std::uint8_t* view(std::streamsize& /*num*/)
+    {
+        return nullptr;
+    }
+
+    /// Hint that the given bytes will be read soon
+    //
+    /// Default implementation does nothing.
+    ///
+    virtual void prefetch(std::streampos /*pos*/, std::streamsize /*num*/) {}
+
     /// Write the given number of bytes to the stream
     //
     /// Throw IOException on error/unsupported op.
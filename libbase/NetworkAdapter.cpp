@@ -80,15 +80,27 @@ extern "C" {
 #include "utility.h"
 #include "GnashException.h"
 #include "rc.h"
+#include "HttpCache.h"
+#include "StringPredicates.h"
 #include "GnashSystemFDHeaders.h"
 
 #include <map>
+#include <set>
 #include <string>
 #include <sstream>
 #include <cerrno>
 #include <cstdio> // cached data uses a *FILE
 #include <cstdlib> // std::getenv
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <cctype>
 
 #include <boost/format.hpp>
 
@@ -373,12 +385,203 @@ CurlSession::unlockSharedHandle(CURL* handle, curl_lock_data data)
 }
 
 
+/***********************************************************************
+ *
+ *  ByteRing definition and implementation
+ *
+ **********************************************************************/
+
+/// A ring buffer passing bytes from one thread to another.
+//
+/// One thread only pushes bytes and the other only pops them, so
+/// the two positions are all the state they share and no lock is
+/// needed.
+///
+class ByteRing {
+
+public:
+
+    explicit ByteRing(size_t capacity)
+        :
+        _buffer(capacity),
+        _head(0),
+        _tail(0)
+    {}
+
+    /// Append bytes, all of them or none if there isn't enough room.
+    //
+    /// Only called by the producer thread.
+    ///
+    bool push(const char* from, size_t size);
+
+    /// Write all available bytes to the end of a file.
+    //
+    /// Only called by the consumer thread.
+    ///
+    /// @return the number of bytes popped.
+    ///
+    size_t popTo(FILE* to);
+
+    /// Only called by the consumer thread.
+    bool empty() const {
+        return _head.load(std::memory_order_acquire) ==
+            _tail.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    std::vector<char> _buffer;
+
+    // Total bytes ever pushed, only written by the producer
+    std::atomic<size_t> _head;
+
+    // Total bytes ever popped, only written by the consumer
+    std::atomic<size_t> _tail;
+};
+
+bool
+ByteRing::push(const char* from, size_t size)
+{
+    const size_t head = _head.load(std::memory_order_relaxed);
+    const size_t tail = _tail.load(std::memory_order_acquire);
+    const size_t capacity = _buffer.size();
+
+    if (capacity - (head - tail) < size) return false;
+
+    const size_t pos = head % capacity;
+    const size_t first = std::min(size, capacity - pos);
+    std::copy(from, from + first, _buffer.begin() + pos);
+    std::copy(from + first, from + size, _buffer.begin());
+
+    _head.store(head + size, std::memory_order_release);
+    return true;
+}
+
+size_t
+ByteRing::popTo(FILE* to)
+{
+    const size_t head = _head.load(std::memory_order_acquire);
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    const size_t capacity = _buffer.size();
+    const size_t size = head - tail;
+
+    if (!size) return 0;
+
+    const size_t pos = tail % capacity;
+    const size_t first = std::min(size, capacity - pos);
+    size_t wrote = std::fwrite(&_buffer[pos], 1, first, to);
+    if (wrote == first && first < size) {
+        wrote += std::fwrite(&_buffer[0], 1, size - first, to);
+    }
+
+    if (wrote < size) {
+        boost::format fmt = boost::format("writing to cache file: requested "
+                                          "%d, wrote %d (%s)") %
+                                          size % wrote % std::strerror(errno);
+        throw GnashException(fmt.str());
+    }
+
+    _tail.store(head, std::memory_order_release);
+    return size;
+}
+
+
+/***********************************************************************
+ *
+ *  CurlReactor definition
+ *
+ **********************************************************************/
+
+class CurlStreamFile;
+
+/// The thread running the transfers of all CurlStreamFiles.
+//
+/// All transfers are added to a single libcurl multi handle, so that
+/// connections are kept alive and reused by later transfers to the
+/// same host, and HTTP/2 transfers to a host share a connection when
+/// libcurl supports it. Received data is passed to each stream through
+/// its ByteRing, so readers only wait for data and never drive libcurl
+/// themselves.
+///
+/// Easy handles are only touched by the reactor thread while they are
+/// added to the multi handle, so all changes go through commands.
+///
+class CurlReactor {
+
+public:
+
+    /// Get CurlReactor singleton, starting its thread
+    static CurlReactor& get();
+
+    /// Start the transfer of a CurlStreamFile
+    //
+    /// The handle's CURLOPT_PRIVATE must point to the stream.
+    ///
+    void add(CURL* handle) { command(handle, ADD); }
+
+    /// Stop a transfer, returning when the reactor is done with it
+    void remove(CURL* handle);
+
+    /// Resume a transfer paused because its ByteRing was full
+    void resume(CURL* handle) { command(handle, RESUME); }
+
+private:
+
+    enum Operation {
+        ADD,
+        REMOVE,
+        RESUME
+    };
+
+    struct Command {
+        CURL* handle;
+        Operation op;
+        bool* done;
+    };
+
+    CurlReactor();
+
+    ~CurlReactor();
+
+    /// Queue a command and wake up the reactor thread
+    void command(CURL* handle, Operation op, bool* done = nullptr);
+
+    /// The reactor thread
+    void run();
+
+    /// Process messages of completed transfers
+    void processMessages();
+
+    // the libcurl multi handle, only used by the reactor thread
+    CURLM* _mhandle;
+
+    // the handles in the multi handle, only used by the reactor thread
+    std::set<CURL*> _transfers;
+
+    // mutex protecting _commands and _stop
+    std::mutex _mutex;
+
+    // notified when commands are queued or completed
+    std::condition_variable _wakeup;
+
+    std::vector<Command> _commands;
+
+    bool _stop;
+
+    std::thread _thread;
+};
+
+
 /***********************************************************************
  *
  *  CurlStreamFile definition
  *
  **********************************************************************/
 
+// Bytes received for a stream and not read yet before its transfer is
+// paused. This is larger than libcurl ever passes at once.
+const size_t receiveBufferSize = 256 * 1024;
+
 /// libcurl based IOChannel, for network uri accesses
 class CurlStreamFile : public IOChannel
 {
@@ -443,8 +646,26 @@ public:
 
 private:
 
+    friend class CurlReactor;
+
     void init(const std::string& url, const std::string& cachefile);
 
+    /// Look up the URL in the HTTP cache, for a GET request
+    //
+    /// A stale response with validators is kept to be used if the
+    /// server doesn't send a new one.
+    ///
+    /// @return true if the response was fresh and the stream was
+    ///         filled from it, so there is nothing to transfer.
+    ///
+    bool useHttpCache();
+
+    /// Use or store the response in the HTTP cache, once received.
+    //
+    /// @return the number of bytes added to the cache file.
+    ///
+    std::streamsize finishHttpCache();
+
     // Use this file to cache data
     FILE* _cache;
 
@@ -459,54 +680,298 @@ private:
     // the libcurl easy handle
     CURL *_handle;
 
-    // the libcurl multi handle
-    CURLM *_mhandle;
-
-    // transfer in progress
-    int _running;
+    // transfer in progress, cleared by the reactor thread
+    std::atomic<bool> _running;
 
     // stream error
     // false on no error.
     // Example of errors would be:
     //    404 - file not found
     //    timeout occurred
-    bool _error;
+    std::atomic<bool> _error;
+
+    // Data received by the reactor thread and not yet cached
+    ByteRing _received;
+
+    // Set by the reactor thread when _received was full
+    std::atomic<bool> _paused;
+
+    // Protects nothing, only used to wait for the reactor thread
+    std::mutex _mutex;
+
+    // Notified by the reactor thread on data, pause or completion
+    std::condition_variable _wakeup;
 
     // Post data. Empty if no POST has been requested
     std::string _postdata;
 
+    // Where to store the response, 0 if not to be stored or once done
+    HttpCache* _httpCache;
+
+    // The stale cached response being revalidated, if any
+    HttpCache::Entry _httpCacheEntry;
+
+    // The body of the response being revalidated, or 0
+    FILE* _httpCacheBody;
+
+    // Whether the stream was filled from the HTTP cache, without any
+    // transfer
+    bool _fromHttpCache;
+
+    // Status and headers of the last response, set by the reactor thread
+    long _status;
+    HttpCache::Headers _headers;
+
     // Current size of cached data
     std::streampos _cached;
 
     /// Total stream size.
     //
-    /// This will be 0 until known
+    /// This will be 0 until known, set by the reactor thread.
     ///
-    mutable size_t _size;
+    std::atomic<size_t> _size;
 
     // Attempt at filling the cache up to the given size.
-    // Will call libcurl routines to fetch data.
+    // Will wait for the reactor thread to receive data.
     void fillCache(std::streampos size);
 
-    // Process pending curl messages (handles 404)
-    void processMessages();
-
     // Filling the cache as much as possible w/out blocking.
-    // Will call libcurl routines to fetch data.
+    // Only moves data already received to the cache.
     void fillCacheNonBlocking();
 
-    // Append sz bytes to the cache
-    std::streamsize cache(void *from, std::streamsize sz);
+    // Move received data to the cache, resuming a paused transfer
+    std::streamsize cache();
+
+    // Wake up a reader waiting in fillCache, from the reactor thread
+    void notify();
+
+    // Note the end of the transfer, from the reactor thread
+    void complete(bool error);
 
     // Callback for libcurl, will be called
-    // by fillCache() and will call cache()
+    // by the reactor thread and will push to _received
     static size_t recv(void *buf, size_t size, size_t nmemb, void *userp);
 
+    // Callback for libcurl, will be called by the reactor
+    // thread with each header line of the responses
+    static size_t recvHeader(char *buf, size_t size, size_t nitems,
+            void *userp);
+
     // List of custom headers for this stream.
     struct curl_slist *_customHeaders;
 };
 
 
+/***********************************************************************
+ *
+ *  CurlReactor implementation
+ *
+ **********************************************************************/
+
+CurlReactor&
+CurlReactor::get()
+{
+    static CurlReactor reactor;
+    return reactor;
+}
+
+CurlReactor::CurlReactor()
+    :
+    _mhandle(nullptr),
+    _stop(false)
+{
+    // Make sure libcurl is initialized, and stays so until we're gone
+    CurlSession::get();
+
+    _mhandle = curl_multi_init();
+    if (!_mhandle) {
+        throw GnashException("Failure initializing curl multi handle");
+    }
+
+#ifdef CURLPIPE_MULTIPLEX
+    // Let HTTP/2 transfers to the same host share a connection
+    curl_multi_setopt(_mhandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+
+    _thread = std::thread(&CurlReactor::run, this);
+}
+
+CurlReactor::~CurlReactor()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_wakeup(_mhandle);
+#endif
+    _wakeup.notify_all();
+    _thread.join();
+
+    curl_multi_cleanup(_mhandle);
+}
+
+void
+CurlReactor::command(CURL* handle, Operation op, bool* done)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const Command c = { handle, op, done };
+        _commands.push_back(c);
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_wakeup(_mhandle);
+#endif
+    _wakeup.notify_all();
+}
+
+void
+CurlReactor::remove(CURL* handle)
+{
+    bool done = false;
+    command(handle, REMOVE, &done);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _wakeup.wait(lock, [&done] { return done; });
+}
+
+void
+CurlReactor::run()
+{
+    std::vector<Command> commands;
+
+    for (;;) {
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            // Sleep until there is something to do
+            if (_transfers.empty()) {
+                _wakeup.wait(lock, [this] {
+                    return _stop || !_commands.empty();
+                });
+            }
+            if (_stop) return;
+
+            commands.swap(_commands);
+        }
+
+        for (const Command& c : commands) {
+            switch (c.op) {
+                case ADD:
+                {
+                    const CURLMcode mcode =
+                        curl_multi_add_handle(_mhandle, c.handle);
+                    if (mcode == CURLM_OK) {
+                        _transfers.insert(c.handle);
+                        break;
+                    }
+
+                    // The transfer will never run: don't leave its
+                    // reader waiting for it.
+                    log_error(_("CURL: %s"), curl_multi_strerror(mcode));
+                    char* priv = nullptr;
+                    curl_easy_getinfo(c.handle, CURLINFO_PRIVATE, &priv);
+                    CurlStreamFile* stream =
+                        reinterpret_cast<CurlStreamFile*>(priv);
+                    assert(stream);
+                    stream->complete(true);
+                    break;
+                }
+                case REMOVE:
+                    // libcurl doesn't complain about removing a handle
+                    // that was never added.
+                    if (_transfers.erase(c.handle)) {
+                        curl_multi_remove_handle(_mhandle, c.handle);
+                    }
+                    break;
+                case RESUME:
+                    curl_easy_pause(c.handle, CURLPAUSE_CONT);
+                    break;
+            }
+        }
+
+        // Tell remove() callers their handles are out
+        if (std::any_of(commands.begin(), commands.end(),
+                    [](const Command& c) { return c.done; })) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (const Command& c : commands) {
+                if (c.done) *c.done = true;
+            }
+            _wakeup.notify_all();
+        }
+        commands.clear();
+
+        if (_transfers.empty()) continue;
+
+        int running;
+        CURLMcode mcode;
+        do {
+            mcode = curl_multi_perform(_mhandle, &running);
+        } while (mcode == CURLM_CALL_MULTI_PERFORM);
+
+        if (mcode != CURLM_OK) {
+            log_error(_("CURL: %s"), curl_multi_strerror(mcode));
+        }
+
+        processMessages();
+
+        // Wait for activity on any transfer. Without curl_multi_wakeup,
+        // the timeout is kept low so that commands aren't delayed.
+#if LIBCURL_VERSION_NUM >= 0x074400
+        curl_multi_poll(_mhandle, nullptr, 0, 1000, nullptr);
+#else
+        curl_multi_wait(_mhandle, nullptr, 0, 10, nullptr);
+#endif
+    }
+}
+
+void
+CurlReactor::processMessages()
+{
+    CURLMsg *curl_msg;
+    
+    // The number of messages left in the queue (not used by us).
+    int msgs;
+    while ((curl_msg = curl_multi_info_read(_mhandle, &msgs))) {
+        // Only for completed transactions
+        if (curl_msg->msg != CURLMSG_DONE) continue;
+
+        char* priv = nullptr;
+        curl_easy_getinfo(curl_msg->easy_handle, CURLINFO_PRIVATE, &priv);
+        CurlStreamFile* stream = reinterpret_cast<CurlStreamFile*>(priv);
+        assert(stream);
+
+        // HTTP transaction succeeded
+        if (curl_msg->data.result == CURLE_OK) {
+
+            long code;
+
+            // Check HTTP response
+            curl_easy_getinfo(curl_msg->easy_handle,
+                              CURLINFO_RESPONSE_CODE, &code);
+
+            if ( code >= 400 ) {
+                log_error(_("HTTP response %ld from URL %s"),
+                          code, stream->_url);
+                stream->complete(true);
+            } else {
+                log_debug("HTTP response %ld from URL %s",
+                            code, stream->_url);
+                stream->complete(false);
+            }
+
+        } else {
+            // Transaction failed, pass on curl error.
+            log_error(_("CURL: %s"), curl_easy_strerror(
+                                curl_msg->data.result));
+            stream->complete(true);
+        }
+    }
+}
+
+
 /***********************************************************************
  *
  *  Statics and CurlStreamFile implementation
@@ -522,60 +987,203 @@ CurlStreamFile::recv(void *buf, size_t size, size_t nmemb, void *userp)
         size * nmemb);
 #endif
     CurlStreamFile* stream = static_cast<CurlStreamFile*>(userp);
-    return stream->cache(buf, size * nmemb);
+
+    if (!stream->_size) {
+        double length;
+        if (curl_easy_getinfo(stream->_handle,
+                    CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length) == CURLE_OK &&
+                length > 0) {
+            stream->_size = static_cast<size_t>(length);
+        }
+    }
+
+    // The reader is behind: keep the data in libcurl until it catches up.
+    if (!stream->_received.push(static_cast<char*>(buf), size * nmemb)) {
+        stream->_paused = true;
+        stream->notify();
+        return CURL_WRITEFUNC_PAUSE;
+    }
+
+    stream->notify();
+    return size * nmemb;
+}
+
+/*static private*/
+size_t
+CurlStreamFile::recvHeader(char *buf, size_t size, size_t nitems,
+        void *userp)
+{
+    CurlStreamFile* stream = static_cast<CurlStreamFile*>(userp);
+
+    std::string line(buf, size * nitems);
+    while (!line.empty() && std::isspace(line[line.size() - 1])) {
+        line.erase(line.size() - 1);
+    }
+
+    // Each response starts with its status line: after redirects, only
+    // the headers of the last one are kept.
+    if (line.compare(0, 5, "HTTP/") == 0) {
+        const std::string::size_type space = line.find(' ');
+        stream->_status = space == std::string::npos ? 0 :
+            std::strtol(line.c_str() + space, nullptr, 10);
+        stream->_headers = HttpCache::Headers();
+        return size * nitems;
+    }
+
+    const std::string::size_type colon = line.find(':');
+    if (colon == std::string::npos) return size * nitems;
+
+    const std::string name = line.substr(0, colon);
+    std::string::size_type start = line.find_first_not_of(" \t", colon + 1);
+    const std::string value = start == std::string::npos ?
+        std::string() : line.substr(start);
+
+    HttpCache::Headers& headers = stream->_headers;
+    StringNoCaseEqual noCaseCompare;
+
+    if (noCaseCompare(name, "Cache-Control")) {
+        if (!headers.cacheControl.empty()) headers.cacheControl += ",";
+        headers.cacheControl += value;
+    }
+    else if (noCaseCompare(name, "Pragma")) {
+        // HTTP/1.0 servers send "Pragma: no-cache"
+        if (!headers.cacheControl.empty()) headers.cacheControl += ",";
+        headers.cacheControl += value;
+    }
+    else if (noCaseCompare(name, "ETag")) headers.etag = value;
+    else if (noCaseCompare(name, "Last-Modified")) {
+        headers.lastModifiedText = value;
+        headers.lastModified = curl_getdate(value.c_str(), nullptr);
+    }
+    else if (noCaseCompare(name, "Date")) {
+        headers.date = curl_getdate(value.c_str(), nullptr);
+    }
+    else if (noCaseCompare(name, "Expires")) {
+        // Invalid dates, such as "0", mean already expired.
+        headers.expires = curl_getdate(value.c_str(), nullptr);
+        if (headers.expires == -1) headers.expires = 0;
+    }
+    else if (noCaseCompare(name, "Age")) {
+        headers.age = std::strtol(value.c_str(), nullptr, 10);
+    }
+    else if (noCaseCompare(name, "Vary")) headers.vary = true;
+
+    return size * nitems;
+}
+
+/*private*/
+void
+CurlStreamFile::notify()
+{
+    // Taking the mutex ensures a reader that just found nothing to do
+    // is already waiting.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _wakeup.notify_all();
 }
 
+/*private*/
+void
+CurlStreamFile::complete(bool error)
+{
+    if (error) _error = true;
+    _running = false;
+    notify();
+}
 
 /*private*/
 std::streamsize
-CurlStreamFile::cache(void *from, std::streamsize size)
+CurlStreamFile::cache()
 {
-    // take note of current position
-    long curr_pos = std::ftell(_cache);
+    std::streamsize wrote = 0;
 
-    // seek to the end
-    std::fseek(_cache, 0, SEEK_END);
+    if (!_received.empty()) {
+        // take note of current position
+        long curr_pos = std::ftell(_cache);
 
-    std::streamsize wrote = std::fwrite(from, 1, size, _cache);
-    if ( wrote < 1 ) {
-        boost::format fmt = boost::format("writing to cache file: requested "
-                                          "%d, wrote %d (%s)") %
-                                          size % wrote % std::strerror(errno);
-        throw GnashException(fmt.str());
+        // seek to the end
+        std::fseek(_cache, 0, SEEK_END);
+
+        wrote = _received.popTo(_cache);
+
+        // Set the size of cached data
+        _cached = std::ftell(_cache);
+
+        // reset position for next read
+        std::fseek(_cache, curr_pos, SEEK_SET);
     }
 
-    // Set the size of cached data
-    _cached = std::ftell(_cache);
+    // There is room again for anything libcurl is holding back.
+    if (_paused.exchange(false)) {
+        CurlReactor::get().resume(_handle);
+    }
 
-    // reset position for next read
-    std::fseek(_cache, curr_pos, SEEK_SET);
+    // Nothing more will be received once the transfer is over.
+    if (_httpCache && !_running && _received.empty()) {
+        wrote += finishHttpCache();
+    }
 
     return wrote;
 }
 
 /*private*/
-void
-CurlStreamFile::fillCacheNonBlocking()
+std::streamsize
+CurlStreamFile::finishHttpCache()
 {
-    if ( ! _running ) {
-#if GNASH_CURL_VERBOSE
-        log_debug("Not running: fillCacheNonBlocking returning");
-#endif
-        return;
-    }
+    HttpCache& httpCache = *_httpCache;
+    _httpCache = nullptr;
+
+    std::streamsize wrote = 0;
+    const std::time_t now = std::time(nullptr);
+
+    if (_status == 304 && _httpCacheBody) {
+        // The cached response is still valid, so use its body as if
+        // it had been received.
+        log_debug("Using revalidated cached response for %s", _url);
 
-    CURLMcode mcode;
+        long curr_pos = std::ftell(_cache);
+        std::fseek(_cache, 0, SEEK_END);
 
-    do {
-        mcode = curl_multi_perform(_mhandle, &_running);
-    } while (mcode == CURLM_CALL_MULTI_PERFORM); // && _running ?
+        char buf[8192];
+        size_t got;
+        while ((got = std::fread(buf, 1, sizeof buf, _httpCacheBody)) > 0) {
+            if (std::fwrite(buf, 1, got, _cache) < got) {
+                throw GnashException(_("Could not write to cache file"));
+            }
+            wrote += got;
+        }
+
+        _cached = std::ftell(_cache);
+        _size = _cached;
+        std::fseek(_cache, curr_pos, SEEK_SET);
+
+        if (HttpCache::cacheable(_headers, now, _httpCacheEntry)) {
+            httpCache.store(_httpCacheEntry, _cache);
+        }
+    }
+    else if (_status == 200 && !_error) {
+        HttpCache::Entry entry;
+        entry.url = _url;
+        if (HttpCache::cacheable(_headers, now, entry)) {
+            httpCache.store(entry, _cache);
+        }
+        else httpCache.remove(_url);
+    }
 
-    if (mcode != CURLM_OK) {
-        throw GnashException(curl_multi_strerror(mcode));
+    if (_httpCacheBody) {
+        std::fclose(_httpCacheBody);
+        _httpCacheBody = nullptr;
     }
 
-    // handle 404
-    processMessages();
+    return wrote;
+}
+
+/*private*/
+void
+CurlStreamFile::fillCacheNonBlocking()
+{
+    cache();
 }
 
 
@@ -590,23 +1198,8 @@ CurlStreamFile::fillCache(std::streampos size)
 
     assert(size >= 0);
 
-    if ( ! _running || _cached >= size) {
-#if GNASH_CURL_VERBOSE
-        if (!_running) log_debug("Not running: returning");
-        else log_debug("Already enough bytes cached: returning");
-#endif
-        return;
-    }
-
-    fd_set readfd, writefd, exceptfd;
-    int maxfd;
-    CURLMcode mcode;
-    timeval tv;
-
-    // Hard-coded slect timeout.
-    // This number is kept low to give more thread switch
-    // opportunities while waiting for a load.
-    const long maxSleepUsec = 10000;  // 1/100 of a second
+    // Hard-coded wait timeout, after which the user timeout is checked.
+    const std::chrono::milliseconds maxWait(100);
 
     const unsigned int userTimeout = static_cast<unsigned int>(
             RcInitFile::getDefaultInstance().getStreamsTimeout()*1000);
@@ -616,159 +1209,31 @@ CurlStreamFile::fillCache(std::streampos size)
 #endif
 
     WallClockTimer lastProgress; // timer since last progress
-    while (_running) {
-        fillCacheNonBlocking(); // NOTE: will handle 404
-	
-        // Do this here to avoid calling select()
-        // when we have enough bytes anyway, or
-        // we reached EOF
-        if (_cached >= size || !_running) break; 
-	
-#if GNASH_CURL_VERBOSE
-        //log_debug("cached: %d, size: %d", _cached, size);
-#endif
-	
-        // Zero these out _before_ calling curl_multi_fdset!
-        FD_ZERO(&readfd);
-        FD_ZERO(&writefd);
-        FD_ZERO(&exceptfd);
-
-        mcode = curl_multi_fdset(_mhandle, &readfd, &writefd, 
-                &exceptfd, &maxfd);
-
-        if (mcode != CURLM_OK) {
-            // This is a serious error, not just a failure to add any
-            // fds.
-            throw GnashException(curl_multi_strerror(mcode));
-        }
-
-#ifdef GNASH_CURL_VERBOSE
-        log_debug("Max fd: %d", maxfd);
-#endif
-
-        // A value of -1 means no file descriptors were added.
-        if (maxfd < 0) {
-#if GNASH_CURL_VERBOSE
-            log_debug("curl_multi_fdset: maxfd == %1%", maxfd);
-#endif
-	    // As of libcurl 7.21.x, the DNS resolving appears to be going
-	    // on in the background, so curl_multi_fdset fails to return
-	    // anything useful. So we use the user timeout value to
-	    // give DNS enough time to resolve the lookup.
-            if (userTimeout && lastProgress.elapsed() > userTimeout) {
-                log_error(_("FIXME: Timeout (%u milliseconds) while loading "
-			    "from URL %s"), userTimeout, _url);
-                // TODO: should we set _error here ?
-                return;
-            } else {
-                continue;
-            }
-        }
-
-        tv.tv_sec = 0;
-        tv.tv_usec = maxSleepUsec;
-
-#ifdef GNASH_CURL_VERBOSE
-        log_debug("select() with %d milliseconds timeout", maxSleepUsec*1000);
-#endif
-
-        // Wait for data on the filedescriptors until a timeout set
-        // in gnashrc.
-        int ret = select(maxfd + 1, &readfd, &writefd, &exceptfd, &tv);
-
-// select() will always fail on OS/2 and AmigaOS4 as we can't select
-// on file descriptors, only on sockets
-#if !defined(__OS2__) && !defined(__amigaos4__) && !defined(WIN32)
-        if ( ret == -1 ) {
-            if ( errno == EINTR ) {
-                // we got interrupted by a signal
-                // let's consider this as a timeout
-#ifdef GNASH_CURL_VERBOSE
-                log_debug("select() was interrupted by a signal");
-#endif
-                ret = 0;
-            } else {
-                // something unexpected happened
-                boost::format fmt = boost::format(
-                    "error polling data from connection to %s: %s ")
-                    % _url % strerror(errno);
-                throw GnashException(fmt.str());
-            }
-        }
-#endif
-        if ( ! ret ) {
-            // Timeout, check the clock to see
-            // if we expired the user Timeout
-#ifdef GNASH_CURL_VERBOSE
-            log_debug("select() timed out, elapsed is %u",
-		      lastProgress.elapsed());
-#endif
-            if (userTimeout && lastProgress.elapsed() > userTimeout) {
-                log_error(_("Timeout (%u milliseconds) while loading "
-                            "from URL %s"), userTimeout, _url);
-                // TODO: should we set _error here ?
-                return;
-            }
-        } else {
-            // Activity, reset the timer...
-#ifdef GNASH_CURL_VERBOSE
-            log_debug("FD activity, resetting progress timer");
-#endif
-            lastProgress.restart();
-        }
+    for (;;) {
 
-    }
-
-    // Processing messages is already done by fillCacheNonBlocking,
-    // so we might likely avoid it here.
-    processMessages();
+        // Take note of the end of the transfer before caching, so
+        // that all data received before it is cached.
+        const bool running = _running;
 
-}
+        if (cache()) lastProgress.restart();
 
-/*private*/
-void
-CurlStreamFile::processMessages()
-{
-    CURLMsg *curl_msg;
-    
-    // The number of messages left in the queue (not used by us).
-    int msgs;
-    while ((curl_msg = curl_multi_info_read(_mhandle, &msgs))) {
-        // Only for completed transactions
-        if (curl_msg->msg == CURLMSG_DONE) {
-	    
-            // HTTP transaction succeeded
-            if (curl_msg->data.result == CURLE_OK) {
-		
-                long code;
-		
-                // Check HTTP response
-                curl_easy_getinfo(curl_msg->easy_handle,
-				  CURLINFO_RESPONSE_CODE, &code);
-		
-                if ( code >= 400 ) {
-                    log_error(_("HTTP response %ld from URL %s"),
-			      code, _url);
-                    _error = true;
-                    _running = false;
-                } else {
-                    log_debug("HTTP response %ld from URL %s",
-				code, _url);
-                }
+        if (_cached >= size || !running) break;
 
-            } else {
-                // Transaction failed, pass on curl error.
-                log_error(_("CURL: %s"), curl_easy_strerror(
-                                    curl_msg->data.result));
-                _error = true;
-            }
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wakeup.wait_for(lock, maxWait, [this] {
+            return !_received.empty() || _paused || !_running;
+        });
+        lock.unlock();
 
+        if (userTimeout && lastProgress.elapsed() > userTimeout) {
+            log_error(_("Timeout (%u milliseconds) while loading "
+                        "from URL %s"), userTimeout, _url);
+            // TODO: should we set _error here ?
+            return;
         }
-
     }
 }
 
-
 /*private*/
 void
 CurlStreamFile::init(const std::string& url, const std::string& cachefile)
@@ -776,14 +1241,19 @@ CurlStreamFile::init(const std::string& url, const std::string& cachefile)
     _customHeaders = nullptr;
 
     _url = url;
-    _running = 1;
+    _running = true;
     _error = false;
+    _paused = false;
 
     _cached = 0;
     _size = 0;
 
+    _httpCache = nullptr;
+    _httpCacheBody = nullptr;
+    _fromHttpCache = false;
+    _status = 0;
+
     _handle = curl_easy_init();
-    _mhandle = curl_multi_init();
 
     const RcInitFile& rcfile = RcInitFile::getDefaultInstance();
     
@@ -893,27 +1363,117 @@ are not honored during the DNS lookup - which you can  work  around  by
         throw GnashException(curl_easy_strerror(ccode));
     }
 
-    //fillCache(32); // pre-cache 32 bytes
-    //curl_multi_perform(_mhandle, &_running);
+    // let the reactor find us from the handle
+    ccode = curl_easy_setopt(_handle, CURLOPT_PRIVATE, this);
+    if ( ccode != CURLE_OK ) {
+        throw GnashException(curl_easy_strerror(ccode));
+    }
+
+#ifdef CURLPIPE_MULTIPLEX
+    // Use HTTP/2 where the server offers it over TLS, and wait for
+    // a connection being set up to the same host rather than opening
+    // another one, in case it can be shared. Failures are ignored, as
+    // HTTP/1.1 will be used.
+    curl_easy_setopt(_handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(_handle, CURLOPT_PIPEWAIT, 1L);
+#endif
+}
+
+/*private*/
+bool
+CurlStreamFile::useHttpCache()
+{
+    HttpCache* httpCache = HttpCache::getDefaultInstance();
+    if (!httpCache) return false;
+
+    // Only HTTP responses say whether they can be cached.
+    StringNoCaseEqual noCaseCompare;
+    if (!noCaseCompare(_url.substr(0, 7), "http://") &&
+            !noCaseCompare(_url.substr(0, 8), "https://")) {
+        return false;
+    }
+
+    FILE* body = httpCache->open(_url, _httpCacheEntry);
+    if (body && _httpCacheEntry.fresh(std::time(nullptr))) {
+
+        log_debug("Using cached response for %s", _url);
+
+        char buf[8192];
+        size_t got;
+        while ((got = std::fread(buf, 1, sizeof buf, body)) > 0) {
+            if (std::fwrite(buf, 1, got, _cache) < got) {
+                std::fclose(body);
+                throw GnashException(_("Could not write to cache file"));
+            }
+        }
+        std::fclose(body);
+
+        _cached = std::ftell(_cache);
+        _size = _cached;
+        std::rewind(_cache);
+
+        _running = false;
+        _fromHttpCache = true;
+        return true;
+    }
+
+    if (body && _httpCacheEntry.revalidatable()) {
+        // Ask for the response only if it changed.
+        _httpCacheBody = body;
+        if (!_httpCacheEntry.etag.empty()) {
+            _customHeaders = curl_slist_append(_customHeaders,
+                    ("If-None-Match: " + _httpCacheEntry.etag).c_str());
+        }
+        if (!_httpCacheEntry.lastModified.empty()) {
+            _customHeaders = curl_slist_append(_customHeaders,
+                    ("If-Modified-Since: " +
+                     _httpCacheEntry.lastModified).c_str());
+        }
+        CURLcode ccode = curl_easy_setopt(_handle, CURLOPT_HTTPHEADER,
+                _customHeaders);
+        if ( ccode != CURLE_OK ) {
+            throw GnashException(curl_easy_strerror(ccode));
+        }
+    }
+    else if (body) {
+        std::fclose(body);
+    }
+
+    CURLcode ccode = curl_easy_setopt(_handle, CURLOPT_HEADERDATA, this);
+    if ( ccode != CURLE_OK ) {
+        throw GnashException(curl_easy_strerror(ccode));
+    }
+
+    ccode = curl_easy_setopt(_handle, CURLOPT_HEADERFUNCTION,
+        CurlStreamFile::recvHeader);
+    if ( ccode != CURLE_OK ) {
+        throw GnashException(curl_easy_strerror(ccode));
+    }
+
+    _httpCache = httpCache;
+    return false;
 }
 
 /*public*/
 CurlStreamFile::CurlStreamFile(const std::string& url,
         const std::string& cachefile)
+    :
+    _received(receiveBufferSize)
 {
     log_debug("CurlStreamFile %p created", this);
     init(url, cachefile);
 
-    // CURLMcode ret =
-    CURLMcode mcode = curl_multi_add_handle(_mhandle, _handle);
-    if ( mcode != CURLM_OK ) {
-        throw GnashException(curl_multi_strerror(mcode));
-    }
+    // Only plain GET requests can be answered from the HTTP cache.
+    if (useHttpCache()) return;
+
+    CurlReactor::get().add(_handle);
 }
 
 /*public*/
 CurlStreamFile::CurlStreamFile(const std::string& url, const std::string& vars,
        const std::string& cachefile)
+    :
+    _received(receiveBufferSize)
 {
     log_debug("CurlStreamFile %p created", this);
     init(url, cachefile);
@@ -956,10 +1516,7 @@ CurlStreamFile::CurlStreamFile(const std::string& url, const std::string& vars,
         throw GnashException(curl_easy_strerror(ccode));
     }
 
-    CURLMcode mcode = curl_multi_add_handle(_mhandle, _handle);
-    if ( mcode != CURLM_OK ) {
-        throw GnashException(curl_multi_strerror(mcode));
-    }
+    CurlReactor::get().add(_handle);
 
 }
 
@@ -967,6 +1524,8 @@ CurlStreamFile::CurlStreamFile(const std::string& url, const std::string& vars,
 CurlStreamFile::CurlStreamFile(const std::string& url, const std::string& vars,
         const NetworkAdapter::RequestHeaders& headers,
         const std::string& cachefile)
+    :
+    _received(receiveBufferSize)
 {
     log_debug("CurlStreamFile %p created", this);
     init(url, cachefile);
@@ -1022,10 +1581,7 @@ CurlStreamFile::CurlStreamFile(const std::string& url, const std::string& vars,
         throw GnashException(curl_easy_strerror(ccode));
     }
 
-    CURLMcode mcode = curl_multi_add_handle(_mhandle, _handle);
-    if ( mcode != CURLM_OK ) {
-        throw GnashException(curl_multi_strerror(mcode));
-    }
+    CurlReactor::get().add(_handle);
 
 }
 
@@ -1034,10 +1590,10 @@ CurlStreamFile::CurlStreamFile(const std::string& url, const std::string& vars,
 CurlStreamFile::~CurlStreamFile()
 {
     log_debug("CurlStreamFile %p deleted", this);
-    curl_multi_remove_handle(_mhandle, _handle);
+    if (!_fromHttpCache) CurlReactor::get().remove(_handle);
     curl_easy_cleanup(_handle);
-    curl_multi_cleanup(_mhandle);
     std::fclose(_cache);
+    if (_httpCacheBody) std::fclose(_httpCacheBody);
     if ( _customHeaders ) curl_slist_free_all(_customHeaders); 
 }
 
@@ -1093,7 +1649,8 @@ CurlStreamFile::readNonBlocking(void *dst, std::streamsize bytes)
 bool
 CurlStreamFile::eof() const
 {
-    bool ret = ( ! _running && feof(_cache) );
+    bool ret = ( ! _running && _received.empty() && ! _httpCache &&
+            feof(_cache) );
 
 #ifdef GNASH_CURL_VERBOSE
     log_debug("eof() returning %d", ret);
@@ -1157,24 +1714,16 @@ CurlStreamFile::seek(std::streampos pos)
 void
 CurlStreamFile::go_to_end()
 {
-    CURLMcode mcode;
-    while (_running > 0) {
-        do {
-            mcode=curl_multi_perform(_mhandle, &_running);
-        } while ( mcode == CURLM_CALL_MULTI_PERFORM );
-
-        if ( mcode != CURLM_OK ) {
-            throw IOException(curl_multi_strerror(mcode));
-        }
-	
-        long code;
-        curl_easy_getinfo(_handle, CURLINFO_RESPONSE_CODE, &code);
-        if (code == 404) {	// file not found!
-            throw IOException("File not found");
+    while (_running) {
+        fillCache(std::numeric_limits<std::streamoff>::max());
+        if (_error) {
+            throw IOException("Error loading " + _url);
         }
-
     }
 
+    // Cache anything received since fillCache last did.
+    cache();
+
     if (std::fseek(_cache, 0, SEEK_END) == -1) {
         throw IOException("NetworkAdapter: fseek to end failed");
     } 
@@ -1184,16 +1733,6 @@ CurlStreamFile::go_to_end()
 size_t
 CurlStreamFile::size() const
 {
-    if ( ! _size ) {
-        double size;
-        CURLcode ret = curl_easy_getinfo(_handle,
-                CURLINFO_CONTENT_LENGTH_DOWNLOAD, &size);
-        if (ret == CURLE_OK) {
-            assert(size <= std::numeric_limits<size_t>::max());
-            _size = static_cast<size_t>(size);
-        }
-    }
-
 #ifdef GNASH_CURL_VERBOSE
     log_debug("get_stream_size() returning %lu", _size);
 #endif
@@ -88,14 +88,11 @@ StreamProvider::getStream(const URL& url, bool namedCacheFile) const
             // check security here !!
 		    if (!allow(url)) return stream;
 
-			FILE *newin = std::fopen(path.c_str(), "rb");
-			if (!newin)  { 
+			stream = makeFileChannel(path.c_str(), "rb");
+			if (!stream.get())  { 
 				log_error(_("Could not open file %1%: %2%"),
 				          path, std::strerror(errno));
-				return stream;
 			}
-			// Close on destruction
-			stream = std::move(makeFileChannel(newin, true));
 			return stream;
 		}
 	}
@@ -153,13 +150,11 @@ StreamProvider::getStream(const URL& url, const std::string& postdata,
 		else {
 			if (!allow(url)) return stream;
 
-			FILE *newin = std::fopen(path.c_str(), "rb");
-			if (!newin)  { 
+			stream = makeFileChannel(path.c_str(), "rb");
+			if (!stream.get())  { 
 				log_error(_("Could not open file %1%: %2%"),
 				          path, std::strerror(errno));
-				return stream;
 			}
-			stream = makeFileChannel(newin, false);
 			return stream;
 		}
 	}
@@ -70,7 +70,12 @@ RcInitFile::getDefaultInstance()
 RcInitFile::RcInitFile()
         :
     _delay(0),
+    _maxFrameSkip(4),
     _movieLibraryLimit(8),
+    _timelineSnapshotInterval(64),
+    _timelineSnapshotLimit(64),
+    _movieLoaderThreads(4),
+    _tagDecoderThreads(0),
     _debug(false),
     _debugger(false),
     _verbosity(-1),
@@ -112,6 +117,7 @@ RcInitFile::RcInitFile()
     _quality(-1),
     _saveStreamingMedia(false),
     _saveLoadedMedia(false),
+    _httpCacheSize(64),
     _popups(true),
     _webcamDevice(-1),
     _microphoneDevice(-1),
@@ -466,6 +472,18 @@ RcInitFile::parseFile(const std::string& filespec)
                 _mediaCacheDir = value;
                 continue;
             }
+
+            if (noCaseCompare(variable, "httpCacheDir") ) {
+                expandPath(value);
+                _httpCacheDir = value;
+                continue;
+            }
+
+            if (noCaseCompare(variable, "glyphCacheFile") ) {
+                expandPath(value);
+                _glyphCacheFile = value;
+                continue;
+            }
             
             if (noCaseCompare(variable, "documentroot") ) {
                 _wwwroot = value;
@@ -583,8 +601,26 @@ RcInitFile::parseFile(const std::string& filespec)
             ||
                  extractNumber(_movieLibraryLimit, "movieLibraryLimit",
                          variable, value)
+            ||
+                 extractNumber(_timelineSnapshotInterval,
+                         "timelineSnapshotInterval", variable, value)
+            ||
+                 extractNumber(_timelineSnapshotLimit,
+                         "timelineSnapshotLimit", variable, value)
+            ||
+                 extractNumber(_movieLoaderThreads,
+                         "movieLoaderThreads", variable, value)
+            ||
+                 extractNumber(_tagDecoderThreads,
+                         "tagDecoderThreads", variable, value)
+            ||
+                 extractNumber(_httpCacheSize, "httpCacheSize", variable,
+                         value)
             ||
                  extractNumber(_delay, "delay", variable, value)
+            ||
+                 extractNumber(_maxFrameSkip, "maxFrameSkip", variable,
+                         value)
             ||
                  extractNumber(_verbosity, "verbosity", variable, value)
             ||
@@ -769,8 +805,14 @@ RcInitFile::updateFile(const std::string& filespec)
     cmd << "startStopped " << _startStopped << endl <<
     cmd << "streamsTimeout " << _streamsTimeout << endl <<
     cmd << "movieLibraryLimit " << _movieLibraryLimit << endl <<
+    cmd << "timelineSnapshotInterval " << _timelineSnapshotInterval << endl <<
+    cmd << "timelineSnapshotLimit " << _timelineSnapshotLimit << endl <<
+    cmd << "movieLoaderThreads " << _movieLoaderThreads << endl <<
+    cmd << "tagDecoderThreads " << _tagDecoderThreads << endl <<
+    cmd << "httpCacheSize " << _httpCacheSize << endl <<
     cmd << "quality " << _quality << endl <<    
     cmd << "delay " << _delay << endl <<
+    cmd << "maxFrameSkip " << _maxFrameSkip << endl <<
     cmd << "verbosity " << _verbosity << endl <<
     cmd << "solReadOnly " << _solreadonly << endl <<
     cmd << "solLocalDomain " << _sollocaldomain << endl <<
@@ -796,6 +838,8 @@ RcInitFile::updateFile(const std::string& filespec)
     // at the next run (even though that's not the way to use it...)
 
     cmd << "mediaDir " << _mediaCacheDir << endl <<    
+    cmd << "httpCacheDir " << _httpCacheDir << endl <<
+    cmd << "glyphCacheFile " << _glyphCacheFile << endl <<
     cmd << "debuglog " << _log << endl <<
     cmd << "documentroot " << _wwwroot << endl <<
     cmd << "flashSystemOS " << _flashSystemOS << endl <<
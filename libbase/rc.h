@@ -83,6 +83,12 @@ public:
     int getTimerDelay() const { return _delay; }
     void setTimerDelay(int x) { _delay = x; }
 
+    /// The most frames in a row not rendered to keep to the frame rate.
+    //
+    /// 0 renders every frame, however late.
+    int getMaxFrameSkip() const { return _maxFrameSkip; }
+    void setMaxFrameSkip(int value) { _maxFrameSkip = value; }
+
     bool showASCodingErrors() const { return _verboseASCodingErrors; }
     void showASCodingErrors(bool value);
 
@@ -95,6 +101,34 @@ public:
     int getMovieLibraryLimit() const { return _movieLibraryLimit; }
     void setMovieLibraryLimit(int value) { _movieLibraryLimit = value; }
 
+    /// The number of frames between DisplayList snapshots of a timeline.
+    //
+    /// 0 disables the snapshots.
+    int getTimelineSnapshotInterval() const {
+        return _timelineSnapshotInterval;
+    }
+    void setTimelineSnapshotInterval(int value) {
+        _timelineSnapshotInterval = value;
+    }
+
+    /// The maximum number of DisplayList snapshots kept for each timeline.
+    int getTimelineSnapshotLimit() const { return _timelineSnapshotLimit; }
+    void setTimelineSnapshotLimit(int value) {
+        _timelineSnapshotLimit = value;
+    }
+
+    /// The number of threads loading movies for loadMovie requests.
+    int getMovieLoaderThreads() const { return _movieLoaderThreads; }
+    void setMovieLoaderThreads(int value) { _movieLoaderThreads = value; }
+
+    /// The number of threads decoding definition tags of loading movies.
+    //
+    /// 0 means one per processor.
+    std::uint32_t getTagDecoderThreads() const { return _tagDecoderThreads; }
+    void setTagDecoderThreads(std::uint32_t value) {
+        _tagDecoderThreads = value;
+    }
+
     bool enableExtensions() const { return _extensionsEnabled; }
 
     /// Return true if user is willing to start the gui in "stop" mode
@@ -306,6 +340,23 @@ public:
     void setMediaDir(const std::string& value) { _mediaCacheDir = value; }
 
     const std::string& getMediaDir() const { return _mediaCacheDir; }
+
+    /// The directory of the HTTP cache, empty if there is no cache.
+    const std::string& getHttpCacheDir() const { return _httpCacheDir; }
+
+    void setHttpCacheDir(const std::string& value) { _httpCacheDir = value; }
+
+    /// The maximum size of the HTTP cache, in megabytes.
+    int getHttpCacheSize() const { return _httpCacheSize; }
+
+    void setHttpCacheSize(int value) { _httpCacheSize = value; }
+
+    /// The file device font glyph outlines are kept in, empty if none.
+    const std::string& getGlyphCacheFile() const { return _glyphCacheFile; }
+
+    void setGlyphCacheFile(const std::string& value) {
+        _glyphCacheFile = value;
+    }
 	
     void setWebcamDevice(int value) {_webcamDevice = value;}
     
@@ -444,9 +495,24 @@ protected:
     /// The timer delay
     std::uint32_t  _delay;
 
+    /// Max number of frames in a row not rendered when late
+    std::uint32_t  _maxFrameSkip;
+
     /// Max number of movie clips to store in the library      
     std::uint32_t  _movieLibraryLimit;
 
+    /// Frames between DisplayList snapshots of a timeline
+    std::uint32_t  _timelineSnapshotInterval;
+
+    /// Max number of DisplayList snapshots of a timeline
+    std::uint32_t  _timelineSnapshotLimit;
+
+    /// Number of threads loading movies
+    std::uint32_t  _movieLoaderThreads;
+
+    /// Number of threads decoding tags, 0 for one per processor
+    std::uint32_t  _tagDecoderThreads;
+
     /// Enable debugging of this class
     bool _debug;
 
@@ -577,6 +643,15 @@ protected:
 
     std::string _mediaCacheDir;
 
+    /// Where HTTP responses are cached, if anywhere
+    std::string _httpCacheDir;
+
+    /// Max size of the HTTP cache, in megabytes
+    std::uint32_t _httpCacheSize;
+
+    /// Where device font glyph outlines are kept, if anywhere
+    std::string _glyphCacheFile;
+
     bool _popups;
 
     ///FIXME: this should probably eventually be changed to a more readable
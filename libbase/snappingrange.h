@@ -493,40 +493,70 @@ public:
     }
     
     /// Combines known ranges. Previously merged ranges may have come close
-    /// to other ranges. Algorithm could be optimized. 
+    /// to other ranges.
+    //
+    /// Two ranges can only snap if the gap between them along the x axis
+    /// is less than (snap factor - 1) times the sum of their widths. The
+    /// ranges are sorted by their left edge, so that each one only needs
+    /// testing against the ones starting within that distance of its right
+    /// edge. A merged range may come close to one already passed, so the
+    /// ranges are swept again until nothing is merged.
     void combineRanges() const {
     
         // makes no sense in single mode
         if (_singleMode) return;
     
-        bool restart = true;
-        
         _combineCounter = 0;
         
-        while (restart) {
+        const double slack = _snapFactor - 1.0;
+
+        bool merged = _ranges.size() > 1;
+        
+        while (merged) {
         
-            int rcount = _ranges.size();
+            merged = false;
 
-            restart=false;
+            std::sort(_ranges.begin(), _ranges.end(), MinXLessThan());
+
+            double maxWidth = 0;
+            for (const RangeType& r : _ranges) {
+                maxWidth = std::max<double>(maxWidth, r.width());
+            }
+
+            const size_type rcount = _ranges.size();
+            std::vector<bool> gone(rcount, false);
         
-            for (int i=0; i<rcount; i++) {
+            for (size_type i = 0; i < rcount; ++i) {
+
+                if (gone[i]) continue;
+                RangeType& r = _ranges[i];
             
-                for (int j=i+1; j<rcount; j++) {
+                for (size_type j = i + 1; j < rcount; ++j) {
+
+                    if (gone[j]) continue;
+
+                    // Integer ranges include their last row and column,
+                    // hence the extra pixels.
+                    const double gap = static_cast<double>(
+                            _ranges[j].getMinX()) - r.getMaxX();
+                    if (gap > slack * (r.width() + maxWidth + 2) + 1) break;
                 
-                    if (snaptest(_ranges[i], _ranges[j], _snapFactor)) {
-                        // merge i + j
-                        _ranges[i].expandTo(_ranges[j]);
-                        
-                        _ranges.erase(_ranges.begin() + j);
-                        
-                        restart=true; // restart from beginning
-                        break;
-                        
+                    if (snaptest(r, _ranges[j], _snapFactor)) {
+                        r.expandTo(_ranges[j]);
+                        maxWidth = std::max<double>(maxWidth, r.width());
+                        gone[j] = true;
+                        merged = true;
                     } 
                 } 
-                
-                if (restart) break;
             } 
+
+            if (merged) {
+                size_type kept = 0;
+                for (size_type i = 0; i < rcount; ++i) {
+                    if (!gone[i]) _ranges[kept++] = _ranges[i];
+                }
+                _ranges.resize(kept);
+            }
         } 
         
         // limit number of ranges
@@ -577,6 +607,13 @@ public:
     
 private:
 
+    /// Orders ranges by their left edge.
+    struct MinXLessThan
+    {
+        bool operator()(const RangeType& a, const RangeType& b) const {
+            return a.getMinX() < b.getMinX();
+        }
+    };
     
     /// Calls combineRanges() once in a while, but not always. Avoids too many
     /// combineRanges() checks, which could slow down everything.
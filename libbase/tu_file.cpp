@@ -8,6 +8,8 @@
 #include "tu_file.h"
 
 #include <cstdio>
+#include <cstring>
+#include <algorithm>
 #include <boost/format.hpp>
 #include <cerrno>
 
@@ -16,6 +18,12 @@
 #include "IOChannel.h" 
 #include "log.h"
 
+#if !defined(_WIN32) && !defined(__amigaos4__)
+# include <sys/mman.h>
+# include <fcntl.h>
+# define GNASH_MAP_FILES 1
+#endif
+
 namespace gnash {
 
 /// An IOChannel that works on a C stdio file.
@@ -240,6 +248,144 @@ tu_file::close()
     std::fclose(_data);
 }
 
+#ifdef GNASH_MAP_FILES
+
+/// An IOChannel that works on a file mapped in memory.
+//
+/// It behaves as a tu_file opened for reading, but reads are copies from
+/// the mapping and view() gives the bytes in place.
+class MappedFile : public IOChannel
+{
+public:
+
+    /// Map a file, or return NULL if it's not a regular file or can't
+    /// be mapped.
+    static std::unique_ptr<IOChannel> open(const char* filepath);
+
+    ~MappedFile();
+
+    std::streamsize read(void* dst, std::streamsize num);
+
+    const std::uint8_t* view(std::streamsize& num);
+
+    void prefetch(std::streampos pos, std::streamsize num);
+
+    std::streampos tell() const { return _pos; }
+
+    bool seek(std::streampos p);
+
+    void go_to_end() {
+        _pos = _size;
+        _eof = false;
+    }
+
+    /// As with stdio, EOF is only reached by reading past the end.
+    bool eof() const { return _eof; }
+
+    bool bad() const { return false; }
+
+    size_t size() const { return _size; }
+
+private:
+
+    MappedFile(const std::uint8_t* data, size_t size);
+
+    const std::uint8_t* const _data;
+
+    const size_t _size;
+
+    size_t _pos;
+
+    bool _eof;
+};
+
+std::unique_ptr<IOChannel>
+MappedFile::open(const char* filepath)
+{
+    const int fd = ::open(filepath, O_RDONLY);
+    if (fd < 0) return std::unique_ptr<IOChannel>();
+
+    struct stat statbuf;
+    void* data = MAP_FAILED;
+
+    // Empty files can't be mapped, and files that are not regular may
+    // change size or not support mapping at all.
+    if (fstat(fd, &statbuf) == 0 && S_ISREG(statbuf.st_mode) &&
+            statbuf.st_size > 0) {
+        data = mmap(nullptr, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+
+    if (data == MAP_FAILED) return std::unique_ptr<IOChannel>();
+
+    // Movies and videos are mostly read from start to end.
+    madvise(data, statbuf.st_size, MADV_SEQUENTIAL);
+
+    return std::unique_ptr<IOChannel>(new MappedFile(
+                static_cast<const std::uint8_t*>(data), statbuf.st_size));
+}
+
+MappedFile::MappedFile(const std::uint8_t* data, size_t size)
+    :
+    _data(data),
+    _size(size),
+    _pos(0),
+    _eof(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    munmap(const_cast<std::uint8_t*>(_data), _size);
+}
+
+std::streamsize
+MappedFile::read(void* dst, std::streamsize num)
+{
+    assert(dst);
+    const std::uint8_t* src = view(num);
+    std::memcpy(dst, src, num);
+    return num;
+}
+
+const std::uint8_t*
+MappedFile::view(std::streamsize& num)
+{
+    if (static_cast<size_t>(num) > _size - _pos) {
+        num = _size - _pos;
+        _eof = true;
+    }
+    const std::uint8_t* ret = _data + _pos;
+    _pos += num;
+    return ret;
+}
+
+void
+MappedFile::prefetch(std::streampos pos, std::streamsize num)
+{
+    if (pos < 0 || static_cast<size_t>(pos) >= _size || num <= 0) return;
+    const size_t first = pos;
+    const size_t end = first + std::min<size_t>(num, _size - first);
+
+    // The range must start at a page boundary.
+    static const size_t pageSize = sysconf(_SC_PAGESIZE);
+    const size_t start = first - first % pageSize;
+
+    madvise(const_cast<std::uint8_t*>(_data) + start, end - start,
+            MADV_WILLNEED);
+}
+
+bool
+MappedFile::seek(std::streampos p)
+{
+    if (p < 0 || static_cast<size_t>(p) > _size) return false;
+    _pos = p;
+    _eof = false;
+    return true;
+}
+
+#endif
+
 std::unique_ptr<IOChannel>
 makeFileChannel(FILE* fp, bool close)
 {
@@ -250,6 +396,13 @@ makeFileChannel(FILE* fp, bool close)
 std::unique_ptr<IOChannel>
 makeFileChannel(const char* filepath, const char* mode)
 {
+#ifdef GNASH_MAP_FILES
+	if (!std::strcmp(mode, "rb") || !std::strcmp(mode, "r")) {
+		std::unique_ptr<IOChannel> mapped = MappedFile::open(filepath);
+		if (mapped.get()) return mapped;
+	}
+#endif
+
 	FILE* fp = fopen(filepath, mode);
 	if ( fp == nullptr ) { return std::unique_ptr<IOChannel>(); }
 
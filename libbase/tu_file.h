@@ -35,6 +35,11 @@ DSOEXPORT std::unique_ptr<IOChannel> makeFileChannel(FILE* fp, bool close);
 /// @param mode The mode the file should be opened in, such as "rb" "w+b" (see
 /// std::fopen)
 ///
+/// Regular files opened for reading only are mapped in memory when the
+/// system allows it, so that reading them needs no system calls and
+/// IOChannel::view() can give their bytes in place. A mapped file must
+/// not be truncated while it is read.
+///
 /// @return An IOChannel or NULL if the file could not be opened.
 DSOEXPORT std::unique_ptr<IOChannel> makeFileChannel(const char* filepath, const char* mode);
 
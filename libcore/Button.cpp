@@ -764,6 +764,25 @@ Button::getBounds() const
     return allBounds;
 }
 
+SWFRect
+Button::getLocalHitBounds() const
+{
+    SWFRect allBounds;
+
+    typedef std::vector<const DisplayObject*> Chars;
+    Chars actChars;
+    getActiveCharacters(actChars);
+    for (const DisplayObject* ch : actChars) {
+        allBounds.expand_to_rect(ch->getHitBounds());
+    }
+
+    for (const DisplayObject* ch : _hitCharacters) {
+        allBounds.expand_to_rect(ch->getHitBounds());
+    }
+
+    return allBounds;
+}
+
 bool
 Button::pointInShape(std::int32_t x, std::int32_t y) const
 {
@@ -106,6 +106,10 @@ public:
     void add_invalidated_bounds(InvalidatedRanges& ranges, bool force);
     
     virtual SWFRect getBounds() const;
+
+    /// Include the hit area, which may be larger than the active
+    /// DisplayObjects.
+    virtual SWFRect getLocalHitBounds() const;
     
     // See dox in DisplayObject.h
     bool pointInShape(std::int32_t x, std::int32_t y) const;
@@ -0,0 +1,312 @@
+// DeviceGlyphCache.cpp: outlines of device font glyphs, shared by all fonts.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include "DeviceGlyphCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include "GnashFileUtilities.h"
+#include "ShapeRecord.h"
+#include "FillStyle.h"
+#include "Geometry.h"
+#include "SWFRect.h"
+#include "RGBA.h"
+#include "rc.h"
+#include "log.h"
+
+namespace gnash {
+
+namespace {
+
+/// Identifies a glyph cache file, and its version and byte order.
+const char magic[] = "GnashGlyphs1";
+const std::uint32_t byteOrder = 0x01020304;
+
+// Limits to reject corrupt files before allocating for them.
+const std::uint32_t maxFaceLength = 4096;
+const std::uint32_t maxPaths = 1 << 16;
+const std::uint32_t maxEdges = 1 << 20;
+
+/// The cache used by device fonts, kept in the rc file's glyphCacheFile.
+class DefaultCache : public DeviceGlyphCache
+{
+public:
+
+    DefaultCache()
+        :
+        _path(RcInitFile::getDefaultInstance().getGlyphCacheFile())
+    {
+        if (!_path.empty() && !load(_path)) {
+            log_debug("No glyphs read from glyph cache %s", _path);
+        }
+    }
+
+    ~DefaultCache() {
+        if (!_path.empty() && changed()) save(_path);
+    }
+
+private:
+
+    const std::string _path;
+};
+
+template<typename T>
+bool
+readValue(FILE* f, T& value)
+{
+    return std::fread(&value, sizeof value, 1, f) == 1;
+}
+
+template<typename T>
+void
+writeValue(FILE* f, const T& value)
+{
+    std::fwrite(&value, sizeof value, 1, f);
+}
+
+/// Read a glyph shape, the way it was made from a system font.
+std::unique_ptr<SWF::ShapeRecord>
+readShape(FILE* f)
+{
+    std::unique_ptr<SWF::ShapeRecord> shape;
+
+    std::uint8_t hasBounds;
+    if (!readValue(f, hasBounds)) return shape;
+
+    SWFRect bounds;
+    if (hasBounds) {
+        std::int32_t b[4];
+        if (std::fread(b, sizeof b, 1, f) != 1) return shape;
+        bounds = SWFRect(b[0], b[1], b[2], b[3]);
+    }
+
+    std::uint32_t pathCount;
+    if (!readValue(f, pathCount) || pathCount > maxPaths) return shape;
+
+    SWF::Subshape subshape;
+    subshape.addFillStyle(SolidFill(rgba()));
+
+    for (std::uint32_t i = 0; i < pathCount; ++i) {
+        std::uint32_t styles[3];
+        std::int32_t start[2];
+        std::uint32_t edgeCount;
+        if (std::fread(styles, sizeof styles, 1, f) != 1 ||
+                std::fread(start, sizeof start, 1, f) != 1 ||
+                !readValue(f, edgeCount) || edgeCount > maxEdges) {
+            return shape;
+        }
+
+        // Glyphs only have the one fill style, and no line styles.
+        if (styles[0] > 1 || styles[1] > 1 || styles[2]) return shape;
+
+        Path path(start[0], start[1], styles[0], styles[1], styles[2]);
+        std::vector<std::int32_t> edges(edgeCount * 4);
+        if (edgeCount && std::fread(&edges[0], sizeof(std::int32_t),
+                    edges.size(), f) != edges.size()) {
+            return shape;
+        }
+        for (size_t e = 0; e < edges.size(); e += 4) {
+            path.m_edges.emplace_back(edges[e], edges[e + 1], edges[e + 2],
+                    edges[e + 3]);
+        }
+        subshape.addPath(path);
+    }
+
+    subshape.pack();
+
+    shape.reset(new SWF::ShapeRecord);
+    shape->addSubshape(subshape);
+    shape->setBounds(bounds);
+    return shape;
+}
+
+void
+writeShape(FILE* f, const SWF::ShapeRecord& shape)
+{
+    const SWFRect& bounds = shape.getBounds();
+    const std::uint8_t hasBounds = !bounds.is_null();
+    writeValue(f, hasBounds);
+    if (hasBounds) {
+        const std::int32_t b[4] = { bounds.get_x_min(), bounds.get_y_min(),
+            bounds.get_x_max(), bounds.get_y_max() };
+        std::fwrite(b, sizeof b, 1, f);
+    }
+
+    // Glyphs made from system fonts have a single subshape.
+    SWF::ShapeRecord::Paths paths;
+    if (!shape.subshapes().empty()) {
+        shape.subshapes().front().copyPaths(paths);
+    }
+
+    writeValue(f, static_cast<std::uint32_t>(paths.size()));
+    for (const Path& path : paths) {
+        const std::uint32_t styles[3] = { path.m_fill0, path.m_fill1,
+            path.m_line };
+        const std::int32_t start[2] = { path.ap.x, path.ap.y };
+        std::fwrite(styles, sizeof styles, 1, f);
+        std::fwrite(start, sizeof start, 1, f);
+        writeValue(f, static_cast<std::uint32_t>(path.m_edges.size()));
+        for (const Edge& edge : path.m_edges) {
+            const std::int32_t e[4] = { edge.cp.x, edge.cp.y, edge.ap.x,
+                edge.ap.y };
+            std::fwrite(e, sizeof e, 1, f);
+        }
+    }
+}
+
+} // anonymous namespace
+
+DeviceGlyphCache::DeviceGlyphCache()
+    :
+    _changed(false)
+{
+}
+
+DeviceGlyphCache&
+DeviceGlyphCache::getDefaultInstance()
+{
+    static DefaultCache cache;
+    return cache;
+}
+
+bool
+DeviceGlyphCache::get(const std::string& face, std::uint32_t index,
+        Glyph& glyph) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<Key, Glyph>::const_iterator it =
+        _glyphs.find(std::make_pair(face, index));
+    if (it == _glyphs.end()) return false;
+    glyph = it->second;
+    return true;
+}
+
+void
+DeviceGlyphCache::add(const std::string& face, std::uint32_t index,
+        Glyph& glyph)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::pair<std::map<Key, Glyph>::iterator, bool> ins =
+        _glyphs.insert(std::make_pair(std::make_pair(face, index), glyph));
+    if (ins.second) _changed = true;
+    else glyph = ins.first->second;
+}
+
+size_t
+DeviceGlyphCache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _glyphs.size();
+}
+
+bool
+DeviceGlyphCache::changed() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _changed;
+}
+
+bool
+DeviceGlyphCache::load(const std::string& path)
+{
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+
+    char header[sizeof magic];
+    std::uint32_t order;
+    bool ok = std::fread(header, sizeof header, 1, f) == 1 &&
+        !std::memcmp(header, magic, sizeof magic) &&
+        readValue(f, order) && order == byteOrder;
+
+    std::uint32_t faceLength;
+    while (ok && readValue(f, faceLength)) {
+        ok = false;
+        if (faceLength > maxFaceLength) break;
+
+        std::string face(faceLength, '\0');
+        std::uint32_t index;
+        Glyph glyph;
+        if ((faceLength &&
+                    std::fread(&face[0], faceLength, 1, f) != 1) ||
+                !readValue(f, index) || !readValue(f, glyph.advance)) {
+            break;
+        }
+
+        glyph.shape = readShape(f);
+        if (!glyph.shape) break;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _glyphs.insert(std::make_pair(std::make_pair(face, index), glyph));
+        ok = true;
+    }
+
+    ok = ok && !std::ferror(f);
+    std::fclose(f);
+    return ok;
+}
+
+bool
+DeviceGlyphCache::save(const std::string& path)
+{
+    if (!mkdirRecursive(path)) return false;
+
+    std::ostringstream tmp;
+    tmp << path << ".tmp-" << getpid();
+    const std::string tmpPath = tmp.str();
+
+    FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) return false;
+
+    std::fwrite(magic, sizeof magic, 1, f);
+    writeValue(f, byteOrder);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const std::pair<const Key, Glyph>& g : _glyphs) {
+            const std::string& face = g.first.first;
+            writeValue(f, static_cast<std::uint32_t>(face.size()));
+            std::fwrite(face.data(), face.size(), 1, f);
+            writeValue(f, g.first.second);
+            writeValue(f, g.second.advance);
+            writeShape(f, *g.second.shape);
+        }
+        _changed = false;
+    }
+
+    const bool ok = !std::ferror(f);
+    if (std::fclose(f) != 0 || !ok ||
+            std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace gnash
+
+// Local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -0,0 +1,118 @@
+// DeviceGlyphCache.h: outlines of device font glyphs, shared by all fonts.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_DEVICEGLYPHCACHE_H
+#define GNASH_DEVICEGLYPHCACHE_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <boost/noncopyable.hpp>
+
+#include "dsodefs.h"
+
+// Forward declarations
+namespace gnash {
+    namespace SWF {
+        class ShapeRecord;
+    }
+}
+
+namespace gnash {
+
+/// Outlines of device font glyphs, shared by all Fonts of all movies.
+//
+/// Making an outline from a system font is slow, and every Font using a
+/// device font used to make its own. Glyphs are kept by face and glyph
+/// index, where the face is a string identifying a font file, so that a
+/// glyph is only made once per process, or once at all if the cache is
+/// saved to a file.
+///
+/// All methods are thread-safe. The outlines are immutable once added.
+class DSOEXPORT DeviceGlyphCache : boost::noncopyable
+{
+public:
+
+    struct Glyph
+    {
+        Glyph() : advance(0) {}
+
+        std::shared_ptr<const SWF::ShapeRecord> shape;
+
+        /// Advance to the next glyph, in the units of the shape.
+        float advance;
+    };
+
+    DeviceGlyphCache();
+
+    /// Get the cache used by device fonts.
+    //
+    /// The glyphs in the file set by the glyphCacheFile rc option are
+    /// read the first time this is called, and the file is written at
+    /// exit if glyphs were added.
+    static DeviceGlyphCache& getDefaultInstance();
+
+    /// Find a glyph.
+    //
+    /// @return whether the glyph was found.
+    bool get(const std::string& face, std::uint32_t index, Glyph& glyph) const;
+
+    /// Add a glyph.
+    //
+    /// If the glyph was added meanwhile, by another thread, the glyph
+    /// is set to that one, so that the outline is still shared.
+    void add(const std::string& face, std::uint32_t index, Glyph& glyph);
+
+    /// Return the number of glyphs.
+    size_t size() const;
+
+    /// Whether glyphs were added since the cache was last loaded or saved.
+    bool changed() const;
+
+    /// Add the glyphs from a file written by save().
+    //
+    /// Glyphs already in the cache are kept.
+    ///
+    /// @return false if the file couldn't be read or was not valid, in
+    ///         which case glyphs before the error may have been added.
+    bool load(const std::string& path);
+
+    /// Write all glyphs to a file.
+    //
+    /// The file is written under a temporary name and then renamed, so
+    /// that processes reading it never see a partial file.
+    ///
+    /// @return false if the file couldn't be written.
+    bool save(const std::string& path);
+
+private:
+
+    typedef std::pair<std::string, std::uint32_t> Key;
+
+    mutable std::mutex _mutex;
+
+    std::map<Key, Glyph> _glyphs;
+
+    bool _changed;
+};
+
+} // namespace gnash
+
+#endif
@@ -26,6 +26,7 @@
 #include <stack>
 #include <cassert>
 #include <functional>
+#include <utility>
 #include <boost/format.hpp>
 
 #include "log.h"
@@ -60,14 +61,6 @@ namespace {
 /// Anonymous namespace for generic algorithm functors.
 namespace {
 
-struct DepthEquals : std::binary_function<const DisplayObject*, int, bool>
-{
-    bool operator()(const DisplayObject* item, int depth) const {
-        if (!item) return false;
-        return item->get_depth() == depth;
-    }
-};
-
 struct DepthLessThan : std::binary_function<const DisplayObject*, int, bool>
 {
     bool operator()(const DisplayObject* item, int depth) const {
@@ -76,14 +69,6 @@ struct DepthLessThan : std::binary_function<const DisplayObject*, int, bool>
     }
 };
 
-struct DepthGreaterThan : std::binary_function<const DisplayObject*, int, bool>
-{
-    bool operator()(const DisplayObject* item, int depth) const {
-        if (!item) return false;
-        return item->get_depth() > depth;
-    }
-};
-
 class NameEquals
 {
 public:
@@ -118,15 +103,9 @@ DisplayList::getNextHighestDepth() const
 {
     testInvariant();
 
-    int nexthighestdepth=0;
-    for (DisplayObject* ch : _charsByDepth) {
-
-        const int chdepth = ch->get_depth();
-        if (chdepth >= nexthighestdepth) {
-            nexthighestdepth = chdepth+1;
-        }
-    }
-    return nexthighestdepth;
+    // The list is sorted, so the last DisplayObject has the highest depth.
+    if (_charsByDepth.empty()) return 0;
+    return std::max(0, _charsByDepth.back()->get_depth() + 1);
 }
 
 DisplayObject*
@@ -134,20 +113,18 @@ DisplayList::getDisplayObjectAtDepth(int depth) const
 {
     testInvariant();
 
-    for (DisplayObject* ch : _charsByDepth) {
+    for (const_iterator it = std::lower_bound(_charsByDepth.begin(),
+                _charsByDepth.end(), depth, DepthLessThan()),
+            itEnd = _charsByDepth.end();
+            it != itEnd && (*it)->get_depth() == depth; ++it) {
 
         // Should not be there!
-        if (ch->isDestroyed()) continue;
-
-        // found
-        if (ch->get_depth() == depth) return ch;
+        if ((*it)->isDestroyed()) continue;
 
-        // non-existent (chars are ordered by depth)
-        if (ch->get_depth() > depth) return nullptr;
+        return *it;
     }
 
     return nullptr;
-
 }
 
 
@@ -157,6 +134,35 @@ DisplayList::getDisplayObjectByName(string_table& st, const ObjectURI& uri,
 {
     testInvariant();
 
+    // The lowercase keys depend on the string_table.
+    if (caseless && _st != &st) {
+        _namesNoCase.valid = false;
+        _st = &st;
+    }
+
+    NameIndex& index = caseless ? _namesNoCase : _names;
+
+    if (!index.valid) {
+        index.entries.clear();
+        for (DisplayObject* ch : _charsByDepth) {
+            const ObjectURI& name = ch->get_name();
+            NameEntry& e =
+                index.entries[caseless ? name.noCase(st) : getName(name)];
+            if (!e.count++) e.first = ch;
+        }
+        index.valid = true;
+    }
+
+    const auto found =
+        index.entries.find(caseless ? uri.noCase(st) : getName(uri));
+
+    if (found == index.entries.end()) return nullptr;
+
+    DisplayObject* ch = found->second.first;
+    if (!ch->isDestroyed()) return ch;
+
+    // Destroyed DisplayObjects shouldn't be found (see NameEquals), so
+    // look for the next one with the name.
     const container_type::const_iterator e = _charsByDepth.end();
 
     container_type::const_iterator it =
@@ -165,7 +171,16 @@ DisplayList::getDisplayObjectByName(string_table& st, const ObjectURI& uri,
     if (it == e) return nullptr;
     
     return *it;
+}
 
+void
+DisplayList::renamed(DisplayObject& ch, const ObjectURI& oldName)
+{
+    if (!_names.valid && !_namesNoCase.valid) return;
+    if (find(&ch) == _charsByDepth.end()) return;
+
+    unindexName(&ch, oldName);
+    indexName(&ch);
 }
 
 void
@@ -175,14 +190,13 @@ DisplayList::placeDisplayObject(DisplayObject* ch, int depth)
     ch->set_invalidated();
     ch->set_depth(depth);
 
-    container_type::iterator it =
-        std::find_if( _charsByDepth.begin(), _charsByDepth.end(),
-                std::bind(std::not2(DepthLessThan()), std::placeholders::_1,
-                     depth));
+    container_type::iterator it = std::lower_bound(_charsByDepth.begin(),
+            _charsByDepth.end(), depth, DepthLessThan());
 
     if (it == _charsByDepth.end() || (*it)->get_depth() != depth) {
         // add the new char
         _charsByDepth.insert(it, ch);
+        indexName(ch);
     }
     else {
         // remember bounds of old char
@@ -193,7 +207,9 @@ DisplayList::placeDisplayObject(DisplayObject* ch, int depth)
         DisplayObject* oldCh = *it;
 
         // replace existing char (before calling unload!)
+        unindexName(oldCh);
         *it = ch;
+        indexName(ch);
     
         if (oldCh->unload()) {
             // reinsert removed DisplayObject if needed
@@ -213,15 +229,18 @@ DisplayList::add(DisplayObject* ch, bool replace)
 {
     const int depth = ch->get_depth();
 
-    container_type::iterator it =
-        std::find_if(_charsByDepth.begin(), _charsByDepth.end(),
-                std::bind(std::not2(DepthLessThan()), std::placeholders::_1,
-                     depth));
+    container_type::iterator it = std::lower_bound(_charsByDepth.begin(),
+            _charsByDepth.end(), depth, DepthLessThan());
 
     if (it == _charsByDepth.end() || (*it)->get_depth() != depth) {
         _charsByDepth.insert(it, ch);
+        indexName(ch);
+    }
+    else if (replace) {
+        unindexName(*it);
+        *it = ch;
+        indexName(ch);
     }
-    else if (replace) *it = ch;
 
     testInvariant();
 }
@@ -238,12 +257,12 @@ DisplayList::replaceDisplayObject(DisplayObject* ch, int depth,
     ch->set_invalidated();
     ch->set_depth(depth);
 
-    container_type::iterator it =
-        std::find_if(_charsByDepth.begin(), _charsByDepth.end(),
-            std::bind(std::not2(DepthLessThan()), std::placeholders::_1, depth));
+    container_type::iterator it = std::lower_bound(_charsByDepth.begin(),
+            _charsByDepth.end(), depth, DepthLessThan());
 
     if (it == _charsByDepth.end() || (*it)->get_depth() != depth) {
         _charsByDepth.insert(it, ch);
+        indexName(ch);
     }
     else {
         // Make a copy (before replacing)
@@ -265,7 +284,9 @@ DisplayList::replaceDisplayObject(DisplayObject* ch, int depth,
         oldch->add_invalidated_bounds(old_ranges, true);        
 
         // replace existing char (before calling unload)
+        unindexName(oldch);
         *it = ch;
+        indexName(ch);
 
         // Unload old char
         if (oldch->unload()) {
@@ -338,16 +359,15 @@ DisplayList::removeDisplayObject(int depth)
 
     // TODO: would it be legal to call removeDisplayObject with a depth
     //             in the "removed" zone ?
-    // TODO: optimize to take by-depth order into account
-    container_type::iterator it = 
-        std::find_if( _charsByDepth.begin(), _charsByDepth.end(),
-            std::bind(DepthEquals(), std::placeholders::_1, depth));
+    container_type::iterator it = std::lower_bound(_charsByDepth.begin(),
+            _charsByDepth.end(), depth, DepthLessThan());
 
-    if (it != _charsByDepth.end()) {
+    if (it != _charsByDepth.end() && (*it)->get_depth() == depth) {
         // Make a copy (before erasing)
         DisplayObject* oldCh = *it;
 
         // Erase (before calling unload)
+        unindexName(oldCh);
         _charsByDepth.erase(it);
 
         if (oldCh->unload()) {
@@ -389,15 +409,11 @@ DisplayList::swapDepths(DisplayObject* ch1, int newdepth)
 
     assert(srcdepth != newdepth);
 
-    // TODO: optimize this scan by taking ch1 depth into account ?
-    container_type::iterator it1 =
-        std::find(_charsByDepth.begin(), _charsByDepth.end(), ch1);
+    container_type::iterator it1 = find(ch1);
 
     // upper bound ...
-    container_type::iterator it2 =
-        std::find_if(_charsByDepth.begin(), _charsByDepth.end(),
-            std::bind(std::not2(DepthLessThan()), std::placeholders::_1,
-                newdepth));
+    container_type::iterator it2 = std::lower_bound(_charsByDepth.begin(),
+            _charsByDepth.end(), newdepth, DepthLessThan());
 
     if (it1 == _charsByDepth.end()) {
         log_error(_("First argument to DisplayList::swapDepth() "
@@ -405,10 +421,15 @@ DisplayList::swapDepths(DisplayObject* ch1, int newdepth)
         return;
     }
 
+    // The order of DisplayObjects with the same name may change.
+    unindexName(ch1);
+
     // Found another DisplayObject at the given depth
     if (it2 != _charsByDepth.end() && (*it2)->get_depth() == newdepth) {
         DisplayObject* ch2 = *it2;
+        unindexName(ch2);
         ch2->set_depth(srcdepth);
+        indexName(ch2);
 
         // TODO: we're not actually invalidated ourselves, rather 
         // our parent is...
@@ -422,16 +443,16 @@ DisplayList::swapDepths(DisplayObject* ch1, int newdepth)
     }
     else {
         // No DisplayObject found at the given depth
-        // Move the DisplayObject to the new position
-        // NOTE: insert *before* erasing, in case the list is
-        //             the only referer of the ref-counted DisplayObject
-        _charsByDepth.insert(it2, ch1);
-        _charsByDepth.erase(it1);
+        // Move the DisplayObject to the new position, shifting the
+        // ones in between.
+        if (it1 < it2) std::rotate(it1, it1 + 1, it2);
+        else std::rotate(it2, it1, it1 + 1);
     }
 
     // don't change depth before the iter_swap case above, as
     // we'll need it to assign to the new DisplayObject
     ch1->set_depth(newdepth);
+    indexName(ch1);
 
     // TODO: we're not actually invalidated ourselves, rather our parent is...
     //             UdoG ? Want to verify this ?
@@ -454,13 +475,11 @@ DisplayList::insertDisplayObject(DisplayObject* obj, int index)
     obj->set_depth(index);
 
     // Find the first index greater than or equal to the required index
-    container_type::iterator it =
-        std::find_if(_charsByDepth.begin(), _charsByDepth.end(),
-            std::bind(std::not2(DepthLessThan()), std::placeholders::_1,
-                index));
+    container_type::iterator it = std::lower_bound(_charsByDepth.begin(),
+            _charsByDepth.end(), index, DepthLessThan());
         
     // Insert the DisplayObject before that position
-    _charsByDepth.insert(it, obj);
+    it = _charsByDepth.insert(it, obj) + 1;
 
     // Shift depths upwards until no depths are duplicated. No DisplayObjects
     // are removed!
@@ -469,6 +488,10 @@ DisplayList::insertDisplayObject(DisplayObject* obj, int index)
         ++index, ++it;
     }
 
+    // The shifted DisplayObjects keep their order, so only the new one
+    // changes the name index.
+    indexName(obj);
+
     testInvariant();
 }
 
@@ -484,8 +507,11 @@ DisplayList::unload()
     // the first unload handler is encountered, subsequent children should
     // not be destroyed or removed from the display list. This affects
     // children without an unload handler.
-    for (iterator it = beginNonRemoved(_charsByDepth),
-            itEnd = _charsByDepth.end(); it != itEnd; ) {
+    //
+    // The kept children are moved down over the removed ones, and the
+    // end of the list erased once.
+    iterator kept = beginNonRemoved(_charsByDepth);
+    for (iterator it = kept, itEnd = _charsByDepth.end(); it != itEnd; ++it) {
         // make a copy
         DisplayObject* di = *it;
 
@@ -495,16 +521,17 @@ DisplayList::unload()
         // Destroy those with a handler anyway?
         if (di->unload()) {
             unloadHandler = true;
-            ++it;
+            *kept++ = di;
             continue;
         }
 
         if (!unloadHandler) {
+            unindexName(di);
             di->destroy();
-            it = _charsByDepth.erase(it);
         }
-        else ++it;
+        else *kept++ = di;
     }
+    _charsByDepth.erase(kept, _charsByDepth.end());
 
     testInvariant();
 
@@ -517,21 +544,20 @@ DisplayList::destroy()
 {
     testInvariant();
 
-    for (iterator it = _charsByDepth.begin(), itEnd = _charsByDepth.end();
-            it != itEnd; ) {
-
-        // make a copy
-        DisplayObject* di = *it;
+    iterator kept = _charsByDepth.begin();
+    for (DisplayObject* di : _charsByDepth) {
 
         // skip if already unloaded
         if ( di->isDestroyed() ) {
-            ++it;
+            *kept++ = di;
             continue;
         }
 
+        unindexName(di);
         di->destroy();
-        it = _charsByDepth.erase(it); 
     }
+    _charsByDepth.erase(kept, _charsByDepth.end());
+
     testInvariant();
 }
 
@@ -615,7 +641,7 @@ DisplayList::omit_display()
     }
 }
 
-void 
+size_t
 DisplayList::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
 {
     testInvariant();
@@ -648,6 +674,8 @@ DisplayList::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
     std::stack<InvalidatedRanges> rangesStack;
     bool drawing_mask = false;
 
+    size_t skipped = 0;
+
     iterator it = beginNonRemoved(_charsByDepth);
     for (iterator endIt = _charsByDepth.end(); it != endIt; ++it) {
         DisplayObject* dobj = *it;
@@ -697,6 +725,14 @@ DisplayList::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
             dobj->add_invalidated_bounds(ranges, force);
         }
         else {
+
+            // Neither the DisplayObject nor any of its children changed,
+            // so it has no invalidated bounds and there's no need to
+            // look into it. Masks are always needed for the ranges stack.
+            if (!force && !dobj->invalidated() && !dobj->childInvalidated()) {
+                ++skipped;
+                continue;
+            }
             
             if (rangesStack.empty()) {
                 // --> normal case for unmasked DisplayObjects
@@ -726,6 +762,8 @@ DisplayList::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
             drawing_mask = false; 
         }
     }
+
+    return skipped;
 }
 
 void
@@ -733,101 +771,93 @@ DisplayList::mergeDisplayList(DisplayList& newList, DisplayObject& o)
 {
     testInvariant();
 
-    iterator itOld = beginNonRemoved(_charsByDepth);
-    iterator itNew = beginNonRemoved(newList._charsByDepth);
+    container_type& oldChars = _charsByDepth;
+    container_type& newChars = newList._charsByDepth;
 
-    iterator itOldEnd = dlistTagsEffectiveZoneEnd(_charsByDepth);
-    iterator itNewEnd = dlistTagsEffectiveZoneEnd(newList._charsByDepth);
+    iterator itOld = beginNonRemoved(oldChars);
+    iterator itNew = beginNonRemoved(newChars);
 
-    // step1. 
-    // starting scanning both lists.
-    while (itOld != itOldEnd) {
+    const iterator itOldEnd = dlistTagsEffectiveZoneEnd(oldChars);
+    const iterator itNewEnd = dlistTagsEffectiveZoneEnd(newChars);
 
-        iterator itOldBackup = itOld;
-        
-        DisplayObject* chOld = *itOldBackup;
-        const int depthOld = chOld->get_depth();
+    // The merged list is built in a new container, as inserting into
+    // and erasing from the old one would invalidate the iterators. It
+    // starts with the "removed" zone of the old list.
+    container_type merged(oldChars.begin(), itOld);
+    merged.reserve(oldChars.size() + (itNewEnd - itNew));
 
-        while (itNew != itNewEnd) {
-            iterator itNewBackup = itNew;
-            
-            DisplayObject* chNew = *itNewBackup;
-            const int depthNew = chNew->get_depth();
-            
-            // depth in old list is occupied, and empty in new list.
-            if (depthOld < depthNew) {
+    // DisplayObjects of the old list to unload once the merged list is
+    // in place, paired with the DisplayObject of the new list they take
+    // their transformation from if they are kept.
+    std::vector<std::pair<DisplayObject*, DisplayObject*> > changes;
 
-                ++itOld;
-                // unload the DisplayObject if it's in static zone(-16384,0)
-                if (depthOld < 0) {
-                    o.set_invalidated();
-                    _charsByDepth.erase(itOldBackup);
+    // step1. 
+    // starting scanning both lists.
+    while (itOld != itOldEnd && itNew != itNewEnd) {
 
-                     if (chOld->unload()) reinsertRemovedCharacter(chOld);
-                     else chOld->destroy();
-                }
+        DisplayObject* chOld = *itOld;
+        const int depthOld = chOld->get_depth();
 
-                break;
-            }
-            // depth is occupied in both lists
+        DisplayObject* chNew = *itNew;
+        const int depthNew = chNew->get_depth();
             
-            if (depthOld == depthNew) {
-                ++itOld;
-                ++itNew;
-                
-                const bool is_ratio_compatible = 
-                    (chOld->get_ratio() == chNew->get_ratio());
-
-                if (!is_ratio_compatible || chOld->isDynamic() ||
-                        !isReferenceable(*chOld)) {
-                    // replace the DisplayObject in old list with
-                    // corresponding DisplayObject in new list
-                    o.set_invalidated();
-                    _charsByDepth.insert(itOldBackup, *itNewBackup);
-                    _charsByDepth.erase(itOldBackup);
-                    
-                    // unload the old DisplayObject
-                    if (chOld->unload()) reinsertRemovedCharacter(chOld); 
-                    else chOld->destroy();
-                }
-                else {
-                    newList._charsByDepth.erase(itNewBackup);
-
-                    // replace the transformation SWFMatrix if the old
-                    // DisplayObject accepts static transformation.
-                    if (chOld->get_accept_anim_moves()) {
-                        chOld->setMatrix(getMatrix(*chNew), true); 
-                        chOld->setCxForm(getCxForm(*chNew));
-                    }
-                    chNew->unload();
-                    chNew->destroy();
-                }
-
-                break;
+        // depth in old list is occupied, and empty in new list.
+        if (depthOld < depthNew) {
+
+            ++itOld;
+            // unload the DisplayObject if it's in static zone(-16384,0)
+            if (depthOld < 0) {
+                o.set_invalidated();
+                changes.push_back(std::make_pair(chOld, nullptr));
             }
+            else merged.push_back(chOld);
+            continue;
+        }
 
-            // depth in old list is empty, but occupied in new list.
+        // depth in old list is empty, but occupied in new list.
+        if (depthOld > depthNew) {
             ++itNew;
             // add the new DisplayObject to the old list.
             o.set_invalidated();
-            _charsByDepth.insert(itOldBackup, *itNewBackup);
+            merged.push_back(chNew);
+            continue;
         }
 
-        // break if finish scanning the new list
-        if (itNew == itNewEnd) break;
+        // depth is occupied in both lists
+        const bool is_ratio_compatible = 
+            (chOld->get_ratio() == chNew->get_ratio());
+
+        if (!is_ratio_compatible || chOld->isDynamic() ||
+                !isReferenceable(*chOld)) {
+            // replace the DisplayObject in old list with
+            // corresponding DisplayObject in new list
+            o.set_invalidated();
+            merged.push_back(chNew);
+            changes.push_back(std::make_pair(chOld, nullptr));
+        }
+        else {
+            // keep the old DisplayObject, dropping the new one from
+            // the new list.
+            merged.push_back(chOld);
+            changes.push_back(std::make_pair(chOld, chNew));
+            *itNew = nullptr;
+        }
+
+        ++itOld;
+        ++itNew;
     }
 
     // step2(only required if scanning of new list finished earlier in step1).
     // continue to scan the static zone of the old list.
     // unload remaining DisplayObjects directly.
-    while ((itOld != itOldEnd) && ((*itOld)->get_depth() < 0)) {
+    for (; itOld != itOldEnd; ++itOld) {
 
         DisplayObject* chOld = *itOld;
-        o.set_invalidated();
-        itOld = _charsByDepth.erase(itOld);
-
-        if (chOld->unload()) reinsertRemovedCharacter(chOld);
-        else chOld->destroy();
+        if (chOld->get_depth() < 0) {
+            o.set_invalidated();
+            changes.push_back(std::make_pair(chOld, nullptr));
+        }
+        else merged.push_back(chOld);
     }
 
     // step3(only required if scanning of old list finished earlier in step1).
@@ -835,25 +865,51 @@ DisplayList::mergeDisplayList(DisplayList& newList, DisplayObject& o)
     // add remaining DisplayObjects directly.
     if (itNew != itNewEnd) {
         o.set_invalidated();
-        _charsByDepth.insert(itOld, itNew, itNewEnd);
+        merged.insert(merged.end(), itNew, itNewEnd);
+    }
+
+    merged.insert(merged.end(), itOldEnd, oldChars.end());
+    oldChars.swap(merged);
+    dropNames();
+
+    for (const auto& change : changes) {
+
+        DisplayObject* chOld = change.first;
+        DisplayObject* chNew = change.second;
+
+        if (!chNew) {
+            // unload the old DisplayObject
+            if (chOld->unload()) reinsertRemovedCharacter(chOld);
+            else chOld->destroy();
+            continue;
+        }
+
+        // replace the transformation SWFMatrix if the old
+        // DisplayObject accepts static transformation.
+        if (chOld->get_accept_anim_moves()) {
+            chOld->setMatrix(getMatrix(*chNew), true); 
+            chOld->setCxForm(getCxForm(*chNew));
+        }
+        chNew->unload();
+        chNew->destroy();
     }
 
     // step4.
     // Copy all unloaded DisplayObjects from the new display list to the
     // old display list, and clear the new display list
-    for (itNew = newList._charsByDepth.begin(); itNew != itNewEnd; ++itNew) {
+    for (itNew = newChars.begin(); itNew != itNewEnd; ++itNew) {
 
         DisplayObject* chNew = *itNew;
+        if (!chNew) continue;
+
         const int depthNew = chNew->get_depth();
 
         if (chNew->unloaded()) {
-            iterator it =
-                std::find_if(_charsByDepth.begin(), _charsByDepth.end(),
-                    std::bind(std::not2(DepthLessThan()), std::placeholders::_1,
-                        depthNew));
+            iterator it = std::lower_bound(_charsByDepth.begin(),
+                    _charsByDepth.end(), depthNew, DepthLessThan());
             
             o.set_invalidated();
-            _charsByDepth.insert(it, *itNew);
+            _charsByDepth.insert(it, chNew);
         }
     }
 
@@ -866,7 +922,7 @@ DisplayList::mergeDisplayList(DisplayList& newList, DisplayObject& o)
             e = newList._charsByDepth.end(); i != e; ++i) {
 
         DisplayObject* ch = *i;
-        if (!ch->unloaded()) {
+        if (ch && !ch->unloaded()) {
 
             iterator found =
                 std::find(_charsByDepth.begin(), _charsByDepth.end(), ch);
@@ -885,6 +941,7 @@ DisplayList::mergeDisplayList(DisplayList& newList, DisplayObject& o)
     }
 #endif
     newList._charsByDepth.clear();
+    newList.dropNames();
 
     testInvariant();
 }
@@ -902,13 +959,11 @@ DisplayList::reinsertRemovedCharacter(DisplayObject* ch)
     int newDepth = DisplayObject::removedDepthOffset - oldDepth;
     ch->set_depth(newDepth);
 
-    // TODO: optimize this by searching from the end(lowest depth).
-    container_type::iterator it =
-        std::find_if(_charsByDepth.begin(), _charsByDepth.end(),
-                std::bind(std::not2(DepthLessThan()), std::placeholders::_1,
-                    newDepth));
+    container_type::iterator it = std::lower_bound(_charsByDepth.begin(),
+            _charsByDepth.end(), newDepth, DepthLessThan());
 
     _charsByDepth.insert(it, ch);
+    indexName(ch);
 
     testInvariant();
 }
@@ -918,11 +973,90 @@ DisplayList::removeUnloaded()
 {
     testInvariant();
 
-    _charsByDepth.remove_if(std::mem_fn(&DisplayObject::unloaded));
+    const iterator last = std::remove_if(_charsByDepth.begin(),
+            _charsByDepth.end(), std::mem_fn(&DisplayObject::unloaded));
+
+    if (last != _charsByDepth.end()) {
+        _charsByDepth.erase(last, _charsByDepth.end());
+        dropNames();
+    }
 
     testInvariant();
 }
 
+DisplayList::iterator
+DisplayList::find(const DisplayObject* ch)
+{
+    const int depth = ch->get_depth();
+
+    for (iterator it = std::lower_bound(_charsByDepth.begin(),
+                _charsByDepth.end(), depth, DepthLessThan()),
+            itEnd = _charsByDepth.end();
+            it != itEnd && (*it)->get_depth() == depth; ++it) {
+        if (*it == ch) return it;
+    }
+    return _charsByDepth.end();
+}
+
+void
+DisplayList::indexName(DisplayObject* ch)
+{
+    indexName(ch, ch->get_name());
+}
+
+void
+DisplayList::indexName(DisplayObject* ch, const ObjectURI& name)
+{
+    NameIndex* indices[] = { &_names, &_namesNoCase };
+
+    for (NameIndex* index : indices) {
+
+        if (!index->valid) continue;
+
+        const string_table::key key =
+            index == &_names ? getName(name) : name.noCase(*_st);
+
+        // A DisplayObject is inserted before any others at its depth.
+        NameEntry& e = index->entries[key];
+        if (!e.count++ || ch->get_depth() <= e.first->get_depth()) {
+            e.first = ch;
+        }
+    }
+}
+
+void
+DisplayList::unindexName(DisplayObject* ch)
+{
+    unindexName(ch, ch->get_name());
+}
+
+void
+DisplayList::unindexName(DisplayObject* ch, const ObjectURI& name)
+{
+    NameIndex* indices[] = { &_names, &_namesNoCase };
+
+    for (NameIndex* index : indices) {
+
+        if (!index->valid) continue;
+
+        const string_table::key key =
+            index == &_names ? getName(name) : name.noCase(*_st);
+
+        auto it = index->entries.find(key);
+        if (it == index->entries.end()) {
+            // Should not happen!
+            index->valid = false;
+            continue;
+        }
+
+        NameEntry& e = it->second;
+        if (!--e.count) index->entries.erase(it);
+
+        // The next DisplayObject with the name isn't known.
+        else if (e.first == ch) index->valid = false;
+    }
+}
+
 
 #if GNASH_PARANOIA_LEVEL > 1 && !defined(NDEBUG)
 DisplayList::const_iterator
@@ -941,9 +1075,7 @@ beginNonRemoved(DisplayList::container_type& c)
     const int depth = 1 + DisplayObject::removedDepthOffset -
         DisplayObject::staticDepthOffset;
     
-    return std::find_if(c.begin(), c.end(),
-            std::bind(std::not2(DepthLessThan()), std::placeholders::_1,
-                depth));
+    return std::lower_bound(c.begin(), c.end(), depth, DepthLessThan());
 }
 
 #if GNASH_PARANOIA_LEVEL > 1 && !defined(NDEBUG)
@@ -954,18 +1086,17 @@ beginNonRemoved(const DisplayList::container_type& c)
     const int depth = 1 + DisplayObject::removedDepthOffset -
         DisplayObject::staticDepthOffset;
 
-    return std::find_if(c.begin(), c.end(), 
-            std::bind(std::not2(DepthLessThan()), std::placeholders::_1,
-                depth));
+    return std::lower_bound(c.begin(), c.end(), depth, DepthLessThan());
 }
 #endif
 
 DisplayList::iterator
 dlistTagsEffectiveZoneEnd(DisplayList::container_type& c)
 {
-    return std::find_if(c.begin(), c.end(), 
-            std::bind(DepthGreaterThan(), std::placeholders::_1,
-                0xffff + DisplayObject::staticDepthOffset));
+    // The first depth above 65535 (-16384).
+    const int depth = 0xffff + DisplayObject::staticDepthOffset + 1;
+
+    return std::lower_bound(c.begin(), c.end(), depth, DepthLessThan());
 }
 
 } // anonymous namespace
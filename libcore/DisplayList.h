@@ -20,7 +20,8 @@
 #ifndef GNASH_DLIST_H
 #define GNASH_DLIST_H
 
-#include <list>
+#include <vector>
+#include <unordered_map>
 #include <iosfwd>
 #if GNASH_PARANOIA_LEVEL > 1 && !defined(NDEBUG)
 #include "DisplayObject.h"
@@ -30,6 +31,7 @@
 #endif
 
 #include "snappingrange.h"
+#include "string_table.h"
 #include "dsodefs.h" // for DSOTEXPORT
 
 
@@ -61,18 +63,22 @@ namespace gnash {
 /// tags instructing when to add or remove DisplayObjects
 /// from the stage.
 ///
+/// The DisplayObjects are kept in a vector sorted by depth, so that
+/// they can be found by depth with a binary search, and the first
+/// DisplayObject with each name is indexed for lookups by name.
+///
 class DisplayList
 {
 
 public:
 
-	typedef std::list<DisplayObject*> container_type;
+	typedef std::vector<DisplayObject*> container_type;
 	typedef container_type::iterator iterator;
 	typedef container_type::const_iterator const_iterator;
 	typedef container_type::reverse_iterator reverse_iterator;
 	typedef container_type::const_reverse_iterator const_reverse_iterator;
 
-    DisplayList() {}
+    DisplayList() : _st(nullptr) {}
     ~DisplayList() {}
 
     /// Output operator
@@ -236,6 +242,16 @@ public:
 	DSOTEXPORT DisplayObject* getDisplayObjectByName(string_table& st,
             const ObjectURI& uri, bool caseless) const;
 
+	/// Update the name index after a DisplayObject was renamed
+	//
+	/// Nothing is done if the DisplayObject isn't in the list.
+	///
+	/// @param ch
+	///     The renamed DisplayObject.
+	/// @param oldName
+	///     The name it had before.
+	void renamed(DisplayObject& ch, const ObjectURI& oldName);
+
 	/// \brief 
 	/// Visit each DisplayObject in the list in reverse depth
 	/// order (higher depth first).
@@ -268,7 +284,12 @@ public:
 
     /// Like DisplayObject_instance::add_invalidated_bounds() this method calls the
     /// method with the same name of all childs.	
-	void add_invalidated_bounds(InvalidatedRanges& ranges, bool force);	
+	//
+	/// Childs that didn't change, and none of whose childs did, are
+	/// skipped unless force is true.
+	///
+	/// @return the number of childs skipped.
+	size_t add_invalidated_bounds(InvalidatedRanges& ranges, bool force);	
 	
 	/// Return number of elements in the list
 	size_t size() const { 
@@ -345,7 +366,60 @@ private:
     /// occupied
 	void reinsertRemovedCharacter(DisplayObject* ch);
 
+	/// Return an iterator to the given DisplayObject, or end() if it
+	/// isn't in the list.
+	iterator find(const DisplayObject* ch);
+
+	/// The DisplayObjects with one name.
+	struct NameEntry
+	{
+		/// The one with the lowest depth.
+		DisplayObject* first;
+
+		/// How many there are.
+		size_t count;
+	};
+
+	/// An index of the DisplayObjects in the list by name.
+	//
+	/// An index is only built when a lookup needs it, and is then kept
+	/// up to date by the common changes to the list. Other changes just
+	/// drop it, to be rebuilt on the next lookup.
+	struct NameIndex
+	{
+		NameIndex() : valid(false) {}
+
+		bool valid;
+
+		std::unordered_map<string_table::key, NameEntry> entries;
+	};
+
+	/// Add a DisplayObject just inserted in the list to the name indices.
+	void indexName(DisplayObject* ch, const ObjectURI& name);
+
+	void indexName(DisplayObject* ch);
+
+	/// Remove a DisplayObject about to be erased from the name indices.
+	void unindexName(DisplayObject* ch, const ObjectURI& name);
+
+	void unindexName(DisplayObject* ch);
+
+	/// Drop the name indices.
+	void dropNames() {
+		_names.valid = false;
+		_namesNoCase.valid = false;
+	}
+
 	container_type _charsByDepth;
+
+	/// The DisplayObjects by name.
+	mutable NameIndex _names;
+
+	/// The DisplayObjects by lowercase name, for caseless lookups.
+	mutable NameIndex _namesNoCase;
+
+	/// The string_table used for the keys of _namesNoCase.
+	mutable string_table* _st;
 };
 
 template <class V>
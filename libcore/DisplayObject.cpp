@@ -109,7 +109,8 @@ DisplayObject::DisplayObject(movie_root& mr, as_object* object,
     _unloaded(false),
     _destroyed(false),
     _invalidated(true),
-    _child_invalidated(true)
+    _child_invalidated(true),
+    _hitBoundsValid(false)
 {
     assert(m_old_invalidated_ranges.isNull());
 
@@ -188,6 +189,14 @@ DisplayObject::set_invalidated()
 void
 DisplayObject::set_invalidated(const char* debug_file, int debug_line)
 {
+    // Our hit bounds may change, and with them those of our parents.
+    // A new DisplayObject has none yet, so always start from the parent.
+    _hitBoundsValid = false;
+    for (DisplayObject* ch = _parent; ch && ch->_hitBoundsValid;
+            ch = ch->_parent) {
+        ch->_hitBoundsValid = false;
+    }
+
     // Set the invalidated-flag of the parent. Note this does not mean that
     // the parent must re-draw itself, it just means that one of it's childs
     // needs to be re-drawn.
@@ -234,6 +243,18 @@ DisplayObject::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
     }        
 }
 
+const SWFRect&
+DisplayObject::getHitBounds() const
+{
+    if (!_hitBoundsValid) {
+        _hitBounds.set_null();
+        _hitBounds.expand_to_transformed_rect(getMatrix(*this),
+                getLocalHitBounds());
+        _hitBoundsValid = true;
+    }
+    return _hitBounds;
+}
+
 void
 DisplayObject::set_child_invalidated()
 {
@@ -722,6 +743,16 @@ DisplayObject::allowHandCursor() const
     return toBool(val, getVM(*obj));
 }
 
+void
+DisplayObject::set_name(const ObjectURI& uri)
+{
+    const ObjectURI oldName = _name;
+    _name = uri;
+
+    DisplayObjectContainer* p = dynamic_cast<DisplayObjectContainer*>(_parent);
+    if (p) p->childRenamed(*this, oldName);
+}
+
 void
 DisplayObject::setMask(DisplayObject* mask)
 {
@@ -425,9 +425,9 @@ public:
     void setMask(DisplayObject* mask);
 
     /// Set DisplayObject name, initializing the original target member
-    void set_name(const ObjectURI& uri) {
-        _name = uri;
-    }
+    //
+    /// The parent's DisplayList is told, as it indexes its members by name.
+    void set_name(const ObjectURI& uri);
 
     const ObjectURI& get_name() const { return _name; }
 
@@ -479,6 +479,24 @@ public:
 
 	virtual SWFRect getBounds() const = 0;
 
+    /// Return the bounds of the area where this DisplayObject can be hit
+    /// by the mouse, in its parent's coordinate space.
+    //
+    /// Mouse hit tests only need to look at DisplayObjects whose hit
+    /// bounds contain the point, so the DisplayObject tree is a bounding
+    /// volume hierarchy for them. The bounds are cached until this
+    /// DisplayObject or one of its children is invalidated.
+    const SWFRect& getHitBounds() const;
+
+    /// Return the bounds of the area where this DisplayObject can be hit
+    /// by the mouse, in local coordinates.
+    //
+    /// The default implementation returns getBounds(). DisplayObjects
+    /// that can be hit outside of those must override this.
+    virtual SWFRect getLocalHitBounds() const {
+        return getBounds();
+    }
+
     /// Return true if the given point falls in this DisplayObject's bounds
     //
     /// @param x        Point x coordinate in world space
@@ -1111,6 +1129,15 @@ private:
     /// can be set at the same time. 
     bool _child_invalidated;
 
+    /// Cached result of getHitBounds().
+    mutable SWFRect _hitBounds;
+
+    /// Whether _hitBounds is up to date.
+    //
+    /// This is only true if it is also true for all children, so
+    /// invalidation can stop at the first DisplayObject where it's false.
+    mutable bool _hitBoundsValid;
+
 
 };
 
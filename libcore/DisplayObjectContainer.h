@@ -57,6 +57,14 @@ public:
         return _displayList.size();
     }
 
+    /// Called when one of our children was renamed.
+    //
+    /// @param ch       The renamed child.
+    /// @param oldName  The name it had before.
+    void childRenamed(DisplayObject& ch, const ObjectURI& oldName) {
+        _displayList.renamed(ch, oldName);
+    }
+
 #ifdef USE_SWFTREE
     // Override to append display list info, see dox in DisplayObject.h
     virtual InfoTree::iterator getMovieInfo(InfoTree& tr,
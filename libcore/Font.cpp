@@ -59,7 +59,7 @@ Font::GlyphInfo::GlyphInfo()
     advance(0)
 {}
 
-Font::GlyphInfo::GlyphInfo(std::unique_ptr<SWF::ShapeRecord> the_glyph,
+Font::GlyphInfo::GlyphInfo(std::shared_ptr<const SWF::ShapeRecord> the_glyph,
         float advance)
     :
     glyph(std::move(the_glyph)),
@@ -97,7 +97,7 @@ Font::~Font()
 {
 }
 
-SWF::ShapeRecord*
+const SWF::ShapeRecord*
 Font::get_glyph(int index, bool embedded) const
 {
     // What to do if embedded is true and this is a
@@ -284,7 +284,7 @@ Font::add_os_glyph(std::uint16_t code)
     float advance;
 
     // Get the vectorial glyph
-    std::unique_ptr<SWF::ShapeRecord> sh = ft->getGlyph(code, advance);
+    std::shared_ptr<const SWF::ShapeRecord> sh = ft->getGlyph(code, advance);
 
     if (!sh.get()) {
         log_error(_("Could not create shape "
@@ -134,9 +134,9 @@ public:
     ///
     /// @return
     ///    The glyph outline, or NULL if out of range. (would be a
-    /// programming error most likely). The ShapeRecord is owned by
-    /// the Font class.
-    SWF::ShapeRecord* get_glyph(int glyph_index, bool embedded) const;
+    /// programming error most likely). The ShapeRecord lives at
+    /// least as long as the Font.
+    const SWF::ShapeRecord* get_glyph(int glyph_index, bool embedded) const;
 
     /// Get name of this font. 
     const std::string& name() const { return _name; }
@@ -231,10 +231,12 @@ public:
 
         /// Construct default textured glyph
         //
-        /// Takes ownership of the SWF::ShapeRecord.
-        GlyphInfo(std::unique_ptr<SWF::ShapeRecord> glyph, float advance);
+        /// The SWF::ShapeRecord of a device glyph is shared by all fonts
+        /// using the same system font.
+        GlyphInfo(std::shared_ptr<const SWF::ShapeRecord> glyph,
+                float advance);
 
-        std::unique_ptr<SWF::ShapeRecord> glyph;
+        std::shared_ptr<const SWF::ShapeRecord> glyph;
 
         float advance;
     };
@@ -24,11 +24,14 @@
 #include "FreetypeGlyphsProvider.h"
 
 #include <string>
+#include <sstream>
 #include <memory> // for unique_ptr
 #include <cstdint>
 #include <boost/format.hpp>
 
 #include "GnashException.h"
+#include "GnashFileUtilities.h"
+#include "DeviceGlyphCache.h"
 #include "ShapeRecord.h"
 #include "log.h"
 #include "FillStyle.h"
@@ -107,6 +110,10 @@ public:
     void finish() 
     {
         _currPath->close();
+
+        // The glyph is shared through the DeviceGlyphCache, so it
+        // won't change.
+        _subshape.pack();
         _shape.addSubshape(_subshape);
     }
 
@@ -467,6 +474,15 @@ FreetypeGlyphsProvider::FreetypeGlyphsProvider(const std::string& name,
     // we will scale 
     scale = (float)unitsPerEM()/_face->units_per_EM;
 
+    // Glyphs made from an older version of the file must not be used.
+    std::ostringstream key;
+    key << filename;
+    struct stat st;
+    if (stat(filename.c_str(), &st) == 0) {
+        key << ':' << st.st_size << ':' << st.st_mtime;
+    }
+    _faceKey = key.str();
+
 #ifdef GNASH_DEBUG_DEVICEFONTS
     log_debug("EM square for font '%s' is %d, scale is this %g",
               name, _face->units_per_EM, scale);
@@ -480,12 +496,23 @@ FreetypeGlyphsProvider::FreetypeGlyphsProvider(const std::string&, bool, bool)
 #endif // ndef USE_FREETYPE 
 
 #ifdef USE_FREETYPE
-std::unique_ptr<SWF::ShapeRecord>
+std::shared_ptr<const SWF::ShapeRecord>
 FreetypeGlyphsProvider::getGlyph(std::uint16_t code, float& advance)
 {
+    // Glyphs are cached by index, as fonts can map several codes to
+    // the same glyph.
+    const FT_UInt index = FT_Get_Char_Index(_face, code);
+
+    DeviceGlyphCache& cache = DeviceGlyphCache::getDefaultInstance();
+    DeviceGlyphCache::Glyph cached;
+    if (cache.get(_faceKey, index, cached)) {
+        advance = cached.advance;
+        return cached.shape;
+    }
+
     std::unique_ptr<SWF::ShapeRecord> glyph;
 
-    FT_Error error = FT_Load_Char(_face, code, FT_LOAD_NO_BITMAP | 
+    FT_Error error = FT_Load_Glyph(_face, index, FT_LOAD_NO_BITMAP | 
                                                 FT_LOAD_NO_SCALE);
 
     if (error) {
@@ -544,11 +571,15 @@ FreetypeGlyphsProvider::getGlyph(std::uint16_t code, float& advance)
 
     walker.finish();
 
-    return glyph;
+    cached.shape = std::move(glyph);
+    cached.advance = advance;
+    cache.add(_faceKey, index, cached);
+
+    return cached.shape;
 }
 #else // ndef(USE_FREETYPE)
 
-std::unique_ptr<SWF::ShapeRecord>
+std::shared_ptr<const SWF::ShapeRecord>
 FreetypeGlyphsProvider::getGlyph(std::uint16_t, float& advance)
 {
     abort(); // should never be called... 
@@ -99,9 +99,11 @@ public:
     ///
     /// @return A DefineShapeTag in unitsPerEM() coordinates,
     ///         or a NULL pointer if the given DisplayObject code
-    ///         doesn't exist in this font.
+    ///         doesn't exist in this font. The shape may be shared with
+    ///         other fonts using the same font file, through the
+    ///         DeviceGlyphCache.
     ///
-    std::unique_ptr<SWF::ShapeRecord> getGlyph(std::uint16_t code,
+    std::shared_ptr<const SWF::ShapeRecord> getGlyph(std::uint16_t code,
             float& advance);
 
     /// Return the font's ascender in terms of its EM own square.
@@ -168,6 +170,9 @@ private:
 
     FT_Face    _face;
 
+    /// Identifies the font file in the DeviceGlyphCache.
+    std::string _faceKey;
+
 #endif // USE_FREETYPE
 
 };
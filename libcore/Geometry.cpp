@@ -22,11 +22,108 @@
 #include <cmath>
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 
 #include "log.h"
 #include "LineStyle.h"
 
 namespace gnash {
+
+namespace {
+
+/// Append a value to a buffer, in the machine's byte order.
+template<typename T>
+void
+append(std::vector<std::uint8_t>& data, T value)
+{
+    const size_t pos = data.size();
+    data.resize(pos + sizeof(T));
+    std::memcpy(&data[pos], &value, sizeof(T));
+}
+
+/// The offset between two ordinates, wrapping around like the decoder.
+std::int32_t
+offset(std::int32_t from, std::int32_t to)
+{
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(to) -
+            static_cast<std::uint32_t>(from));
+}
+
+bool
+fitsInt16(std::int32_t v)
+{
+    return v >= std::numeric_limits<std::int16_t>::min() &&
+        v <= std::numeric_limits<std::int16_t>::max();
+}
+
+}
+
+PackedPaths::PackedPaths(const std::vector<Path>& paths)
+    :
+    _size(paths.size())
+{
+    for (const Path& path : paths) {
+
+        const size_t header = _data.size();
+        append<std::uint32_t>(_data, path.m_fill0);
+        append<std::uint32_t>(_data, path.m_fill1);
+        append<std::uint32_t>(_data, path.m_line);
+        append<std::int32_t>(_data, path.ap.x);
+        append<std::int32_t>(_data, path.ap.y);
+        append<std::uint32_t>(_data, path.m_edges.size());
+        // The size of the edges, written when known.
+        append<std::uint32_t>(_data, 0);
+        assert(_data.size() - header == const_iterator::headerSize);
+
+        point prev = path.ap;
+        for (const Edge& e : path.m_edges) {
+
+            std::int32_t d[4];
+            size_t n;
+            std::uint8_t flags = 0;
+
+            if (e.straight()) {
+                flags |= EDGE_STRAIGHT;
+                d[0] = offset(prev.x, e.ap.x);
+                d[1] = offset(prev.y, e.ap.y);
+                n = 2;
+            }
+            else {
+                d[0] = offset(prev.x, e.cp.x);
+                d[1] = offset(prev.y, e.cp.y);
+                d[2] = offset(e.cp.x, e.ap.x);
+                d[3] = offset(e.cp.y, e.ap.y);
+                n = 4;
+            }
+
+            if (!std::all_of(d, d + n, fitsInt16)) flags |= EDGE_WIDE;
+
+            _data.push_back(flags);
+            for (size_t i = 0; i < n; ++i) {
+                if (flags & EDGE_WIDE) append<std::int32_t>(_data, d[i]);
+                else append<std::int16_t>(_data, d[i]);
+            }
+            prev = e.ap;
+        }
+
+        const std::uint32_t edges =
+            _data.size() - header - const_iterator::headerSize;
+        std::memcpy(&_data[header + const_iterator::headerSize - 4], &edges, 4);
+    }
+
+    _data.shrink_to_fit();
+}
+
+void
+PackedPaths::expand(std::vector<Path>& paths) const
+{
+    paths.reserve(paths.size() + size());
+    for (const PackedPath& p : *this) {
+        paths.push_back(Path(p));
+    }
+}
+
 namespace geometry {
 
 namespace {
@@ -121,8 +218,12 @@ int curve_x_crossings(const T x0, const T y0, const T x1, const T y1,
 
 } // anonymous namespace
 
+namespace {
+
+/// The implementation of pointTest for Path and PackedPath.
+template<typename Paths>
 bool
-pointTest(const std::vector<Path>& paths,
+pointTestPaths(const Paths& paths,
         const std::vector<LineStyle>& lineStyles, std::int32_t x,
         std::int32_t y, const SWFMatrix& wm)
 {
@@ -148,15 +249,11 @@ pointTest(const std::vector<Path>& paths,
     // later we will need non-zero for glyphs... (TODO)
     bool even_odd = true;  
 
-    unsigned npaths = paths.size();
     int counter = 0;
 
     // browse all paths
-    for (unsigned pno=0; pno<npaths; pno++)
+    for (const auto& pth : paths)
     {
-        const Path& pth = paths[pno];
-        unsigned nedges = pth.m_edges.size();
-
         float next_pen_x = pth.ap.x;
         float next_pen_y = pth.ap.y;
         float pen_x, pen_y;
@@ -195,9 +292,9 @@ pointTest(const std::vector<Path>& paths,
         }
 
         // browse all edges of the path
-        for (unsigned eno=0; eno<nedges; eno++)
+        for (auto it = pth.begin(), e = pth.end(); it != e; ++it)
         {
-            const Edge& edg = pth.m_edges[eno];
+            const Edge& edg = *it;
             pen_x = next_pen_x;
             pen_y = next_pen_y;
             next_pen_x = edg.ap.x;
@@ -280,6 +377,24 @@ pointTest(const std::vector<Path>& paths,
              (!even_odd && (counter != 0)) );
 }
 
+} // anonymous namespace
+
+bool
+pointTest(const std::vector<Path>& paths,
+        const std::vector<LineStyle>& lineStyles, std::int32_t x,
+        std::int32_t y, const SWFMatrix& wm)
+{
+    return pointTestPaths(paths, lineStyles, x, y, wm);
+}
+
+bool
+pointTest(const PackedPaths& paths,
+        const std::vector<LineStyle>& lineStyles, std::int32_t x,
+        std::int32_t y, const SWFMatrix& wm)
+{
+    return pointTestPaths(paths, lineStyles, x, y, wm);
+}
+
 } // namespace geometry
 } // namespace gnash
 
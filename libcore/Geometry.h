@@ -27,6 +27,9 @@
 
 #include <vector> // for path composition
 #include <cmath> // sqrt
+#include <cstring> // memcpy
+#include <cstdint>
+#include <iterator>
 
 
 // Forward declarations
@@ -162,6 +165,71 @@ public:
 };
 
 
+/// \brief
+/// Return true if the given point is within the given squared distance
+/// from a series of edges.
+//
+/// NOTE: if there are no edges, false is returned.
+///
+/// @param start
+///    The point the first edge starts from.
+///
+/// @param begin, end
+///    The edges, as iterators to Edge.
+///
+template<typename EdgeIterator>
+bool
+edgesWithinSquareDistance(const point& start, EdgeIterator begin,
+        EdgeIterator end, const point& p, double dist)
+{
+    point px(start);
+    for (; begin != end; ++begin)
+    {
+        const Edge& e = *begin;
+        point np(e.ap);
+
+        if (e.straight())
+        {
+            double d = Edge::squareDistancePtSeg(p, px, np);
+            if ( d <= dist ) return true;
+        }
+        else
+        {
+
+            const point& A = px;
+            const point& C = e.cp;
+            const point& B = e.ap;
+
+            // Approximate the curve to segCount segments
+            // and compute distance of query point from each
+            // segment.
+            //
+            // TODO: find an apprpriate value for segCount based
+            //             on rendering scale ?
+            //
+            int segCount = 10; 
+            point p0(A.x, A.y);
+            for (int i=1; i<=segCount; ++i)
+            {
+                float t1 = static_cast<float>(i) / segCount;
+                point p1 = Edge::pointOnCurve(A, C, B, t1);
+
+                // distance from point and segment being an approximation 
+                // of the curve 
+                double d = Edge::squareDistancePtSeg(p, p0, p1);
+                if ( d <= dist ) return true;
+
+                p0.setTo(p1.x, p1.y);
+            }
+        }
+        px = np;
+    }
+
+    return false;
+}
+
+class PackedPath;
+
 /// A subset of a shape, a series of edges sharing a single set of styles. 
 class DSOEXPORT Path
 {
@@ -202,6 +270,9 @@ public:
         m_edges(from.m_edges)
     {
     }
+
+    /// Copy a path out of a PackedPaths.
+    explicit Path(const PackedPath& from);
     
     /// Initialize a path 
     //
@@ -389,54 +460,8 @@ public:
     bool
     withinSquareDistance(const point& p, double dist) const
     {
-        size_t nedges = m_edges.size();
-
-        if ( ! nedges ) return false;
-
-        point px(ap);
-        for (size_t i=0; i<nedges; ++i)
-        {
-            const Edge& e = m_edges[i];
-            point np(e.ap);
-
-            if (e.straight())
-            {
-                double d = Edge::squareDistancePtSeg(p, px, np);
-                if ( d <= dist ) return true;
-            }
-            else
-            {
-
-                const point& A = px;
-                const point& C = e.cp;
-                const point& B = e.ap;
-
-                // Approximate the curve to segCount segments
-                // and compute distance of query point from each
-                // segment.
-                //
-                // TODO: find an apprpriate value for segCount based
-                //             on rendering scale ?
-                //
-                int segCount = 10; 
-                point p0(A.x, A.y);
-                for (int i=1; i<=segCount; ++i)
-                {
-                    float t1 = static_cast<float>(i) / segCount;
-                    point p1 = Edge::pointOnCurve(A, C, B, t1);
-
-                    // distance from point and segment being an approximation 
-                    // of the curve 
-                    double d = Edge::squareDistancePtSeg(p, p0, p1);
-                    if ( d <= dist ) return true;
-
-                    p0.setTo(p1.x, p1.y);
-                }
-            }
-            px = np;
-        }
-
-        return false;
+        return edgesWithinSquareDistance(ap, m_edges.begin(), m_edges.end(),
+                p, dist);
     }
 
     /// Transform all path coordinates according to the given SWFMatrix.
@@ -530,8 +555,350 @@ public:
     {
         return m_edges[n];
     }
+
+    /// Iterators to the edges, as for a PackedPath.
+    std::vector<Edge>::const_iterator begin() const
+    {
+        return m_edges.begin();
+    }
+
+    std::vector<Edge>::const_iterator end() const
+    {
+        return m_edges.end();
+    }
 }; // end of class Path
 
+/// The paths of a shape that won't change, packed in a single buffer.
+//
+/// Shapes parsed from a SWF keep their paths for as long as the movie,
+/// and a Path costs an allocation and 16 bytes for each Edge, though
+/// most edges are short and many are straight. Here each path is a
+/// header with its styles, its start point and its size, followed by its
+/// edges. Each edge is a flags byte followed by the offsets of its points
+/// from the previous one, as 16-bit integers when they all fit. The
+/// control point of a straight edge is not stored.
+///
+/// The paths are read with iterators, which decode the edges as they go.
+/// Iterating gives PackedPath objects, which have the same members as
+/// Path for reading, so that code can be written for both.
+class DSOEXPORT PackedPaths
+{
+public:
+
+    /// Flags of an encoded edge.
+    enum EdgeFlags {
+        /// The edge is straight, its control point isn't stored.
+        EDGE_STRAIGHT = 0x01,
+
+        /// The offsets are 32-bit.
+        EDGE_WIDE = 0x02
+    };
+
+    /// A forward iterator to the edges of a PackedPath.
+    class EdgeIterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Edge value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Edge* pointer;
+        typedef const Edge& reference;
+
+        EdgeIterator()
+            :
+            _pos(nullptr),
+            _next(nullptr),
+            _end(nullptr)
+        {}
+
+        /// @param pos      The first encoded edge.
+        /// @param end      The end of the encoded edges.
+        /// @param start    The point the first edge starts from.
+        EdgeIterator(const std::uint8_t* pos, const std::uint8_t* end,
+                const point& start)
+            :
+            _pos(pos),
+            _next(pos),
+            _end(end),
+            _edge(start, start)
+        {
+            decode();
+        }
+
+        const Edge& operator*() const { return _edge; }
+
+        const Edge* operator->() const { return &_edge; }
+
+        EdgeIterator& operator++() {
+            _pos = _next;
+            decode();
+            return *this;
+        }
+
+        EdgeIterator operator++(int) {
+            EdgeIterator ret(*this);
+            ++*this;
+            return ret;
+        }
+
+        bool operator==(const EdgeIterator& o) const {
+            return _pos == o._pos;
+        }
+
+        bool operator!=(const EdgeIterator& o) const {
+            return _pos != o._pos;
+        }
+
+    private:
+
+        /// Decode the edge at _next, starting from the current anchor.
+        void decode() {
+            if (_next == _end) return;
+            const std::uint8_t flags = *_next++;
+            if (flags & EDGE_STRAIGHT) {
+                readOffset(flags, _edge.ap);
+                _edge.cp = _edge.ap;
+            }
+            else {
+                _edge.cp = _edge.ap;
+                readOffset(flags, _edge.cp);
+                _edge.ap = _edge.cp;
+                readOffset(flags, _edge.ap);
+            }
+        }
+
+        /// Add the next offset to a point.
+        void readOffset(std::uint8_t flags, point& p) {
+            std::int32_t dx, dy;
+            if (flags & EDGE_WIDE) {
+                std::memcpy(&dx, _next, 4);
+                std::memcpy(&dy, _next + 4, 4);
+                _next += 8;
+            }
+            else {
+                std::int16_t x, y;
+                std::memcpy(&x, _next, 2);
+                std::memcpy(&y, _next + 2, 2);
+                _next += 4;
+                dx = x;
+                dy = y;
+            }
+            // Offsets wrap around, so that they are exact for any points.
+            p.x = static_cast<std::int32_t>(static_cast<std::uint32_t>(p.x) +
+                    static_cast<std::uint32_t>(dx));
+            p.y = static_cast<std::int32_t>(static_cast<std::uint32_t>(p.y) +
+                    static_cast<std::uint32_t>(dy));
+        }
+
+        const std::uint8_t* _pos;
+        const std::uint8_t* _next;
+        const std::uint8_t* _end;
+        Edge _edge;
+    };
+
+    class const_iterator;
+
+    PackedPaths()
+        :
+        _size(0)
+    {}
+
+    /// Pack some paths.
+    explicit PackedPaths(const std::vector<Path>& paths);
+
+    inline const_iterator begin() const;
+
+    inline const_iterator end() const;
+
+    /// The number of paths.
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return !_size;
+    }
+
+    /// Append copies of the paths to a vector.
+    void expand(std::vector<Path>& paths) const;
+
+private:
+
+    std::vector<std::uint8_t> _data;
+
+    size_t _size;
+};
+
+/// A path in a PackedPaths.
+//
+/// This is a view of the packed data, which must outlive it.
+class PackedPath
+{
+public:
+
+    /// Left fill style index (1-based)
+    unsigned m_fill0;
+
+    /// Right fill style index (1-based)
+    unsigned m_fill1;
+
+    /// Line style index (1-based)
+    unsigned m_line;
+
+    /// Start point of the path
+    point ap;
+
+    /// Return the number of edges in this path
+    size_t size() const {
+        return _size;
+    }
+
+    /// Return true if this path contains no edges
+    bool empty() const {
+        return !_size;
+    }
+
+    PackedPaths::EdgeIterator begin() const {
+        return PackedPaths::EdgeIterator(_edges, _end, ap);
+    }
+
+    PackedPaths::EdgeIterator end() const {
+        return PackedPaths::EdgeIterator(_end, _end, ap);
+    }
+
+    unsigned getLeftFill() const {
+        return m_fill0;
+    }
+
+    unsigned getRightFill() const {
+        return m_fill1;
+    }
+
+    unsigned getLineStyle() const {
+        return m_line;
+    }
+
+    /// See Path::withinSquareDistance().
+    bool withinSquareDistance(const point& p, double dist) const {
+        return edgesWithinSquareDistance(ap, begin(), end(), p, dist);
+    }
+
+private:
+
+    friend class PackedPaths::const_iterator;
+
+    PackedPath()
+        :
+        m_fill0(0),
+        m_fill1(0),
+        m_line(0),
+        _size(0),
+        _edges(nullptr),
+        _end(nullptr)
+    {}
+
+    size_t _size;
+    const std::uint8_t* _edges;
+    const std::uint8_t* _end;
+};
+
+/// A forward iterator to the paths of a PackedPaths.
+class PackedPaths::const_iterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef PackedPath value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const PackedPath* pointer;
+    typedef const PackedPath& reference;
+
+    const_iterator()
+        :
+        _pos(nullptr),
+        _end(nullptr)
+    {}
+
+    const_iterator(const std::uint8_t* pos, const std::uint8_t* end)
+        :
+        _pos(pos),
+        _end(end)
+    {
+        decode();
+    }
+
+    const PackedPath& operator*() const { return _path; }
+
+    const PackedPath* operator->() const { return &_path; }
+
+    const_iterator& operator++() {
+        _pos = _path._end;
+        decode();
+        return *this;
+    }
+
+    const_iterator operator++(int) {
+        const_iterator ret(*this);
+        ++*this;
+        return ret;
+    }
+
+    bool operator==(const const_iterator& o) const {
+        return _pos == o._pos;
+    }
+
+    bool operator!=(const const_iterator& o) const {
+        return _pos != o._pos;
+    }
+
+    /// The size of a path header.
+    static const size_t headerSize = 28;
+
+private:
+
+    /// Decode the header of the path at _pos.
+    void decode() {
+        if (_pos == _end) return;
+        std::uint32_t h[7];
+        std::memcpy(h, _pos, headerSize);
+        _path.m_fill0 = h[0];
+        _path.m_fill1 = h[1];
+        _path.m_line = h[2];
+        _path.ap.x = static_cast<std::int32_t>(h[3]);
+        _path.ap.y = static_cast<std::int32_t>(h[4]);
+        _path._size = h[5];
+        _path._edges = _pos + headerSize;
+        _path._end = _path._edges + h[6];
+    }
+
+    const std::uint8_t* _pos;
+    const std::uint8_t* _end;
+    PackedPath _path;
+};
+
+inline PackedPaths::const_iterator
+PackedPaths::begin() const
+{
+    return const_iterator(_data.data(), _data.data() + _data.size());
+}
+
+inline PackedPaths::const_iterator
+PackedPaths::end() const
+{
+    const std::uint8_t* end = _data.data() + _data.size();
+    return const_iterator(end, end);
+}
+
+inline
+Path::Path(const PackedPath& from)
+    :
+    m_fill0(from.m_fill0),
+    m_fill1(from.m_fill1),
+    m_line(from.m_line),
+    ap(from.ap),
+    m_edges(from.begin(), from.end())
+{
+}
+
 namespace geometry
 {
 
@@ -539,6 +906,10 @@ bool pointTest(const std::vector<Path>& paths,
     const std::vector<LineStyle>& lineStyles, std::int32_t x,
     std::int32_t y, const SWFMatrix& wm);
 
+bool pointTest(const PackedPaths& paths,
+    const std::vector<LineStyle>& lineStyles, std::int32_t x,
+    std::int32_t y, const SWFMatrix& wm);
+
 } // namespace geometry
 
 
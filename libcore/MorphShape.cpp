@@ -32,7 +32,9 @@ MorphShape::MorphShape(movie_root& mr, as_object* object,
     :
     DisplayObject(mr, object, parent),
     _def(def),
-    _shape(_def->shape1())
+    // Start with the definition's own shape1, which it outlives.
+    _shape(std::shared_ptr<const SWF::ShapeRecord>(), &_def->shape1()),
+    _morphRatio(-1)
 {
 }
 
@@ -53,9 +55,9 @@ MorphShape::pointInShape(std::int32_t x, std::int32_t y) const
     //       in DrawingApiTest (kind of a fill-leakage making
     //       the collision detection find you inside a self-crossing
     //       shape).
-    if (!_shape.getBounds().point_test(lp.x, lp.y)) return false;
+    if (!_shape->getBounds().point_test(lp.x, lp.y)) return false;
 
-    return _shape.pointTest(lp.x, lp.y, wm);
+    return _shape->pointTest(lp.x, lp.y, wm);
 }
 
 void  
@@ -65,21 +67,23 @@ MorphShape::display(Renderer& renderer, const Transform& base)
 
     const Transform xform = base * transform();
 
-    _def->display(renderer, _shape, xform); 
+    _def->display(renderer, *_shape, xform); 
     clear_invalidated();
 }
 
-inline double
-MorphShape::currentRatio() const
+SWFRect
+MorphShape::getBounds() const
 {
-    return get_ratio() / 65535.0;
+    // TODO: optimize this more.
+    SWFRect bounds = _shape->getBounds();
+    bounds.expand_to_rect(_def->shape2().getBounds());
+    return bounds;
 }
 
 SWFRect
-MorphShape::getBounds() const
+MorphShape::getLocalHitBounds() const
 {
-    // TODO: optimize this more.
-    SWFRect bounds = _shape.getBounds();
+    SWFRect bounds = _def->shape1().getBounds();
     bounds.expand_to_rect(_def->shape2().getBounds());
     return bounds;
 }
@@ -87,7 +91,11 @@ MorphShape::getBounds() const
 void
 MorphShape::morph()
 {
-    _shape.setLerp(_def->shape1(), _def->shape2(), currentRatio());
+    const int ratio = get_ratio();
+    if (ratio == _morphRatio) return;
+
+    _shape = _def->shape(ratio);
+    _morphRatio = ratio;
 }
 
 
@@ -23,6 +23,7 @@
 #include "DisplayObject.h"
 #include "swf/DefineMorphShapeTag.h"
 #include <boost/intrusive_ptr.hpp>
+#include <memory>
 #include <cassert>
 
 namespace gnash {
@@ -56,22 +57,28 @@ public:
     virtual void display(Renderer& renderer, const Transform& xform);
 
     virtual SWFRect getBounds() const;
+
+    /// The bounds of both shapes, which contain the shape at any ratio.
+    virtual SWFRect getLocalHitBounds() const;
     
     virtual bool pointInShape(std::int32_t  x, std::int32_t  y) const;
  
     const SWF::ShapeRecord& shape() const {
-        return _shape;
+        return *_shape;
     }
 
 private:
     
+    /// Get the shape at the current ratio, if that changed.
     void morph();
 
-    double currentRatio() const;
-
     const boost::intrusive_ptr<const SWF::DefineMorphShapeTag> _def;
 	
-    SWF::ShapeRecord _shape;
+    /// The shape at _morphRatio, shared with the definition's cache.
+    std::shared_ptr<const SWF::ShapeRecord> _shape;
+
+    /// The ratio of _shape, or -1 before the first morph.
+    int _morphRatio;
 
 };
 
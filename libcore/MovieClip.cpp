@@ -64,6 +64,8 @@
 #include "RunResources.h"
 #include "Transform.h"
 #include "ConstantPool.h" // for PoolGuard
+#include "TimelineSnapshots.h"
+#include "rc.h"
 
 namespace gnash {
 
@@ -196,6 +198,10 @@ public:
         }
         if (!ch->visible()) return;
 
+        // Only DisplayObjects whose hit bounds contain the point need
+        // the exact test.
+        if (!ch->getHitBounds().point_test(_pp.x, _pp.y)) return;
+
         _candidates.push_back(ch);
     }
 
@@ -369,6 +375,23 @@ private:
     SWFRect& _bounds;
 };
 
+/// A DisplayList visitor used to compute its overall hit bounds.
+//
+/// Unlike BoundsFinder this includes unloaded DisplayObjects, as
+/// MouseEntityFinder doesn't skip them.
+class HitBoundsFinder
+{
+public:
+    explicit HitBoundsFinder(SWFRect& b) : _bounds(b) {}
+
+    void operator()(const DisplayObject* ch) {
+        _bounds.expand_to_rect(ch->getHitBounds());
+    }
+
+private:
+    SWFRect& _bounds;
+};
+
 struct ReachableMarker
 {
     void operator()(DisplayObject *ch) const {
@@ -384,11 +407,20 @@ struct ReachableMarker
 class DropTargetFinder
 {
 public:
-    DropTargetFinder(std::int32_t x, std::int32_t y, DisplayObject* dragging)
+
+    /// @param x, y
+    ///     Query point in world coordinate space
+    ///
+    /// @param pp
+    ///     Query point in parent coordinate space
+    ///
+    DropTargetFinder(std::int32_t x, std::int32_t y, point pp,
+            DisplayObject* dragging)
         :
         _highestHiddenDepth(std::numeric_limits<int>::min()),
         _x(x),
         _y(y),
+        _pp(std::move(pp)),
         _dragging(dragging),
         _dropch(nullptr),
         _candidates(),
@@ -432,6 +464,11 @@ public:
             }
             return;
         }
+
+        // Only DisplayObjects whose hit bounds contain the point need
+        // the exact test.
+        if (!ch->getHitBounds().point_test(_pp.x, _pp.y)) return;
+
         _candidates.push_back(ch);
     }
 
@@ -466,6 +503,10 @@ private:
 
     std::int32_t _x;
     std::int32_t _y;
+
+    /// Query point in parent coordinate space
+    point _pp;
+
     DisplayObject* _dragging;
     mutable const DisplayObject* _dropch;
 
@@ -1014,7 +1055,19 @@ MovieClip::restoreDisplayList(size_t tgtFrame)
     assert(tgtFrame <= _currentFrame);
 
     DisplayList tmplist;
-    for (size_t f = 0; f < tgtFrame; ++f) {
+    size_t f = 0;
+
+    // Start from the last snapshot of the timeline before the target.
+    const RcInitFile& rc = RcInitFile::getDefaultInstance();
+    const int interval = rc.getTimelineSnapshotInterval();
+    if (_def && !isDestroyed() && interval > 0 &&
+            tgtFrame >= static_cast<size_t>(interval)) {
+        TimelineSnapshots& s = _def->timelineSnapshots(interval,
+                rc.getTimelineSnapshotLimit());
+        f = s.restore(tgtFrame, *this, tmplist);
+    }
+
+    for (; f < tgtFrame; ++f) {
         _currentFrame = f;
         executeFrameTags(f, tmplist, SWF::ControlTag::TAG_DLIST);
     }
@@ -1517,7 +1570,11 @@ MovieClip::findDropTarget(std::int32_t x, std::int32_t y,
 
     if (!visible()) return nullptr; // isn't me !
 
-    DropTargetFinder finder(x, y, dragging);
+    // The hit bounds of our children are in our coordinate space.
+    point pp(x, y);
+    getWorldMatrix(*this).invert().transform(pp);
+
+    DropTargetFinder finder(x, y, pp, dragging);
     _displayList.visitAll(finder);
 
     // does it hit any child ?
@@ -1654,7 +1711,9 @@ MovieClip::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
         ranges.add(m_old_invalidated_ranges); 
     }
     
-    _displayList.add_invalidated_bounds(ranges, force || invalidated());
+    const size_t skipped =
+        _displayList.add_invalidated_bounds(ranges, force || invalidated());
+    stage().countInvalidatedBounds(_displayList.size() - skipped, skipped);
 
     /// Add drawable.
     SWFRect bounds;
@@ -1984,6 +2043,15 @@ MovieClip::getBounds() const
     return bounds;
 }
 
+SWFRect
+MovieClip::getLocalHitBounds() const
+{
+    SWFRect bounds = _drawable.getBounds();
+    HitBoundsFinder f(bounds);
+    _displayList.visitAll(f);
+    return bounds;
+}
+
 bool
 MovieClip::isEnabled() const
 {
@@ -145,6 +145,9 @@ public:
     /// Get the composite bounds of all component drawing elements
     virtual SWFRect getBounds() const;
 
+    /// Get the composite hit bounds of the drawing and all children
+    virtual SWFRect getLocalHitBounds() const;
+
     // See dox in DisplayObject.h
     virtual bool pointInShape(std::int32_t x, std::int32_t y) const;
 
@@ -38,6 +38,7 @@
 #include "ExecutableCode.h"
 #include "RunResources.h"
 #include "StreamProvider.h"
+#include "rc.h"
 
 //#define GNASH_DEBUG_LOADMOVIE_REQUESTS_PROCESSING 1
 //#define GNASH_DEBUG_LOCKING 1
@@ -47,6 +48,8 @@ namespace gnash {
 MovieLoader::MovieLoader(movie_root& mr)
     :
     _killed(false),
+    _started(0),
+    _nextCompleted(0),
     _movieRoot(mr)
 {
 }
@@ -81,11 +84,12 @@ MovieLoader::processRequests()
         log_debug("processRequests: lock on requests: obtained");
 #endif
 
-        // Find first non-completed request (the others we'll wait)
+        // Find first request nobody is loading yet
         Requests::iterator endIt = _requests.end();
         Requests::iterator it = find_if(_requests.begin(), endIt,
-                                        std::bind(&Request::pending,
-                                                  std::placeholders::_1));
+                [](const Request& r) {
+                    return !r.started() && !r.cancelled();
+                });
 
         if (it == endIt) {
 
@@ -107,6 +111,7 @@ MovieLoader::processRequests()
         }
 
         Request& lr = *it;
+        lr.start(_started++);
 
 #ifdef GNASH_DEBUG_LOCKING
         log_debug("processRequests: lock on requests: release");
@@ -151,7 +156,7 @@ MovieLoader::processRequest(Request& r)
 void
 MovieLoader::clear()
 {
-    if (_thread.joinable()) {
+    if (!_threads.empty()) {
 
 #ifdef GNASH_DEBUG_LOCKING
         log_debug("clear: lock on requests: trying");
@@ -176,17 +181,20 @@ MovieLoader::clear()
         log_debug("clear: lock on kill: release for kill");
 #endif
 
-        log_debug("waking up loader thread");
+        log_debug("waking up loader threads");
 
         _wakeup.notify_all(); // in case it was sleeping
 
 #ifdef GNASH_DEBUG_LOCKING
         log_debug("clear: lock on requests: release after notify_all");
 #endif
-        requestsLock.unlock(); // allow the thread to die
+        requestsLock.unlock(); // allow the threads to die
 
         log_debug("MovieLoader notified, joining");
-        _thread.join();
+        for (std::thread& t : _threads) {
+            t.join();
+        }
+        _threads.clear();
         log_debug("MovieLoader joined");
     }
 
@@ -204,6 +212,45 @@ void
 MovieLoader::clearRequests()
 {
     _requests.clear();
+    _started = 0;
+    _nextCompleted = 0;
+}
+
+// private, called with _requestsMutex locked
+// runs in main thread
+void
+MovieLoader::cancelUnloadedRequests()
+{
+    const int version = _movieRoot.getVM().getSWFVersion();
+
+    for (Requests::iterator it = _requests.begin(); it != _requests.end(); ) {
+
+        Request& r = *it;
+        if (r.cancelled() || r.completed() || !r.targetUnloaded()) {
+            ++it;
+            continue;
+        }
+
+        // The target may have been replaced by another DisplayObject,
+        // which the movie is then loaded into.
+        const std::string& target = r.getTarget();
+        unsigned int levelno;
+        if (_movieRoot.findCharacterByTarget(target) ||
+                isLevelTarget(version, target, levelno)) {
+            ++it;
+            continue;
+        }
+
+        log_debug("Cancelling load request for unloaded target %s", target);
+
+        // A request being loaded is kept until it completes, so that
+        // the loading thread can still use it.
+        if (r.started()) {
+            r.cancel();
+            ++it;
+        }
+        else it = _requests.erase(it);
+    }
 }
 
 // private 
@@ -347,13 +394,27 @@ MovieLoader::processCompletedRequests()
             _requests.size());
 #endif
 
+        if (_requests.empty()) break;
+
+        cancelUnloadedRequests();
+
+        // Only the next request in the order loading started can be
+        // processed, even if later ones completed before it.
         Requests::iterator endIt = _requests.end();
         Requests::iterator it = find_if(_requests.begin(), endIt,
-                                        std::bind(&Request::completed,
-                                                  std::placeholders::_1));
+                [this](const Request& r) {
+                    return r.started() && r.ticket() == _nextCompleted;
+                });
 
         // Releases scoped lock.
-        if (it == endIt) break;
+        if (it == endIt || !it->completed()) break;
+
+        ++_nextCompleted;
+
+        // Check again, as the target may have come back since the
+        // request was cancelled.
+        const bool cancelled = it->cancelled() &&
+            !_movieRoot.findCharacterByTarget(it->getTarget());
 
 #ifdef GNASH_DEBUG_LOCKING
         log_debug("processCompletedRequests: lock on requests: releasing");
@@ -367,8 +428,10 @@ MovieLoader::processCompletedRequests()
             firstCompleted->getTarget());
 #endif
 
-        bool checkit = processCompletedRequest(firstCompleted);
-        assert(checkit);
+        if (!cancelled) {
+            bool checkit = processCompletedRequest(firstCompleted);
+            assert(checkit);
+        }
 
 #ifdef GNASH_DEBUG_LOCKING
         log_debug("processCompletedRequests: lock on requests for removal: "
@@ -420,6 +483,9 @@ MovieLoader::loadMovie(const std::string& urlstr,
     const std::string* postdata = (method == MovieClip::METHOD_POST) ? &data
                                                                      : nullptr;
 
+    // The request is cancelled if this is unloaded before completion.
+    DisplayObject* targetObject = _movieRoot.findCharacterByTarget(target);
+
 #ifdef GNASH_DEBUG_LOCKING
     log_debug("loadMovie: lock on requests: trying");
 #endif
@@ -431,16 +497,19 @@ MovieLoader::loadMovie(const std::string& urlstr,
 #endif
 
     _requests.push_front(
-        new Request(url, target, postdata, handler)
+        new Request(url, target, targetObject, postdata, handler)
     );
 
-    // Start or wake up the loader thread 
-    if (!_thread.joinable()) {
+    // Start another loader thread, or wake up an existing one
+    const size_t maxThreads =
+        std::max(RcInitFile::getDefaultInstance().getMovieLoaderThreads(), 1);
+
+    if (_threads.size() < maxThreads) {
         _killed=false;
-        _thread = std::thread(std::bind(&MovieLoader::processRequests, this));
+        _threads.emplace_back(std::bind(&MovieLoader::processRequests, this));
     } else {
         log_debug("loadMovie: waking up existing thread");
-        _wakeup.notify_all();
+        _wakeup.notify_one();
     }
 
 #ifdef GNASH_DEBUG_LOCKING
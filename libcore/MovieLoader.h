@@ -23,6 +23,7 @@
 #include <condition_variable>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/noncopyable.hpp>
@@ -46,6 +47,11 @@ namespace gnash {
 /// Hide the asynchonous mechanism of movies loading.
 /// Currently implemented using threads, could be refactored to use
 /// non-blocking reads.
+//
+/// Up to a configurable number of requests are loaded at the same time,
+/// each by its own thread. Whatever order they finish in, completed
+/// requests are processed in the order their loading started, which is
+/// the order a single thread would have completed them in.
 ///
 class DSOEXPORT MovieLoader : boost::noncopyable {
 
@@ -76,10 +82,15 @@ public:
             const std::string& data, MovieClip::VariablesMethod method,
             as_object* handler=nullptr);
 
-    /// Drop all requests and kill the thread
+    /// Drop all requests and kill the threads
     void clear();
 
     /// Process all completed movie load requests.
+    //
+    /// Requests whose target was unloaded, and can't be found any more,
+    /// are cancelled first: they are not loaded if they haven't started
+    /// yet, and no events are sent for them. Targets that didn't exist
+    /// when the movie was requested are only looked up on completion.
     void processCompletedRequests();
 
     void setReachable() const;
@@ -92,16 +103,24 @@ private:
         /// @param postdata
         ///   If not null POST method will be used for HTTP.
         ///
-        Request(URL u, std::string t,
+        /// @param targetObject
+        ///   The DisplayObject found for the target when the request
+        ///   was made, or null.
+        ///
+        Request(URL u, std::string t, DisplayObject* targetObject,
                 const std::string* postdata, as_object* handler)
                 :
                 _target(std::move(t)),
+                _targetObject(targetObject),
                 _url(std::move(u)),
                 _usePost(false),
                 _mdef(nullptr),
                 _mutex(),
                 _handler(handler),
-                _completed(false)
+                _completed(false),
+                _started(false),
+                _cancelled(false),
+                _ticket(0)
         {
             if (postdata) {
                 _postData = *postdata;
@@ -115,6 +134,7 @@ private:
         bool usePost() const { return _usePost; }
         as_object* getHandler() const { return _handler; }
         void setReachable() const {
+            if (_targetObject) _targetObject->setReachable();
             if (_handler) _handler->setReachable();
         }
 
@@ -138,13 +158,6 @@ private:
             return _completed;
         }
 
-        /// Only check if request is completed
-        bool pending() const
-        {
-            std::lock_guard<std::mutex> lock(_mutex);
-            return !_completed;
-        }
-
         /// Only check if request is completed
         bool completed() const
         {
@@ -166,8 +179,37 @@ private:
             _completed = true;
         }
 
+        /// Whether a thread started loading the request.
+        //
+        /// This and the functions below are only used with
+        /// MovieLoader::_requestsMutex locked.
+        bool started() const { return _started; }
+
+        /// Mark the request as being loaded.
+        //
+        /// @param ticket   The number of requests started before this one.
+        void start(size_t ticket) {
+            _started = true;
+            _ticket = ticket;
+        }
+
+        size_t ticket() const { return _ticket; }
+
+        bool cancelled() const { return _cancelled; }
+
+        void cancel() { _cancelled = true; }
+
+        /// Whether the target found when the request was made has been
+        /// unloaded since.
+        //
+        /// Only used by the main thread.
+        bool targetUnloaded() const {
+            return _targetObject && _targetObject->unloaded();
+        }
+
     private:
         std::string _target;
+        DisplayObject* _targetObject;
         URL _url;
         bool _usePost;
         std::string _postData;
@@ -175,6 +217,9 @@ private:
         mutable std::mutex _mutex;
         as_object* _handler;
         bool _completed;
+        bool _started;
+        bool _cancelled;
+        size_t _ticket;
     };
 
     /// Load requests
@@ -187,6 +232,11 @@ private:
     void processRequest(Request& r);
     void clearRequests();
 
+    /// Cancel requests whose target was unloaded and can't be found.
+    //
+    /// Called with _requestsMutex locked.
+    void cancelUnloadedRequests();
+
     /// Check a Request and process if completed.
     //
     /// @return true if the request was completely processed.
@@ -196,12 +246,19 @@ private:
     /// Was thread kill requested ?
     std::atomic<bool> _killed;
 
+    /// The number of requests started, and the ticket of the next
+    /// request to process when completed.
+    //
+    /// Both are protected by _requestsMutex.
+    size_t _started;
+    size_t _nextCompleted;
+
     std::condition_variable _wakeup;
 
     /// needed for some facilities like find_character_by_target
     movie_root& _movieRoot;
 
-    std::thread _thread;
+    std::vector<std::thread> _threads;
 };
 
 } // namespace gnash
@@ -28,6 +28,7 @@
 
 #include <cstring>
 #include <climits>
+#include <algorithm>
 
 //#define USE_TU_FILE_BYTESWAPPING 1
 
@@ -36,8 +37,14 @@ namespace gnash {
 SWFStream::SWFStream(IOChannel* input)
     :
     m_input(input),
-    m_current_byte(0),
-    m_unused_bits(0)
+    _bits(0),
+    _bitCount(0),
+    _data(nullptr),
+    _bufferSize(0),
+    _bufferStart(0),
+    _bufferPos(0),
+    _buffered(false),
+    _bufferPending(false)
 {
 }
 
@@ -82,108 +89,135 @@ unsigned SWFStream::read(char *buf, unsigned count)
 
     if ( ! count ) return 0;
 
+    if (buffered())
+    {
+        const size_t left = _bufferSize - _bufferPos;
+        if (left < count) count = left;
+        std::copy(_data + _bufferPos, _data + _bufferPos + count, buf);
+        _bufferPos += count;
+        return count;
+    }
+
     return m_input->read(buf, count);
 }
 
-bool SWFStream::read_bit()
+void
+SWFStream::fillBuffer()
 {
-    if (!m_unused_bits)
-    {
-        m_current_byte = m_input->read_byte(); // don't want to align here
-        m_unused_bits = 7;
-        return (m_current_byte&0x80);
-    }
-    else
+    assert(!_tagBoundsStack.empty());
+    _bufferPending = false;
+
+    const unsigned long start = m_input->tell();
+    const unsigned long end = _tagBoundsStack.front().second;
+
+    // A truncated stream leaves a short buffer, and reading past
+    // its end fails as reading past the end of the input did.
+    std::streamsize size = end > start ? end - start : 0;
+    _data = m_input->view(size);
+    if (!_data)
     {
-        return ( m_current_byte & (1<<(--m_unused_bits)) );
+        _buffer.resize(size);
+        if (size) _buffer.resize(m_input->read(&_buffer[0], size));
+        _data = _buffer.data();
+        size = _buffer.size();
     }
+    _bufferSize = size;
+
+    _bufferStart = start;
+    _bufferPos = 0;
+    _buffered = true;
 }
 
-unsigned SWFStream::read_uint(unsigned short bitcount)
+bool
+SWFStream::dropBuffer(unsigned long pos)
 {
-    // htf_sweet.swf fails when this is set to 24. There seems to
-    // be no reason why this should be limited to 32 other than
-    // that it is higher than a movie is likely to need.
-    if (bitcount > 32)
+    _buffered = false;
+    _bufferPending = !_tagBoundsStack.empty();
+    _bits = 0;
+    _bitCount = 0;
+
+    // Don't keep the memory of an unusually large tag.
+    if (_buffer.capacity() > 64 * 1024)
     {
-        // This might overflow a uint32_t or attempt to read outside
-        // the byte cache (relies on there being only 4 bytes after
-        // possible unused bits.)
-        throw ParserException("Unexpectedly long value advertised.");
+        std::vector<std::uint8_t>().swap(_buffer);
     }
 
-    // Optimization for multibyte read
-    if ( bitcount > m_unused_bits )
-    {
-        typedef unsigned char byte;
+    return m_input->seek(pos);
+}
 
-        std::uint32_t value = 0;
+void
+SWFStream::fillBits(unsigned bitcount)
+{
+    // There are never more than 32 bits needed, so _bitCount is at
+    // most 31 here and the shifts below can't overflow.
+    assert(bitcount <= 32 && _bitCount < bitcount);
 
-        if (m_unused_bits) // Consume all the unused bits.
+    if (!buffered())
+    {
+        // Don't read past what is needed, as the input position must
+        // stay that of the next unread byte.
+        while (_bitCount < bitcount)
         {
-            int unusedMask = (1 << m_unused_bits)-1;
-            bitcount -= m_unused_bits; 
-            value |= ((m_current_byte&unusedMask) << bitcount);
+            _bits |= std::uint64_t(m_input->read_byte()) << (56 - _bitCount);
+            _bitCount += 8;
         }
+        return;
+    }
 
-        int bytesToRead = bitcount/8;
-        int spareBits = bitcount%8; // additional bits to read
-
-        //std::cerr << "BytesToRead: " << bytesToRead << " spareBits: " << spareBits << " unusedBits: " << (int)m_unused_bits << std::endl;
-
-        assert (bytesToRead <= 4);
-        byte cache[5]; // at most 4 bytes in the cache + eventual spare bits
-
-        if ( spareBits ) m_input->read(&cache, bytesToRead+1);
-        else m_input->read(&cache, bytesToRead);
-
-        for (int i=0; i<bytesToRead; ++i)
-        {
-            bitcount -= 8;
-            value |= cache[i] << bitcount; 
-        }
+    if (_bufferSize - _bufferPos >= 8)
+    {
+        // Load as many whole bytes as fit. Bits of a further byte may
+        // be included too, but they are the ones the next load puts
+        // in the same place.
+        const std::uint8_t* p = _data + _bufferPos;
+        std::uint64_t word = 0;
+        for (size_t i = 0; i < 8; ++i) word = (word << 8) | p[i];
+
+        const unsigned bytes = (64 - _bitCount) / 8;
+        _bits |= word >> _bitCount;
+        _bitCount += bytes * 8;
+        _bufferPos += bytes;
+        return;
+    }
 
-        //assert(bitcount == spareBits);
-        if ( bitcount )
-        {
-            m_current_byte = cache[bytesToRead];
-            m_unused_bits = 8-bitcount;
-            value |= m_current_byte >> m_unused_bits;
-        }
-        else
+    while (_bitCount < bitcount)
+    {
+        if (_bufferPos == _bufferSize)
         {
-            m_unused_bits = 0;
+            throw ParserException(_("Unexpected end of tag while reading "
+                        "bits"));
         }
-
-        return value;
-        
+        _bits |= std::uint64_t(_data[_bufferPos++]) << (56 - _bitCount);
+        _bitCount += 8;
     }
+}
 
-    if (!m_unused_bits)
+bool SWFStream::read_bit()
+{
+    return read_uint(1);
+}
+
+unsigned SWFStream::read_uint(unsigned short bitcount)
+{
+    // htf_sweet.swf fails when this is set to 24. There seems to
+    // be no reason why this should be limited to 32 other than
+    // that it is higher than a movie is likely to need.
+    if (bitcount > 32)
     {
-        m_current_byte = m_input->read_byte();
-        m_unused_bits = 8;
+        // This might overflow a uint32_t, and fillBits relies on
+        // needing no more than 32 bits.
+        throw ParserException("Unexpectedly long value advertised.");
     }
 
-    // TODO: optimize unusedMask creation ?
-    //       (it's 0xFF if ! m_unused_bits above)
-    int unusedMask = (1 << m_unused_bits)-1;
+    if (!bitcount) return 0;
 
-    if (bitcount == m_unused_bits)
-    {
-        // Consume all the unused bits.
-        m_unused_bits = 0;
-        return (m_current_byte&unusedMask);
-    }
-    else
-    {
-        assert(bitcount < m_unused_bits);
-        // Consume some of the unused bits.
+    if (_bitCount < bitcount) fillBits(bitcount);
 
-        m_unused_bits -= bitcount;
-        return ((m_current_byte&unusedMask) >> m_unused_bits);
-    }
+    const std::uint32_t value = _bits >> (64 - bitcount);
+    _bits <<= bitcount;
+    _bitCount -= bitcount;
 
+    return value;
 }
 
 
@@ -319,6 +353,16 @@ double SWFStream::read_d64()
 std::uint8_t    SWFStream::read_u8()
 {
     align();
+
+    if (buffered())
+    {
+        if (_bufferPos == _bufferSize)
+        {
+            throw ParserException(_("Unexpected end of stream while reading"));
+        }
+        return _data[_bufferPos++];
+    }
+
     return m_input->read_byte();
 }
 
@@ -446,6 +490,8 @@ void SWFStream::read_string_with_length(unsigned len, std::string& to)
 unsigned long
 SWFStream::tell()
 {
+    if (_buffered) return _bufferStart + _bufferPos - _bitCount / 8;
+
     int pos = m_input->tell();
     // TODO: check return value? Could be negative.
     return static_cast<unsigned long>(pos);
@@ -479,8 +525,15 @@ SWFStream::seek(unsigned long pos)
         }
     }
 
+    if (_buffered && pos >= _bufferStart &&
+            pos - _bufferStart <= _bufferSize)
+    {
+        _bufferPos = pos - _bufferStart;
+        return true;
+    }
+
     // Do the seek.
-    if (!m_input->seek(pos))
+    if (!dropBuffer(pos))
     {
         // TODO: should we throw an exception ?
         //       we might be called from an exception handler
@@ -513,7 +566,7 @@ SWFStream::open_tag()
     int tagHeader = read_u16();
     int tagType = tagHeader >> 6;
     int tagLength = tagHeader & 0x3F;
-    assert(m_unused_bits == 0);
+    assert(_bitCount == 0);
         
     if (tagLength == 0x3F)
     {
@@ -569,6 +622,10 @@ SWFStream::open_tag()
     // fast-forward past it when we're done reading it.
     _tagBoundsStack.push_back(std::make_pair(tagStart, tagEnd));
 
+    // The body of an outermost tag is read when it is first needed, as
+    // it may not have been loaded yet.
+    if (_tagBoundsStack.size() == 1) _bufferPending = true;
+
     IF_VERBOSE_PARSE (
 	    log_parse(_("SWF[%lu]: tag type = %d, tag length = %d, end tag = %lu"),
         tagStart, tagType, tagLength, tagEnd);
@@ -587,19 +644,34 @@ SWFStream::close_tag()
 
     //log_debug("Close tag called at %d, stream size: %d", endPos);
 
-    if (!m_input->seek(endPos))
+    _bits = 0;
+    _bitCount = 0;
+
+    // The end of a nested tag is normally in the buffer.
+    const unsigned long end = endPos;
+    if (_buffered && !_tagBoundsStack.empty() && end >= _bufferStart &&
+            end - _bufferStart <= _bufferSize)
+    {
+        _bufferPos = end - _bufferStart;
+        return;
+    }
+
+    if (!dropBuffer(endPos))
     {
         // We'll go on reading right past the end of the stream
         // if we don't throw an exception.
         throw ParserException(_("Could not seek to reported end of tag"));
     }
-
-    m_unused_bits = 0;
 }
 
 void
 SWFStream::consumeInput()
 {
+	_buffered = false;
+	_bufferPending = false;
+	_bits = 0;
+	_bitCount = 0;
+
 	// IOChannel::go_to_end is documented
 	// to possibly throw an exception (!)
 	try {
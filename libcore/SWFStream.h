@@ -55,6 +55,12 @@ namespace gnash {
 /// - aligned reads always start on a byte boundary
 /// - bitwise reads can cross byte boundaries
 /// 
+/// The body of the outermost open tag is read into memory the first time
+/// it is needed, so that bit-packed values are read from a buffer, 64 bits
+/// at a time, rather than with a call to the IOChannel for each byte.
+/// The body is only read when its data is used, so a tag can be opened
+/// before all of it has been loaded. Inputs that hold their data in
+/// memory, such as mapped files, are read in place.
 class DSOEXPORT SWFStream
 {
 public:
@@ -134,8 +140,10 @@ public:
 	///
 	void	align()
 	{
-		m_unused_bits=0;
-		// m_current_byte = 0; // this is not needed
+		// Whole bytes already taken from the tag buffer are read again.
+		_bufferPos -= _bitCount / 8;
+		_bitCount = 0;
+		_bits = 0;
 	}
 
 	/// Read <count> bytes from the source stream and copy that data to <buf>.
@@ -384,7 +392,7 @@ public:
 #ifndef GNASH_TRUST_SWF_INPUT
 		if ( _tagBoundsStack.empty() ) return; // not in a tag (should we check file length ?)
 		unsigned long int bytesLeft = get_tag_end_position() - tell();
-		unsigned long int bitsLeft = (bytesLeft*8)+m_unused_bits;
+		unsigned long int bitsLeft = (bytesLeft*8)+(_bitCount%8);
 		if ( bitsLeft < needed )
 		{
 			std::stringstream ss;
@@ -414,9 +422,61 @@ public:
 
 private:
 
+	/// Read the body of the outermost tag into _data, if needed.
+	//
+	/// @return	whether reads come from _data.
+	bool buffered()
+	{
+		if (_bufferPending) fillBuffer();
+		return _buffered;
+	}
+
+	void fillBuffer();
+
+	/// Stop reading from _data, and continue from the given position
+	/// in the input.
+	//
+	/// @return	whether the input could seek to the position.
+	bool dropBuffer(unsigned long pos);
+
+	/// Make at least the given number of bits available in _bits.
+	void fillBits(unsigned bitcount);
+
 	IOChannel*	m_input;
-	std::uint8_t	m_current_byte;
-	std::uint8_t	m_unused_bits;
+
+	/// Bits read but not used yet, the next one being the highest.
+	std::uint64_t _bits;
+
+	/// The number of bits in _bits.
+	//
+	/// When reading from _data, this can include whole bytes, which
+	/// are given back by align(). Otherwise it is less than 8.
+	unsigned _bitCount;
+
+	/// The body of the outermost tag, or the part after where it was
+	/// first read.
+	//
+	/// This is in the input's own memory if it can give it in place,
+	/// otherwise it is a copy in _buffer.
+	const std::uint8_t* _data;
+
+	/// The size of _data.
+	size_t _bufferSize;
+
+	/// Storage for _data if the input has to be copied.
+	std::vector<std::uint8_t> _buffer;
+
+	/// The position in the input of the start of _data.
+	unsigned long _bufferStart;
+
+	/// The position in _data of the next byte to read into _bits.
+	size_t _bufferPos;
+
+	/// Whether reads come from _data.
+	bool _buffered;
+
+	/// Whether an outermost tag was opened and its body not read yet.
+	bool _bufferPending;
 
 	typedef std::pair<unsigned long,unsigned long> TagBoundaries;
 	// position of start and end of tag
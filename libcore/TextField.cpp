@@ -73,6 +73,31 @@
 
 namespace gnash {
 
+struct TextField::Paragraph
+{
+    /// The position in the text of the first character.
+    size_t pos;
+
+    /// The state of format_text() and handleChar() before the first
+    /// character is handled.
+    SWF::TextRecord rec;
+    std::int32_t x;
+    std::int32_t y;
+    int lastCode;
+    int lastSpaceGlyph;
+    LineStarts::value_type lastLineStartRecord;
+
+    /// The sizes of the layout containers, which only grow from here.
+    size_t records;
+    size_t lineStarts;
+    size_t recordStarts;
+
+    size_t glyphCount;
+    size_t maxScroll;
+    SWFRect textBounds;
+    SWFRect bounds;
+};
+
 TextField::TextField(as_object* object, DisplayObject* parent,
         const SWF::DefineEditTextTag& def)
     :
@@ -351,12 +376,9 @@ TextField::display(Renderer& renderer, const Transform& base)
     int yoffset = (getFontHeight() + fontLeading) + PADDING_TWIPS;
     size_t recordline;
     for (size_t i = 0; i < _textRecords.size(); ++i) {
-        recordline = 0;
         //find the line the record is on
-        while (recordline < _line_starts.size() && 
-                _line_starts[recordline] <= _recordStarts[i]) {
-            ++recordline;
-        }
+        recordline = std::upper_bound(_line_starts.begin(),
+                _line_starts.end(), _recordStarts[i]) - _line_starts.begin();
         //offset the line
         _textRecords[i].setYOffset((recordline-_scroll)*yoffset);
         //add the lines we want to the display record
@@ -1010,15 +1032,115 @@ TextField::insertTab(SWF::TextRecord& rec, std::int32_t& x, float scale)
     }
 }
 
+TextField::LayoutSettings
+TextField::layoutSettings()
+{
+    LayoutSettings settings;
+    settings.font = _font.get();
+    settings.fontHeight = getFontHeight();
+    settings.leftMargin = getLeftMargin();
+    settings.rightMargin = getRightMargin();
+    settings.indent = getIndent();
+    settings.blockIndent = getBlockIndent();
+    settings.alignment = getTextAlignment();
+    settings.autoSize = getAutoSize();
+    settings.embedFonts = _embedFonts;
+    settings.wordWrap = doWordWrap();
+    settings.bullet = _bullet;
+    settings.password = password();
+    settings.underlined = getUnderlined();
+    settings.color = getTextColor();
+    settings.url = _url;
+    settings.target = _target;
+    settings.tabStops = _tabStops;
+
+    // The bounds are worked out by the layout itself in this case.
+    const bool autoBounds = _autoSize != AUTOSIZE_NONE && !doWordWrap();
+    settings.width = autoBounds ? 0 : _bounds.width();
+    settings.height = autoBounds ? 0 : _bounds.height();
+    return settings;
+}
+
+bool
+TextField::LayoutSettings::operator==(const LayoutSettings& o) const
+{
+    return font == o.font && fontHeight == o.fontHeight &&
+        leftMargin == o.leftMargin && rightMargin == o.rightMargin &&
+        indent == o.indent && blockIndent == o.blockIndent &&
+        alignment == o.alignment && autoSize == o.autoSize &&
+        embedFonts == o.embedFonts && wordWrap == o.wordWrap &&
+        bullet == o.bullet && password == o.password &&
+        underlined == o.underlined && color == o.color && url == o.url &&
+        target == o.target && tabStops == o.tabStops &&
+        width == o.width && height == o.height;
+}
+
+void
+TextField::saveParagraph(size_t pos, std::int32_t x, std::int32_t y,
+        const SWF::TextRecord& rec, int last_code, int last_space_glyph,
+        LineStarts::value_type last_line_start_record)
+{
+    Paragraph p;
+    p.pos = pos;
+    p.rec = rec;
+    p.x = x;
+    p.y = y;
+    p.lastCode = last_code;
+    p.lastSpaceGlyph = last_space_glyph;
+    p.lastLineStartRecord = last_line_start_record;
+    p.records = _textRecords.size();
+    p.lineStarts = _line_starts.size();
+    p.recordStarts = _recordStarts.size();
+    p.glyphCount = _glyphcount;
+    p.maxScroll = _maxScroll;
+    p.textBounds = m_text_bounding_box;
+    p.bounds = _bounds;
+    _paragraphs.push_back(p);
+}
+
 void
 TextField::format_text()
 {
-    _textRecords.clear();
-    _line_starts.clear();
-    _recordStarts.clear();
-    _glyphcount = 0;
+    // Keep the paragraphs before the first change to the text, if the
+    // text is plain and was laid out the same way. HTML tags can change
+    // the layout settings anywhere, so that is always laid out in full.
+    const LayoutSettings settings = layoutSettings();
+    if (doHtml() || _paragraphs.empty() || !(settings == _laidOutSettings)) {
+        _paragraphs.clear();
+    }
+    else {
+        const size_t common = std::mismatch(_laidOutText.begin(),
+                _laidOutText.begin() + std::min(_laidOutText.size(),
+                    _text.size()), _text.begin()).first -
+            _laidOutText.begin();
+        while (!_paragraphs.empty() && _paragraphs.back().pos > common) {
+            _paragraphs.pop_back();
+        }
+    }
+    _laidOutSettings = settings;
+    if (doHtml()) _laidOutText.clear();
+    else _laidOutText = _text;
+
+    const bool resume = !_paragraphs.empty();
 
-    _recordStarts.push_back(0);
+    if (resume) {
+        const Paragraph& p = _paragraphs.back();
+        _textRecords.erase(_textRecords.begin() + p.records,
+                _textRecords.end());
+        _line_starts.resize(p.lineStarts);
+        _recordStarts.resize(p.recordStarts);
+        _glyphcount = p.glyphCount;
+        _maxScroll = p.maxScroll;
+        m_text_bounding_box = p.textBounds;
+    }
+    else {
+        _textRecords.clear();
+        _line_starts.clear();
+        _recordStarts.clear();
+        _glyphcount = 0;
+
+        _recordStarts.push_back(0);
+    }
 		
     // nothing more to do if text is empty
     if (_text.empty()) {
@@ -1061,58 +1183,12 @@ TextField::format_text()
     SWFRect oldBounds(_bounds);
 
     SWF::TextRecord rec;    // one to work on
-    rec.setFont(_font.get());
-    rec.setUnderline(underlined);
-    rec.setColor(getTextColor()); 
-    rec.setXOffset(PADDING_TWIPS + 
-            std::max(0, leftMargin + indent + blockIndent));
-    rec.setYOffset(PADDING_TWIPS + fontHeight + fontLeading);
-    rec.setTextHeight(fontHeight);
-	
-	// create in textrecord.h
-	rec.setURL(_url);
-	rec.setTarget(_target);
-    
-    // BULLET CASE:
-                
-    // First, we indent 10 spaces, and then place the bullet
-    // character (in this case, an asterisk), then we pad it
-    // again with 10 spaces
-    // Note: this works only for additional lines of a 
-    // bulleted list, so that is why there is a bullet format
-    // in the beginning of format_text()
-    if (_bullet) {
-        int space = rec.getFont()->get_glyph_index(32, _embedFonts);
-
-        SWF::TextRecord::GlyphEntry ge;
-        ge.index = space;
-        ge.advance = scale * rec.getFont()->get_advance(space, _embedFonts);
-        rec.addGlyph(ge, 5);
-
-        // We use an asterisk instead of a bullet
-        int bullet = rec.getFont()->get_glyph_index(42, _embedFonts);
-        ge.index = bullet;
-        ge.advance = scale * rec.getFont()->get_advance(bullet, _embedFonts);
-        rec.addGlyph(ge);
-        
-        space = rec.getFont()->get_glyph_index(32, _embedFonts);
-        ge.index = space;
-        ge.advance = scale * rec.getFont()->get_advance(space, _embedFonts);
-        rec.addGlyph(ge, 4);
-    }
-
-    std::int32_t x = static_cast<std::int32_t>(rec.xOffset());
-    std::int32_t y = static_cast<std::int32_t>(rec.yOffset());
-
-    // Start the bbox at the upper-left corner of the first glyph.
-    //reset_bounding_box(x, y + fontHeight); 
-    
+    std::int32_t x;
+    std::int32_t y;
     int last_code = -1; // only used if _embedFonts
     int last_space_glyph = -1;
     size_t last_line_start_record = 0;
 
-    _line_starts.push_back(0);
-    
     // String iterators are very sensitive to 
     // potential changes to the string (to allow for copy-on-write).
     // So there must be no external changes to the string or
@@ -1121,6 +1197,71 @@ TextField::format_text()
     std::wstring::const_iterator it = _text.begin();
     const std::wstring::const_iterator e = _text.end();
 
+    if (resume) {
+        // Carry on from the start of the first changed paragraph.
+        const Paragraph& p = _paragraphs.back();
+        rec = p.rec;
+        x = p.x;
+        y = p.y;
+        last_code = p.lastCode;
+        last_space_glyph = p.lastSpaceGlyph;
+        last_line_start_record = p.lastLineStartRecord;
+        if (autoSize != AUTOSIZE_NONE && !doWordWrap()) _bounds = p.bounds;
+        it += p.pos;
+    }
+    else {
+        rec.setFont(_font.get());
+        rec.setUnderline(underlined);
+        rec.setColor(getTextColor()); 
+        rec.setXOffset(PADDING_TWIPS + 
+                std::max(0, leftMargin + indent + blockIndent));
+        rec.setYOffset(PADDING_TWIPS + fontHeight + fontLeading);
+        rec.setTextHeight(fontHeight);
+	
+        // create in textrecord.h
+        rec.setURL(_url);
+        rec.setTarget(_target);
+    
+        // BULLET CASE:
+                
+        // First, we indent 10 spaces, and then place the bullet
+        // character (in this case, an asterisk), then we pad it
+        // again with 10 spaces
+        // Note: this works only for additional lines of a 
+        // bulleted list, so that is why there is a bullet format
+        // in the beginning of format_text()
+        if (_bullet) {
+            int space = rec.getFont()->get_glyph_index(32, _embedFonts);
+
+            SWF::TextRecord::GlyphEntry ge;
+            ge.index = space;
+            ge.advance = scale * rec.getFont()->get_advance(space,
+                    _embedFonts);
+            rec.addGlyph(ge, 5);
+
+            // We use an asterisk instead of a bullet
+            int bullet = rec.getFont()->get_glyph_index(42, _embedFonts);
+            ge.index = bullet;
+            ge.advance = scale * rec.getFont()->get_advance(bullet,
+                    _embedFonts);
+            rec.addGlyph(ge);
+        
+            space = rec.getFont()->get_glyph_index(32, _embedFonts);
+            ge.index = space;
+            ge.advance = scale * rec.getFont()->get_advance(space,
+                    _embedFonts);
+            rec.addGlyph(ge, 4);
+        }
+
+        x = static_cast<std::int32_t>(rec.xOffset());
+        y = static_cast<std::int32_t>(rec.yOffset());
+
+        // Start the bbox at the upper-left corner of the first glyph.
+        //reset_bounding_box(x, y + fontHeight); 
+    
+        _line_starts.push_back(0);
+    }
+
     ///handleChar takes care of placing the glyphs    
     handleChar(it, e, x, y, rec, last_code, last_space_glyph,
             last_line_start_record);
@@ -1179,9 +1320,8 @@ TextField::scrollLines()
         }
 
         // which line is the cursor on?
-        while (line < manylines && _line_starts[line] <= m_cursor) {
-            ++line;
-        }
+        line = std::upper_bound(_line_starts.begin(), _line_starts.end(),
+                m_cursor) - _line_starts.begin();
 
         if (manylines - _scroll <= _linesindisplay) {
             // This is for if we delete a line
@@ -1207,9 +1347,6 @@ TextField::newLine(std::int32_t& x, std::int32_t& y,
 				LineStarts::value_type& last_line_start_record, float div)
 {
     // newline.
-    LineStarts::iterator linestartit = _line_starts.begin();
-    LineStarts::const_iterator linestartend = _line_starts.end();
-    
     // TODO: work out how leading affects things.
     const float leading = 0;
     
@@ -1241,16 +1378,10 @@ TextField::newLine(std::int32_t& x, std::int32_t& y,
     last_space_glyph = -1;
     last_line_start_record = _textRecords.size();
                          
-    linestartit = _line_starts.begin();
-    linestartend = _line_starts.end();
     //Fit a line_start in the correct place
     const size_t currentPos = _glyphcount;
-
-    while (linestartit < linestartend && *linestartit < currentPos)
-    {
-        ++linestartit;
-    }
-    _line_starts.insert(linestartit, currentPos);
+    _line_starts.insert(std::lower_bound(_line_starts.begin(),
+                _line_starts.end(), currentPos), currentPos);
 
     // BULLET CASE:
                 
@@ -1294,9 +1425,6 @@ TextField::handleChar(std::wstring::const_iterator& it,
         std::int32_t& y, SWF::TextRecord& rec, int& last_code,
         int& last_space_glyph, LineStarts::value_type& last_line_start_record)
 {
-    LineStarts::iterator linestartit = _line_starts.begin();
-    LineStarts::const_iterator linestartend = _line_starts.end();
-    
     float scale = _fontHeight /
         static_cast<float>(_font->unitsPerEM(_embedFonts)); 
     float fontDescent = _font->descent(_embedFonts) * scale; 
@@ -1306,8 +1434,17 @@ TextField::handleChar(std::wstring::const_iterator& it,
     const float fontLeading = 0;
     
     std::uint32_t code = 0;
+    bool paragraph = false;
     while (it != e)
     {
+        // Plain text is never handled recursively, so the layout state
+        // after a newline is that of the next paragraph.
+        if (paragraph && !doHtml()) {
+            saveParagraph(it - _text.cbegin(), x, y, rec, last_code,
+                    last_space_glyph, last_line_start_record);
+        }
+        paragraph = false;
+
         code = *it++;
         if (!code) break;
 
@@ -1357,6 +1494,7 @@ TextField::handleChar(std::wstring::const_iterator& it,
             case 10:
             {
                 newLine(x,y,rec,last_space_glyph,last_line_start_record,1.0);
+                paragraph = true;
                 break;
             }
             case '<':
@@ -1809,8 +1947,6 @@ TextField::handleChar(std::wstring::const_iterator& it,
                 assert(!_textRecords.empty());
                 SWF::TextRecord& last_line = _textRecords.back();
                 
-                linestartit = _line_starts.begin();
-                linestartend = _line_starts.end();
                 if (last_space_glyph == -1)
                 {
                     // Pull the previous glyph down onto the
@@ -1824,12 +1960,9 @@ TextField::handleChar(std::wstring::const_iterator& it,
                         //record the new line start
                         //
                         const size_t currentPos = _glyphcount;
-                        while (linestartit != linestartend &&
-                                *linestartit + 1 <= currentPos)
-                        {
-                            ++linestartit;
-                        }
-                        _line_starts.insert(linestartit, currentPos);
+                        _line_starts.insert(std::lower_bound(
+                                    _line_starts.begin(), _line_starts.end(),
+                                    currentPos), currentPos);
                         _recordStarts.push_back(currentPos);
                     }
                 } else {
@@ -1853,12 +1986,9 @@ TextField::handleChar(std::wstring::const_iterator& it,
                     const size_t linestartpos = _glyphcount -
                             rec.glyphs().size();
 
-                    while (linestartit < linestartend &&
-                            *linestartit < linestartpos)
-                    {
-                        ++linestartit;
-                    }
-                    _line_starts.insert(linestartit, linestartpos);
+                    _line_starts.insert(std::lower_bound(
+                                _line_starts.begin(), _line_starts.end(),
+                                linestartpos), linestartpos);
                     _recordStarts.push_back(linestartpos);
                 }
 
@@ -630,6 +630,10 @@ private:
 
 	/// Convert the DisplayObjects in _text into a series of
 	/// text_glyph_records to be rendered.
+	//
+	/// Plain text is laid out again only from the first paragraph that
+	/// changed since the last call, as long as none of the settings the
+	/// layout depends on changed.
 	void format_text();
 	
 	/// Move viewable lines based on m_cursor
@@ -641,6 +645,46 @@ private:
 				 SWF::TextRecord& rec, int& last_space_glyph,
 				 LineStarts::value_type& last_line_start_record, float div);
 					
+	/// The layout state at the start of a paragraph of plain text.
+	struct Paragraph;
+
+	/// The settings the layout of the text depends on, other than the
+	/// text itself.
+	struct LayoutSettings
+	{
+		const Font* font;
+		std::uint16_t fontHeight;
+		std::uint16_t leftMargin;
+		std::uint16_t rightMargin;
+		std::uint16_t indent;
+		std::uint16_t blockIndent;
+		TextAlignment alignment;
+		AutoSize autoSize;
+		bool embedFonts;
+		bool wordWrap;
+		bool bullet;
+		bool password;
+		bool underlined;
+		rgba color;
+		std::string url;
+		std::string target;
+		std::vector<int> tabStops;
+
+		/// Only set when the layout doesn't change the bounds.
+		float width;
+		float height;
+
+		bool operator==(const LayoutSettings& o) const;
+	};
+
+	/// The current layout settings.
+	LayoutSettings layoutSettings();
+
+	/// Record the layout state at the start of a paragraph.
+	void saveParagraph(size_t pos, std::int32_t x, std::int32_t y,
+            const SWF::TextRecord& rec, int last_code, int last_space_glyph,
+            LineStarts::value_type last_line_start_record);
+
 	/// De-reference and do appropriate action for character iterator
 	void handleChar(std::wstring::const_iterator& it,
             const std::wstring::const_iterator& e, std::int32_t& x,
@@ -738,6 +782,16 @@ private:
 	std::vector<int> _tabStops;
 	LineStarts _line_starts;
 
+	/// The text laid out by the last format_text() call, if it was plain.
+	std::wstring _laidOutText;
+
+	/// The settings of the last format_text() call.
+	LayoutSettings _laidOutSettings;
+
+	/// The layout state at the start of each paragraph of _laidOutText
+	/// after the first, in order.
+	std::vector<Paragraph> _paragraphs;
+
 	/// The text variable name
 	//
 	/// This is stored here, and not just in the definition,
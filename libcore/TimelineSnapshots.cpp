@@ -0,0 +1,209 @@
+// TimelineSnapshots.cpp: display list state of a timeline at some frames.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "TimelineSnapshots.h"
+
+#include <algorithm>
+
+#include "movie_definition.h"
+#include "MovieClip.h"
+#include "DisplayList.h"
+#include "ControlTag.h"
+#include "PlaceObject2Tag.h"
+#include "RemoveObjectTag.h"
+#include "DoActionTag.h"
+#include "StartSoundTag.h"
+#include "StreamSoundBlockTag.h"
+
+namespace gnash {
+
+namespace {
+
+/// The properties a move tag sets, as bits.
+int
+moveFields(const SWF::PlaceObject2Tag& tag)
+{
+    return (tag.hasMatrix() ? 1 : 0) | (tag.hasCxform() ? 2 : 0) |
+        (tag.hasRatio() ? 4 : 0);
+}
+
+/// Whether a tag does nothing when its state is executed.
+bool
+actionOnly(const SWF::ControlTag& tag)
+{
+    return dynamic_cast<const SWF::DoActionTag*>(&tag) ||
+        dynamic_cast<const SWF::StartSoundTag*>(&tag) ||
+        dynamic_cast<const SWF::StreamSoundBlockTag*>(&tag);
+}
+
+}
+
+TimelineSnapshots&
+movie_definition::timelineSnapshots(size_t interval, size_t limit) const
+{
+    std::lock_guard<std::mutex> lock(_timelineSnapshotsMutex);
+    if (!_timelineSnapshots) {
+        _timelineSnapshots.reset(new TimelineSnapshots(*this, interval,
+                    limit));
+    }
+    return *_timelineSnapshots;
+}
+
+TimelineSnapshots::TimelineSnapshots(const movie_definition& def,
+        size_t interval, size_t limit)
+    :
+    _def(def),
+    _interval(std::max<size_t>(interval, 1)),
+    _limit(limit)
+{
+    _current.frame = 0;
+}
+
+TimelineSnapshots::~TimelineSnapshots()
+{
+}
+
+size_t
+TimelineSnapshots::restore(size_t frame, MovieClip& m, DisplayList& dlist)
+{
+    // Executing the tags can run code, so only hold the lock while
+    // finding the tags to execute.
+    std::vector<const SWF::ControlTag*> tags;
+    size_t restored;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Only frames that are loaded can be scanned, and there's no
+        // point in scanning once no more snapshots can be kept.
+        while (_current.frame < frame && _snapshots.size() < _limit &&
+                _current.frame < _def.get_loading_frame()) {
+            scan();
+        }
+
+        std::vector<Snapshot>::const_reverse_iterator it = _snapshots.rbegin();
+        while (it != _snapshots.rend() && it->frame > frame) ++it;
+        if (it == _snapshots.rend()) return 0;
+
+        tags = it->tags;
+        for (const auto& depth : it->depths) {
+            tags.insert(tags.end(), depth.second.tags.begin(),
+                    depth.second.tags.end());
+            tags.insert(tags.end(), depth.second.moves.begin(),
+                    depth.second.moves.end());
+        }
+        restored = it->frame;
+    }
+
+    for (const SWF::ControlTag* tag : tags) {
+        tag->executeState(&m, dlist);
+    }
+
+    return restored;
+}
+
+void
+TimelineSnapshots::scan()
+{
+    const movie_definition::PlayList* playlist =
+        _def.getPlaylist(_current.frame);
+
+    if (playlist) {
+        for (const auto& item : *playlist) {
+            const SWF::ControlTag& tag = *item;
+
+            const SWF::PlaceObject2Tag* place =
+                dynamic_cast<const SWF::PlaceObject2Tag*>(&tag);
+            if (place) {
+                this->place(*place);
+                continue;
+            }
+
+            const SWF::RemoveObjectTag* remove =
+                dynamic_cast<const SWF::RemoveObjectTag*>(&tag);
+            if (remove) {
+                _current.depths.erase(remove->getDepth());
+                continue;
+            }
+
+            if (!actionOnly(tag)) _current.tags.push_back(&tag);
+        }
+    }
+
+    ++_current.frame;
+
+    if (_current.frame % _interval == 0 && _snapshots.size() < _limit) {
+        _snapshots.push_back(_current);
+    }
+}
+
+void
+TimelineSnapshots::place(const SWF::PlaceObject2Tag& tag)
+{
+    const int depth = tag.getDepth();
+    std::map<int, Depth>::iterator it = _current.depths.find(depth);
+
+    // Only a DisplayObject that exists can be moved or replaced, and
+    // a new one is only placed where there is none.
+    switch (tag.getPlaceType()) {
+
+        case SWF::PlaceObject2Tag::PLACE:
+            if (it != _current.depths.end()) return;
+            if (!_def.getDefinitionTag(tag.getID())) return;
+            _current.depths[depth].tags.push_back(&tag);
+            return;
+
+        case SWF::PlaceObject2Tag::MOVE:
+        {
+            if (it == _current.depths.end()) return;
+            std::vector<const SWF::PlaceObject2Tag*>& moves = it->second.moves;
+            moves.push_back(&tag);
+
+            // Keep only the moves that still set something.
+            std::vector<const SWF::PlaceObject2Tag*> kept;
+            int done = 0;
+            for (size_t i = moves.size(); i > 0; --i) {
+                const int fields = moveFields(*moves[i - 1]);
+                if (fields & ~done) kept.push_back(moves[i - 1]);
+                done |= fields;
+            }
+            moves.assign(kept.rbegin(), kept.rend());
+            return;
+        }
+
+        case SWF::PlaceObject2Tag::REPLACE:
+        {
+            if (it == _current.depths.end()) return;
+            Depth& d = it->second;
+            d.tags.insert(d.tags.end(), d.moves.begin(), d.moves.end());
+            d.moves.clear();
+            d.tags.push_back(&tag);
+            return;
+        }
+
+        case SWF::PlaceObject2Tag::REMOVE:
+            if (it != _current.depths.end()) _current.depths.erase(it);
+            return;
+    }
+}
+
+} // namespace gnash
+
+// Local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -0,0 +1,142 @@
+// TimelineSnapshots.h: display list state of a timeline at some frames.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_TIMELINESNAPSHOTS_H
+#define GNASH_TIMELINESNAPSHOTS_H
+
+#include <map>
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+// Forward declarations
+namespace gnash {
+    class DisplayList;
+    class MovieClip;
+    class movie_definition;
+    namespace SWF {
+        class ControlTag;
+        class PlaceObject2Tag;
+    }
+}
+
+namespace gnash {
+
+/// The state tags needed to rebuild a timeline's DisplayList at some frames.
+//
+/// Going back in a timeline means executing the state tags of all frames
+/// from the first one, which is slow for long timelines. Each DisplayList
+/// tag only affects one depth, so most of these tags can be dropped: a
+/// depth only needs the PlaceObject that created its DisplayObject, any
+/// later replacements, and the last tag that set each of its matrix,
+/// color transform and ratio. Other state tags are all kept.
+//
+/// A snapshot of these tags is kept every few frames, so that a backward
+/// jump only executes the tags of the snapshot and of the frames after it.
+/// The snapshots depend only on the definition, so they are shared by all
+/// instances of a timeline.
+class TimelineSnapshots
+{
+public:
+
+    /// Create snapshots for a timeline.
+    //
+    /// @param def      The definition of the timeline.
+    /// @param interval The number of frames between snapshots.
+    /// @param limit    The maximum number of snapshots to keep.
+    TimelineSnapshots(const movie_definition& def, size_t interval,
+            size_t limit);
+
+    ~TimelineSnapshots();
+
+    /// Rebuild a DisplayList from the last snapshot before a frame.
+    //
+    /// Snapshots up to the frame are taken first if necessary. This may
+    /// be called from several threads at once.
+    //
+    /// @param frame    The 0-based frame whose state tags are to be
+    ///                 executed next.
+    /// @param m        The MovieClip to execute the tags for.
+    /// @param dlist    The DisplayList to rebuild, which should be empty.
+    /// @return         The number of frames whose tags were executed. The
+    ///                 caller must execute the tags of the frames from this
+    ///                 one up to the target frame.
+    size_t restore(size_t frame, MovieClip& m, DisplayList& dlist);
+
+    /// The number of snapshots kept.
+    size_t size() const {
+        return _snapshots.size();
+    }
+
+private:
+
+    /// The tags still affecting one depth.
+    struct Depth
+    {
+        /// The tag that created the DisplayObject and later replacements,
+        /// along with the moves made before each replacement.
+        std::vector<const SWF::PlaceObject2Tag*> tags;
+
+        /// The moves since the last of tags, in order.
+        //
+        /// A move is dropped when later ones set all of the matrix, color
+        /// transform and ratio it sets, so there are at most three.
+        std::vector<const SWF::PlaceObject2Tag*> moves;
+    };
+
+    struct Snapshot
+    {
+        /// The number of frames whose tags are included.
+        size_t frame;
+
+        /// State tags other than DisplayList tags.
+        std::vector<const SWF::ControlTag*> tags;
+
+        std::map<int, Depth> depths;
+    };
+
+    /// Add the state tags of the next frame to _current.
+    void scan();
+
+    /// Add a PlaceObject tag to _current.
+    void place(const SWF::PlaceObject2Tag& tag);
+
+    const movie_definition& _def;
+
+    const size_t _interval;
+
+    const size_t _limit;
+
+    /// The snapshots, in order of frame.
+    std::vector<Snapshot> _snapshots;
+
+    /// The state after all frames scanned so far.
+    Snapshot _current;
+
+    /// Protects _snapshots and _current.
+    std::mutex _mutex;
+};
+
+} // namespace gnash
+
+#endif
+
+// Local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -79,16 +79,6 @@ Timer::start()
 }
     
 
-bool
-Timer::expired(unsigned long now, unsigned long& elapsed)
-{
-    if (cleared()) return false;
-    long unsigned expTime = _start + _interval;
-    if (now < expTime) return false;
-    elapsed = expTime-now;
-    return true;
-}
-
 void
 Timer::executeAndReset()
 {
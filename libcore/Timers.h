@@ -99,24 +99,18 @@ public:
 
     /// Clear the timer, ready for reuse
     //
-    /// When a Timer is cleared, the expired() function
-    /// will always return false.
+    /// A cleared Timer never executes again.
     ///
     /// Use setInterval() to reset it.
     ///
     void clearInterval();
 
-    /// Get expiration state
-    // /// @param now
-    ///    Current time, in milliseconds.
-    ///
-    /// @param elapsed
-    ///    Output parameter, will be set to the amount of milliseconds
-    ///    elapsed since actual expiration, if expired.
-    ///
-    /// @return true if the timer expired, false otherwise.
-    ///
-    bool expired(unsigned long now, unsigned long& elapsed); 
+    /// Return the time at which the timer expires, in milliseconds.
+    //
+    /// This is only meaningful if the timer is not cleared(). It only
+    /// changes when the timer executes, so it can be used to keep timers
+    /// ordered until then.
+    unsigned long deadline() const { return _start + _interval; }
 
     /// Return true if interval has been cleared.
     //
@@ -87,6 +87,12 @@ public:
     Property* getProperty(as_object** owner = nullptr) const {
 
         assert(_object);
+
+        // An element stored in the vector has to become a real Property
+        // to be returned.
+        size_t i;
+        if (_object->denseIndex(_uri, i)) _object->makeSparse();
+
         Property* prop = _object->_members.getProperty(_uri);
         
         if (prop && _condition(*prop)) {
@@ -272,6 +278,31 @@ private:
     SortedPropertyList& _to;
 };
 
+/// A Property predicate noting whether any property is an array element.
+//
+/// It never accepts a property, so no values are fetched.
+class IsIndexName
+{
+public:
+    IsIndexName(VM& vm, bool& found) : _vm(vm), _found(found) {}
+
+    bool operator()(const Property& p) const {
+        if (_vm.getIndex(p.uri()) >= 0) _found = true;
+        return false;
+    }
+private:
+    VM& _vm;
+    bool& _found;
+};
+
+class NoVisit : public PropertyVisitor
+{
+public:
+    bool accept(const ObjectURI&, const as_value&) {
+        return false;
+    }
+};
+
 } // anonymous namespace
 
 
@@ -312,9 +343,115 @@ as_object::stringValue() const
 std::pair<bool,bool>
 as_object::delProperty(const ObjectURI& uri)
 {
+    size_t i;
+    if (denseIndex(uri, i)) {
+        // Deleting the last element doesn't leave a hole.
+        if (i + 1 == _elements->size()) {
+            _elements->pop_back();
+            return std::make_pair(true, true);
+        }
+        makeSparse();
+    }
     return _members.delProperty(uri);
 }
 
+void
+as_object::setArray(bool array)
+{
+    _array = array;
+
+    if (!array) {
+        makeSparse();
+        return;
+    }
+
+    if (_elements || _relay) return;
+
+    // Only an object without elements can start storing them in a vector.
+    bool found = false;
+    IsIndexName cmp(_vm, found);
+    NoVisit v;
+    _members.visitValues(v, cmp);
+    if (found) return;
+
+    _elements.reset(new std::vector<as_value>);
+}
+
+bool
+as_object::denseIndex(const ObjectURI& uri, size_t& i) const
+{
+    if (!_elements) return false;
+    const int index = _vm.getIndex(uri);
+    if (index < 0 || static_cast<size_t>(index) >= _elements->size()) {
+        return false;
+    }
+    i = index;
+    return true;
+}
+
+bool
+as_object::getElement(const ObjectURI& uri, as_value* val) const
+{
+    size_t i;
+    if (!denseIndex(uri, i)) return false;
+    *val = (*_elements)[i];
+    return true;
+}
+
+bool
+as_object::setElement(size_t i, const as_value& val)
+{
+    if (!_elements || _trigs.get() || displayObject()) return false;
+
+    if (i < _elements->size()) {
+        (*_elements)[i] = val;
+        return true;
+    }
+
+    // Anything else would leave a hole. A getter-setter with this name
+    // in a prototype would have to be called instead.
+    if (i != _elements->size() || _vm.indexGetters()) return false;
+
+    if (i >= arrayLength(*this)) {
+        set_member(NSV::PROP_LENGTH, static_cast<double>(i + 1));
+        if (!_elements || i != _elements->size()) return false;
+    }
+
+    _elements->push_back(val);
+    return true;
+}
+
+void
+as_object::makeSparse()
+{
+    if (!_elements) return;
+
+    // Reset first, so that setting the properties doesn't come back here.
+    std::unique_ptr<std::vector<as_value> > elements(std::move(_elements));
+
+    for (size_t i = 0, e = elements->size(); i != e; ++i) {
+        _members.setValue(_vm.getIndexURI(i), (*elements)[i]);
+    }
+}
+
+void
+as_object::prepareInsert(const ObjectURI& uri)
+{
+    if (!_elements) return;
+    if (_elements->empty() && _vm.getIndex(uri) < 0) return;
+    if (_members.getProperty(uri)) return;
+    makeSparse();
+}
+
+void
+as_object::visitElements(PropertyVisitor& visitor) const
+{
+    if (!_elements) return;
+    for (size_t i = 0; i < _elements->size(); ++i) {
+        if (!visitor.accept(_vm.getIndexURI(i), (*_elements)[i])) return;
+    }
+}
+
 
 void
 as_object::add_property(const std::string& name, as_function& getter,
@@ -322,6 +459,9 @@ as_object::add_property(const std::string& name, as_function& getter,
 {
     const ObjectURI& uri = getURI(vm(), name);
 
+    if (_vm.getIndex(uri) >= 0) _vm.setIndexGetters();
+    prepareInsert(uri);
+
     Property* prop = _members.getProperty(uri);
 
     if (prop) {
@@ -379,6 +519,8 @@ as_object::get_member(const ObjectURI& uri, as_value* val)
 {
     assert(val);
 
+    if (getElement(uri, val)) return true;
+
     const int version = getSWFVersion(*this);
 
     PrototypeRecursor<IsVisible> pr(this, uri, IsVisible(version));
@@ -520,6 +662,7 @@ as_object::set_prototype(const as_value& proto)
     // TODO: check what happens if __proto__ is set as a user-defined 
     // getter/setter
     // TODO: check triggers !!
+    prepareInsert(NSV::PROP_uuPROTOuu);
     _members.setValue(NSV::PROP_uuPROTOuu, proto, as_object::DefaultFlags);
 }
 
@@ -583,6 +726,15 @@ bool
 as_object::set_member(const ObjectURI& uri, const as_value& val, bool ifFound)
 {
 
+    // Elements stored in the vector don't need the lookup below.
+    if (_elements) {
+        const int i = _vm.getIndex(uri);
+        if (i >= 0) {
+            const bool found = static_cast<size_t>(i) < _elements->size();
+            if ((found || !ifFound) && setElement(i, val)) return found;
+        }
+    }
+
     bool tfVarFound = false;
     if (displayObject()) {
         MovieClip* mc = dynamic_cast<MovieClip*>(displayObject());
@@ -646,6 +798,7 @@ as_object::set_member(const ObjectURI& uri, const as_value& val, bool ifFound)
     if (ifFound) return false;
         
     // Property does not exist, so it won't be read-only. Set it.
+    prepareInsert(uri);
     if (!_members.setValue(uri, val)) {
             
         IF_VERBOSE_ASCODING_ERRORS(
@@ -677,6 +830,7 @@ as_object::init_member(const ObjectURI& uri, const as_value& val, int flags)
 {
 
     // Set (or create) a SimpleProperty 
+    prepareInsert(uri);
     if (!_members.setValue(uri, val, flags)) {
         ObjectURI::Logger l(getStringTable(*this));
         log_error(_("Attempt to initialize read-only property '%s'"
@@ -698,6 +852,8 @@ void
 as_object::init_property(const ObjectURI& uri, as_function& getter,
                          as_function& setter, int flags)
 {
+    if (_vm.getIndex(uri) >= 0) _vm.setIndexGetters();
+    prepareInsert(uri);
     _members.addGetterSetter(uri, getter, &setter, as_value(), flags);
 }
 
@@ -713,6 +869,8 @@ void
 as_object::init_property(const ObjectURI& uri, as_c_function_ptr getter,
                          as_c_function_ptr setter, int flags)
 {
+    if (_vm.getIndex(uri) >= 0) _vm.setIndexGetters();
+    prepareInsert(uri);
     _members.addGetterSetter(uri, getter, setter, flags);
 }
 
@@ -720,6 +878,8 @@ bool
 as_object::init_destructive_property(const ObjectURI& uri, as_function& getter,
                                      int flags)
 {
+    if (_vm.getIndex(uri) >= 0) _vm.setIndexGetters();
+    prepareInsert(uri);
     return _members.addDestructiveGetter(uri, getter, flags);
 }
 
@@ -727,6 +887,8 @@ bool
 as_object::init_destructive_property(const ObjectURI& uri,
                                      as_c_function_ptr getter, int flags)
 {
+    if (_vm.getIndex(uri) >= 0) _vm.setIndexGetters();
+    prepareInsert(uri);
     return _members.addDestructiveGetter(uri, getter, flags);
 }
 
@@ -752,6 +914,8 @@ as_object::init_readonly_property(const std::string& name,
 void
 as_object::set_member_flags(const ObjectURI& uri, int setTrue, int setFalse)
 {
+    size_t i;
+    if (denseIndex(uri, i)) makeSparse();
     _members.setFlags(uri, setTrue, setFalse);
 }
 
@@ -851,9 +1015,12 @@ as_object::prototypeOf(as_object& instance)
 void
 as_object::dump_members() 
 {
-    log_debug("%d members of object %p follow", _members.size(),
+    log_debug("%d members of object %p follow", _members.size() + denseSize(),
             static_cast<const void*>(this));
     _members.dump();
+    for (size_t i = 0; i < denseSize(); ++i) {
+        log_debug("  %d: %s", i, (*_elements)[i]);
+    }
 }
 
 void
@@ -862,6 +1029,7 @@ as_object::setPropFlags(const as_value& props_val, int set_false, int set_true)
 
     if (props_val.is_null()) {
         // Take all the members of the object
+        makeSparse();
         _members.setFlagsAll(set_true, set_false);
         return;
     }
@@ -917,6 +1085,10 @@ as_object::visitKeys(KeyVisitor& visitor) const
     const as_object* current(this);
     while (current && visited.insert(current).second) {
         current->_members.visitKeys(visitor, doneList);
+        for (size_t i = 0; i < current->denseSize(); ++i) {
+            const ObjectURI uri = _vm.getIndexURI(i);
+            if (doneList.insert(uri).second) visitor(uri);
+        }
         current = current->get_prototype();
     }
 }
@@ -925,6 +1097,8 @@ as_object::visitKeys(KeyVisitor& visitor) const
 Property*
 as_object::getOwnProperty(const ObjectURI& uri)
 {
+    size_t i;
+    if (denseIndex(uri, i)) makeSparse();
     return _members.getProperty(uri);
 }
 
@@ -1012,6 +1186,11 @@ as_object::markReachableResources() const
 {
     _members.setReachable();
 
+    if (_elements) {
+        std::for_each(_elements->begin(), _elements->end(),
+                      std::mem_fn(&as_value::setReachable));
+    }
+
     if (_trigs.get()) {
         for (TriggerContainer::const_iterator it = _trigs->begin();
              it != _trigs->end(); ++it) {
@@ -532,6 +532,7 @@ public:
     /// Drop all properties from this object
     void clearProperties() {
         _members.clear();
+        if (_elements) _elements->clear();
     }
 
     /// Visit the properties of this object by key/as_value pairs
@@ -545,7 +546,7 @@ public:
     ///                 a const as_value as second argument.
     template<typename T>
     void visitProperties(PropertyVisitor& visitor) const {
-        _members.visitValues<T>(visitor);
+        if (_members.visitValues<T>(visitor)) visitElements(visitor);
     }
 
     /// Visit all visible property identifiers.
@@ -602,7 +603,10 @@ public:
     /// is assigned. There are tests verifying this behaviour in
     /// actionscript.all and the swfdec testsuite.
     void setRelay(Relay* p) {
-        if (p) _array = false;
+        if (p) {
+            _array = false;
+            makeSparse();
+        }
         if (_relay) _relay->clean();
         _relay.reset(p);
     }
@@ -627,8 +631,59 @@ public:
     }
 
     /// Set whether this object should be treated as an array.
-    void setArray(bool array = true) {
-        _array = array;
+    //
+    /// A new array stores its elements in a vector rather than as named
+    /// properties, until something needs them to be real properties.
+    void setArray(bool array = true);
+
+    /// Return true if the elements of this array are stored in a vector.
+    bool dense() const {
+        return _elements.get();
+    }
+
+    /// The number of elements stored in the vector.
+    size_t denseSize() const {
+        return _elements ? _elements->size() : 0;
+    }
+
+    /// Get an element of a dense array without looking up its name.
+    //
+    /// @param i    The index of the element.
+    /// @param val  Set to the value of the element if it is found.
+    /// @return     false if the element isn't stored in the vector. The
+    ///             normal property lookup has to be used then.
+    bool getElement(size_t i, as_value* val) const {
+        if (!_elements || i >= _elements->size()) return false;
+        *val = (*_elements)[i];
+        return true;
+    }
+
+    /// Get an element of a dense array by name.
+    //
+    /// @param uri  The name of the element.
+    /// @param val  Set to the value of the element if it is found.
+    /// @return     false if the element isn't stored in the vector.
+    bool getElement(const ObjectURI& uri, as_value* val) const;
+
+    /// Set an element of a dense array without looking up its name.
+    //
+    /// This updates the length property as set_member() would.
+    //
+    /// @param i    The index of the element.
+    /// @param val  The new value of the element.
+    /// @return     false if the element can't be stored in the vector,
+    ///             because it would leave a hole or a trigger or
+    ///             getter-setter might have to be called. The caller must
+    ///             use set_member() then.
+    bool setElement(size_t i, const as_value& val);
+
+    /// Drop the elements stored in the vector from an index on.
+    //
+    /// This does not change the length property.
+    //
+    /// @param size The number of elements to keep.
+    void truncateElements(size_t size) {
+        if (_elements && size < _elements->size()) _elements->resize(size);
     }
 
     /// Return the DisplayObject associated with this object.
@@ -709,12 +764,44 @@ private:
     /// destructor is called.
     std::unique_ptr<Relay> _relay;
 
+    /// Move the elements stored in the vector to the named properties.
+    //
+    /// This is done when an element needs to be a real Property, for
+    /// instance when its flags are changed or it is looked up as the
+    /// member of a prototype, and when an array gets a hole. The array
+    /// stays sparse after that.
+    void makeSparse();
+
+    /// Get the index of an element stored in the vector.
+    //
+    /// @return     true if the name is an index below denseSize().
+    bool denseIndex(const ObjectURI& uri, size_t& i) const;
+
+    /// Make the array sparse if a new property is being added.
+    //
+    /// The elements in the vector are always enumerated after the
+    /// named properties, so nothing can be added after them.
+    void prepareInsert(const ObjectURI& uri);
+
+    /// Visit the elements stored in the vector as properties.
+    //
+    /// They have no flags, so any property predicate accepts them.
+    void visitElements(PropertyVisitor& visitor) const;
+
     /// The VM containing this object.
     VM& _vm;
 
     /// Properties of this as_object
     PropertyList _members;
 
+    /// The elements of a dense array.
+    //
+    /// When this exists, the properties named 0 to size() - 1 are stored
+    /// here instead of in _members, and no other property is named like
+    /// an array index. They are all plain values without flags, and were
+    /// added after all of the properties in _members.
+    std::unique_ptr<std::vector<as_value> > _elements;
+
     /// The constructors of the objects implemented by this as_object.
     //
     /// There is no need to use a complex container as the list of 
@@ -776,6 +863,8 @@ getMember(as_object& o, const ObjectURI& uri)
 inline as_value
 getOwnProperty(as_object& o, const ObjectURI& uri)
 {
+    as_value val;
+    if (o.dense() && o.getElement(uri, &val)) return val;
     Property* p = o.getOwnProperty(uri);
     return p ? p->getValue(o) : as_value();
 }
@@ -853,6 +942,8 @@ get(as_object* o)
 inline bool
 hasOwnProperty(as_object& o, const ObjectURI& uri)
 {
+    as_value val;
+    if (o.getElement(uri, &val)) return true;
     return (o.getOwnProperty(uri));
 }
 
@@ -26,7 +26,6 @@
 #include <functional>
 #include <iterator>
 #include <boost/algorithm/string/case_conv.hpp>
-#include <boost/lexical_cast.hpp>
 
 #include "as_value.h"
 #include "log.h"
@@ -87,7 +86,6 @@ namespace {
     as_value array_splice(const fn_call& fn);
 
     ObjectURI getKey(const fn_call& fn, size_t i);
-    int isIndex(const std::string& name);
 
     /// Implementation of foreachArray that takes a start and end range.
     template<typename T> void foreachArray(as_object& array, int start,
@@ -911,7 +909,7 @@ bool
 IsStrictArray::accept(const ObjectURI& uri, const as_value& /*val*/)
 {
     // We ignore namespace.
-    if (isIndex(uri.toString(_st.getStringTable())) >= 0) return true;
+    if (_st.getIndex(uri, false) >= 0) return true;
     _strict = false;
     return false;
 }
@@ -928,7 +926,7 @@ checkArrayLength(as_object& array, const ObjectURI& uri, const as_value& val)
         return;
     }
 
-    const int index = isIndex(uri.toString(getStringTable(array)));
+    const int index = getVM(array).getIndex(uri, false);
 
     // if we were sent a valid array index
     if (index >= 0) {
@@ -994,8 +992,7 @@ array_class_init(as_object& where, const ObjectURI& uri)
 ObjectURI
 arrayKey(VM& vm, size_t i)
 {
-    // TODO: tell getURI that the string is already lowercase!
-    return getURI(vm, std::to_string(i), true);
+    return vm.getIndexURI(i);
 }
 
 namespace {
@@ -1321,6 +1318,7 @@ array_push(const fn_call& fn)
     const size_t size = arrayLength(*array);
 
     for (size_t i = 0; i < shift; ++i) {
+        if (array->setElement(size + i, fn.arg(i))) continue;
         array->set_member(getKey(fn, size + i), fn.arg(i));
     }
  
@@ -1340,6 +1338,27 @@ array_unshift(const fn_call& fn)
 
     const size_t size = arrayLength(*array);
 
+    // Elements stored in a vector are rewritten in order, so that none
+    // of them has to be deleted.
+    if (array->denseSize() == size) {
+        std::vector<as_value> elements;
+        elements.reserve(size + shift);
+        for (size_t i = 0; i < shift; ++i) {
+            elements.push_back(fn.arg(i));
+        }
+        as_value val;
+        for (size_t i = 0; i < size; ++i) {
+            array->getElement(i, &val);
+            elements.push_back(val);
+        }
+        for (size_t i = 0; i < elements.size(); ++i) {
+            if (array->setElement(i, elements[i])) continue;
+            array->set_member(getKey(fn, i), elements[i]);
+        }
+        setArrayLength(*array, size + shift);
+        return as_value(size + shift);
+    }
+
     for (size_t i = size + shift - 1; i >= shift ; --i) {
         const ObjectURI nextkey = getKey(fn, i - shift);
         const ObjectURI currentkey = getKey(fn, i);
@@ -1388,7 +1407,18 @@ array_shift(const fn_call& fn)
 
     as_value ret = getOwnProperty(*array, getKey(fn, 0));
 
-    for (size_t i = 0; i < static_cast<size_t>(size - 1); ++i) {
+    size_t i = 0;
+
+    // Elements stored in a vector are moved without deleting them.
+    if (array->denseSize() == size) {
+        as_value val;
+        for (; i < static_cast<size_t>(size - 1); ++i) {
+            array->getElement(i + 1, &val);
+            if (!array->setElement(i, val)) break;
+        }
+    }
+
+    for (; i < static_cast<size_t>(size - 1); ++i) {
         const ObjectURI nextkey = getKey(fn, i + 1);
         const ObjectURI currentkey = getKey(fn, i);
         array->delProperty(currentkey);
@@ -1410,7 +1440,20 @@ array_reverse(const fn_call& fn)
     // An array with 0 or 1 elements has nothing to reverse.
     if (size < 2) return as_value();
 
-    for (size_t i = 0; i < static_cast<size_t>(size) / 2; ++i) {
+    size_t i = 0;
+
+    // Elements stored in a vector are swapped without deleting them.
+    if (array->denseSize() == size) {
+        as_value top, bottom;
+        for (; i < static_cast<size_t>(size) / 2; ++i) {
+            array->getElement(i, &bottom);
+            array->getElement(size - i - 1, &top);
+            if (!array->setElement(i, top)) break;
+            array->setElement(size - i - 1, bottom);
+        }
+    }
+
+    for (; i < static_cast<size_t>(size) / 2; ++i) {
         const ObjectURI bottomkey = getKey(fn, i);
         const ObjectURI topkey = getKey(fn, size - i - 1);
         const as_value top = getOwnProperty(*array, topkey);
@@ -1557,10 +1600,12 @@ join(as_object* array, const std::string& separator)
     VM& vm = getVM(*array);
     const int version = getSWFVersion(*array);
 
+    as_value el;
     for (size_t i = 0; i < size; ++i) {
         if (i) s += separator;
-        const std::string& index = std::to_string(i);
-        const as_value& el = getOwnProperty(*array, getURI(vm, index));
+        if (!array->getElement(i, &el)) {
+            el = getOwnProperty(*array, arrayKey(vm, i));
+        }
         s += el.to_string(version);
     }
     return as_value(s);
@@ -1593,8 +1638,10 @@ void foreachArray(as_object& array, int start, int end, T& pred)
 
     VM& vm = getVM(array);
 
+    as_value val;
     for (size_t i = start; i < static_cast<size_t>(end); ++i) {
-        pred(getOwnProperty(array, arrayKey(vm, i)));
+        if (array.getElement(i, &val)) pred(val);
+        else pred(getOwnProperty(array, arrayKey(vm, i)));
     }
 }
 
@@ -1621,6 +1668,10 @@ resizeArray(as_object& o, const int size)
 
     const size_t currentSize = arrayLength(o);
     if (realSize < currentSize) {
+        // No other property is named like an element of a dense array.
+        o.truncateElements(realSize);
+        if (o.dense()) return;
+
         VM& vm = getVM(o);
         for (size_t i = realSize; i < currentSize; ++i) {
             o.delProperty(arrayKey(vm, i));
@@ -1638,17 +1689,6 @@ setArrayLength(as_object& array, const int size)
     array.set_member(NSV::PROP_LENGTH, size);
 }
 
-int
-isIndex(const std::string& nameString)
-{
-    try {
-        return boost::lexical_cast<int>(nameString);
-    }
-    catch (boost::bad_lexical_cast& e) {
-        return -1;
-    }
-}
-
 } // anonymous namespace
 
 } // end of gnash namespace
@@ -41,7 +41,8 @@ size_t arrayLength(as_object& array);
 /// Convert an integral value into an ObjectURI
 //
 /// NB this function adds a string value to the VM for each separate
-/// integral value. It's the way the VM works.
+/// integral value. It's the way the VM works. The VM caches the
+/// ObjectURIs of the indices.
 //
 /// @param i        The integral value to find
 /// @return         The ObjectURI to look up.
@@ -82,8 +83,10 @@ void foreachArray(as_object& array, T& pred)
 
     VM& vm = getVM(array);
 
+    as_value val;
     for (size_t i = 0; i < static_cast<size_t>(size); ++i) {
-        pred(getOwnProperty(array, arrayKey(vm, i)));
+        if (array.getElement(i, &val)) pred(val);
+        else pred(getOwnProperty(array, arrayKey(vm, i)));
     }
 }
 
@@ -23,6 +23,9 @@
 #include <algorithm>
 #include <locale>
 #include <stdexcept>
+#include <memory>
+#include <array>
+#include <cstdint>
 
 #include "SWFCtype.h"
 #include "fn_call.h"
@@ -62,7 +65,62 @@ namespace {
     as_value string_oldToUpper(const fn_call& fn);
     as_value string_ctor(const fn_call& fn);
 
-    size_t validIndex(const std::wstring& subject, int index);
+    /// A string decoded so that its characters can be indexed.
+    //
+    /// Decoding is the expensive part of most String methods, and
+    /// scripts often call them on the same string in a loop, so the
+    /// last few decoded strings are kept by decode(). A string with
+    /// only ASCII characters isn't decoded at all, as each byte is one
+    /// character in any SWF version.
+    class DecodedString
+    {
+    public:
+        DecodedString(std::string str, int version);
+
+        /// The number of characters.
+        size_t size() const {
+            return _ascii ? _str.size() : _wstr.size();
+        }
+
+        /// The code of a character, which must exist.
+        std::uint32_t at(size_t i) const {
+            return _ascii ? static_cast<unsigned char>(_str[i]) : _wstr[i];
+        }
+
+        /// Encode some of the characters for the SWF version.
+        //
+        /// Like std::string::substr(), len may go past the end.
+        std::string substr(size_t start, size_t len) const;
+
+        /// Find a string, returning std::string::npos if it isn't there.
+        size_t find(const DecodedString& s, size_t start) const;
+
+        /// Find a string from the end.
+        size_t rfind(const DecodedString& s, size_t start) const;
+
+        /// The characters as a wide string.
+        const std::wstring& wide() const;
+
+        const std::string& str() const { return _str; }
+        int version() const { return _version; }
+
+    private:
+        const std::string _str;
+        const int _version;
+        const bool _ascii;
+
+        /// Only built on demand for an ASCII string.
+        mutable std::wstring _wstr;
+    };
+
+    typedef std::shared_ptr<const DecodedString> DecodedPtr;
+
+    /// Decode a string, or get it from the cache if it was just decoded.
+    //
+    /// The result is shared, so it stays valid when the cache replaces it.
+    DecodedPtr decode(const std::string& str, int version);
+
+    size_t validIndex(const DecodedString& subject, int index);
     void attachStringInterface(as_object& o);
 
     inline bool checkArgs(const fn_call& fn, size_t min, size_t max,
@@ -174,17 +232,17 @@ string_slice(const fn_call& fn)
     std::string str;
     const int version = getStringVersioned(fn, val, str);
 
-    std::wstring wstr = utf8::decodeCanonicalString(str, version);
+    const DecodedPtr wstr = decode(str, version);
 
     if (!checkArgs(fn, 1, 2, "String.slice()")) return as_value();
 
-    size_t start = validIndex(wstr, toInt(fn.arg(0), getVM(fn)));
+    size_t start = validIndex(*wstr, toInt(fn.arg(0), getVM(fn)));
 
-    size_t end = wstr.length();
+    size_t end = wstr->size();
 
     if (fn.nargs >= 2)
     {
-        end = validIndex(wstr, toInt(fn.arg(1), getVM(fn)));
+        end = validIndex(*wstr, toInt(fn.arg(1), getVM(fn)));
 
     } 
 
@@ -197,8 +255,7 @@ string_slice(const fn_call& fn)
 
     //log_debug("start: %d, end: %d, retlen: %d", start, end, retlen);
 
-    return as_value(utf8::encodeCanonicalString(
-                wstr.substr(start, retlen), version));
+    return as_value(wstr->substr(start, retlen));
 }
 
 // String.split(delimiter[, limit])
@@ -229,7 +286,8 @@ string_split(const fn_call& fn)
     std::string str;
     const int version = getStringVersioned(fn, val, str);
     
-    std::wstring wstr = utf8::decodeCanonicalString(str, version);
+    const DecodedPtr decoded = decode(str, version);
+    const std::wstring& wstr = decoded->wide();
 
     Global_as& gl = getGlobal(fn);
     as_object* array = gl.createArray();
@@ -306,8 +364,7 @@ string_split(const fn_call& fn)
         if (delim.empty()) {
             for (size_t i = 0, e = std::min<size_t>(wstr.size(), max);
                     i < e; ++i) {
-                callMethod(array, NSV::PROP_PUSH,
-                       utf8::encodeCanonicalString(wstr.substr(i, 1), version));
+                callMethod(array, NSV::PROP_PUSH, decoded->substr(i, 1));
             }
             return as_value(array);
         }
@@ -320,8 +377,8 @@ string_split(const fn_call& fn)
     while (num < max) {
         pos = wstr.find(delim, pos);
 
-        callMethod(array, NSV::PROP_PUSH, utf8::encodeCanonicalString(
-                       wstr.substr(prevpos, pos - prevpos), version));
+        callMethod(array, NSV::PROP_PUSH,
+                decoded->substr(prevpos, pos - prevpos));
 
         if (pos == std::wstring::npos) break;
         num++;
@@ -343,12 +400,11 @@ string_lastIndexOf(const fn_call& fn)
     
     std::string str;
     const int version = getStringVersioned(fn, val, str);
-    const std::wstring& wstr = utf8::decodeCanonicalString(str, version);
+    const DecodedPtr wstr = decode(str, version);
 
     if (!checkArgs(fn, 1, 2, "String.lastIndexOf()")) return as_value(-1);
 
-    const std::wstring& toFind = utf8::decodeCanonicalString(
-        fn.arg(0).to_string(version), version);
+    const DecodedPtr toFind = decode(fn.arg(0).to_string(version), version);
 
     int start = str.size();
 
@@ -360,7 +416,7 @@ string_lastIndexOf(const fn_call& fn)
         return as_value(-1);
     }
 
-    size_t found = wstr.rfind(toFind, start);
+    size_t found = wstr->rfind(*toFind, start);
 
     if (found == std::string::npos) {
         return as_value(-1);
@@ -382,13 +438,13 @@ string_substr(const fn_call& fn)
     std::string str;
     const int version = getStringVersioned(fn, val, str);
 
-    std::wstring wstr = utf8::decodeCanonicalString(str, version);
+    const DecodedPtr wstr = decode(str, version);
 
     if (!checkArgs(fn, 1, 2, "String.substr()")) return as_value(str);
     
-    int start = validIndex(wstr, toInt(fn.arg(0), getVM(fn)));
+    int start = validIndex(*wstr, toInt(fn.arg(0), getVM(fn)));
 
-    int num = wstr.length();
+    int num = wstr->size();
 
     if (fn.nargs >= 2 && !fn.arg(1).is_undefined())
     {
@@ -398,13 +454,13 @@ string_substr(const fn_call& fn)
             if ( -num <= start ) num = 0;
             else
             {
-                num = wstr.length() + num;
+                num = wstr->size() + num;
                 if ( num < 0 ) return as_value("");
             }
         }
     }
 
-    return as_value(utf8::encodeCanonicalString(wstr.substr(start, num), version));
+    return as_value(wstr->substr(start, num));
 }
 
 // string.substring(start[, end])
@@ -420,20 +476,20 @@ string_substring(const fn_call& fn)
     std::string str;
     const int version = getStringVersioned(fn, val, str);
 
-    const std::wstring& wstr = utf8::decodeCanonicalString(str, version);
+    const DecodedPtr wstr = decode(str, version);
 
     if (!checkArgs(fn, 1, 2, "String.substring()")) return as_value(str);
 
     const as_value& s = fn.arg(0);
 
     int start = toInt(s, getVM(fn));
-    int end = wstr.size();
+    int end = wstr->size();
 
     if (s.is_undefined() || start < 0) {
         start = 0;
     }
 
-    if (static_cast<unsigned>(start) >= wstr.size()) {
+    if (static_cast<unsigned>(start) >= wstr->size()) {
         return as_value("");
     }
 
@@ -454,14 +510,14 @@ string_substring(const fn_call& fn)
         }
     }
     
-    if (static_cast<unsigned>(end) > wstr.size()) {
-        end = wstr.size();
+    if (static_cast<unsigned>(end) > wstr->size()) {
+        end = wstr->size();
     }
     
     end -= start;
     //log_debug("Start: %d, End: %d", start, end);
 
-    return as_value(utf8::encodeCanonicalString(wstr.substr(start, end), version));
+    return as_value(wstr->substr(start, end));
 }
 
 as_value
@@ -476,12 +532,10 @@ string_indexOf(const fn_call& fn)
 
     if (!checkArgs(fn, 1, 2, "String.indexOf")) return as_value(-1);
 
-    const std::wstring& wstr = utf8::decodeCanonicalString(str, version);
+    const DecodedPtr wstr = decode(str, version);
 
     const as_value& tfarg = fn.arg(0); // to find arg
-    const std::wstring& toFind =
-        utf8::decodeCanonicalString(tfarg.to_string(version),
-                version);
+    const DecodedPtr toFind = decode(tfarg.to_string(version), version);
 
     size_t start = 0;
 
@@ -500,9 +554,9 @@ string_indexOf(const fn_call& fn)
         }
     }
 
-    const size_t pos = wstr.find(toFind, start);
+    const size_t pos = wstr->find(*toFind, start);
 
-    if (pos == std::wstring::npos) {
+    if (pos == std::string::npos) {
         return as_value(-1);
     }
 
@@ -562,7 +616,7 @@ string_charCodeAt(const fn_call& fn)
     std::string str;
     const int version = getStringVersioned(fn, val, str);
 
-    const std::wstring& wstr = utf8::decodeCanonicalString(str, version);
+    const DecodedPtr wstr = decode(str, version);
 
     if (fn.nargs == 0) {
         IF_VERBOSE_ASCODING_ERRORS(
@@ -581,13 +635,13 @@ string_charCodeAt(const fn_call& fn)
 
     size_t index = static_cast<size_t>(toInt(fn.arg(0), getVM(fn)));
 
-    if (index >= wstr.length()) {
+    if (index >= wstr->size()) {
         as_value rv;
         setNaN(rv);
         return rv;
     }
 
-    return as_value(wstr.at(index));
+    return as_value(wstr->at(index));
 }
 
 as_value
@@ -603,25 +657,17 @@ string_charAt(const fn_call& fn)
     // to_int() makes this safe from overflows.
     const size_t index = static_cast<size_t>(toInt(fn.arg(0), getVM(fn)));
 
-    size_t currentIndex = 0;
+    // The string is always read as UTF-8, even in SWF5.
+    const DecodedPtr wstr = decode(str, 6);
 
-    std::string::const_iterator it = str.begin(), e = str.end();
+    // We've reached the end without finding the index
+    if (index >= wstr->size()) return as_value("");
 
-    while (std::uint32_t code = utf8::decodeNextUnicodeCharacter(it, e))
-    {
-        if (currentIndex == index)
-        {
-            if (version == 5)
-            {
-                return as_value(utf8::encodeLatin1Character(code));
-            }
-            return as_value(utf8::encodeUnicodeCharacter(code));
-        }
-        ++currentIndex;
+    const std::uint32_t code = wstr->at(index);
+    if (version == 5) {
+        return as_value(utf8::encodeLatin1Character(code));
     }
-
-    // We've reached the end without finding the index
-    return as_value("");
+    return as_value(utf8::encodeUnicodeCharacter(code));
 }
 
 as_value
@@ -632,7 +678,7 @@ string_toUpperCase(const fn_call& fn)
     std::string str;
     const int version = getStringVersioned(fn, val, str);
 
-    std::wstring wstr = utf8::decodeCanonicalString(str, version);
+    std::wstring wstr = decode(str, version)->wide();
 
 #if !defined(__HAIKU__) && !defined(__amigaos4__) && !defined(__ANDROID__)
     static const std::locale swfLocale((std::locale()), new SWFCtype());
@@ -658,7 +704,7 @@ string_toLowerCase(const fn_call& fn)
     std::string str;
     const int version = getStringVersioned(fn, val, str);
 
-    std::wstring wstr = utf8::decodeCanonicalString(str, version);
+    std::wstring wstr = decode(str, version)->wide();
 
 #if !defined(__HAIKU__) && !defined(__amigaos4__) && !defined(__ANDROID__)
     static const std::locale swfLocale((std::locale()), new SWFCtype());
@@ -735,8 +781,8 @@ string_ctor(const fn_call& fn)
     as_object* obj = fn.this_ptr;
 
     obj->setRelay(new String_as(str));
-    std::wstring wstr = utf8::decodeCanonicalString(str, getSWFVersion(fn));
-    obj->init_member(NSV::PROP_LENGTH, wstr.size(), as_object::DefaultFlags);
+    const DecodedPtr wstr = decode(str, getSWFVersion(fn));
+    obj->init_member(NSV::PROP_LENGTH, wstr->size(), as_object::DefaultFlags);
 
     return as_value();
 }
@@ -795,8 +841,68 @@ inline bool checkArgs(const fn_call& fn, size_t min, size_t max,
     return true;
 }
 
+DecodedString::DecodedString(std::string str, int version)
+    :
+    _str(std::move(str)),
+    _version(version),
+    _ascii(std::find_if(_str.begin(), _str.end(), [](char c) {
+                    // A NUL ends the string when it is decoded.
+                    return c <= 0 || static_cast<unsigned char>(c) > 0x7f;
+                }) == _str.end())
+{
+    if (!_ascii) _wstr = utf8::decodeCanonicalString(_str, _version);
+}
+
+std::string
+DecodedString::substr(size_t start, size_t len) const
+{
+    if (_ascii) return _str.substr(start, len);
+    return utf8::encodeCanonicalString(_wstr.substr(start, len), _version);
+}
+
+size_t
+DecodedString::find(const DecodedString& s, size_t start) const
+{
+    if (_ascii && s._ascii) return _str.find(s._str, start);
+    return wide().find(s.wide(), start);
+}
+
+size_t
+DecodedString::rfind(const DecodedString& s, size_t start) const
+{
+    if (_ascii && s._ascii) return _str.rfind(s._str, start);
+    return wide().rfind(s.wide(), start);
+}
+
+const std::wstring&
+DecodedString::wide() const
+{
+    if (_ascii && _wstr.size() != _str.size()) {
+        _wstr.assign(_str.begin(), _str.end());
+    }
+    return _wstr;
+}
+
+DecodedPtr
+decode(const std::string& str, int version)
+{
+    // ActionScript runs in one thread, but each thread gets its own
+    // cache to be safe.
+    static thread_local std::array<DecodedPtr, 4> cache;
+    static thread_local size_t next = 0;
+
+    for (const DecodedPtr& d : cache) {
+        if (d && d->version() == version && d->str() == str) return d;
+    }
+
+    DecodedPtr d = std::make_shared<const DecodedString>(str, version);
+    cache[next] = d;
+    next = (next + 1) % cache.size();
+    return d;
+}
+
 size_t
-validIndex(const std::wstring& subject, int index)
+validIndex(const DecodedString& subject, int index)
 {
 
     if (index < 0) {
@@ -20,6 +20,8 @@
 
 #include "movie_root.h"
 
+#include <algorithm>
+#include <vector>
 #include <utility>
 #include <string>
 #include <sstream>
@@ -96,6 +98,13 @@ namespace {
     void notifyLoad(MovieClip* ch);
 }
 
+namespace {
+
+/// How late, in milliseconds, frames may be and still be caught up.
+const size_t maxFrameLateness = 1000;
+
+}
+
 // Utility classes
 namespace {
 
@@ -151,6 +160,8 @@ movie_root::movie_root(VirtualClock& clock, const RunResources& runResources)
     _movies(),
     _rootMovie(nullptr),
     _invalidated(true),
+    _boundsVisited(0),
+    _boundsSkipped(0),
     _disableScripts(false),
     _processingActionLevel(PRIORITY_SIZE),
     _hostfd(-1),
@@ -191,6 +202,7 @@ movie_root::~movie_root()
 {
     clear(_actionQueue);
     _intervalTimers.clear();
+    _clearedTimers.clear();
     _movieLoader.clear();
 
     assert(testInvariant());
@@ -345,7 +357,7 @@ movie_root::setLevel(unsigned int num, Movie* movie)
             // NOTE: this was tested but not automated, the
             //       test sets an interval and then loads something
             //       in _level0. The result is the interval is disabled.
-            _intervalTimers.clear();
+            clearIntervalTimers();
 
             // TODO: check what else we should do in these cases 
             //       (like, unregistering all childs etc...)
@@ -536,7 +548,7 @@ movie_root::reset()
     _movies.clear();
 
     // remove all intervals
-    _intervalTimers.clear();
+    clearIntervalTimers();
 
     // remove all loadMovie requests
     _movieLoader.clear();
@@ -819,6 +831,10 @@ movie_root::addIntervalTimer(std::unique_ptr<Timer> timer)
 
     assert(_intervalTimers.find(id) == _intervalTimers.end());
 
+    _timerQueue.push_back(std::make_pair(timer->deadline(), id));
+    std::push_heap(_timerQueue.begin(), _timerQueue.end(),
+            std::greater<TimerQueueEntry>());
+
     _intervalTimers.insert(std::make_pair(id, std::move(timer)));
 
     return id;
@@ -832,18 +848,27 @@ movie_root::clearIntervalTimer(std::uint32_t x)
         return false;
     }
 
-    // We do not remove the element here because
-    // we might have been called during execution
-    // of another timer, thus during a scan of the _intervalTimers
-    // container. If we use erase() here, the iterators in executeTimers
-    // would be invalidated. Rather, executeTimers() would check container
-    // elements for being still active and remove the cleared one in a safe way
-    // at each iteration.
+    // We might have been called during execution of this or another
+    // timer, so the Timer is kept until executeTimers() is done with it.
+    // Its entry in _timerQueue is dropped when it comes up.
     it->second->clearInterval();
+    _clearedTimers.push_back(std::move(it->second));
+    _intervalTimers.erase(it);
 
     return true;
 }
 
+void
+movie_root::clearIntervalTimers()
+{
+    for (TimerMap::value_type& timer : _intervalTimers) {
+        timer.second->clearInterval();
+        _clearedTimers.push_back(std::move(timer.second));
+    }
+    _intervalTimers.clear();
+    _timerQueue.clear();
+}
+
 bool
 movie_root::advance()
 {
@@ -931,7 +956,15 @@ movie_root::advance()
             if (elapsed >= _movieAdvancementDelay) {
                 advanced = true;
                 advanceMovie();
-                _lastMovieAdvancement = now;
+
+                // Keep to the frame rate when heart-beats are late, so
+                // that the movie doesn't slow down. When more than a
+                // second late, as after the process was suspended, the
+                // late frames are not caught up.
+                if (elapsed - _movieAdvancementDelay < maxFrameLateness) {
+                    _lastMovieAdvancement += _movieAdvancementDelay;
+                }
+                else _lastMovieAdvancement = now;
             }
 #ifdef USE_SOUND
         }
@@ -1357,6 +1390,9 @@ movie_root::setStageDisplayState(const DisplayState ds)
 void
 movie_root::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
 {
+    _boundsVisited = 0;
+    _boundsSkipped = 0;
+
     if (isInvalidated()) {
         ranges.setWorld();
         return;
@@ -1366,6 +1402,7 @@ movie_root::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
                         ++i) {
         i->second->add_invalidated_bounds(ranges, force);
     }
+    countInvalidatedBounds(_movies.size(), 0);
 }
 
 size_t
@@ -1703,45 +1740,62 @@ movie_root::executeTimers()
     log_debug("Checking %d timers for expiry", _intervalTimers.size());
 #endif
 
+    // No timer is executing, so cleared ones can go.
+    _clearedTimers.clear();
+
     // Don't do anything if we have no timers, just return so we don't
     // waste cpu cycles.
-    if (_intervalTimers.empty()) {
+    if (_timerQueue.empty()) {
         return;
     }
 
-    unsigned long now = _vm.getTime();
-
-    typedef std::multimap<unsigned long, Timer*>
-        ExpiredTimers;
+    const unsigned long now = _vm.getTime();
+    const std::greater<TimerQueueEntry> later;
 
-    ExpiredTimers expiredTimers;
+    // Take the expired timers from the queue, in the order they run.
+    // Those added or reset by the expired ones only run on next call.
+    std::vector<TimerQueueEntry> expired;
+    while (!_timerQueue.empty() && _timerQueue.front().first <= now) {
+        std::pop_heap(_timerQueue.begin(), _timerQueue.end(), later);
+        const TimerQueueEntry entry = _timerQueue.back();
+        _timerQueue.pop_back();
 
-    for (TimerMap::iterator it = _intervalTimers.begin(),
-            itEnd = _intervalTimers.end(); it != itEnd; ) {
+        // Entries of cleared timers are dropped here.
+        if (_intervalTimers.count(entry.second)) expired.push_back(entry);
+    }
 
-        TimerMap::iterator nextIterator = it;
-        ++nextIterator;
+    for (const TimerQueueEntry& entry : expired) {
+        // A timer may clear others.
+        TimerMap::iterator it = _intervalTimers.find(entry.second);
+        if (it != _intervalTimers.end()) it->second->executeAndReset();
+    }
 
-        Timer* timer = it->second.get();
+    for (const TimerQueueEntry& entry : expired) {
+        TimerMap::iterator it = _intervalTimers.find(entry.second);
+        if (it == _intervalTimers.end()) continue;
 
-        if (timer->cleared()) {
-            // this timer was cleared, erase it
+        // Timers that run once are cleared after executing.
+        if (it->second->cleared()) {
             _intervalTimers.erase(it);
+            continue;
         }
-        else {
-            unsigned long elapsed;
-            if (timer->expired(now, elapsed)) {
-                expiredTimers.insert(std::make_pair(elapsed, timer));
-            }
+        _timerQueue.push_back(
+                std::make_pair(it->second->deadline(), entry.second));
+        std::push_heap(_timerQueue.begin(), _timerQueue.end(), later);
+    }
+
+    // Rebuild the queue when it's mostly entries of cleared timers,
+    // such as timeouts cleared long before their deadline.
+    if (_timerQueue.size() > 2 * _intervalTimers.size() + 16) {
+        _timerQueue.clear();
+        for (const TimerMap::value_type& timer : _intervalTimers) {
+            _timerQueue.push_back(
+                    std::make_pair(timer.second->deadline(), timer.first));
         }
-
-        it = nextIterator;
+        std::make_heap(_timerQueue.begin(), _timerQueue.end(), later);
     }
 
-    foreachSecond(expiredTimers.begin(), expiredTimers.end(),
-                  &Timer::executeAndReset);
-
-    if (!expiredTimers.empty())
+    if (!expired.empty())
         processActionQueue();
 }
 
@@ -1820,6 +1874,9 @@ movie_root::getTopmostMouseEntity(std::int32_t x, std::int32_t y) const
     for (Levels::const_reverse_iterator i=_movies.rbegin(), e=_movies.rend();
             i != e; ++i)
     {
+        // Nothing outside of a level's hit bounds can be hit.
+        if (!i->second->getHitBounds().point_test(x, y)) continue;
+
         InteractiveObject* ret = i->second->topmostMouseEntity(x, y);
         if (ret) return ret;
     }
@@ -1833,6 +1890,8 @@ movie_root::findDropTarget(std::int32_t x, std::int32_t y,
 {
     for (Levels::const_reverse_iterator i=_movies.rbegin(), e=_movies.rend();
             i!=e; ++i) {
+
+        if (!i->second->getHitBounds().point_test(x, y)) continue;
         
         const DisplayObject* ret = i->second->findDropTarget(x, y, dragging);
         if (ret) return ret;
@@ -2342,6 +2401,16 @@ movie_root::getMovieInfo(InfoTree& tr, InfoTree::iterator it)
     // Stage: scripts state (enabled/disabled)
     localIter = tr.append_child(it, std::make_pair("Scripts",
                 _disableScripts ? " disabled" : "enabled"));
+
+    // Stage: timers, and queued entries including those of cleared timers.
+    os.str("");
+    os << _intervalTimers.size();
+    localIter = tr.append_child(it, std::make_pair("Active timers",
+                os.str()));
+    os.str("");
+    os << _timerQueue.size();
+    localIter = tr.append_child(it, std::make_pair("Queued timers",
+                os.str()));
      
     getCharacterTree(tr, it);    
 }
@@ -72,6 +72,7 @@
 #include <string>
 #include <vector>
 #include <forward_list>
+#include <unordered_map>
 #include <set>
 #include <bitset>
 #include <array>
@@ -358,6 +359,10 @@ public:
     /// Main and only callback from hosting application.
     /// Expected to be called at 10ms resolution.
     //
+    /// Frames are due at the frame rate from the first one, so a late
+    /// heart-beat doesn't delay the frames after it. A heart-beat only
+    /// advances one frame; timeToNextFrame() tells if another is due.
+    ///
     /// @return true if the heart-beat resulted in actual
     ///         SWF playhead advancement (frame advancement)
     ///
@@ -417,6 +422,28 @@ public:
     
     DSOEXPORT void add_invalidated_bounds(InvalidatedRanges& ranges,
             bool force);
+
+    /// Add to the DisplayObjects counted by add_invalidated_bounds().
+    //
+    /// @param visited  The number whose invalidated bounds were added.
+    /// @param skipped  The number skipped because neither they nor any
+    ///                 of their children changed.
+    void countInvalidatedBounds(size_t visited, size_t skipped) {
+        _boundsVisited += visited;
+        _boundsSkipped += skipped;
+    }
+
+    /// The number of DisplayObjects visited by the last
+    /// add_invalidated_bounds().
+    size_t invalidatedBoundsVisited() const {
+        return _boundsVisited;
+    }
+
+    /// The number of DisplayObjects skipped by the last
+    /// add_invalidated_bounds().
+    size_t invalidatedBoundsSkipped() const {
+        return _boundsSkipped;
+    }
     
     /// Return the topmost active entity under the pointer
     //
@@ -892,8 +919,14 @@ private:
     void executeAdvanceCallbacks();
     
     /// Execute expired timers
+    //
+    /// Timers run in the order of their deadlines, and those with the
+    /// same deadline in the order they were added.
     void executeTimers();
 
+    /// Clear all interval timers.
+    void clearIntervalTimers();
+
     /// Cleanup references to unloaded DisplayObjects and run the GC.
     void cleanupAndCollect();
 
@@ -1014,10 +1047,27 @@ private:
 
     LoadCallbacks _loadCallbacks;
     
-    typedef std::map<std::uint32_t, std::unique_ptr<Timer>> TimerMap;
+    typedef std::unordered_map<std::uint32_t, std::unique_ptr<Timer>>
+        TimerMap;
 
+    /// Active timers, by id.
     TimerMap _intervalTimers;
 
+    /// A timer's deadline and id.
+    typedef std::pair<unsigned long, std::uint32_t> TimerQueueEntry;
+
+    /// Active timers in a heap, the earliest deadline and then id first.
+    //
+    /// Entries of cleared timers stay until they reach the top or until
+    /// executeTimers() rebuilds the queue.
+    std::vector<TimerQueueEntry> _timerQueue;
+
+    /// Timers cleared since the last executeTimers().
+    //
+    /// A timer may clear itself or others while executing, so they are
+    /// only destroyed when no timer executes.
+    std::vector<std::unique_ptr<Timer>> _clearedTimers;
+
     size_t _lastTimerId;
 
     /// bit-array for recording the unreleased keys
@@ -1051,6 +1101,10 @@ private:
     /// See setInvalidated
     bool _invalidated;
 
+    /// See countInvalidatedBounds
+    size_t _boundsVisited;
+    size_t _boundsSkipped;
+
     /// This is set to true if execution of scripts
     /// aborted due to action limit set or whatever else
     bool _disableScripts;
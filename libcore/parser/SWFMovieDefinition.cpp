@@ -464,6 +464,10 @@ SWFMovieDefinition::read_all_swf()
                     return;
                 }
             }
+            // Ask for the chunk after this one to be loaded while this
+            // one is parsed.
+            _in->prefetch(_str->tell() + chunkSize, chunkSize);
+
             if (!parser.read(std::min<size_t>(left, chunkSize))) break;
 
             left -= parser.bytesRead();
@@ -21,9 +21,19 @@
 #include "RunResources.h"
 #include "SWFParser.h"
 #include "TagLoadersTable.h"
+#include "DecodedTag.h"
+#include "IOChannel.h"
+#include "rc.h"
 #include "log.h"
 
 #include <iomanip>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <boost/noncopyable.hpp>
 
 namespace gnash {
 
@@ -32,6 +42,173 @@ namespace {
     void dumpTagBytes(SWFStream& in, std::ostream& os);
 }
 
+namespace {
+
+/// An IOChannel reading a tag copied from a SWFStream.
+class TagBuffer : public IOChannel
+{
+public:
+
+    explicit TagBuffer(std::vector<char> data)
+        :
+        _data(std::move(data)),
+        _pos(0)
+    {}
+
+    virtual std::streamsize read(void* dst, std::streamsize bytes) {
+        const std::streamsize got =
+            std::min<std::streamsize>(bytes, _data.size() - _pos);
+        std::copy(_data.begin() + _pos, _data.begin() + _pos + got,
+                static_cast<char*>(dst));
+        _pos += got;
+        return got;
+    }
+
+    virtual std::streampos tell() const {
+        return _pos;
+    }
+
+    virtual bool seek(std::streampos pos) {
+        if (pos < 0 || static_cast<size_t>(pos) > _data.size()) return false;
+        _pos = pos;
+        return true;
+    }
+
+    virtual void go_to_end() {
+        _pos = _data.size();
+    }
+
+    virtual bool eof() const {
+        return _pos == _data.size();
+    }
+
+    virtual bool bad() const {
+        return false;
+    }
+
+    virtual size_t size() const {
+        return _data.size();
+    }
+
+private:
+
+    const std::vector<char> _data;
+
+    size_t _pos;
+};
+
+} // anonymous namespace
+
+/// The threads decoding tags for all SWFParsers.
+class DecoderThreads : boost::noncopyable
+{
+public:
+
+    /// Get the threads, or 0 if tags are decoded by the parsing threads.
+    //
+    /// The tagDecoderThreads setting is checked on every call, but the
+    /// threads are only started the first time they are needed.
+    static DecoderThreads* get();
+
+    size_t size() const {
+        return _threads.size();
+    }
+
+    /// Run a job on one of the threads.
+    void add(std::function<void()> job);
+
+private:
+
+    explicit DecoderThreads(size_t count);
+
+    /// Finish all jobs before stopping the threads.
+    ~DecoderThreads();
+
+    void run();
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+
+    std::condition_variable _wakeup;
+
+    std::deque<std::function<void()> > _jobs;
+
+    bool _stop;
+};
+
+DecoderThreads*
+DecoderThreads::get()
+{
+    size_t count = RcInitFile::getDefaultInstance().getTagDecoderThreads();
+    if (!count) count = std::thread::hardware_concurrency();
+
+    // A single thread might as well be the parsing thread.
+    if (count < 2) return nullptr;
+
+    static DecoderThreads threads(count);
+    return &threads;
+}
+
+DecoderThreads::DecoderThreads(size_t count)
+    :
+    _stop(false)
+{
+    for (size_t i = 0; i < count; ++i) {
+        _threads.push_back(std::thread(&DecoderThreads::run, this));
+    }
+}
+
+DecoderThreads::~DecoderThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeup.notify_all();
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+void
+DecoderThreads::add(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+    _wakeup.notify_one();
+}
+
+void
+DecoderThreads::run()
+{
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeup.wait(lock, [this] { return _stop || !_jobs.empty(); });
+            if (_jobs.empty()) return;
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+    }
+}
+
+SWFParser::~SWFParser()
+{
+    // Tags before the end of a truncated stream are still added, as
+    // they would be if they had been loaded.
+    try {
+        addDecoded();
+    }
+    catch (const std::exception& e) {
+        log_error(_("Error adding decoded tags: %s"), e.what());
+    }
+}
+
 size_t
 SWFParser::openTag()
 {
@@ -47,6 +224,66 @@ SWFParser::closeTag()
     _tagOpen = false;
 }
 
+void
+SWFParser::decode(SWF::TagLoadersTable::TagDecoder df,
+        DecoderThreads& threads)
+{
+
+    // Copy the tag with a long header, so that the decoding thread's
+    // SWFStream opens it as this one did.
+    const unsigned long length = _stream.get_tag_end_position() - _stream.tell();
+    std::vector<char> data(6 + length);
+    data.resize(6 + _stream.read(&data[6], length));
+
+    const std::uint32_t got = data.size() - 6;
+    const std::uint16_t header = (_tag << 6) | 0x3f;
+    data[0] = header & 0xff;
+    data[1] = header >> 8;
+    for (size_t i = 0; i < 4; ++i) {
+        data[2 + i] = (got >> (8 * i)) & 0xff;
+    }
+
+    std::shared_ptr<IOChannel> in(new TagBuffer(std::move(data)));
+    const SWF::TagType tag = _tag;
+    movie_definition& md = *_md;
+    const RunResources& r = _runResources;
+
+    typedef std::packaged_task<std::unique_ptr<SWF::DecodedTag>()> Task;
+    std::shared_ptr<Task> task(new Task(
+        [df, tag, in, &md, &r] () -> std::unique_ptr<SWF::DecodedTag> {
+            SWFStream s(in.get());
+            s.open_tag();
+            std::unique_ptr<SWF::DecodedTag> decoded = df(s, tag, md, r);
+            s.close_tag();
+            return decoded;
+        }));
+
+    _decoding.push_back(task->get_future());
+    threads.add([task] { (*task)(); });
+
+    // Tags can be large, so don't copy them much faster than they
+    // are decoded.
+    addDecoded(2 * threads.size());
+}
+
+void
+SWFParser::addDecoded(size_t left)
+{
+    while (_decoding.size() > left) {
+        std::future<std::unique_ptr<SWF::DecodedTag> > f =
+            std::move(_decoding.front());
+        _decoding.pop_front();
+
+        try {
+            std::unique_ptr<SWF::DecodedTag> decoded = f.get();
+            if (decoded) decoded->add(*_md, _runResources);
+        }
+        catch (const ParserException& e) {
+            log_error(_("Parsing exception: %s"), e.what());
+        }
+    }
+}
+
 bool
 SWFParser::read(std::streamsize bytes)
 {
@@ -57,6 +294,8 @@ SWFParser::read(std::streamsize bytes)
 
     const SWF::TagLoadersTable& tagLoaders = _runResources.tagLoaders();
 
+    DecoderThreads* threads = DecoderThreads::get();
+
     while (_bytesRead < _endRead) {
         
         const size_t startPos = _stream.tell();
@@ -79,20 +318,29 @@ SWFParser::read(std::streamsize bytes)
             // Signal that we have reached the end of a SWF or sprite when
             // a SWF::END tag is encountered.
             if (_tag == SWF::END) {
+                addDecoded();
                 closeTag();
                 return false;
             }
 
             SWF::TagLoadersTable::TagLoader lf = nullptr;
+            SWF::TagLoadersTable::TagDecoder df = nullptr;
 
             if (_tag == SWF::SHOWFRAME) {
                 // show frame tag -- advance to the next frame.
                 IF_VERBOSE_PARSE(log_parse(_("SHOWFRAME tag")));
+                addDecoded();
                 _md->incrementLoadedFrames();
             }
+            else if (threads && tagLoaders.getDecoder(_tag, df)) {
+                decode(df, *threads);
+            }
             else if (tagLoaders.get(_tag, lf)) {
                 // call the tag loader.  The tag loader should add
                 // DisplayObjects or tags to the movie data structure.
+                // It may depend on earlier tags, so they must be added
+                // first.
+                addDecoded();
                 lf(_stream, _tag, *_md, _runResources);
             }
             else {
@@ -24,11 +24,20 @@
 #define GNASH_SWFPARSER_H
 
 #include "SWF.h"
+#include "TagLoadersTable.h"
+
+#include <deque>
+#include <future>
+#include <memory>
 
 namespace gnash {
     class SWFStream;
     class movie_definition;
     class RunResources;
+    class DecoderThreads;
+    namespace SWF {
+        class DecodedTag;
+    }
 }
 
 namespace gnash {
@@ -47,6 +56,12 @@ namespace gnash {
 /// The SWFParser will only deal with ParserExceptions in an open tag.
 /// Exceptions thrown when opening and closing tags signal a fatal error,
 /// and will be left to the callers to deal with.
+//
+/// Tags with a TagDecoder are decoded by a pool of threads shared by all
+/// SWFParsers, while the following tags are parsed. What they decoded is
+/// added to the movie before any other tag is loaded and before a frame
+/// is complete, so the movie changes in the same order as when all tags
+/// are loaded one after the other.
 class SWFParser
 {
 
@@ -65,6 +80,9 @@ public:
     {
     }
 
+    /// Add any tags still being decoded to the movie.
+    ~SWFParser();
+
     /// The number of bytes processed by this SWFParser.
     size_t bytesRead() const {
         return _bytesRead;
@@ -91,6 +109,13 @@ private:
 
     void closeTag();
 
+    /// Copy the open tag and start decoding it on one of the threads.
+    void decode(SWF::TagLoadersTable::TagDecoder df, DecoderThreads& threads);
+
+    /// Add decoded tags to the movie in order, waiting for them to be
+    /// decoded, until only the given number are left.
+    void addDecoded(size_t left = 0);
+
     SWFStream& _stream;
     
     movie_definition* _md;
@@ -107,6 +132,9 @@ private:
     
     SWF::TagType _tag;
 
+    /// The tags being decoded, in order.
+    std::deque<std::future<std::unique_ptr<SWF::DecodedTag> > > _decoding;
+
 };
 
 } // namespace gnash
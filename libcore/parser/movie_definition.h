@@ -53,8 +53,9 @@
 #endif
 
 #include <string>
-#include <memory> // for unique_ptr
+#include <memory> // for unique_ptr, shared_ptr
 #include <vector> // for PlayList typedef
+#include <mutex>
 #include <boost/intrusive_ptr.hpp>
 #include <cstdint>
 
@@ -66,6 +67,7 @@ namespace gnash {
 	class CachedBitmap;
 	class Movie;
 	class MovieClip;
+	class TimelineSnapshots;
 	namespace SWF {
         class ControlTag;
     }
@@ -456,6 +458,19 @@ public:
 	}
 
 #endif
+
+    /// Snapshots of the DisplayList state along the timeline.
+    //
+    /// These are created when a MovieClip first jumps backwards, and are
+    /// shared by all instances of the definition, which MovieLibrary may
+    /// give to movies in other threads.
+    //
+    /// @param interval The number of frames between snapshots, if they
+    ///                 have to be created.
+    /// @param limit    The maximum number of snapshots, if they have to
+    ///                 be created.
+    TimelineSnapshots& timelineSnapshots(size_t interval, size_t limit) const;
+
 protected:
 
     movie_definition(std::uint16_t id = 0)
@@ -464,6 +479,12 @@ protected:
     {}
 
     virtual ~movie_definition() {}
+
+private:
+
+    mutable std::mutex _timelineSnapshotsMutex;
+
+    mutable std::shared_ptr<TimelineSnapshots> _timelineSnapshots;
 };
 
 } // namespace gnash
@@ -0,0 +1,84 @@
+// DecodedTag.h: tags decoded away from the SWF parsing thread.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_SWF_DECODEDTAG_H
+#define GNASH_SWF_DECODEDTAG_H
+
+#include <cstdint>
+#include <boost/intrusive_ptr.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "DefinitionTag.h"
+#include "movie_definition.h"
+
+// Forward declarations
+namespace gnash {
+    class RunResources;
+}
+
+namespace gnash {
+namespace SWF {
+
+/// The result of a TagDecoder, waiting to be added to its movie.
+//
+/// Decoding a tag that only depends on its own data can be done by any
+/// thread, but the movie must only be changed by the thread parsing it,
+/// in the order of the tags.
+class DecodedTag : boost::noncopyable
+{
+public:
+
+    virtual ~DecodedTag() {}
+
+    /// Add what was decoded to the movie.
+    //
+    /// This is called by the thread parsing the movie.
+    virtual void add(movie_definition& m, const RunResources& r) = 0;
+};
+
+/// A decoded DefinitionTag, to be added to the dictionary.
+class DecodedDefinition : public DecodedTag
+{
+public:
+
+    DecodedDefinition(std::uint16_t id, DefinitionTag* tag)
+        :
+        _id(id),
+        _tag(tag)
+    {}
+
+    virtual void add(movie_definition& m, const RunResources& /*r*/) {
+        m.addDisplayObject(_id, _tag.get());
+    }
+
+private:
+
+    const std::uint16_t _id;
+
+    const boost::intrusive_ptr<DefinitionTag> _tag;
+};
+
+} // namespace SWF
+} // namespace gnash
+
+#endif
+
+// Local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -244,6 +244,31 @@ addDefaultLoaders(TagLoadersTable& table)
 
     std::for_each(tags.begin(), tags.end(), AddLoader(table));
 
+    // Tags that can be decoded by other threads while the movie is
+    // parsed. DEFINEBITS isn't, as it depends on the JPEGTABLES tag.
+    const std::vector<std::pair<TagType, TagLoadersTable::TagDecoder> >
+        decoders = {
+        {SWF::DEFINESHAPE,DefineShapeTag::decoder},
+        {SWF::DEFINESHAPE2,DefineShapeTag::decoder},
+        {SWF::DEFINESHAPE3,DefineShapeTag::decoder},
+        {SWF::DEFINESHAPE4,DefineShapeTag::decoder},
+        {SWF::DEFINESHAPE4_,DefineShapeTag::decoder},
+        {SWF::DEFINEMORPHSHAPE,DefineMorphShapeTag::decoder},
+        {SWF::DEFINEMORPHSHAPE2,DefineMorphShapeTag::decoder},
+        {SWF::DEFINEMORPHSHAPE2_,DefineMorphShapeTag::decoder},
+        {SWF::DEFINEFONT,DefineFontTag::decoder},
+        {SWF::DEFINEFONT2,DefineFontTag::decoder},
+        {SWF::DEFINEFONT3,DefineFontTag::decoder},
+        {SWF::DEFINEBITSJPEG2,DefineBitsTag::decoder},
+        {SWF::DEFINEBITSJPEG3,DefineBitsTag::decoder},
+        {SWF::DEFINEBITSJPEG4,DefineBitsTag::decoder},
+        {SWF::DEFINELOSSLESS,DefineBitsTag::decoder},
+        {SWF::DEFINELOSSLESS2,DefineBitsTag::decoder}
+    };
+
+    for (const auto& decoder : decoders) {
+        table.registerDecoder(decoder.first, decoder.second);
+    }
 }
 
 } // namespace SWF
@@ -41,6 +41,7 @@
 #include "CachedBitmap.h"
 #include "GnashImage.h"
 #include "GnashImageJpeg.h"
+#include "DecodedTag.h"
 
 #ifdef HAVE_ZLIB_H
 #include <zlib.h>
@@ -192,21 +193,74 @@ jpeg_tables_loader(SWFStream& in, TagType tag, movie_definition& m,
     m.set_jpeg_loader(std::move(input));
 }
 
-void
-DefineBitsTag::loader(SWFStream& in, TagType tag, movie_definition& m,
-        const RunResources& r)
+namespace {
+
+/// A decoded bitmap tag, whose image is added to the movie.
+class DecodedBitmap : public DecodedTag
 {
-    in.ensureBytes(2);
-    const std::uint16_t id = in.read_u16();
+public:
+
+    DecodedBitmap(std::uint16_t id, std::unique_ptr<image::GnashImage> im)
+        :
+        _id(id),
+        _image(std::move(im))
+    {}
+
+    virtual void add(movie_definition& m, const RunResources& r);
+
+private:
+
+    const std::uint16_t _id;
 
-    if (m.getBitmap(id)) {
+    std::unique_ptr<image::GnashImage> _image;
+};
+
+void
+DecodedBitmap::add(movie_definition& m, const RunResources& r)
+{
+    if (m.getBitmap(_id)) {
         IF_VERBOSE_MALFORMED_SWF(
             log_swferror(_("DEFINEBITS: Duplicate id (%d) for bitmap "
-                    "DisplayObject - discarding it"), id);
+                    "DisplayObject - discarding it"), _id);
         );
         return;
     }
 
+    // The renderer is only used by the thread parsing the movie.
+    Renderer* renderer = r.renderer();
+    if (!renderer) {
+        IF_VERBOSE_PARSE(
+            log_parse(_("No renderer, not adding bitmap %1%"), _id)
+        );
+        return;
+    }    
+    boost::intrusive_ptr<CachedBitmap> bi =
+        renderer->createCachedBitmap(std::move(_image));
+
+    IF_VERBOSE_PARSE(
+        log_parse(_("Adding bitmap id %1%"), _id);
+    );
+    // add bitmap to movie under DisplayObject id.
+    m.addBitmap(_id, bi);
+}
+
+}
+
+void
+DefineBitsTag::loader(SWFStream& in, TagType tag, movie_definition& m,
+        const RunResources& r)
+{
+    std::unique_ptr<DecodedTag> bitmap = decoder(in, tag, m, r);
+    if (bitmap) bitmap->add(m, r);
+}
+
+std::unique_ptr<DecodedTag>
+DefineBitsTag::decoder(SWFStream& in, TagType tag, movie_definition& m,
+        const RunResources& /*r*/)
+{
+    in.ensureBytes(2);
+    const std::uint16_t id = in.read_u16();
+
     std::unique_ptr<image::GnashImage> im;
 
     switch (tag) {
@@ -232,23 +286,10 @@ DefineBitsTag::loader(SWFStream& in, TagType tag, movie_definition& m,
         IF_VERBOSE_MALFORMED_SWF(
             log_swferror(_("Failed to parse bitmap for character %1%"), id);
         );
-        return;
+        return std::unique_ptr<DecodedTag>();
     }
 
-    Renderer* renderer = r.renderer();
-    if (!renderer) {
-        IF_VERBOSE_PARSE(
-            log_parse(_("No renderer, not adding bitmap %1%"), id)
-        );
-        return;
-    }    
-    boost::intrusive_ptr<CachedBitmap> bi = renderer->createCachedBitmap(std::move(im));
-
-    IF_VERBOSE_PARSE(
-        log_parse(_("Adding bitmap id %1%"), id);
-    );
-    // add bitmap to movie under DisplayObject id.
-    m.addBitmap(id, bi);
+    return std::unique_ptr<DecodedTag>(new DecodedBitmap(id, std::move(im)));
 }
 
 namespace {
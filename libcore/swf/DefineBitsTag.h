@@ -22,11 +22,16 @@
 
 #include "SWF.h" 
 
+#include <memory>
+
 // Forward declarations
 namespace gnash {
     class movie_definition;
     class RunResources;
     class SWFStream;
+    namespace SWF {
+        class DecodedTag;
+    }
 }
 
 namespace gnash {
@@ -41,6 +46,13 @@ public:
     static void loader(SWFStream&, TagType, movie_definition&,
             const RunResources&);
 
+    /// Decode the image of a bitmap tag, without adding it to the movie.
+    //
+    /// DEFINEBITS tags use the tables of the last JPEGTABLES tag, so
+    /// they can only be decoded in order.
+    static std::unique_ptr<DecodedTag> decoder(SWFStream&, TagType,
+            movie_definition&, const RunResources&);
+
 };
 
 } // namespace SWF
@@ -30,6 +30,7 @@
 #include "SWF.h"
 #include "movie_definition.h"
 #include "ShapeRecord.h"
+#include "DecodedTag.h"
 #include "log.h"
 
 // Based on the public domain work of Thatcher Ulrich <tu@tulrich.com> 2003
@@ -37,9 +38,42 @@
 namespace gnash {
 namespace SWF {
 
+namespace {
+
+/// A decoded DefineFont tag, whose Font is added to the movie.
+class DecodedFont : public DecodedTag
+{
+public:
+
+    DecodedFont(int id, boost::intrusive_ptr<Font> font)
+        :
+        _id(id),
+        _font(std::move(font))
+    {}
+
+    virtual void add(movie_definition& m, const RunResources& /*r*/) {
+        m.add_font(_id, _font);
+    }
+
+private:
+
+    const int _id;
+
+    const boost::intrusive_ptr<Font> _font;
+};
+
+}
+
 void
 DefineFontTag::loader(SWFStream& in, TagType tag, movie_definition& m,
             const RunResources& r)
+{
+    decoder(in, tag, m, r)->add(m, r);
+}
+
+std::unique_ptr<DecodedTag>
+DefineFontTag::decoder(SWFStream& in, TagType tag, movie_definition& m,
+            const RunResources& r)
 {
     assert(tag == DEFINEFONT || tag == DEFINEFONT2 || tag == DEFINEFONT3);
 
@@ -49,7 +83,7 @@ DefineFontTag::loader(SWFStream& in, TagType tag, movie_definition& m,
     std::unique_ptr<DefineFontTag> ft(new DefineFontTag(in, m, tag, r));
     boost::intrusive_ptr<Font> f(new Font(std::move(ft)));
 
-    m.add_font(fontID, f);
+    return std::unique_ptr<DecodedTag>(new DecodedFont(fontID, f));
 }
 
 void
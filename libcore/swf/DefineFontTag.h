@@ -33,6 +33,7 @@
 #include "SWF.h"
 #include "Font.h"
 #include <map>
+#include <memory>
 #include <string>
 #include <cstdint>
 
@@ -41,6 +42,9 @@ namespace gnash {
     class SWFStream;
     class movie_definition;
     class RunResources;
+    namespace SWF {
+        class DecodedTag;
+    }
 }
 
 namespace gnash {
@@ -57,6 +61,10 @@ public:
     static void loader(SWFStream& in, TagType tag, movie_definition& m,
             const RunResources& r);
 
+    /// Read a DefineFont tag, without adding its Font to the movie.
+    static std::unique_ptr<DecodedTag> decoder(SWFStream& in, TagType tag,
+            movie_definition& m, const RunResources& r);
+
     /// Return the glyphs read from the DefineFont tag.
     const Font::GlyphInfoRecords& glyphTable() const {
         return _glyphTable;
@@ -27,6 +27,8 @@
 
 #include <cstdint>
 
+#include "DecodedTag.h"
+
 #include "TypesParser.h"
 #include "MorphShape.h"
 #include "SWFStream.h"
@@ -45,6 +47,13 @@ namespace SWF {
 void
 DefineMorphShapeTag::loader(SWFStream& in, TagType tag, movie_definition& md,
         const RunResources& r)
+{
+    decoder(in, tag, md, r)->add(md, r);
+}
+
+std::unique_ptr<DecodedTag>
+DefineMorphShapeTag::decoder(SWFStream& in, TagType tag,
+        movie_definition& md, const RunResources& r)
 {
     in.ensureBytes(2);
     const std::uint16_t id = in.read_u16();
@@ -54,7 +63,7 @@ DefineMorphShapeTag::loader(SWFStream& in, TagType tag, movie_definition& md,
     );
 
     DefineMorphShapeTag* morph = new DefineMorphShapeTag(in, tag, md, r, id);
-    md.addDisplayObject(id, morph);
+    return std::unique_ptr<DecodedTag>(new DecodedDefinition(id, morph));
 }
 
 DefineMorphShapeTag::DefineMorphShapeTag(SWFStream& in, TagType tag,
@@ -79,6 +88,30 @@ DefineMorphShapeTag::display(Renderer& renderer, const ShapeRecord& shape,
     renderer.drawShape(shape, xform);
 }
 
+std::shared_ptr<const ShapeRecord>
+DefineMorphShapeTag::shape(std::uint16_t ratio) const
+{
+    // Enough for a few instances tweening out of step.
+    const size_t maxMorphs = 8;
+
+    std::lock_guard<std::mutex> lock(_morphsMutex);
+
+    for (Morphs::iterator it = _morphs.begin(), e = _morphs.end();
+            it != e; ++it) {
+        if (it->first == ratio) {
+            _morphs.splice(_morphs.begin(), _morphs, it);
+            return it->second;
+        }
+    }
+
+    std::shared_ptr<ShapeRecord> morph(new ShapeRecord(_shape1));
+    morph->setLerp(_shape1, _shape2, ratio / 65535.0);
+
+    _morphs.push_front(std::make_pair(ratio, morph));
+    if (_morphs.size() > maxMorphs) _morphs.pop_back();
+    return morph;
+}
+
 void
 DefineMorphShapeTag::read(SWFStream& in, TagType tag, movie_definition& md,
         const RunResources& r)
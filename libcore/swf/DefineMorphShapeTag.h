@@ -27,6 +27,12 @@
 #include "ShapeRecord.h"
 #include "DefinitionTag.h"
 
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <cstdint>
+
 // Forward declarations.
 namespace gnash {
     class movie_definition;
@@ -35,6 +41,9 @@ namespace gnash {
     class MorphShape;
     class Renderer;
     class Transform;
+    namespace SWF {
+        class DecodedTag;
+    }
 }
 
 namespace gnash {
@@ -49,6 +58,10 @@ public:
     static void loader(SWFStream& in, TagType tag, movie_definition& m,
             const RunResources& r);
 
+    /// Read a DefineMorphShape tag, without adding it to the movie.
+    static std::unique_ptr<DecodedTag> decoder(SWFStream& in, TagType tag,
+            movie_definition& m, const RunResources& r);
+
     virtual ~DefineMorphShapeTag() {}
 
 	virtual DisplayObject* createDisplayObject(Global_as& gl,
@@ -65,8 +78,20 @@ public:
         return _shape2;
     }
 
+    /// The shape at a ratio between shape1 and shape2.
+    //
+    /// The last few shapes are kept, so that instances at the same
+    /// ratio, or going back to one, don't interpolate them again.
+    ///
+    /// @param ratio    The ratio, from 0 (shape1) to 65535 (shape2).
+    std::shared_ptr<const ShapeRecord> shape(std::uint16_t ratio) const;
+
 private:
 
+    /// The interpolated shapes and their ratios, most recently used first.
+    typedef std::list<std::pair<std::uint16_t,
+            std::shared_ptr<const ShapeRecord> > > Morphs;
+
     DefineMorphShapeTag(SWFStream& in, SWF::TagType tag, movie_definition& md,
             const RunResources& r, std::uint16_t id);
     
@@ -95,6 +120,11 @@ private:
     
     SWFRect _bounds;
 
+    /// Instances may be displayed by several movies sharing a definition.
+    mutable std::mutex _morphsMutex;
+
+    mutable Morphs _morphs;
+
 };
 
 } // namespace SWF
@@ -23,6 +23,7 @@
 
 #include "RunResources.h"
 #include "DefineShapeTag.h"
+#include "DecodedTag.h"
 #include "log.h"
 #include "Shape.h"
 #include "SWFStream.h"
@@ -44,6 +45,13 @@ namespace SWF {
 void
 DefineShapeTag::loader(SWFStream& in, TagType tag, movie_definition& m,
         const RunResources& r)
+{
+    decoder(in, tag, m, r)->add(m, r);
+}
+
+std::unique_ptr<DecodedTag>
+DefineShapeTag::decoder(SWFStream& in, TagType tag, movie_definition& m,
+        const RunResources& r)
 {
     assert(tag == DEFINESHAPE ||
            tag == DEFINESHAPE2 ||
@@ -59,8 +67,7 @@ DefineShapeTag::loader(SWFStream& in, TagType tag, movie_definition& m,
     );
 
     DefineShapeTag* ch = new DefineShapeTag(in, tag, m, r, id);
-    m.addDisplayObject(id, ch);
-
+    return std::unique_ptr<DecodedTag>(new DecodedDefinition(id, ch));
 }
 
 DisplayObject*
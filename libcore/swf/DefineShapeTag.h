@@ -13,6 +13,8 @@
 #include "SWF.h"
 #include "ShapeRecord.h"
 
+#include <memory>
+
 namespace gnash {
 	class SWFStream;
 	class SWFCxForm;
@@ -21,6 +23,9 @@ namespace gnash {
 	class RunResources;
 	class Renderer;
     class Transform;
+    namespace SWF {
+        class DecodedTag;
+    }
 }
 
 namespace gnash {
@@ -36,6 +41,10 @@ public:
     static void loader(SWFStream& in, TagType tag, movie_definition& m,
             const RunResources& r);
 
+    /// Read a DefineShape tag, without adding it to the movie.
+    static std::unique_ptr<DecodedTag> decoder(SWFStream& in, TagType tag,
+            movie_definition& m, const RunResources& r);
+
     // Display a Shape character.
     void display(Renderer& renderer, const Transform& xform) const;
 
@@ -102,6 +102,15 @@ public:
     static void loader(SWFStream& in, TagType tag, movie_definition& m,
             const RunResources& r);
 
+    /// NOTE: getPlaceType() is dependent on the enum values.
+    enum PlaceType
+    {
+        REMOVE  = 0, 
+        MOVE    = 1,
+        PLACE   = 2,
+        REPLACE = 3
+    };
+
     int getPlaceType() const { 
         return m_has_flags2 & (HAS_CHARACTER_MASK | MOVE_MASK);
     } 
@@ -173,15 +182,6 @@ private:
     
     std::uint8_t _blendMode;
 
-    /// NOTE: getPlaceType() is dependent on the enum values.
-    enum PlaceType
-    {
-        REMOVE  = 0, 
-        MOVE    = 1,
-        PLACE   = 2,
-        REPLACE = 3
-    };
-
     enum has_flags2_mask_e
     {
         HAS_CLIP_ACTIONS_MASK = 1 << 7,
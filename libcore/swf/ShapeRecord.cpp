@@ -75,6 +75,7 @@ ShapeRecord::ShapeRecord(SWFStream& in, SWF::TagType tag, movie_definition& m,
         const RunResources& r)
 {
     read(in, tag, m, r);
+    for (Subshape& subshape : _subshapes) subshape.pack();
 }
 
 ShapeRecord::ShapeRecord()
@@ -99,6 +100,24 @@ Subshape::addFillStyle(const FillStyle& fs)
 }
 
 
+void
+Subshape::pack()
+{
+    if (_paths.empty()) return;
+    _packedPaths = PackedPaths(_paths);
+    Paths().swap(_paths);
+}
+
+void
+Subshape::copyPaths(Paths& paths) const
+{
+    if (packed()) {
+        paths.clear();
+        _packedPaths.expand(paths);
+    }
+    else paths = _paths;
+}
+
 /// Find the bounds of this subhape, and return them in a rectangle.
 SWFRect
 Subshape::computeBounds(int swfVersion) const
@@ -179,6 +198,26 @@ ShapeRecord::setLerp(const ShapeRecord& aa, const ShapeRecord& bb,
         const size_t len = p1.size();
         p.m_edges.resize(len);
 
+        // When the paths match edge for edge, as they usually do, there's
+        // no need to keep track of where we are in the end shape, and
+        // the loop is simple enough for the compiler to vectorize.
+        if (len && k == 0 && n < paths2.size() && p2.size() == len) {
+            const float r = ratio;
+            Edge* e = &p.m_edges.front();
+            const Edge* e1 = &p1.m_edges.front();
+            const Edge* e2 = &p2.m_edges.front();
+            for (size_t j = 0; j < len; ++j) {
+                const Edge& a = e1[j];
+                const Edge& b = e2[j];
+                e[j].cp.x = static_cast<int>(lerp<float>(a.cp.x, b.cp.x, r));
+                e[j].cp.y = static_cast<int>(lerp<float>(a.cp.y, b.cp.y, r));
+                e[j].ap.x = static_cast<int>(lerp<float>(a.ap.x, b.ap.x, r));
+                e[j].ap.y = static_cast<int>(lerp<float>(a.ap.y, b.ap.y, r));
+            }
+            ++n;
+            continue;
+        }
+
         for (size_t j=0; j < p.size(); j++) {
             Edge& e = p[j];
             const Edge& e1 = j < p1.size() ? p1[j] : empty_edge;
@@ -61,6 +61,7 @@ public:
         return _lineStyles;
     }
 
+    /// The paths, unless the subshape is packed.
     const Paths& paths() const {
         return _paths;
     }
@@ -87,10 +88,27 @@ public:
         _lineStyles.push_back(ls);
     }
 
+    /// The paths of a packed subshape.
+    const PackedPaths& packedPaths() const {
+        return _packedPaths;
+    }
+
+    /// Whether the paths have been packed.
+    bool packed() const {
+        return !_packedPaths.empty();
+    }
+
+    /// Move the paths to packedPaths(), for subshapes that won't change.
+    void pack();
+
+    /// Copy the paths, packed or not.
+    void copyPaths(Paths& paths) const;
+
     void clear() {
     	_fillStyles.clear();
     	_lineStyles.clear();
     	_paths.clear();
+    	_packedPaths = PackedPaths();
     }
 
     SWFRect computeBounds(int swfVersion) const;
@@ -99,6 +117,7 @@ private:
     FillStyles _fillStyles;
     LineStyles _lineStyles;
     Paths _paths;
+    PackedPaths _packedPaths;
 };
 
 
@@ -141,7 +160,8 @@ public:
 
     /// Construct a ShapeRecord from a SWFStream.
     //
-    /// This is useful for constructing immutable tags.
+    /// This is useful for constructing immutable tags. The paths
+    /// of the subshapes are packed.
     ShapeRecord(SWFStream& in, SWF::TagType tag, movie_definition& m,
             const RunResources& r);
 
@@ -184,7 +204,12 @@ public:
                    const SWFMatrix& wm) const {
         for (const Subshape& subshape : _subshapes) {
 
-            if (geometry::pointTest(subshape.paths(), subshape.lineStyles(), x, y, wm)) {
+            const bool hit = subshape.packed() ?
+                geometry::pointTest(subshape.packedPaths(),
+                        subshape.lineStyles(), x, y, wm) :
+                geometry::pointTest(subshape.paths(), subshape.lineStyles(),
+                        x, y, wm);
+            if (hit) {
         	    return true;
             }
         }
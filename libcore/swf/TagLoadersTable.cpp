@@ -45,6 +45,25 @@ TagLoadersTable::registerLoader(SWF::TagType t, TagLoader lf)
     return _loaders.insert(std::make_pair(t, lf)).second;
 }
 
+bool
+TagLoadersTable::getDecoder(SWF::TagType t, TagDecoder& df) const
+{
+	Decoders::const_iterator it = _decoders.find(t);
+
+	// no decoder found for the specified tag
+	if (it == _decoders.end()) return false;
+
+	df = it->second;
+	return true;
+}
+
+bool
+TagLoadersTable::registerDecoder(SWF::TagType t, TagDecoder df)
+{
+	assert(df);
+    return _decoders.insert(std::make_pair(t, df)).second;
+}
+
 } // namespace gnash::SWF
 } // namespace gnash
 
@@ -22,6 +22,7 @@
 #include "SWF.h"
 
 #include <map>
+#include <memory>
 #include <boost/noncopyable.hpp>
 
 // Forward declarations
@@ -31,6 +32,12 @@ namespace gnash {
     class RunResources;
 }
 
+namespace gnash {
+namespace SWF {
+    class DecodedTag;
+}
+}
+
 namespace gnash {
 namespace SWF {
 
@@ -50,6 +57,20 @@ public:
 
     typedef std::map<SWF::TagType, TagLoader> Loaders;
 
+	/// Signature of an SWF tag decoder
+	//
+	/// A decoder reads a tag like its TagLoader, but leaves adding the
+	/// result to the movie to the returned DecodedTag, so that it can
+	/// run on another thread than the one parsing the movie. Only tags
+	/// that don't depend on other tags can have a decoder.
+	///
+	/// @return 0 if nothing is to be added to the movie.
+	///
+	typedef std::unique_ptr<DecodedTag> (*TagDecoder)(SWFStream& input,
+            TagType type, movie_definition& m, const RunResources& r);
+
+    typedef std::map<SWF::TagType, TagDecoder> Decoders;
+
     /// Construct an empty TagLoadersTable
 	TagLoadersTable() {}
 
@@ -76,10 +97,28 @@ public:
 	///
 	bool registerLoader(TagType t, TagLoader lf);
 
+	/// Get the TagDecoder for a specified TagType.
+	//
+	/// @return false if no decoder is associated with the tag.
+	///
+	bool getDecoder(TagType t, TagDecoder& df) const;
+
+	/// Register a decoder for the specified SWF::TagType.
+	//
+	/// The tag must also have a loader, which is used when tags aren't
+	/// decoded by other threads.
+	///
+	/// @return false if a decoder is already registered
+	///               for the given tag
+	///
+	bool registerDecoder(TagType t, TagDecoder df);
+
 private:
 
 	Loaders _loaders;
 
+	Decoders _decoders;
+
 };
 
 } // namespace gnash::SWF
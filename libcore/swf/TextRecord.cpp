@@ -254,7 +254,7 @@ TextRecord::displayRecords(Renderer& renderer, const Transform& xform,
 
             }
             else {
-                ShapeRecord* glyph = fnt->get_glyph(index, embedded);
+                const ShapeRecord* glyph = fnt->get_glyph(index, embedded);
 
                 // Draw the DisplayObject using the filled outline.
                 if (glyph) renderer.drawGlyph(*glyph, textColor, m);
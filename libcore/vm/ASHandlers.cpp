@@ -28,6 +28,8 @@
 #include <vector>
 #include <boost/random.hpp>
 #include <algorithm> 
+#include <limits>
+#include <cmath>
 
 #include "log.h"
 #include "SWF.h"
@@ -78,6 +80,14 @@ namespace {
     /// @return     null if the value cannot be converted to an object.
     as_object* safeToObject(VM& vm, const as_value& val);
 
+    /// Get the array index a member name stands for.
+    //
+    /// Only numbers are checked, so that array elements can be accessed
+    /// without converting the name to a string.
+    //
+    /// @return     false if the name is not a number that is an index.
+    bool elementIndex(VM& vm, const as_value& name, size_t& i);
+
     /// Common code for ActionGetUrl and ActionGetUrl2
     //
     /// @param target         the target window or _level1 to _level10
@@ -2591,6 +2601,13 @@ ActionGetMember(ActionExec& thread)
                    target, static_cast<void*>(obj));
     );
 
+    size_t i;
+    if (obj->dense() && elementIndex(getVM(env), member_name, i) &&
+            obj->getElement(i, &env.top(1))) {
+        env.drop(1);
+        return;
+    }
+
     const ObjectURI& k = getURI(getVM(env), member_name.to_string());
 
     if (!obj->get_member(k, &env.top(1))) {
@@ -2615,6 +2632,14 @@ ActionSetMember(ActionExec& thread)
     as_environment& env = thread.env;
 
     as_object* obj = safeToObject(getVM(thread.env), env.top(2));
+
+    size_t i;
+    if (obj && obj->dense() && elementIndex(getVM(env), env.top(1), i) &&
+            obj->setElement(i, env.top(0))) {
+        env.drop(3);
+        return;
+    }
+
     const std::string& member_name = env.top(1).to_string();
     const as_value& member_value = env.top(0);
 
@@ -3455,6 +3480,17 @@ safeToObject(VM& vm, const as_value& val)
     }
 }
 
+bool
+elementIndex(VM& vm, const as_value& name, size_t& i)
+{
+    if (!name.is_number()) return false;
+    const double d = toNumber(name, vm);
+    if (!(d >= 0 && d < std::numeric_limits<int>::max())) return false;
+    if (d != std::floor(d)) return false;
+    i = d;
+    return true;
+}
+
 // Utility: construct an object using given constructor.
 // This is used by both ActionNew and ActionNewMethod and
 // hides differences between builtin and actionscript-defined
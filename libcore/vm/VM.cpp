@@ -29,6 +29,8 @@
 #include <boost/random.hpp> // for random generator
 #include <cstdlib> 
 #include <cmath>
+#include <climits>
+#include <boost/lexical_cast.hpp>
 #ifdef HAVE_SYS_UTSNAME_H
 # include <sys/utsname.h> // For system information
 #endif
@@ -59,7 +61,8 @@ VM::VM(movie_root& root, VirtualClock& clock)
 	_stack(),
     _shLib(new SharedObjectLibrary(*this)),
     _rng(clock.elapsed()),
-    _constantPool(nullptr)
+    _constantPool(nullptr),
+    _indexGetters(false)
 {
 	NSV::loadStrings(_stringTable);
     _global->registerClasses();
@@ -76,6 +79,58 @@ VM::setSWFVersion(int v)
 	_swfversion = v;
 }
 
+namespace {
+
+// Values in VM::_keyIndices. Names that parse as an integer but aren't
+// in plain decimal form are stored as -(index + 2).
+const int INDEX_UNKNOWN = INT_MIN;
+const int INDEX_NONE = -1;
+
+}
+
+ObjectURI
+VM::getIndexURI(size_t i)
+{
+    if (i < _indexURIs.size()) return _indexURIs[i];
+
+    // TODO: tell getURI that the string is already lowercase!
+    const ObjectURI uri = getURI(*this, std::to_string(i), true);
+
+    // Only cache the next index, so a single huge index doesn't
+    // create all the names below it.
+    if (i == _indexURIs.size()) _indexURIs.push_back(uri);
+    return uri;
+}
+
+int
+VM::getIndex(const ObjectURI& uri, bool strict)
+{
+    const string_table::key k = getName(uri);
+    if (k >= _keyIndices.size()) {
+        _keyIndices.resize(k + 1, INDEX_UNKNOWN);
+    }
+
+    int& index = _keyIndices[k];
+    if (index == INDEX_UNKNOWN) {
+        const std::string& name = uri.toString(_stringTable);
+        int value;
+        try {
+            value = boost::lexical_cast<int>(name);
+        }
+        catch (const boost::bad_lexical_cast&) {
+            value = INDEX_NONE;
+        }
+        if (value < 0) index = INDEX_NONE;
+        else if (name == std::to_string(value)) index = value;
+        else if (value <= INT_MAX - 2) index = -(value + 2);
+        else index = INDEX_NONE;
+    }
+
+    if (index >= 0) return index;
+    if (index == INDEX_NONE || strict) return INDEX_NONE;
+    return -(index + 2);
+}
+
 VM::RNG&
 VM::randomNumberGenerator() 
 {
@@ -25,6 +25,7 @@
 #endif
 
 #include <map>
+#include <vector>
 #include <memory> 
 #include <array>
 #include <cstdint>
@@ -248,6 +249,38 @@ public:
 
     const ConstantPool *getConstantPool() const { return _constantPool; }
 
+    /// Get the ObjectURI for an array index.
+    //
+    /// The names of the indices are cached, so they don't have to be
+    /// formatted and looked up in the string table every time.
+    //
+    /// @param i        The array index.
+    /// @return         The ObjectURI naming the array element.
+    ObjectURI getIndexURI(size_t i);
+
+    /// Get the array index a property name stands for.
+    //
+    /// The result is cached for each name, so the string is only
+    /// parsed the first time.
+    //
+    /// @param uri      The property name.
+    /// @param strict   If true, only the plain decimal form ("3", not
+    ///                 "03" or "+3") is accepted. This is the only name
+    ///                 that refers to an Array element; the others
+    ///                 still change the length of an Array.
+    /// @return         The index, or -1 if the name is not an index.
+    int getIndex(const ObjectURI& uri, bool strict = true);
+
+    /// Note that a getter-setter was added with an array index as name.
+    //
+    /// Until this happens, which is rare, an Array storing its elements
+    /// in a vector can append to it without searching its prototypes
+    /// for a setter.
+    void setIndexGetters() { _indexGetters = true; }
+
+    /// Whether a getter-setter was ever added with an array index as name.
+    bool indexGetters() const { return _indexGetters; }
+
 private:
 
 	/// Stage associated with this VM
@@ -281,6 +314,16 @@ private:
     RNG _rng;
 
     const ConstantPool* _constantPool;
+
+    /// The names of array indices, in order of index.
+    std::vector<ObjectURI> _indexURIs;
+
+    /// The array index each string table key stands for.
+    //
+    /// See getIndex() for the encoding.
+    std::vector<int> _keyIndices;
+
+    bool _indexGetters;
 };
 
 // @param lowerCaseHint if true the caller guarantees
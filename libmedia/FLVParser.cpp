@@ -20,6 +20,7 @@
 
 #include <string>
 #include <iosfwd>
+#include <algorithm>
 
 #include "FLVParser.h"
 #include "log.h"
@@ -46,6 +47,7 @@ FLVParser::FLVParser(std::unique_ptr<IOChannel> lt)
 	MediaParser(std::move(lt)),
 	_lastParsedPosition(0),
 	_nextPosToIndex(0),
+	_prefetchedTo(0),
 	_audio(false),
 	_video(false),
 	_cuePoints(),
@@ -98,6 +100,7 @@ FLVParser::seek(std::uint32_t& time)
             "position %d and time %d", time, it->second, it->first);
 	time = it->first;
 	_lastParsedPosition=lowerBoundPosition; 
+	_prefetchedTo=lowerBoundPosition;
 	_parsingComplete=false; // or NetStream will send the Play.Stop event...
 
 
@@ -358,6 +361,16 @@ FLVParser::parseNextTag(bool index_only)
 		_bytesLoaded = position;
 	}
 
+	// Ask for the tags ahead of playback to be loaded, a large range
+	// at a time.
+	const std::uint64_t readAhead = 512 * 1024;
+	if (!index_only && position + readAhead / 2 > _prefetchedTo)
+	{
+		const std::uint64_t from = std::max(position, _prefetchedTo);
+		_stream->prefetch(from, position + readAhead - from);
+		_prefetchedTo = position + readAhead;
+	}
+
 	// check for empty tag
 	if (flvtag.body_size == 0) return true;
 
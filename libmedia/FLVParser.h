@@ -260,6 +260,9 @@ private:
 	/// Position of next tag to index
 	std::uint64_t _nextPosToIndex;
 
+	/// End of the input asked to be loaded ahead of parsing.
+	std::uint64_t _prefetchedTo;
+
 	/// Audio stream is present
 	bool _audio;
 
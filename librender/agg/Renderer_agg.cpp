@@ -207,19 +207,16 @@ inline void applyClipBox(Rasterizer& ras, const geometry::Range2d<int>& bounds)
 /// Analyzes a set of paths to detect real presence of fills and/or outlines
 /// TODO: This should be something the character tells us and should be 
 /// cached. 
+template<typename Paths>
 void
-analyzePaths(const GnashPaths &paths, bool& have_shape,
+analyzePaths(const Paths &paths, bool& have_shape,
     bool& have_outline)
 {
 
     have_shape = false;
     have_outline = false;
 
-    const int pcount = paths.size();
-
-    for (int pno=0; pno<pcount; ++pno) {
-
-        const Path &the_path = paths[pno];
+    for (const auto& the_path : paths) {
 
         if ((the_path.m_fill0 > 0) || (the_path.m_fill1 > 0)) {
             have_shape = true;
@@ -1030,7 +1027,7 @@ public:
     if (_clipbounds_selected.empty()) return; 
       
     GnashPaths paths;
-    apply_matrix_to_path(shape.subshapes().front().paths(), paths, mat);
+    apply_matrix_to_path(shape.subshapes().front(), paths, mat);
 
     // If it's a mask, we don't need the rest.
     if (m_drawing_mask) {
@@ -1118,28 +1115,26 @@ public:
 
         for (const SWF::Subshape& subshape : shape.subshapes()) {
 
-            const SWF::ShapeRecord::FillStyles& fillStyles = subshape.fillStyles();
-            const SWF::ShapeRecord::LineStyles& lineStyles = subshape.lineStyles();
-            const SWF::ShapeRecord::Paths& paths = subshape.paths();
-
             // select ranges
             select_clipbounds(shape.getBounds(), xform.matrix);
 
             // render the DisplayObject's subshape.
-            drawShape(fillStyles, lineStyles, paths, xform.matrix,
-                      xform.colorTransform);
+            drawSubshape(subshape, xform.matrix, xform.colorTransform);
         }
     }
 
-    void drawShape(const std::vector<FillStyle>& FillStyles,
-        const std::vector<LineStyle>& line_styles,
-        const std::vector<Path>& objpaths, const SWFMatrix& mat,
+    void drawSubshape(const SWF::Subshape& subshape, const SWFMatrix& mat,
         const SWFCxForm& cx)
     {
+        const std::vector<FillStyle>& FillStyles = subshape.fillStyles();
+        const std::vector<LineStyle>& line_styles = subshape.lineStyles();
 
         bool have_shape, have_outline;
 
-        analyzePaths(objpaths, have_shape, have_outline);
+        if (subshape.packed()) {
+            analyzePaths(subshape.packedPaths(), have_shape, have_outline);
+        }
+        else analyzePaths(subshape.paths(), have_shape, have_outline);
 
         if (!have_shape && !have_outline) {
             // Early return for invisible character.
@@ -1147,7 +1142,7 @@ public:
         }
 
         GnashPaths paths;
-        apply_matrix_to_path(objpaths, paths, mat);
+        apply_matrix_to_path(subshape, paths, mat);
 
         // Masks apparently do not use agg_paths, so return
         // early
@@ -1197,10 +1192,10 @@ public:
         _clipbounds_selected.clear();
     }
 
-    /// Takes a path and translates it using the given SWFMatrix. The new path
-    /// is stored in paths_out. Both paths_in and paths_out are expected to
-    /// be in TWIPS.
-    void apply_matrix_to_path(const GnashPaths &paths_in, 
+    /// Takes the paths of a subshape and translates them using the given
+    /// SWFMatrix. The new paths are stored in paths_out. Both are expected
+    /// to be in TWIPS.
+    void apply_matrix_to_path(const SWF::Subshape& subshape,
           GnashPaths& paths_out, const SWFMatrix &source_mat) 
     {
 
@@ -1211,7 +1206,7 @@ public:
         mat.concatenate(source_mat);
 
         // Copy paths for in-place transform
-        paths_out = paths_in;
+        subshape.copyPaths(paths_out);
 
         /// Transform all the paths using the matrix.
         std::for_each(paths_out.begin(), paths_out.end(), 
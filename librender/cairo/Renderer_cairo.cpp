@@ -980,14 +980,20 @@ Renderer_cairo::drawShape(const SWF::ShapeRecord& shape, const Transform& xform)
     for (const SWF::Subshape& subshape: shape.subshapes()) {
 
         if (_drawing_mask) {      
-            PathVec scaled_path_vec = subshape.paths();
+            PathVec scaled_path_vec;
+            subshape.copyPaths(scaled_path_vec);
         
             apply_matrix_to_paths(scaled_path_vec, xform.matrix);
             draw_mask(scaled_path_vec); 
             continue;
         }
 
-        draw_subshape(subshape.paths(), xform.matrix, xform.colorTransform,
+        // Cairo paths are built from Path objects.
+        PathVec packed_path_vec;
+        if (subshape.packed()) subshape.copyPaths(packed_path_vec);
+
+        draw_subshape(subshape.packed() ? packed_path_vec : subshape.paths(),
+                xform.matrix, xform.colorTransform,
                 subshape.fillStyles(), subshape.lineStyles());
     }
 }
@@ -1007,7 +1013,8 @@ Renderer_cairo::drawGlyph(const SWF::ShapeRecord& rec, const rgba& color,
     
     glyph_fs.push_back(coloring);
 
-    const PathVec& path_vec = rec.subshapes().front().paths();
+    PathVec path_vec;
+    rec.subshapes().front().copyPaths(path_vec);
     
     std::vector<LineStyle> dummy_ls;
     
@@ -1323,16 +1323,33 @@ public:
     return nullptr;
   }
   
-  PathVec normalize_paths(const PathVec &paths)
+  /// The path to normalize, copied out of packed paths.
+  static const Path& unpacked_path(const Path& path, Path& /*copy*/)
+  {
+    return path;
+  }
+
+  static const Path& unpacked_path(const PackedPath& path, Path& copy)
+  {
+    copy = Path(path);
+    return copy;
+  }
+
+  template<typename Paths>
+  PathVec normalize_paths(const Paths &paths)
   {
     PathVec normalized;
+    Path copy;
   
-    for (const Path& cur_path : paths) {
+    for (const auto& path : paths) {
 
-      if (cur_path.m_edges.empty()) {
+      if (path.empty()) {
         continue;
-      
-      } else if (cur_path.m_fill0 && cur_path.m_fill1) {     
+      }
+
+      const Path& cur_path = unpacked_path(path, copy);
+
+      if (cur_path.m_fill0 && cur_path.m_fill1) {     
         
         // Two fill styles; duplicate and then reverse the left-filled one.
         normalized.push_back(cur_path);
@@ -1371,17 +1388,14 @@ public:
   /// Analyzes a set of paths to detect real presence of fills and/or outlines
   /// TODO: This should be something the character tells us and should be 
   /// cached. 
-  void analyze_paths(const PathVec &paths, bool& have_shape,
+  template<typename Paths>
+  void analyze_paths(const Paths &paths, bool& have_shape,
     bool& have_outline) {
     //normalize_paths(paths);
     have_shape=false;
     have_outline=false;
     
-    int pcount = paths.size();
-    
-    for (int pno=0; pno<pcount; pno++) {
-    
-      const Path &the_path = paths[pno];
+    for (const auto& the_path : paths) {
     
       if ((the_path.m_fill0>0) || (the_path.m_fill1>0)) {
         have_shape=true;
@@ -1628,8 +1642,9 @@ public:
     //for_each(paths, &path::transform, mat);
   }  
 
+  template<typename Paths>
   void
-  draw_subshape(const PathVec& path_vec,
+  draw_subshape(const Paths& path_vec,
     const SWFMatrix& mat,
     const SWFCxForm& cx,
     const std::vector<FillStyle>& FillStyles,
@@ -1718,19 +1733,29 @@ public:
     oglScopeMatrix scope_mat(xform.matrix);
 
     for (const SWF::Subshape& subshape : shape.subshapes()) {
-        const PathVec& path_vec = subshape.paths();
+        if (subshape.packed()) {
+            drawSubshape(subshape, subshape.packedPaths(), xform);
+        }
+        else drawSubshape(subshape, subshape.paths(), xform);
+    }
+  }
 
+  template<typename Paths>
+  void drawSubshape(const SWF::Subshape& subshape, const Paths& path_vec,
+          const Transform& xform)
+  {
         if (!path_vec.size()) {
             // No paths. Nothing to draw...
             return;
         }
     
         if (_drawing_mask) {
-            PathVec scaled_path_vec = path_vec;
+            PathVec scaled_path_vec;
+            subshape.copyPaths(scaled_path_vec);
       
             apply_matrix_to_paths(scaled_path_vec, xform.matrix);
             draw_mask(scaled_path_vec); 
-            continue;
+            return;
         }    
     
         bool have_shape, have_outline;
@@ -1738,12 +1763,11 @@ public:
         analyze_paths(path_vec, have_shape, have_outline);
     
         if (!have_shape && !have_outline) {
-            continue; // invisible character
+            return; // invisible character
         }  
 
         draw_subshape(path_vec, xform.matrix, xform.colorTransform,
                       subshape.fillStyles(), subshape.lineStyles());
-    }
   }
 
   virtual void drawGlyph(const SWF::ShapeRecord& rec, const rgba& c,
@@ -1764,7 +1788,12 @@ public:
     
     oglScopeMatrix scope_mat(mat);
     
-    draw_subshape(rec.subshapes().front().paths(), mat, dummy_cx, glyph_fs, dummy_ls);
+    const SWF::Subshape& subshape = rec.subshapes().front();
+    if (subshape.packed()) {
+        draw_subshape(subshape.packedPaths(), mat, dummy_cx, glyph_fs,
+                dummy_ls);
+    }
+    else draw_subshape(subshape.paths(), mat, dummy_cx, glyph_fs, dummy_ls);
   }
 
   virtual void set_scale(float xscale, float yscale) {
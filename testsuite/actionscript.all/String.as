@@ -133,6 +133,20 @@ check_equals(r.lastIndexOf("ghi", 17287638764), 6);
 check_equals(r.lastIndexOf(""), 16);
 check_equals(r.lastIndexOf(7), 10);
 
+#if OUTPUT_VERSION > 5
+// Each method counts characters the same way, whether or not the string
+// has characters outside ASCII.
+u = String.fromCharCode(97, 233, 98, 233);
+check_equals(u.length, 4);
+check_equals(u.charCodeAt(1), 233);
+check_equals(u.charCodeAt(3), 233);
+check_equals(u.charAt(2), "b");
+check_equals(u.indexOf("b"), 2);
+check_equals(u.lastIndexOf(String.fromCharCode(233)), 3);
+check_equals(u.substr(1, 2), String.fromCharCode(233, 98));
+check_equals(u.slice(-2).charCodeAt(1), 233);
+#endif
+
 // UTF8 lastIndexOf
 s = "tést";
 #if OUTPUT_VERSION > 5
@@ -1363,7 +1377,7 @@ _global.String = OrigString;
 
 var baseTests = 329;
 var asmTests = 23;
-var ge6Tests = 19;
+var ge6Tests = 27;
 
 var totalTests = baseTests;
 #ifdef MING_SUPPORTS_ASM
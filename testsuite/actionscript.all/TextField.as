@@ -1302,16 +1302,63 @@ CTF = function () {
 
 o = new CTF();
 
+//------------------------------------------------------------
+// Editing a paragraph in the middle of a long text only lays out the
+// text again from that paragraph. The lines should be the same as
+// when laying out all of the text.
+//------------------------------------------------------------
+
+_root.createTextField("tfinc", 1001, 0, 0, 100, 60);
+_root.createTextField("tffull", 1002, 0, 100, 100, 60);
+tfinc.wordWrap = true;
+tfinc.multiline = true;
+tffull.wordWrap = true;
+tffull.multiline = true;
+
+paras = [];
+for (i = 0; i < 20; ++i) {
+    paras.push("Paragraph " + i + " with a few words to wrap");
+}
+tfinc.text = paras.join("\n");
+
+paras[10] = "A much longer paragraph in the middle, which wraps onto more "
+    + "lines than the one it replaces did";
+tfinc.text = paras.join("\n");
+tffull.text = paras.join("\n");
+check_equals(tfinc.text, tffull.text);
+check_equals(tfinc.textWidth, tffull.textWidth);
+check_equals(tfinc.textHeight, tffull.textHeight);
+check_equals(tfinc.maxscroll, tffull.maxscroll);
+check_equals(tfinc.bottomScroll, tffull.bottomScroll);
+tfinc.scroll = tfinc.maxscroll;
+tffull.scroll = tffull.maxscroll;
+check_equals(tfinc.bottomScroll, tffull.bottomScroll);
+
+// Shorten the paragraph again and remove a later one.
+tfinc.scroll = 1;
+paras[10] = "Short";
+paras.splice(15, 1);
+tfinc.text = paras.join("\n");
+_root.createTextField("tffull2", 1003, 0, 200, 100, 60);
+tffull2.wordWrap = true;
+tffull2.multiline = true;
+tffull2.text = paras.join("\n");
+check_equals(tfinc.text, tffull2.text);
+check_equals(tfinc.textWidth, tffull2.textWidth);
+check_equals(tfinc.textHeight, tffull2.textHeight);
+check_equals(tfinc.maxscroll, tffull2.maxscroll);
+check_equals(tfinc.bottomScroll, tffull2.bottomScroll);
+
 //------------------------------------------------------------
 // END OF TESTS
 //------------------------------------------------------------
 
 #if OUTPUT_VERSION == 6
-     check_totals(531);
+     check_totals(542);
 #elif OUTPUT_VERSION == 7
- check_totals(555);
+ check_totals(566);
 #elif OUTPUT_VERSION == 8
- check_totals(556);
+ check_totals(567);
 #endif
 
 #endif
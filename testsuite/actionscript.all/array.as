@@ -1709,6 +1709,41 @@ o.push("Array data");
 ret = o.pop();
 xcheck_equals(ret, "Array data");
 
+// Elements stay in order when the array is changed in place, and
+// holes or deleted elements don't lose any of the others.
+a = [1, 2, 3];
+a.push(4);
+a.unshift(0);
+check_equals(a.toString(), "0,1,2,3,4");
+check_equals(a.shift(), 0);
+a.reverse();
+check_equals(a.toString(), "4,3,2,1");
+check_equals(a.pop(), 1);
+check_equals(a.length, 3);
+delete a[1];
+check_equals(a.toString(), "4,,2");
+check_equals(a.length, 3);
+a[5] = 7;
+check_equals(a.length, 6);
+check_equals(a.toString(), "4,,2,,,7");
+a.length = 2;
+check_equals(a.toString(), "4,");
+
+a = [1, 2];
+a.length = 4;
+a[2] = 3;
+check_equals(a.length, 4);
+check_equals(a.toString(), "1,2,3,");
+
+a = ["a", "b"];
+a.foo = "c";
+a[2] = "d";
+n = 0;
+for (i in a) n++;
+check_equals(n, 4);
+check_equals(a[2], "d");
+check_equals(a["2"], "d");
+
 #if OUTPUT_VERSION > 5
 
 Empty = function() {};
@@ -1813,11 +1848,11 @@ check_equals(ar.__proto__, "string");
 //
 
 #if OUTPUT_VERSION < 6
- check_totals(552);
+ check_totals(567);
 #else
 # if OUTPUT_VERSION < 7
-  check_totals(636);
+  check_totals(651);
 # else
-  check_totals(646);
+  check_totals(661);
 # endif
 #endif
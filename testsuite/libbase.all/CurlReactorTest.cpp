@@ -0,0 +1,206 @@
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+// Streams from a local HTTP listener through the transfer reactor of
+// the curl adapter. The adapter's source is built into the test, as its
+// classes can't be reached from the library.
+
+#include "NetworkAdapter.cpp"
+
+#include "check.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+using namespace gnash;
+
+namespace {
+
+/// Byte at some offset of a body, so that misplaced data is noticed.
+char
+bodyByte(size_t offset)
+{
+    return 'a' + offset % 23;
+}
+
+/// Open a listening socket on an ephemeral port of the loopback address.
+int
+listenLocal(unsigned short& port)
+{
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof addr);
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+
+    socklen_t len = sizeof addr;
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), len) < 0 ||
+            listen(fd, 4) < 0 ||
+            getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                &len) < 0) {
+        close(fd);
+        return -1;
+    }
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+/// Answer the given number of requests, each with a body of the size
+/// given by its path, e.g. "GET /1000".
+void
+serve(int listener, size_t requests)
+{
+    for (size_t i = 0; i < requests; ++i) {
+
+        const int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) return;
+
+        string request;
+        char buf[1024];
+        while (request.find("\r\n\r\n") == string::npos) {
+            const ssize_t got = ::read(fd, buf, sizeof buf);
+            if (got <= 0) break;
+            request.append(buf, got);
+        }
+        const size_t size = std::strtoul(request.c_str() + 5, nullptr, 10);
+
+        ostringstream head;
+        head << "HTTP/1.1 200 OK\r\n"
+             << "Content-Length: " << size << "\r\n"
+             << "Connection: close\r\n\r\n";
+        string response = head.str();
+        for (size_t j = 0; j < size; ++j) response += bodyByte(j);
+
+        // Blocks while the client isn't reading, once its transfer
+        // is paused.
+        for (size_t sent = 0; sent < response.size(); ) {
+            const ssize_t wrote = ::write(fd, response.data() + sent,
+                    response.size() - sent);
+            if (wrote <= 0) break;
+            sent += wrote;
+        }
+        close(fd);
+    }
+}
+
+/// Read a stream to its end, checking its bytes.
+void
+readBody(IOChannel& stream, size_t size)
+{
+    size_t total = 0;
+    size_t misplaced = 0;
+    char buf[4096];
+    while (std::streamsize got = stream.read(buf, sizeof buf)) {
+        for (std::streamsize i = 0; i < got; ++i) {
+            if (buf[i] != bodyByte(total + i)) ++misplaced;
+        }
+        total += got;
+    }
+
+    check(stream.eof());
+    check(!stream.bad());
+    check_equals(total, size);
+    check_equals(misplaced, 0);
+    check_equals(stream.size(), size);
+}
+
+string
+url(unsigned short port, size_t size)
+{
+    ostringstream s;
+    s << "http://127.0.0.1:" << port << "/" << size;
+    return s.str();
+}
+
+}
+
+TRYMAIN(_runtest);
+int
+trymain(int /*argc*/, char** /*argv*/)
+{
+    gnash::LogFile& dbglogfile = gnash::LogFile::getDefaultInstance();
+    dbglogfile.setVerbosity(0);
+
+    // Transfers must not be answered from, or stored in, a cache.
+    RcInitFile& rcfile = RcInitFile::getDefaultInstance();
+    rcfile.setHttpCacheDir("");
+
+    // A stream left waiting gives up, without an error, after this.
+    rcfile.setStreamsTimeout(10);
+
+    unsigned short port;
+    const int listener = listenLocal(port);
+    check(listener >= 0);
+    if (listener < 0) return 0;
+
+    std::thread server(serve, listener, 2);
+
+    // A completed transfer.
+    {
+        CurlStreamFile stream(url(port, 10000), "");
+        readBody(stream, 10000);
+    }
+
+    // A body four times larger than what is kept for a stream that isn't
+    // read: the transfer is paused until the stream is read, then resumed.
+    {
+        const size_t size = receiveBufferSize * 4;
+        CurlStreamFile stream(url(port, size), "");
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        readBody(stream, size);
+    }
+
+    server.join();
+
+    // A transfer libcurl won't add must fail its stream rather than leave
+    // it waiting. The listener is no longer accepting, so the stream's own
+    // transfer never gets a response. Its reactor is given another handle
+    // to it, which libcurl refuses as it's already in a multi handle.
+    {
+        CurlStreamFile stream(url(port, 10), "");
+
+        CURLM* other = curl_multi_init();
+        CURL* handle = curl_easy_init();
+        curl_multi_add_handle(other, handle);
+        curl_easy_setopt(handle, CURLOPT_PRIVATE, &stream);
+
+        CurlReactor::get().add(handle);
+
+        char c;
+        check_equals(stream.read(&c, 1), 0);
+        check(stream.bad());
+
+        curl_multi_remove_handle(other, handle);
+        curl_easy_cleanup(handle);
+        curl_multi_cleanup(other);
+    }
+
+    close(listener);
+
+    return 0;
+}
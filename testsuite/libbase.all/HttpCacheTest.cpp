@@ -0,0 +1,230 @@
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include "check.h"
+#include "HttpCache.h"
+#include "GnashFileUtilities.h"
+
+#include <cstdio>
+#include <string>
+#include <iostream>
+#include <utime.h>
+
+using namespace std;
+using namespace gnash;
+
+namespace {
+
+const char* const dir = "HttpCacheTestDir";
+
+FILE*
+makeBody(size_t size)
+{
+    FILE* f = tmpfile();
+    for (size_t i = 0; i < size; ++i) fputc('a' + i % 26, f);
+    return f;
+}
+
+/// Remove all files of the cache and the cache itself.
+void
+clear()
+{
+    DIR* d = opendir(dir);
+    if (!d) return;
+    while (struct dirent* ent = readdir(d)) {
+        remove((string(dir) + "/" + ent->d_name).c_str());
+    }
+    closedir(d);
+    rmdir(dir);
+}
+
+/// Make a cached response look last used at some time.
+void
+setUsed(const string& url, time_t when)
+{
+    // The file name isn't known, so find the file with its content.
+    DIR* d = opendir(dir);
+    while (struct dirent* ent = readdir(d)) {
+        const string path = string(dir) + "/" + ent->d_name;
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) continue;
+        char line[256];
+        const bool found = fgets(line, sizeof line, f) &&
+            fgets(line, sizeof line, f) && string(line) == "url " + url + "\n";
+        fclose(f);
+        if (found) {
+            struct utimbuf times = { when, when };
+            utime(path.c_str(), &times);
+        }
+    }
+    closedir(d);
+}
+
+void
+testCacheable()
+{
+    const time_t now = 1000000000;
+
+    HttpCache::Headers h;
+    HttpCache::Entry e;
+
+    // Nothing to say how long to keep it or how to check it.
+    check(!HttpCache::cacheable(h, now, e));
+
+    h.cacheControl = "public, max-age=60";
+    check(HttpCache::cacheable(h, now, e));
+    check_equals(e.expires, now + 60);
+    check(e.fresh(now + 59));
+    check(!e.fresh(now + 60));
+
+    h.age = 20;
+    check(HttpCache::cacheable(h, now, e));
+    check_equals(e.expires, now + 40);
+    h.age = 0;
+
+    h.cacheControl = "Max-Age=60, No-Store";
+    check(!HttpCache::cacheable(h, now, e));
+
+    // Stale at once, but can be revalidated.
+    e = HttpCache::Entry();
+    h.cacheControl = "no-cache";
+    h.etag = "\"abc\"";
+    check(HttpCache::cacheable(h, now, e));
+    check_equals(e.expires, now);
+    check_equals(e.etag, "\"abc\"");
+    check(e.revalidatable());
+
+    // Validators are kept when a 304 response doesn't repeat them.
+    h = HttpCache::Headers();
+    h.cacheControl = "max-age=10";
+    check(HttpCache::cacheable(h, now, e));
+    check_equals(e.etag, "\"abc\"");
+
+    // Expires is relative to the server's Date.
+    e = HttpCache::Entry();
+    h = HttpCache::Headers();
+    h.date = now - 500;
+    h.expires = now - 400;
+    check(HttpCache::cacheable(h, now, e));
+    check_equals(e.expires, now + 100);
+
+    // max-age takes precedence over Expires.
+    h.cacheControl = "max-age=5";
+    check(HttpCache::cacheable(h, now, e));
+    check_equals(e.expires, now + 5);
+
+    // Heuristic expiry from Last-Modified.
+    e = HttpCache::Entry();
+    h = HttpCache::Headers();
+    h.lastModified = now - 1000;
+    h.lastModifiedText = "Sat, 08 Sep 2001 01:30:00 GMT";
+    check(HttpCache::cacheable(h, now, e));
+    check_equals(e.expires, now + 100);
+    check_equals(e.lastModified, h.lastModifiedText);
+
+    h.lastModified = now - 100 * 24 * 3600;
+    check(HttpCache::cacheable(h, now, e));
+    check_equals(e.expires, now + 24 * 3600);
+
+    h.vary = true;
+    check(!HttpCache::cacheable(h, now, e));
+}
+
+void
+testStore()
+{
+    clear();
+    check(mkdirRecursive(string(dir) + "/"));
+
+    HttpCache cache(dir, 10000);
+
+    HttpCache::Entry e;
+    check(!cache.open("http://localhost/a", e));
+
+    HttpCache::Entry stored;
+    stored.url = "http://localhost/a";
+    stored.etag = "\"1\"";
+    stored.expires = 1234;
+
+    FILE* body = makeBody(3000);
+    fseek(body, 10, SEEK_SET);
+    check(cache.store(stored, body));
+    check_equals(ftell(body), 10);
+    fclose(body);
+
+    FILE* f = cache.open("http://localhost/a", e);
+    check(f);
+    if (f) {
+        check_equals(e.url, "http://localhost/a");
+        check_equals(e.etag, "\"1\"");
+        check(e.lastModified.empty());
+        check_equals(e.expires, 1234);
+        check_equals(e.size, 3000u);
+        check_equals(fgetc(f), 'a');
+        check_equals(fgetc(f), 'b');
+        fclose(f);
+    }
+
+    check(!cache.open("http://localhost/b", e));
+
+    // Too large for the cache.
+    stored.url = "http://localhost/big";
+    body = makeBody(6000);
+    check(!cache.store(stored, body));
+    fclose(body);
+    check(!cache.open("http://localhost/big", e));
+
+    // Least recently used responses are removed to make room.
+    stored.url = "http://localhost/b";
+    body = makeBody(3000);
+    check(cache.store(stored, body));
+    fclose(body);
+
+    setUsed("http://localhost/a", 2000000000);
+    setUsed("http://localhost/b", 1000000000);
+
+    stored.url = "http://localhost/c";
+    body = makeBody(4000);
+    check(cache.store(stored, body));
+    fclose(body);
+
+    f = cache.open("http://localhost/a", e);
+    check(f);
+    if (f) fclose(f);
+    check(!cache.open("http://localhost/b", e));
+    f = cache.open("http://localhost/c", e);
+    check(f);
+    if (f) fclose(f);
+
+    cache.remove("http://localhost/c");
+    check(!cache.open("http://localhost/c", e));
+
+    clear();
+}
+
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+    testCacheable();
+    testStore();
+}
@@ -158,6 +158,31 @@ trymain(int /*argc*/, char** /*argv*/)
     std::unique_ptr<gnash::IOChannel> orig = gnash::makeFileChannel(f, false);
 	lseek(raw, 0, SEEK_SET);
 	compare_reads(orig.get(), raw, "cache", "raw");
+
+	// Regular files opened for reading are mapped, and can be read
+	// in place.
+	std::unique_ptr<gnash::IOChannel> mapped =
+		gnash::makeFileChannel(input, "rb");
+	lseek(raw, 0, SEEK_SET);
+	compare_reads(mapped.get(), raw, "mapped", "raw");
+
+	check(mapped->seek(10));
+	check(!mapped->eof());
+	std::streamsize viewed = 16;
+	const std::uint8_t* view = mapped->view(viewed);
+	check(view);
+	check_equals(viewed, 16);
+	check_equals(mapped->tell(), 26);
+	char buf[16];
+	check_equals(pread(raw, buf, 16, 10), 16);
+	check(view && !memcmp(view, buf, 16));
+
+	check(mapped->seek(mapped->size() - 4));
+	viewed = 16;
+	view = mapped->view(viewed);
+	check_equals(viewed, 4);
+	check(mapped->eof());
+	check(!mapped->seek(mapped->size() + 1));
 	close(raw);
 
 
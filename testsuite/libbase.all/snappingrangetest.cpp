@@ -225,6 +225,26 @@ main(int /*argc*/, char** /*argv*/)
 	finSnap4.add(Range2d<int>(40,273, 108,287));
 
 	check(finSnap3.contains(finSnap4));
+
+	//
+	// Test combining ranges brought together by a merge
+	//
+
+	SnappingRanges2d<int> combSnap;
+	combSnap.add(Range2d<int>(1000, 1000, 1010, 1010));
+	combSnap.add(Range2d<int>(0, 0, 10, 10));
+	combSnap.add(Range2d<int>(40, 0, 50, 10));
+	combSnap.add(Range2d<int>(80, 0, 90, 10));
+	check_equals(combSnap.size(), 4);
+
+	// Merged with the first range, which then reaches the others
+	combSnap.add(Range2d<int>(5, 0, 85, 10));
+	combSnap.combineRanges();
+	check_equals(combSnap.size(), 2);
+	check(combSnap.contains(Range2d<int>(0, 0, 90, 10)));
+	check(combSnap.contains(Range2d<int>(1000, 1000, 1010, 1010)));
+	check(!combSnap.contains(500, 500));
+
 	return 0;
 }
 
@@ -0,0 +1,189 @@
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DeviceGlyphCache.h"
+#include "ShapeRecord.h"
+#include "FillStyle.h"
+#include "Geometry.h"
+#include "SWFRect.h"
+#include "RGBA.h"
+#include "check.h"
+
+using namespace gnash;
+
+namespace {
+
+const char* const file = "DeviceGlyphCacheTest.glyphs";
+
+/// Make a glyph as FreetypeGlyphsProvider does.
+DeviceGlyphCache::Glyph
+makeGlyph(std::int32_t size, float advance)
+{
+    SWF::Subshape subshape;
+    subshape.addFillStyle(SolidFill(rgba()));
+    subshape.addPath(Path(0, 0, 1, 0, 0));
+    subshape.addPath(Path(0, 0, 1, 0, 0));
+    subshape.currentPath().drawLineTo(size, 0);
+    subshape.currentPath().drawCurveTo(size * 2, size, size, size * 2);
+    subshape.currentPath().close();
+    subshape.pack();
+
+    std::unique_ptr<SWF::ShapeRecord> shape(new SWF::ShapeRecord);
+    shape->addSubshape(subshape);
+    shape->setBounds(SWFRect(0, 0, size * 2, size * 2));
+
+    DeviceGlyphCache::Glyph glyph;
+    glyph.shape = std::move(shape);
+    glyph.advance = advance;
+    return glyph;
+}
+
+bool
+sameBounds(const SWFRect& a, const SWFRect& b)
+{
+    if (a.is_null() || b.is_null()) return a.is_null() == b.is_null();
+    return a.get_x_min() == b.get_x_min() && a.get_y_min() == b.get_y_min() &&
+        a.get_x_max() == b.get_x_max() && a.get_y_max() == b.get_y_max();
+}
+
+bool
+sameShape(const SWF::ShapeRecord& a, const SWF::ShapeRecord& b)
+{
+    if (!sameBounds(a.getBounds(), b.getBounds()) ||
+            a.subshapes().size() != 1 ||
+            b.subshapes().size() != 1) {
+        return false;
+    }
+
+    SWF::ShapeRecord::Paths pa, pb;
+    a.subshapes().front().copyPaths(pa);
+    b.subshapes().front().copyPaths(pb);
+    if (pa.size() != pb.size()) return false;
+
+    for (size_t i = 0; i < pa.size(); ++i) {
+        if (pa[i].m_fill0 != pb[i].m_fill0 || pa[i].m_fill1 != pb[i].m_fill1 ||
+                pa[i].m_line != pb[i].m_line || pa[i].ap != pb[i].ap ||
+                pa[i].m_edges.size() != pb[i].m_edges.size()) {
+            return false;
+        }
+        for (size_t e = 0; e < pa[i].m_edges.size(); ++e) {
+            if (pa[i].m_edges[e].cp != pb[i].m_edges[e].cp ||
+                    pa[i].m_edges[e].ap != pb[i].m_edges[e].ap) {
+                return false;
+            }
+        }
+    }
+    return b.subshapes().front().packed();
+}
+
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+    std::remove(file);
+
+    DeviceGlyphCache cache;
+    DeviceGlyphCache::Glyph glyph;
+
+    check(!cache.get("face", 1, glyph));
+    check(!cache.changed());
+
+    DeviceGlyphCache::Glyph a = makeGlyph(100, 512);
+    cache.add("face", 1, a);
+    check(cache.changed());
+    check_equals(cache.size(), 1u);
+
+    check(cache.get("face", 1, glyph));
+    check(glyph.shape == a.shape);
+    check_equals(glyph.advance, 512);
+    check(!cache.get("face", 2, glyph));
+    check(!cache.get("other", 1, glyph));
+
+    // A glyph added again is shared with the first one.
+    DeviceGlyphCache::Glyph again = makeGlyph(100, 512);
+    cache.add("face", 1, again);
+    check(again.shape == a.shape);
+    check_equals(cache.size(), 1u);
+
+    DeviceGlyphCache::Glyph b = makeGlyph(300, 700.5);
+    cache.add("other", 1, b);
+
+    // Save and load into another cache.
+    check(cache.save(file));
+    check(!cache.changed());
+
+    DeviceGlyphCache loaded;
+    check(loaded.load(file));
+    check_equals(loaded.size(), 2u);
+    check(!loaded.changed());
+
+    check(loaded.get("face", 1, glyph));
+    check_equals(glyph.advance, 512);
+    check(sameShape(*a.shape, *glyph.shape));
+    check(loaded.get("other", 1, glyph));
+    check_equals(glyph.advance, 700.5);
+    check(sameShape(*b.shape, *glyph.shape));
+
+    // Missing, truncated and invalid files.
+    DeviceGlyphCache bad;
+    check(!bad.load("DeviceGlyphCacheTest.missing"));
+
+    FILE* f = std::fopen(file, "rb");
+    std::vector<char> data(4096);
+    data.resize(std::fread(&data[0], 1, data.size(), f));
+    std::fclose(f);
+
+    f = std::fopen(file, "wb");
+    std::fwrite(&data[0], data.size() - 10, 1, f);
+    std::fclose(f);
+    check(!bad.load(file));
+    check(bad.size() < 2);
+
+    data[0] = 'X';
+    f = std::fopen(file, "wb");
+    std::fwrite(&data[0], data.size(), 1, f);
+    std::fclose(f);
+    DeviceGlyphCache invalid;
+    check(!invalid.load(file));
+    check_equals(invalid.size(), 0u);
+
+    // A path with a fill style the glyph doesn't have. The first path
+    // of the first glyph starts after the header, the face name, index
+    // and advance, and the bounds and path count.
+    data[0] = 'G';
+    const size_t styleOffset = 13 + 4 + 4 + 4 + 4 + 4 + 1 + 16 + 4;
+    const std::uint32_t badStyle = 2;
+    std::memcpy(&data[styleOffset], &badStyle, sizeof badStyle);
+    f = std::fopen(file, "wb");
+    std::fwrite(&data[0], data.size(), 1, f);
+    std::fclose(f);
+    DeviceGlyphCache badStyles;
+    check(!badStyles.load(file));
+    check_equals(badStyles.size(), 0u);
+
+    std::remove(file);
+}
@@ -43,6 +43,35 @@
 using namespace std;
 using namespace gnash;
 
+namespace {
+
+/// A DisplayObject hit everywhere inside its bounds.
+class BoxCharacter : public DummyCharacter
+{
+public:
+    BoxCharacter(as_object* object, DisplayObject* parent, const SWFRect& r)
+        :
+        DummyCharacter(object, parent),
+        _box(r)
+    {
+    }
+
+    virtual SWFRect getBounds() const { return _box; }
+
+    virtual bool pointInShape(std::int32_t x, std::int32_t y) const {
+        return _box.point_test(x, y);
+    }
+
+    InteractiveObject* topmostMouseEntity(std::int32_t x, std::int32_t y) {
+        return pointInShape(x, y) ? this : nullptr;
+    }
+
+private:
+    const SWFRect _box;
+};
+
+}
+
 TRYMAIN(_runtest);
 int
 trymain(int /*argc*/, char** /*argv*/)
@@ -84,13 +113,68 @@ trymain(int /*argc*/, char** /*argv*/)
     DisplayObject* ch1 ( new DummyCharacter(ob1, root) );
     DisplayObject* ch2 ( new DummyCharacter(ob2, root) );
     
+    VM& vm = getVM(*getObject(root));
+    string_table& st = vm.getStringTable();
+
+    ch1->set_name(getURI(vm, "ch"));
+    ch2->set_name(getURI(vm, "ch"));
+
     dlist1.placeDisplayObject(ch1, 1);
     dlist1.placeDisplayObject(ch2, 2);
     
     check(dlist1 != dlist2);
+
+    check_equals(dlist1.getDisplayObjectAtDepth(2), ch2);
+    check_equals(dlist1.getDisplayObjectAtDepth(3),
+            static_cast<DisplayObject*>(nullptr));
+    check_equals(dlist1.getNextHighestDepth(), 3);
+
+    // The DisplayObject with the lowest depth is found by name.
+    check_equals(dlist1.getDisplayObjectByName(st, getURI(vm, "ch"), false),
+            ch1);
+    check_equals(dlist1.getDisplayObjectByName(st, getURI(vm, "CH"), true),
+            ch1);
+    check_equals(dlist1.getDisplayObjectByName(st, getURI(vm, "CH"), false),
+            static_cast<DisplayObject*>(nullptr));
+
+    dlist1.swapDepths(ch1, 3);
+    check_equals(dlist1.getDisplayObjectAtDepth(1),
+            static_cast<DisplayObject*>(nullptr));
+    check_equals(dlist1.getNextHighestDepth(), 4);
+    check_equals(dlist1.getDisplayObjectByName(st, getURI(vm, "ch"), false),
+            ch2);
+    check_equals(dlist1.getDisplayObjectByName(st, getURI(vm, "CH"), true),
+            ch2);
+
+    dlist1.swapDepths(ch1, 1);
+    check_equals(dlist1.getDisplayObjectByName(st, getURI(vm, "ch"), false),
+            ch1);
     
     dlist2.placeDisplayObject(ch2, 1);
     dlist2.placeDisplayObject(ch1, 2);
+
+    // The cached hit bounds of the root grow when a DisplayObject is
+    // placed outside of them.
+    as_object* ob3 = createObject(getGlobal(*getObject(root)));
+    as_object* ob4 = createObject(getGlobal(*getObject(root)));
+    DisplayObject* box1(new BoxCharacter(ob3, root, SWFRect(0, 0, 200, 200)));
+    DisplayObject* box2(new BoxCharacter(ob4, root,
+                SWFRect(4000, 4000, 4200, 4200)));
+
+    // The mouse position is in pixels, DisplayObject bounds in twips.
+    root->attachCharacter(*box1, 10, nullptr);
+    stage.mouseMoved(5, 5);
+    check_equals(stage.getActiveEntityUnderPointer(), box1);
+    check_equals(stage.getEntityUnderPointer(), box1);
+    check(!root->getHitBounds().point_test(4100, 4100));
+
+    root->attachCharacter(*box2, 11, nullptr);
+    stage.mouseMoved(205, 205);
+    check_equals(stage.getActiveEntityUnderPointer(), box2);
+    check_equals(stage.getEntityUnderPointer(), box2);
+    check(root->getHitBounds().point_test(4100, 4100));
+    stage.mouseMoved(5, 5);
+    check_equals(stage.getActiveEntityUnderPointer(), box1);
     
     return 0;
 }
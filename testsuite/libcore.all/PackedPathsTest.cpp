@@ -0,0 +1,127 @@
+// 
+//   Copyright (C) 2012 Free Software Foundation, Inc
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include <vector>
+#include <limits>
+
+#include "Geometry.h"
+#include "LineStyle.h"
+#include "check.h"
+
+using namespace gnash;
+
+namespace {
+
+bool
+samePath(const Path& a, const PackedPath& b)
+{
+    if (a.m_fill0 != b.m_fill0 || a.m_fill1 != b.m_fill1 ||
+            a.m_line != b.m_line || a.ap != b.ap || a.size() != b.size()) {
+        return false;
+    }
+    std::vector<Edge>::const_iterator ea = a.begin();
+    for (PackedPaths::EdgeIterator eb = b.begin(); eb != b.end(); ++eb, ++ea) {
+        if (ea->cp != eb->cp || ea->ap != eb->ap) return false;
+    }
+    return ea == a.end();
+}
+
+}
+
+int
+main(int /*argc*/, char** /*argv*/)
+{
+    const std::int32_t big = std::numeric_limits<std::int32_t>::max();
+    const std::int32_t small = std::numeric_limits<std::int32_t>::min();
+
+    std::vector<Path> paths;
+
+    // A filled square with a curved side.
+    paths.push_back(Path(0, 0, 1, 0, 0));
+    paths.back().drawLineTo(2000, 0);
+    paths.back().drawCurveTo(2500, 1000, 2000, 2000);
+    paths.back().drawLineTo(0, 2000);
+    paths.back().drawLineTo(0, 0);
+
+    // An outline with offsets that don't fit in 16 bits.
+    paths.push_back(Path(-100, 50, 0, 2, 1));
+    paths.back().drawLineTo(40000, 50);
+    paths.back().drawCurveTo(40000, -40000, 32767, -32768);
+    paths.back().drawLineTo(big, small);
+    paths.back().drawCurveTo(small, big, 0, 0);
+
+    // No edges.
+    paths.push_back(Path(7, 8, 0, 0, 0));
+
+    const PackedPaths packed(paths);
+    check_equals(packed.size(), paths.size());
+    check(!packed.empty());
+    check(PackedPaths().empty());
+    check(PackedPaths().begin() == PackedPaths().end());
+
+    size_t i = 0;
+    for (const PackedPath& p : packed) {
+        check(i < paths.size() && samePath(paths[i], p));
+        ++i;
+    }
+    check_equals(i, paths.size());
+
+    PackedPaths::const_iterator it = packed.begin();
+    check_equals(it->size(), 4u);
+    check(!it->empty());
+    check((++it)->begin()->straight());
+    check(!(++it->begin())->straight());
+    check((++it)->empty());
+    check(it->begin() == it->end());
+    check(++it == packed.end());
+
+    std::vector<Path> expanded(1);
+    packed.expand(expanded);
+    check_equals(expanded.size(), paths.size() + 1);
+    for (i = 0; i < paths.size(); ++i) {
+        const Path& a = paths[i];
+        const Path& b = expanded[i + 1];
+        check_equals(a.ap, b.ap);
+        check_equals(a.m_line, b.m_line);
+        check_equals(a.size(), b.size());
+        bool same = true;
+        for (size_t e = 0; e < a.size(); ++e) {
+            same = same && a[e].cp == b[e].cp && a[e].ap == b[e].ap;
+        }
+        check(same);
+    }
+
+    // Hit tests give the same answers on packed paths.
+    std::vector<LineStyle> lineStyles(1);
+    bool same = true;
+    for (std::int32_t x = -500; x < 3000; x += 50) {
+        for (std::int32_t y = -500; y < 3000; y += 50) {
+            same = same &&
+                geometry::pointTest(paths, lineStyles, x, y, SWFMatrix()) ==
+                geometry::pointTest(packed, lineStyles, x, y, SWFMatrix());
+        }
+    }
+    check(same);
+    check(geometry::pointTest(packed, lineStyles, 1000, 1000, SWFMatrix()));
+    check(geometry::pointTest(packed, lineStyles, 2200, 1000, SWFMatrix()));
+    check(!geometry::pointTest(packed, lineStyles, 3000, 1000, SWFMatrix()));
+}
+
@@ -0,0 +1,134 @@
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+// Measures how fast SWF files are parsed.
+//
+// Usage: ParseBench [-n <repeats>] <file.swf> ...
+//
+// Each file is parsed completely the given number of times, with tags
+// decoded by the parsing thread, and the throughput is printed. This
+// is not run by 'make check'; use 'make bench'.
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include "SWFMovieDefinition.h"
+#include "RunResources.h"
+#include "swf/TagLoadersTable.h"
+#include "swf/DefaultTagLoaders.h"
+#include "ClockTime.h"
+#include "IOChannel.h"
+#include "tu_file.h"
+#include "GnashException.h"
+#include "log.h"
+#include "rc.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <iostream>
+#include <boost/intrusive_ptr.hpp>
+
+using namespace std;
+using namespace gnash;
+
+namespace {
+
+/// Parse a file once.
+//
+/// @return     the number of bytes parsed, or 0 on failure.
+size_t
+parse(const char* file, const RunResources& r)
+{
+    unique_ptr<IOChannel> in = makeFileChannel(file, "rb");
+    if (!in.get()) return 0;
+
+    boost::intrusive_ptr<SWFMovieDefinition> md(new SWFMovieDefinition(r));
+    if (!md->readHeader(std::move(in), file)) return 0;
+    md->read_all_swf();
+
+    return md->get_bytes_loaded();
+}
+
+}
+
+int
+main(int argc, char** argv)
+{
+    size_t repeats = 20;
+    int first = 1;
+    if (argc > 2 && !strcmp(argv[1], "-n")) {
+        repeats = strtoul(argv[2], 0, 10);
+        first = 3;
+    }
+    if (first >= argc || !repeats) {
+        cerr << "Usage: " << argv[0] << " [-n <repeats>] <file.swf> ..."
+             << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Parse errors in the test movies are not what is measured.
+    LogFile::getDefaultInstance().setVerbosity(0);
+
+    // Measure the parser alone, not how many threads decode tags.
+    RcInitFile::getDefaultInstance().setTagDecoderThreads(1);
+
+    RunResources runResources;
+    std::shared_ptr<SWF::TagLoadersTable> loaders(new SWF::TagLoadersTable);
+    addDefaultLoaders(*loaders);
+    runResources.setTagLoaders(loaders);
+
+    double totalBytes = 0;
+    double totalTime = 0;
+
+    for (int i = first; i < argc; ++i) {
+        size_t bytes = 0;
+        const std::uint64_t start = clocktime::getTicks();
+        try {
+            for (size_t n = 0; n < repeats; ++n) {
+                bytes += parse(argv[i], runResources);
+            }
+        }
+        catch (const GnashException& e) {
+            cerr << argv[i] << ": " << e.what() << endl;
+            continue;
+        }
+        const double secs = (clocktime::getTicks() - start) / 1000.0;
+        if (!bytes) {
+            cerr << argv[i] << ": can't parse" << endl;
+            continue;
+        }
+
+        printf("%-40s %10lu bytes %8.2f ms %8.2f MB/s\n", argv[i],
+                static_cast<unsigned long>(bytes / repeats),
+                secs * 1000 / repeats, secs ? bytes / secs / 1e6 : 0.0);
+
+        totalBytes += bytes;
+        totalTime += secs;
+    }
+
+    if (totalTime) {
+        printf("%-40s %10.0f bytes %8.2f ms %8.2f MB/s\n", "total",
+                totalBytes / repeats, totalTime * 1000 / repeats,
+                totalBytes / totalTime / 1e6);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -42,6 +42,7 @@
 #include <fcntl.h>
 #include <string.h>
 #include <sstream>
+#include <algorithm>
 
 
 using namespace std;
@@ -104,6 +105,49 @@ struct ByteReader : public IOChannel
 	
 };
 
+struct MemReader : public IOChannel
+{
+	const unsigned char* data;
+	size_t len;
+	size_t pos;
+
+	MemReader(const unsigned char* d, size_t l)
+		:
+		data(d),
+		len(l),
+		pos(0)
+	{}
+
+    std::streamsize read(void* dst, std::streamsize bytes) 
+	{
+		const size_t got = std::min<size_t>(bytes, len - pos);
+		memcpy(dst, data + pos, got);
+		pos += got;
+		return got;
+	}
+
+    std::streampos tell() const
+	{
+		return pos;
+	}
+
+    bool seek(std::streampos newPos)
+	{
+		if (static_cast<size_t>(newPos) > len) return false;
+		pos=newPos;
+		return true; 
+	}
+
+	void go_to_end() { pos = len; }
+
+	bool eof() const { return pos == len; }
+    
+	bool bad() const { return false; }
+
+    size_t size() const { return len; }
+	
+};
+
 TRYMAIN(_runtest);
 int
 trymain(int /*argc*/, char** /*argv*/)
@@ -480,6 +524,76 @@ trymain(int /*argc*/, char** /*argv*/)
 
 	}
 
+	{
+	/// A tag of type 2 and length 10, containing a tag of type 1
+	/// and length 2, followed by a byte outside the tag.
+	const unsigned char data[] = {
+		0x8A, 0x00,
+		0x99, 0x99, 0x99, 0x99,
+		0x42, 0x00, 0xFF, 0xFF,
+		0x12, 0x34,
+		0x77
+	};
+	MemReader mr(data, sizeof data);
+	SWFStream s(&mr);
+	std::uint16_t u16;
+	std::uint32_t u32;
+
+	check_equals(s.open_tag(), 2);
+	check_equals(s.tell(), 2);
+	check_equals(s.get_tag_end_position(), 12);
+
+	// The same bits as the 0x99999999 above, read from the tag buffer.
+	ret = s.read_bit(); check_equals(ret, 1);
+	check_equals(s.tell(), 3);
+	u32 = s.read_uint(18); check_equals(u32, 52428);
+	check_equals(s.tell(), 5);
+	u16 = s.read_uint(10); check_equals(u16, 819);
+	check_equals(s.tell(), 6);
+	u16 = s.read_uint(3); check_equals(u16, 1);
+	check_equals(s.tell(), 6);
+	s.align();
+	check_equals(s.tell(), 6);
+
+	check_equals(s.open_tag(), 1);
+	check_equals(s.tell(), 8);
+	check_equals(s.get_tag_end_position(), 10);
+	check_equals(s.read_u16(), 0xFFFF);
+	s.close_tag();
+	check_equals(s.tell(), 10);
+	check_equals(s.get_tag_end_position(), 12);
+
+	u16 = s.read_uint(4); check_equals(u16, 1);
+	check_equals(s.tell(), 11);
+	s.align();
+	check_equals(s.read_u8(), 0x34);
+
+	// Seeking stays in the tag.
+	check(s.seek(3));
+	check_equals(s.tell(), 3);
+	check_equals(s.read_u8(), 0x99);
+	check(!s.seek(13));
+	check(s.seek(2));
+	u32 = s.read_uint(32); check_equals(u32, 0x99999999);
+
+	// Reading past the end of the tag fails.
+	check(s.seek(11));
+	check_equals(s.read_u8(), 0x34);
+	bool thrown = false;
+	try {
+		s.read_u8();
+	}
+	catch (const ParserException&) {
+		thrown = true;
+	}
+	check(thrown);
+
+	s.close_tag();
+	check_equals(s.tell(), 12);
+	check_equals(s.read_u8(), 0x77);
+	check_equals(s.tell(), 13);
+	}
+
 	return 0;
 }
 
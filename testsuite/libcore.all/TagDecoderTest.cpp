@@ -0,0 +1,173 @@
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+// Checks that movies parsed with definition tags decoded by several
+// threads are the same as movies parsed with all tags decoded by the
+// parsing thread.
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include "SWFMovieDefinition.h"
+#include "RunResources.h"
+#include "swf/TagLoadersTable.h"
+#include "swf/DefaultTagLoaders.h"
+#include "swf/DefineShapeTag.h"
+#include "Font.h"
+#include "CachedBitmap.h"
+#include "GnashImage.h"
+#include "IOChannel.h"
+#include "tu_file.h"
+#include "log.h"
+#include "rc.h"
+
+#ifdef RENDERER_AGG
+# include "Renderer_agg.h"
+#endif
+
+#include <string>
+#include <sstream>
+#include <memory>
+#include <typeinfo>
+#include <boost/intrusive_ptr.hpp>
+
+#include "check.h"
+
+using namespace std;
+using namespace gnash;
+
+namespace {
+
+bool
+sameBounds(const SWFRect& a, const SWFRect& b)
+{
+    ostringstream sa, sb;
+    sa << a;
+    sb << b;
+    return sa.str() == sb.str();
+}
+
+/// Parse a file completely on this thread.
+boost::intrusive_ptr<SWFMovieDefinition>
+parse(const string& file, const RunResources& r, size_t threads)
+{
+    RcInitFile::getDefaultInstance().setTagDecoderThreads(threads);
+
+    boost::intrusive_ptr<SWFMovieDefinition> md(new SWFMovieDefinition(r));
+    unique_ptr<IOChannel> in = makeFileChannel(file.c_str(), "rb");
+    if (!in.get() || !md->readHeader(std::move(in), file)) return nullptr;
+    md->read_all_swf();
+    return md;
+}
+
+/// Compare what the tags of a movie defined, parsing it serially and
+/// with the given number of threads.
+void
+compare(const string& file, const RunResources& r, size_t threads)
+{
+    boost::intrusive_ptr<SWFMovieDefinition> serial = parse(file, r, 1);
+    boost::intrusive_ptr<SWFMovieDefinition> threaded =
+        parse(file, r, threads);
+
+    check(serial);
+    check(threaded);
+    if (!serial || !threaded) return;
+
+    check_equals(threaded->get_frame_count(), serial->get_frame_count());
+    check_equals(threaded->get_loading_frame(), serial->get_loading_frame());
+    check_equals(threaded->get_bytes_loaded(), serial->get_bytes_loaded());
+
+    size_t definitions = 0, fonts = 0, bitmaps = 0;
+    size_t definitionsDiffer = 0, fontsDiffer = 0, bitmapsDiffer = 0;
+
+    for (size_t id = 0; id < 0x10000; ++id) {
+
+        const SWF::DefinitionTag* st = serial->getDefinitionTag(id);
+        const SWF::DefinitionTag* tt = threaded->getDefinitionTag(id);
+        if (st) ++definitions;
+        if (!st || !tt) {
+            if (st != tt) ++definitionsDiffer;
+        }
+        else if (typeid(*st) != typeid(*tt)) ++definitionsDiffer;
+        else if (const SWF::DefineShapeTag* ss =
+                dynamic_cast<const SWF::DefineShapeTag*>(st)) {
+            const SWF::DefineShapeTag* ts =
+                static_cast<const SWF::DefineShapeTag*>(tt);
+            if (!sameBounds(ss->bounds(), ts->bounds())) ++definitionsDiffer;
+        }
+
+        const Font* sf = serial->get_font(id);
+        const Font* tf = threaded->get_font(id);
+        if (sf) ++fonts;
+        if (!sf || !tf) {
+            if (sf != tf) ++fontsDiffer;
+        }
+        else if (sf->name() != tf->name() ||
+                sf->glyphCount() != tf->glyphCount()) {
+            ++fontsDiffer;
+        }
+
+        CachedBitmap* sb = serial->getBitmap(id);
+        CachedBitmap* tb = threaded->getBitmap(id);
+        if (sb) ++bitmaps;
+        if (!sb || !tb) {
+            if (sb != tb) ++bitmapsDiffer;
+        }
+        else if (sb->image().width() != tb->image().width() ||
+                sb->image().height() != tb->image().height()) {
+            ++bitmapsDiffer;
+        }
+    }
+
+    check(definitions);
+    check(fonts);
+#ifdef RENDERER_AGG
+    check(bitmaps);
+#endif
+    check_equals(definitionsDiffer, 0);
+    check_equals(fontsDiffer, 0);
+    check_equals(bitmapsDiffer, 0);
+}
+
+}
+
+TRYMAIN(_runtest);
+int
+trymain(int /*argc*/, char** /*argv*/)
+{
+    gnash::LogFile& dbglogfile = gnash::LogFile::getDefaultInstance();
+    dbglogfile.setVerbosity(0);
+
+    RunResources runResources;
+    std::shared_ptr<SWF::TagLoadersTable> loaders(new SWF::TagLoadersTable);
+    addDefaultLoaders(*loaders);
+    runResources.setTagLoaders(loaders);
+
+    // Bitmaps are only added to movies parsed with a renderer.
+#ifdef RENDERER_AGG
+    std::shared_ptr<Renderer> renderer(create_Renderer_agg("RGBA32"));
+    runResources.setRenderer(renderer);
+#endif
+
+    // Shapes, fonts and bitmaps are interleaved in these movies.
+    const string srcdir(SRCDIR);
+    compare(srcdir + "/../movies.all/tic_tac2.swf", runResources, 4);
+    compare(srcdir + "/../samples/car_smash.swf", runResources, 2);
+
+    return 0;
+}
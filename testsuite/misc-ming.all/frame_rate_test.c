@@ -0,0 +1,62 @@
+/* 
+ *   Copyright (C) 2012 Free Software Foundation, Inc.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */ 
+
+/*
+ * A movie of 40 frames at 10 frames per second, with a square on each
+ * frame, for checking when frames are advanced by late heart-beats.
+ *
+ * run as ./frame_rate_test
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <ming.h>
+
+#include "ming_utils.h"
+
+#define OUTPUT_VERSION 6
+#define OUTPUT_FILENAME "frame_rate_test.swf"
+
+int
+main(void)
+{
+	SWFMovie mo;
+	SWFShape sh;
+	SWFDisplayItem it;
+	int i;
+
+	Ming_init();
+	mo = newSWFMovie();
+	SWFMovie_setDimension(mo, 800, 600);
+	SWFMovie_setRate(mo, 10);
+
+	sh = make_fill_square(0, 0, 60, 60, 255, 0, 0, 255, 0, 0);
+	it = SWFMovie_add(mo, (SWFBlock)sh);
+
+	for(i=0; i<40; i++)
+	{
+		SWFDisplayItem_moveTo(it, i * 10, 0);
+		SWFMovie_nextFrame(mo);
+	}
+
+	//Output movie
+	puts("Saving " OUTPUT_FILENAME );
+	SWFMovie_save(mo, OUTPUT_FILENAME);
+
+	return 0;
+}
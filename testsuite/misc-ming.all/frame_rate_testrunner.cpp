@@ -0,0 +1,102 @@
+/* 
+ *   Copyright (C) 2012 Free Software Foundation, Inc.
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ */ 
+
+/*
+ * Checks that frames are advanced on the SWF clock when heart-beats are
+ * late, and that the clock is reset rather than caught up when more
+ * than a second late.
+ */
+
+#define INPUT_FILENAME "frame_rate_test.swf"
+
+#include "MovieTester.h"
+#include "MovieClip.h"
+#include "log.h"
+
+#include "check.h"
+#include <string>
+#include <cassert>
+
+using namespace gnash;
+using namespace std;
+
+TRYMAIN(_runtest);
+int
+trymain(int /*argc*/, char** /*argv*/)
+{
+	string filename = string(TGTDIR) + string("/") + string(INPUT_FILENAME);
+	MovieTester tester(filename);
+
+	MovieClip* root = tester.getRootMovie();
+	assert(root);
+
+	// 10 frames per second: a frame is due every 100 milliseconds.
+	check_equals(root->get_frame_count(), 40);
+	check_equals(root->get_current_frame(), 0);
+
+	// A heart-beat 50 milliseconds late advances a frame...
+	tester.advanceClock(150);
+	tester.advance(false);
+	check_equals(root->get_current_frame(), 1);
+
+	// ... and the next frame is still due 200 milliseconds after the
+	// start, not 100 milliseconds after the late heart-beat.
+	tester.advanceClock(50);
+	tester.advance(false);
+	check_equals(root->get_current_frame(), 2);
+
+	// On-time heart-beats then keep to the SWF clock.
+	for (size_t i = 0; i < 5; ++i) {
+		tester.advanceClock(100);
+		tester.advance(false);
+	}
+	check_equals(root->get_current_frame(), 7);
+
+	// Not a frame too early.
+	tester.advanceClock(99);
+	tester.advance(false);
+	check_equals(root->get_current_frame(), 7);
+	tester.advanceClock(1);
+	tester.advance(false);
+	check_equals(root->get_current_frame(), 8);
+
+	// A heart-beat more than a second late, as after the process was
+	// suspended, advances a single frame...
+	tester.advanceClock(1500);
+	tester.advance(false);
+	check_equals(root->get_current_frame(), 9);
+
+	// ... and the frames it missed are not caught up: the next one is
+	// due 100 milliseconds after it.
+	tester.advanceClock(50);
+	tester.advance(false);
+	check_equals(root->get_current_frame(), 9);
+	tester.advanceClock(50);
+	tester.advance(false);
+	check_equals(root->get_current_frame(), 10);
+
+	for (size_t i = 0; i < 5; ++i) {
+		tester.advanceClock(100);
+		tester.advance(false);
+	}
+	check_equals(root->get_current_frame(), 15);
+
+	return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ *   Copyright (C) 2012 Free Software Foundation, Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *
+ */
+
+/*
+ * Test that a loadClip request is cancelled when its target is unloaded
+ * while the movie is still loading, and that no events are sent for it.
+ * A request made at the same time for a target that stays loads as
+ * usual.
+ *
+ * run as ./loadMovieCancelTest <mediadir>
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <ming.h>
+
+#include "ming_utils.h"
+
+#define OUTPUT_VERSION 7
+#define OUTPUT_FILENAME "loadMovieCancelTest.swf"
+
+int
+main(int argc, char** argv)
+{
+    SWFMovie mo;
+    const char *srcdir=".";
+    SWFMovieClip  dejagnuclip;
+    char loads[1024];
+    int i;
+
+    if ( argc>1 ) srcdir=argv[1];
+    else
+    {
+       fprintf(stderr, "Usage: %s <mediadir>\n", argv[0]);
+       return 1;
+    }
+
+    sprintf(loads, "mcl.loadClip('%s/red.swf', 'gone');"
+                   "mcl.loadClip('%s/green.swf', 'kept');", srcdir, srcdir);
+
+    Ming_init();
+    Ming_useSWFVersion (OUTPUT_VERSION);
+    Ming_setScale(20.0); /* let's talk pixels */
+
+    mo = newSWFMovie();
+    SWFMovie_setRate(mo, 12);
+    SWFMovie_setDimension(mo, 640, 400);
+
+    dejagnuclip = get_dejagnu_clip((SWFBlock)get_default_font(srcdir),
+                 10, 0, 80, 800, 600);
+    SWFMovie_add(mo, (SWFBlock)dejagnuclip);
+
+    add_actions(mo,
+                 "events = '';"
+                 "l = {};"
+                 "l.onLoadStart = function(t) { events += 'start ' + t._name + ';'; };"
+                 "l.onLoadError = function(t) { events += 'error ' + t._name + ';'; };"
+                 "l.onLoadInit = function(t) {"
+                 "  events += 'init ' + t._name + ';';"
+                 "  _root.play();"
+                 "};"
+                 "mcl = new MovieClipLoader();"
+                 "mcl.addListener(l);"
+                 "createEmptyMovieClip('gone', 1);"
+                 "createEmptyMovieClip('kept', 2);");
+    add_actions(mo, loads);
+
+    /* Unload the target before its movie has been loaded. */
+    add_actions(mo, "gone.removeMovieClip();");
+    check_equals(mo, "typeof(gone)", "'undefined'");
+    check_equals(mo, "events", "''");
+
+    /* Wait for the movie loaded into 'kept' */
+    add_actions(mo, "stop();");
+    SWFMovie_nextFrame(mo);
+
+    /* Leave time for the other request to complete, had it been kept */
+    for (i = 0; i < 12; i++) SWFMovie_nextFrame(mo);
+
+    check_equals(mo, "events", "'start kept;init kept;'");
+    check_equals(mo, "typeof(gone)", "'undefined'");
+
+    add_actions(mo, "totals(4);");
+    add_actions(mo, "stop();");
+
+    puts("Saving " OUTPUT_FILENAME );
+
+    SWFMovie_save(mo, OUTPUT_FILENAME);
+
+    return 0;
+}
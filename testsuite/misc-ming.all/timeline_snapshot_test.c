@@ -0,0 +1,148 @@
+/*
+ *   Copyright (C) 2012 Free Software Foundation, Inc.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+/*
+ * Test that jumping backwards in a long timeline, which rebuilds the
+ * DisplayList from a snapshot of the timeline, gives the same state as
+ * playing it from the first frame.
+ *
+ * The timeline has 132 frames, so there are snapshots at frames 64 and 128.
+ * Sprites are placed, moved, given a color transform and removed along
+ * it, and the state of all of them is recorded in every frame the first
+ * time the timeline is played. The timeline then goes back to frame 100
+ * and to frame 65, and the state is checked against the recorded one in
+ * every frame played again.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <ming.h>
+
+#include "ming_utils.h"
+
+#define OUTPUT_VERSION 6
+#define OUTPUT_FILENAME "timeline_snapshot_test.swf"
+
+
+int
+main(int argc, char** argv)
+{
+  SWFMovie mo;
+  SWFMovieClip mc, dejagnuclip;
+  SWFShape sh;
+  SWFDisplayItem ita = NULL, itb = NULL, itc = NULL, itd = NULL;
+  int f;
+
+  const char *srcdir=".";
+  if ( argc>1 )
+      srcdir=argv[1];
+  else
+  {
+      fprintf(stderr, "Usage: %s <mediadir>\n", argv[0]);
+      return 1;
+  }
+
+  Ming_init();
+  mo = newSWFMovieWithVersion(OUTPUT_VERSION);
+  SWFMovie_setDimension(mo, 800, 600);
+  SWFMovie_setRate (mo, 12.0);
+
+  dejagnuclip = get_dejagnu_clip((SWFBlock)get_default_font(srcdir), 10, 0, 0, 800, 600);
+  SWFMovie_add(mo, (SWFBlock)dejagnuclip);
+
+  add_actions(mo,
+      "states = []; jumps = 0;"
+      "state = function() {"
+      "  var s = '';"
+      "  var names = ['a', 'b', 'c', 'd'];"
+      "  for (var i = 0; i < names.length; i++) {"
+      "    var m = _root[names[i]];"
+      "    if (typeof(m) == 'movieclip') {"
+      "      s += names[i] + ':' + m.getDepth() + ':' + m._x + ':' + m._y +"
+      "        ':' + m._alpha + ';';"
+      "    }"
+      "  }"
+      "  return s;"
+      "};");
+  SWFMovie_nextFrame(mo); /* 1st frame */
+
+  mc = newSWFMovieClip();
+  sh = make_fill_square (0, 0, 20, 20, 255, 0, 0, 255, 0, 0);
+  SWFMovieClip_add(mc, (SWFBlock)sh);
+  SWFMovieClip_nextFrame(mc);
+
+  for (f = 2; f <= 131; f++)
+  {
+    if (f == 2)
+    {
+      ita = SWFMovie_add(mo, (SWFBlock)mc);
+      SWFDisplayItem_setDepth(ita, 10);
+      SWFDisplayItem_setName(ita, "a");
+      itb = SWFMovie_add(mo, (SWFBlock)mc);
+      SWFDisplayItem_setDepth(itb, 11);
+      SWFDisplayItem_setName(itb, "b");
+    }
+    else
+    {
+      SWFDisplayItem_moveTo(ita, f * 2, 100);
+    }
+
+    if (f < 30 && f % 7 == 0) SWFDisplayItem_moveTo(itb, 10, f * 3);
+    if (f == 30) SWFDisplayItem_remove(itb);
+
+    if (f == 40)
+    {
+      itc = SWFMovie_add(mo, (SWFBlock)mc);
+      SWFDisplayItem_setDepth(itc, 12);
+      SWFDisplayItem_setName(itc, "c");
+      SWFDisplayItem_moveTo(itc, 50, 200);
+    }
+    if (f == 50) SWFDisplayItem_setColorMult(itc, 1.0, 1.0, 1.0, 0.5);
+    if (f == 80) SWFDisplayItem_moveTo(itc, 60, 210);
+    if (f == 90) SWFDisplayItem_remove(itc);
+
+    if (f == 95)
+    {
+      itd = SWFMovie_add(mo, (SWFBlock)mc);
+      SWFDisplayItem_setDepth(itd, 12);
+      SWFDisplayItem_setName(itd, "d");
+    }
+    if (f == 110 || f == 120) SWFDisplayItem_moveTo(itd, f, 300);
+
+    add_actions(mo, "if (!jumps) states[_currentframe] = state();");
+    check_equals(mo, "state()", "states[_currentframe]");
+
+    if (f == 131)
+    {
+      add_actions(mo,
+          "if (jumps == 0) { jumps++; gotoAndPlay(100); }"
+          "else if (jumps == 1) { jumps++; gotoAndPlay(65); }");
+    }
+    SWFMovie_nextFrame(mo);
+  }
+
+  /* 130 frames played first, then 32 from frame 100 and 67 from frame 65 */
+  add_actions(mo, "totals(229); stop();");
+  SWFMovie_nextFrame(mo); /* 132nd frame */
+
+  /* Output movie */
+  puts("Saving " OUTPUT_FILENAME );
+  SWFMovie_save(mo, OUTPUT_FILENAME);
+
+  return 0;
+}
@@ -0,0 +1,650 @@
+// batchrender.cpp:  Render frames of many movies to images, for Gnash.
+//
+//   Copyright (C) 2012 Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <boost/any.hpp>
+
+#ifdef ENABLE_NLS
+# include <clocale>
+#endif
+
+#include "MovieFactory.h"
+#include "swf/TagLoadersTable.h"
+#include "swf/DefaultTagLoaders.h"
+#include "ClockTime.h"
+#include "movie_definition.h"
+#include "MovieClip.h"
+#include "movie_root.h"
+#include "log.h"
+#include "rc.h"
+#include "URL.h"
+#include "GnashException.h"
+#include "GnashEnums.h"
+#include "ManualClock.h"
+#include "StringPredicates.h"
+#include "IOChannel.h"
+#include "tu_file.h"
+#include "GnashFactory.h"
+#include "MediaHandler.h"
+#include "StreamProvider.h"
+#include "RunResources.h"
+#include "HostInterface.h"
+#include "Movie.h"
+#include "Renderer.h"
+#include "Renderer_agg.h"
+#include "snappingrange.h"
+
+extern "C"{
+
+#ifdef HAVE_GETOPT_H
+	#include <getopt.h>
+#endif
+#ifndef __GNUC__
+	extern char *optarg;
+	extern int   optopt;
+	extern int optind, getopt(int, char *const *, const char *);
+#endif
+}
+
+const char *GBATCHRENDER_VERSION = "1.0";
+
+using namespace gnash;
+
+namespace {
+
+gnash::LogFile& dbglogfile = gnash::LogFile::getDefaultInstance();
+gnash::RcInitFile& rcfile = gnash::RcInitFile::getDefaultInstance();
+
+/// A frame to render: either a number of advances or a time in the movie.
+struct Target
+{
+    unsigned long value;
+
+    /// Whether value is in milliseconds rather than advances.
+    bool time;
+};
+
+/// One line of the manifest.
+struct Job
+{
+    std::string swf;
+
+    /// The image file name, with %f replaced by the advance count.
+    std::string output;
+
+    std::vector<Target> targets;
+};
+
+struct Result
+{
+    Result() : ok(false), timedOut(false), images(0), advances(0) {}
+
+    bool ok;
+    bool timedOut;
+    size_t images;
+    size_t advances;
+    std::string error;
+};
+
+/// Settings shared by all workers, fixed before they start.
+struct Settings
+{
+    Settings() : timeout(0), width(0), quality(90) {}
+
+    /// The seconds a movie may take before it is abandoned, or 0.
+    unsigned long timeout;
+
+    /// The width of the images, or 0 to use the movie's own size.
+    unsigned int width;
+
+    int quality;
+
+    std::shared_ptr<SWF::TagLoadersTable> loaders;
+};
+
+/// Answers host queries with the same fixed values as gprocessor.
+//
+/// It has no state, so a single instance serves every movie_root.
+class EventCallback : public HostInterface
+{
+public:
+    boost::any call(const HostInterface::Message& e)
+    {
+        if (e.type() != typeid(HostMessage)) return boost::blank();
+
+        const HostMessage& ev = boost::get<HostMessage>(e);
+
+        switch (ev.event()) {
+            case HostMessage::QUERY:
+                return true;
+            case HostMessage::SHOW_MOUSE:
+                return true;
+            case HostMessage::SCREEN_RESOLUTION:
+                return std::make_pair(800, 640);
+            case HostMessage::SCREEN_DPI:
+                return 72.0;
+            case HostMessage::SCREEN_COLOR:
+                return std::string("Color");
+            case HostMessage::PLAYER_TYPE:
+                return std::string("StandAlone");
+            case HostMessage::PIXEL_ASPECT_RATIO:
+                return 0.9978;
+            default:
+                break;
+        }
+        return boost::blank();
+    }
+
+    // A movie can't end the whole batch.
+    virtual void exit() {}
+};
+
+/// Notes a "quit" fscommand for one movie.
+class FsCommandExecutor : public FsCallback
+{
+public:
+    FsCommandExecutor() : quit(false) {}
+
+    void notify(const std::string& command, const std::string& /*args*/)
+    {
+        StringNoCaseEqual ncasecomp;
+        if (ncasecomp(command, "quit")) quit = true;
+    }
+
+    bool quit;
+};
+
+EventCallback eventCallback;
+
+void usage(const char *name);
+
+/// Parse a target such as 120, 1500ms or 2s.
+bool
+parseTarget(const std::string& s, Target& t)
+{
+    char* end;
+    const double v = std::strtod(s.c_str(), &end);
+    if (end == s.c_str() || v < 0) return false;
+
+    const std::string unit(end);
+    if (unit.empty()) {
+        if (v != std::floor(v)) return false;
+        t.value = v;
+        t.time = false;
+    }
+    else if (unit == "ms") {
+        t.value = v;
+        t.time = true;
+    }
+    else if (unit == "s") {
+        t.value = v * 1000;
+        t.time = true;
+    }
+    else return false;
+
+    return true;
+}
+
+/// The image type for a file name, from its extension.
+FileType
+outputType(const std::string& name)
+{
+    const std::string::size_type dot = name.rfind('.');
+    if (dot == std::string::npos) return GNASH_FILETYPE_UNKNOWN;
+
+    StringNoCaseEqual ncasecomp;
+    const std::string ext = name.substr(dot + 1);
+    if (ncasecomp(ext, "png")) return GNASH_FILETYPE_PNG;
+    if (ncasecomp(ext, "jpg") || ncasecomp(ext, "jpeg")) {
+        return GNASH_FILETYPE_JPEG;
+    }
+    return GNASH_FILETYPE_UNKNOWN;
+}
+
+/// Read the manifest: one movie per line, followed by the image file
+/// name and the frames to render. Empty lines and lines starting with
+/// '#' are skipped, and so are lines whose image file isn't a PNG or
+/// a JPEG.
+bool
+readManifest(std::istream& in, std::vector<Job>& jobs)
+{
+    std::string line;
+    size_t lineno = 0;
+    while (std::getline(in, line)) {
+        ++lineno;
+        std::istringstream ss(line);
+        Job job;
+        if (!(ss >> job.swf) || job.swf[0] == '#') continue;
+
+        std::string target;
+        if (ss >> job.output) {
+            while (ss >> target) {
+                Target t;
+                if (!parseTarget(target, t)) {
+                    std::cerr << boost::format(_("Manifest line %1%: bad "
+                                "frame ``%2%''")) % lineno % target
+                              << std::endl;
+                    return false;
+                }
+                job.targets.push_back(t);
+            }
+        }
+
+        if (job.targets.empty()) {
+            std::cerr << boost::format(_("Manifest line %1%: expected a "
+                        "movie, an image file and at least one frame"))
+                      % lineno << std::endl;
+            return false;
+        }
+
+        if (outputType(job.output) == GNASH_FILETYPE_UNKNOWN) {
+            std::cerr << boost::format(_("Manifest line %1%: can't write "
+                        "``%2%'', skipping it (only png and jpeg images "
+                        "are supported)")) % lineno % job.output
+                      << std::endl;
+            continue;
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+/// The image file to write for an advance count.
+//
+/// If the pattern has no %f and more than one frame is rendered, the
+/// count is put before the extension so that images don't overwrite
+/// each other.
+std::string
+outputName(const Job& job, size_t advances)
+{
+    const std::string count = std::to_string(advances);
+    std::string name = job.output;
+
+    const std::string::size_type pos = name.find("%f");
+    if (pos != std::string::npos) {
+        return name.replace(pos, 2, count);
+    }
+    if (job.targets.size() < 2) return name;
+
+    std::string::size_type dot = name.rfind('.');
+    const std::string::size_type slash = name.rfind('/');
+    if (dot == std::string::npos ||
+            (slash != std::string::npos && dot < slash)) {
+        dot = name.size();
+    }
+    return name.insert(dot, "-" + count);
+}
+
+/// Load a movie and render its frames, virtually.
+//
+/// Everything a movie uses is created here, so any number of movies can
+/// be rendered at the same time on different threads. Time only passes
+/// on the movie's own ManualClock, so the images don't depend on how
+/// busy the machine is.
+Result
+renderMovie(const Job& job, const Settings& settings)
+{
+    Result result;
+    const std::uint64_t start = clocktime::getTicks();
+
+    RunResources runResources;
+    runResources.setTagLoaders(settings.loaders);
+    runResources.setStreamProvider(
+            std::make_shared<StreamProvider>(job.swf, job.swf));
+#ifdef USE_MEDIA
+    std::shared_ptr<media::MediaHandler> mediaHandler(
+            media::MediaFactory::instance().get(rcfile.getMediaHandler()));
+    runResources.setMediaHandler(mediaHandler);
+#endif
+
+    std::shared_ptr<Renderer_agg_base> renderer(
+            create_Renderer_agg("RGBA32"));
+    if (!renderer) {
+        result.error = _("could not create an AGG renderer");
+        return result;
+    }
+    runResources.setRenderer(renderer);
+
+    // Load through a stream rather than from a URL, so that the movie
+    // doesn't go in the MovieFactory's library, which is shared by all
+    // threads: each job owns its definition.
+    const URL url(job.swf);
+    std::unique_ptr<IOChannel> in =
+        runResources.streamProvider().getStream(url);
+    if (!in.get() || in->bad()) {
+        result.error = _("can't open movie");
+        return result;
+    }
+
+    boost::intrusive_ptr<movie_definition> md;
+    try {
+        md = MovieFactory::makeMovie(std::move(in), url.str(), runResources,
+                false);
+    }
+    catch (const GnashException& ge) {
+        result.error = ge.what();
+        return result;
+    }
+    if (!md) {
+        result.error = _("can't load movie");
+        return result;
+    }
+
+    const float fps = md->get_frame_rate() > 0 ? md->get_frame_rate() : 12;
+    const unsigned long frameDelay = 1000 / fps;
+
+    // Turn times into advance counts, and render the frames in order.
+    std::vector<size_t> targets;
+    for (const Target& t : job.targets) {
+        targets.push_back(t.time ? std::ceil(t.value * fps / 1000) : t.value);
+    }
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+
+    const size_t movieWidth = std::max<size_t>(md->get_width_pixels(), 1);
+    const size_t movieHeight = std::max<size_t>(md->get_height_pixels(), 1);
+    const float scale = settings.width ?
+        static_cast<float>(settings.width) / movieWidth : 1.0f;
+    const size_t width = std::max<size_t>(std::lround(movieWidth * scale), 1);
+    const size_t height = std::max<size_t>(std::lround(movieHeight * scale), 1);
+
+    const size_t stride = width * 4;
+    std::vector<unsigned char> buffer(stride * height);
+    renderer->init_buffer(buffer.data(), buffer.size(), width, height,
+            stride);
+    renderer->set_scale(scale, scale);
+
+    InvalidatedRanges world;
+    world.setWorld();
+
+    ManualClock clock;
+    FsCommandExecutor fsCommand;
+
+    // Scope to ensure that movie_root is destroyed before the movie
+    // definition and its resources.
+    {
+        movie_root m(clock, runResources);
+        m.registerEventCallback(&eventCallback);
+        m.registerFSCommandCallback(&fsCommand);
+
+        md->completeLoad();
+
+        MovieClip::MovieVariables v;
+        m.init(md.get(), v);
+        m.setDimensions(movieWidth, movieHeight);
+
+        for (size_t target : targets) {
+
+            while (result.advances < target && !fsCommand.quit) {
+                if (settings.timeout && clocktime::getTicks() - start >
+                        settings.timeout * 1000) {
+                    result.timedOut = true;
+                    result.error = _("timed out");
+                    return result;
+                }
+                clock.advance(frameDelay);
+                m.advance();
+                ++result.advances;
+            }
+
+            const std::string name = outputName(job, target);
+            std::unique_ptr<IOChannel> out = makeFileChannel(name.c_str(),
+                    "wb");
+            if (!out.get()) {
+                result.error = (boost::format(_("can't open ``%1%'' for "
+                                "writing")) % name).str();
+                return result;
+            }
+            try {
+                renderer->set_invalidated_regions(world);
+                m.display();
+                renderer->renderToImage(std::move(out), outputType(name),
+                        settings.quality);
+            }
+            catch (const GnashException& ge) {
+                result.error = ge.what();
+                return result;
+            }
+            ++result.images;
+        }
+    }
+
+    result.ok = true;
+    return result;
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char *argv[])
+{
+    std::ios::sync_with_stdio(false);
+
+    // Enable native language support, i.e. internationalization
+#ifdef ENABLE_NLS
+    setlocale (LC_ALL, "");
+    bindtextdomain (PACKAGE, LOCALEDIR);
+    textdomain (PACKAGE);
+#endif
+    int c;
+
+    // scan for the two main standard GNU options
+    for (c = 0; c < argc; c++) {
+        if (std::strcmp("--help", argv[c]) == 0) {
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        if (std::strcmp("--version", argv[c]) == 0) {
+            std::printf(_("Gnash gbatchrender version: %s, Gnash version: "
+                        "%s\n"), GBATCHRENDER_VERSION, VERSION);
+            return EXIT_SUCCESS;
+        }
+    }
+
+    Settings settings;
+    unsigned int threads = std::thread::hardware_concurrency();
+    bool verbose = false;
+
+    dbglogfile.setLogFilename(rcfile.getDebugLog());
+    if (rcfile.useWriteLog()) {
+        dbglogfile.setWriteDisk(true);
+    }
+
+    while ((c = getopt (argc, argv, ":hvj:t:w:q:")) != -1) {
+        switch (c) {
+            case 'h':
+                usage (argv[0]);
+                dbglogfile.removeLog();
+                return EXIT_SUCCESS;
+            case 'v':
+                verbose = true;
+                break;
+            case 'j':
+                threads = std::strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                settings.timeout = std::strtoul(optarg, NULL, 0);
+                break;
+            case 'w':
+                settings.width = std::strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                settings.quality = std::min(std::max(
+                            std::atoi(optarg), 1), 100);
+                break;
+            case ':':
+                std::fprintf(stderr, "Missing argument for switch ``%c''\n",
+                        optopt);
+                return EXIT_FAILURE;
+            case '?':
+            default:
+                std::fprintf(stderr, "Unknown switch ``%c''\n", optopt);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind + 1 != argc) {
+        usage(argv[0]);
+        dbglogfile.removeLog();
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Job> jobs;
+    const std::string manifest(argv[optind]);
+    if (manifest == "-") {
+        if (!readManifest(std::cin, jobs)) return EXIT_FAILURE;
+    }
+    else {
+        std::ifstream in(manifest.c_str());
+        if (!in) {
+            std::cerr << boost::format(_("Can't open manifest %1%"))
+                % manifest << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (!readManifest(in, jobs)) return EXIT_FAILURE;
+    }
+
+    // The sandboxes are global, so they are all set up before any
+    // worker starts.
+    for (const Job& job : jobs) {
+        URL url(job.swf);
+        if (url.protocol() != "file") continue;
+        const std::string& path = url.path();
+        rcfile.addLocalSandboxPath(path.substr(0, path.find_last_of('/') + 1));
+    }
+
+    settings.loaders = std::make_shared<SWF::TagLoadersTable>();
+    addDefaultLoaders(*settings.loaders);
+
+    threads = std::max(1u, std::min<unsigned int>(threads, jobs.size()));
+
+    std::vector<Result> results(jobs.size());
+    std::atomic<size_t> next(0);
+    std::mutex outputMutex;
+
+    const std::uint64_t start = clocktime::getTicks();
+
+    // Each worker takes the next movie until there are none left.
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            const std::uint64_t jobStart = clocktime::getTicks();
+            results[i] = renderMovie(jobs[i], settings);
+            const Result& r = results[i];
+
+            if (!verbose && r.ok) continue;
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            if (r.ok) {
+                std::cout << boost::format(_("%1%: %2% images, %3% "
+                            "advances, %4% ms")) % jobs[i].swf % r.images
+                    % r.advances % (clocktime::getTicks() - jobStart)
+                    << std::endl;
+            }
+            else {
+                std::cerr << boost::format(_("%1%: %2%")) % jobs[i].swf
+                    % r.error << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+
+    MovieFactory::clear();
+
+    const double seconds = std::max<std::uint64_t>(
+            clocktime::getTicks() - start, 1) / 1000.0;
+
+    size_t ok = 0, timedOut = 0, images = 0, advances = 0;
+    for (const Result& r : results) {
+        if (r.ok) ++ok;
+        if (r.timedOut) ++timedOut;
+        images += r.images;
+        advances += r.advances;
+    }
+
+    std::cout << boost::format(_("%1% movies: %2% rendered, %3% failed, "
+                "%4% timed out")) % jobs.size() % ok
+        % (jobs.size() - ok - timedOut) % timedOut << std::endl;
+    std::cout << boost::format(_("%1% images, %2% advances in %3$.2f s "
+                "with %4% threads: %5$.2f movies/s, %6$.1f advances/s"))
+        % images % advances % seconds % threads % (jobs.size() / seconds)
+        % (advances / seconds) << std::endl;
+
+    return ok == jobs.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+namespace {
+
+void
+usage(const char *name)
+{
+    std::printf(
+    _("gbatchrender -- renders frames of SWF movies to images.\n"
+      "\n"
+      "usage: %s [options] <manifest>\n"
+      "\n"
+      "Each line of the manifest names a movie, the image file to write\n"
+      "and the frames to render, for example:\n"
+      "\n"
+      "  intro.swf thumbs/intro-%%f.png 1 24 2s 1500ms\n"
+      "\n"
+      "A frame is a number of advances, or a time in the movie with an\n"
+      "ms or s suffix. %%f in the file name is replaced by the number of\n"
+      "advances; the file extension selects PNG or JPEG. Use - to read\n"
+      "the manifest from standard input.\n"
+      "\n"
+      "  --help(-h)  Print this info.\n"
+      "  --version   Print the version numbers.\n"
+      "  -v          Report every movie, not only failures\n"
+      "  -j <num>    Render <num> movies at a time (default: one per CPU)\n"
+      "  -t <sec>    Give up on a movie after <sec> seconds (default: "
+      "never)\n"
+      "  -w <px>     Scale images to <px> pixels wide\n"
+      "  -q <num>    JPEG quality, 1 to 100 (default: 90)\n"
+      ), name);
+}
+
+} // anonymous namespace
+
+// Local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End: